@@ -51,7 +51,7 @@ macro(os_set_flags)
 endmacro()
 
 macro(os_target_config)
-    add_definitions(-D__SSSE3__ -D_CRT_SECURE_NO_WARNINGS)
+    add_definitions(-D__SSE2__ -D__SSSE3__ -D_CRT_SECURE_NO_WARNINGS)
 
     if(FORCE_WINUSB_UVC)
         target_sources(${LRS_TARGET}
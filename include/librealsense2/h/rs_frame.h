@@ -25,6 +25,24 @@ typedef enum rs2_timestamp_domain
 } rs2_timestamp_domain;
 const char* rs2_timestamp_domain_to_string(rs2_timestamp_domain info);
 
+/** \brief File formats a points frame can be exported to. Both are written binary little endian. */
+typedef enum rs2_points_file_format
+{
+    RS2_POINTS_FILE_FORMAT_PLY, /**< Stanford polygon file, with optional faces between neighbouring depth pixels */
+    RS2_POINTS_FILE_FORMAT_PCD, /**< Point Cloud Library file, organized when the frame covers the whole depth image */
+    RS2_POINTS_FILE_FORMAT_COUNT /**< Number of enumeration values. Not a valid input: intended to be used in for-loops. */
+} rs2_points_file_format;
+const char* rs2_points_file_format_to_string(rs2_points_file_format format);
+
+/** \brief Content of an exported points file, combined bitwise. */
+typedef enum rs2_points_export_flags
+{
+    RS2_POINTS_EXPORT_DROP_INVALID = 1 << 0, /**< Skip points without depth instead of writing them at the origin (PLY) or as NaN (PCD) */
+    RS2_POINTS_EXPORT_COLORS       = 1 << 1, /**< Write the RGB color of every point, sampled from the texture frame */
+    RS2_POINTS_EXPORT_NORMALS      = 1 << 2, /**< Write a normal per point, estimated from its neighbours in the depth image */
+    RS2_POINTS_EXPORT_FACES        = 1 << 3  /**< Write triangles between neighbouring depth pixels, PLY only */
+} rs2_points_export_flags;
+
 /** \brief Per-Frame-Metadata is the set of read-only properties that might be exposed for each individual frame. */
 typedef enum rs2_frame_metadata_value
 {
@@ -189,6 +207,7 @@ void rs2_keep_frame(rs2_frame* frame);
 /**
 * When called on Points frame type, this method returns a pointer to an array of 3D vertices of the model
 * The coordinate system is: X right, Y up, Z away from the camera. Units: Meters
+* Fails for vertices encoded in 16 bits (see RS2_OPTION_POINTS_ENCODING), those start at rs2_get_frame_data
 * \param[in] frame       Points frame
 * \param[out] error      If non-null, receives any error that occurs during this call, otherwise, errors are ignored
 * \return                Pointer to an array of vertices, lifetime is managed by the frame
@@ -204,6 +223,52 @@ rs2_vertex* rs2_get_frame_vertices(const rs2_frame* frame, rs2_error** error);
 */
 void rs2_export_to_ply(const rs2_frame* frame, const char* fname, rs2_frame* texture, rs2_error** error);
 
+/**
+* When called on Points frame type, this method writes the points to a binary PLY or PCD file.
+* \param[in] frame       Points frame
+* \param[in] fname       The name of the file
+* \param[in] texture     Texture frame, may be null. This operation passes its ownership to the library
+* \param[in] format      File format
+* \param[in] flags       Combination of rs2_points_export_flags
+* \param[out] error      If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_export_points(const rs2_frame* frame, const char* fname, rs2_frame* texture, rs2_points_file_format format, int flags, rs2_error** error);
+
+/**
+* Create an exporter that writes points frames to files on a background thread, so the caller does not wait for the disk.
+* Every frame is written to <prefix><frame number>.ply or .pcd
+* \param[in] prefix      Path and name prefix of the files
+* \param[in] format      File format
+* \param[in] flags       Combination of rs2_points_export_flags
+* \param[in] capacity    Number of frames that may wait for the writer before rs2_points_exporter_enqueue blocks.
+*                        Queued frames stay allocated, keep it small for live streams
+* \param[out] error      If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return                Exporter handle, to be released by rs2_delete_points_exporter
+*/
+rs2_points_exporter* rs2_create_points_exporter(const char* prefix, rs2_points_file_format format, int flags, int capacity, rs2_error** error);
+
+/**
+* Queue a points frame for export. Blocks only while the queue is full
+* \param[in] exporter    Exporter handle
+* \param[in] frame       Points frame. This operation passes its ownership to the exporter
+* \param[in] texture     Texture frame, may be null. This operation passes its ownership to the exporter
+* \param[out] error      If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_points_exporter_enqueue(rs2_points_exporter* exporter, rs2_frame* frame, rs2_frame* texture, rs2_error** error);
+
+/**
+* Wait until every queued frame is written
+* \param[in] exporter    Exporter handle
+* \param[out] error      If non-null, receives the first error of the writer since the last flush
+*/
+void rs2_points_exporter_flush(rs2_points_exporter* exporter, rs2_error** error);
+
+/**
+* Write the frames still queued and release the exporter
+* \param[in] exporter    Exporter handle
+*/
+void rs2_delete_points_exporter(rs2_points_exporter* exporter);
+
 /**
 * When called on Points frame type, this method returns a pointer to an array of texture coordinates per vertex
 * Each coordinate represent a (u,v) pair within [0,1] range, to be mapped to texture image
@@ -221,6 +286,15 @@ rs2_pixel* rs2_get_frame_texture_coordinates(const rs2_frame* frame, rs2_error**
 */
 int rs2_get_frame_points_count(const rs2_frame* frame, rs2_error** error);
 
+/**
+* When called on Points frame type, this method returns a pointer to the index of the depth pixel each vertex was computed from
+* The indices are only present when the pointcloud was asked for them with RS2_OPTION_POINTS_PIXEL_INDICES
+* \param[in] frame       Points frame
+* \param[out] error      If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return                Pointer to an array of pixel indices, lifetime is managed by the frame. Null if the frame has none
+*/
+const int* rs2_get_frame_pixel_indices(const rs2_frame* frame, rs2_error** error);
+
 /**
 * Returns the stream profile that was used to start the stream of this frame
 * \param[in] frame       frame reference, owned by the user
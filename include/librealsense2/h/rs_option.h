@@ -81,6 +81,17 @@ extern "C" {
         RS2_OPTION_ENABLE_POSE_JUMPING, /**< Enable position jumping */
         RS2_OPTION_ENABLE_DYNAMIC_CALIBRATION, /**< Enable dynamic calibration */
         RS2_OPTION_DEPTH_OFFSET, /**< Offset from sensor to depth origin in millimetrers*/
+        RS2_OPTION_FRAMES_POOL_HITS, /**< Number of frame buffers served from the recycled frames pool */
+        RS2_OPTION_FRAMES_POOL_MISSES, /**< Number of frame buffers that had to be newly allocated */
+        RS2_OPTION_FRAMES_POOL_EVICTIONS, /**< Number of recycled frame buffers released after aging out of the pool */
+        RS2_OPTION_PASSTHROUGH_FRAMES_COPIED, /**< Number of zero-copy frames that were copied to release a capture buffer back to the backend */
+        RS2_OPTION_POINTS_COMPACT, /**< Emit only points with valid depth, packed without gaps */
+        RS2_OPTION_POINTS_PIXEL_INDICES, /**< Add the index of the source depth pixel of every point */
+        RS2_OPTION_POINTS_ENCODING, /**< Encoding of the point coordinates: 32-bit float, 16-bit fixed point in depth units or 16-bit half float */
+        RS2_OPTION_VOXEL_LEAF_SIZE, /**< Edge length of the voxels of the voxel filter, in meters */
+        RS2_OPTION_VOXEL_POLICY, /**< Point the voxel filter keeps for every voxel: the centroid or the first point */
+        RS2_OPTION_COLORIZER_FORMAT, /**< Format of the frames of the colorizer: RGB8, RGBA8 or BGR8, RGB8 only for the GLSL colorizer */
+        RS2_OPTION_DEPTH_LUT_OUTPUT, /**< Output of the depth lookup table transform: thresholded depth, disparity or meters */
         RS2_OPTION_COUNT /**< Number of enumeration values. Not a valid input: intended to be used in for-loops. */
     } rs2_option;
 
@@ -243,6 +243,132 @@ rs2_processing_block* rs2_create_rates_printer_block(rs2_error** error);
 */
 rs2_processing_block* rs2_create_zero_order_invalidation_block(rs2_error** error);
 
+/**
+* Creates a point cloud voxel filter block. The filter keeps a single point, the centroid or the first point, for every occupied voxel
+* \param[out] error     If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return               voxel filter processing block
+*/
+rs2_processing_block* rs2_create_voxel_filter_block(rs2_error** error);
+
+/**
+* Creates a depth lookup table transform block. The block thresholds Z16 depth and optionally converts it to disparity or meters, in a single pass
+* \param[out] error     If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return               depth lookup table transform processing block
+*/
+rs2_processing_block* rs2_create_depth_lut_transform_block(rs2_error** error);
+
+/**
+* Creates a depth post-processing chain block. The block runs decimation, depth to disparity, spatial filtering, temporal filtering,
+* disparity to depth and hole filling as a single block, fused over tiles of rows, with the results of the separate filters.
+* Every stage follows the options of its filter, a null filter skips the stage
+* \param[in] decimation    Decimation filter block, or null
+* \param[in] spatial       Spatial filter block, or null
+* \param[in] temporal      Temporal filter block, or null
+* \param[in] hole_filling  Hole filling filter block, or null
+* \param[out] error        If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return                  depth post-processing chain processing block
+*/
+rs2_processing_block* rs2_create_depth_post_processing_chain_block(rs2_processing_block* decimation, rs2_processing_block* spatial,
+    rs2_processing_block* temporal, rs2_processing_block* hole_filling, rs2_error** error);
+
+/**
+* Creates a pipelined processing block, running a chain of processing blocks with every stage on a worker of its own.
+* The stages hand their frames over through bounded queues, so the throughput of the chain is that of its slowest stage.
+* Every stage sees its frames in order. rs2_process_frame returns once the frame is queued at the first stage, and the
+* frames of the last stage go to the callback of the pipelined block, on the worker of that stage.
+* The stages deliver their frames to the pipelined block from then on
+* \param[in] stages      Processing blocks of the chain, in order
+* \param[in] count       Number of stages
+* \param[in] queue_size  Frames waiting between two stages at most, a stage with a full queue ahead waits for room
+* \param[out] error      If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return                pipelined processing block
+*/
+rs2_processing_block* rs2_create_pipelined_processing_block(rs2_processing_block** stages, int count, int queue_size, rs2_error** error);
+
+/** \brief Latency of a node of a processing graph, over the frames it processed so far */
+typedef struct rs2_processing_node_stats
+{
+    unsigned long long frames;  /**< Frames processed by the node */
+    double average_ms;          /**< Average processing time of the block, in milliseconds */
+    double max_ms;              /**< Longest processing time of the block, in milliseconds */
+    double average_wait_ms;     /**< Average time frames waited in the queue of the node, in milliseconds */
+} rs2_processing_node_stats;
+
+/**
+* Creates a processing graph. The graph runs processing blocks as the nodes of a tree, independent nodes concurrently
+* on a pool of workers shared by the graph, every node one frame at a time in the order of its input
+* \param[in] threads     Number of workers of the graph, 0 for one per core
+* \param[out] error      If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return                handle to the processing graph, must be released using rs2_delete_processing_graph
+*/
+rs2_processing_graph* rs2_create_processing_graph(int threads, rs2_error** error);
+
+/**
+* Deletes a processing graph, dropping the frames it did not process yet
+* \param[in] graph       Processing graph
+*/
+void rs2_delete_processing_graph(rs2_processing_graph* graph);
+
+/**
+* Adds a processing block to a processing graph. The node receives the frames of its parent through the stream filter
+* of the edge: a filter of any stream, format and index passes framesets whole, others pass the matching frame, alone
+* or out of a frameset. The block delivers its frames to the graph from then on, nodes can not be added once the
+* graph processed frames
+* \param[in] graph       Processing graph
+* \param[in] block       Processing block of the node, delivering its frames from rs2_process_frame, not a pipelined processing block
+* \param[in] parent      Node feeding the new node, -1 for the frames given to rs2_processing_graph_invoke
+* \param[in] stream      Stream type of the frames passed to the node, RS2_STREAM_ANY for any
+* \param[in] format      Format of the frames passed to the node, RS2_FORMAT_ANY for any
+* \param[in] index       Stream index of the frames passed to the node, -1 for any
+* \param[out] error      If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return                the node of the block in the graph
+*/
+int rs2_processing_graph_add_node(rs2_processing_graph* graph, rs2_processing_block* block, int parent,
+    rs2_stream stream, rs2_format format, int index, rs2_error** error);
+
+/**
+* Sets the callback receiving the frames of a node, on the worker that ran the node
+* \param[in] graph       Processing graph
+* \param[in] node        Node of the graph
+* \param[in] on_frame    Callback receiving the frames of the node
+* \param[out] error      If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_processing_graph_start(rs2_processing_graph* graph, int node, rs2_frame_callback* on_frame, rs2_error** error);
+
+/**
+* Sends the frames of a node to a frame queue
+* \param[in] graph       Processing graph
+* \param[in] node        Node of the graph
+* \param[in] queue       Frame queue receiving the frames of the node
+* \param[out] error      If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_processing_graph_start_queue(rs2_processing_graph* graph, int node, rs2_frame_queue* queue, rs2_error** error);
+
+/**
+* Queues a frame at the roots of a processing graph, and returns once the graph holds few enough frames.
+* Called from a callback of the graph, it queues the frame at once
+* \param[in] graph       Processing graph
+* \param[in] frame       Frame to process, released by the graph
+* \param[out] error      If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_processing_graph_invoke(rs2_processing_graph* graph, rs2_frame* frame, rs2_error** error);
+
+/**
+* Waits until all the frames given to a processing graph went through it. Fails when called from a callback of the graph
+* \param[in] graph       Processing graph
+* \param[out] error      If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_processing_graph_wait(rs2_processing_graph* graph, rs2_error** error);
+
+/**
+* Retrieves the latency of a node of a processing graph
+* \param[in] graph       Processing graph
+* \param[in] node        Node of the graph
+* \param[out] stats      Latency of the node
+* \param[out] error      If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_processing_graph_get_stats(const rs2_processing_graph* graph, int node, rs2_processing_node_stats* stats, rs2_error** error);
+
 /**
 * Retrieve processing block specific information, like name.
 * \param[in]  block     The processing block
@@ -29,6 +29,27 @@ const char* rs2_playback_status_to_string(rs2_playback_status status);
 
 typedef void (*rs2_playback_status_changed_callback_ptr)(rs2_playback_status);
 
+/** \brief Defines how a recording device handles frames arriving while its write queue is over budget */
+typedef enum rs2_recording_queue_policy
+{
+    RS2_RECORDING_QUEUE_POLICY_BLOCK,                /**< Block the sensor until the writer frees enough room */
+    RS2_RECORDING_QUEUE_POLICY_DROP_OLDEST,          /**< Drop the oldest queued frame of the same stream */
+    RS2_RECORDING_QUEUE_POLICY_DROP_NON_DEPTH_FIRST, /**< Drop the oldest queued non-depth frame, depth frames are dropped only when nothing else is queued */
+    RS2_RECORDING_QUEUE_POLICY_COUNT
+} rs2_recording_queue_policy;
+
+const char* rs2_recording_queue_policy_to_string(rs2_recording_queue_policy policy);
+
+/** \brief Live statistics of the queue holding frames between a recording device and the file writer */
+typedef struct rs2_recording_queue_stats
+{
+    unsigned long long queued_bytes;   /**< Frame data waiting to be written, in bytes */
+    unsigned long long queued_frames;  /**< Number of frames waiting to be written */
+    unsigned long long dropped_frames; /**< Number of frames discarded by the queue policy */
+    unsigned long long written_bytes;  /**< Frame data written to file so far, in bytes */
+    double             write_throughput; /**< Frame data written during the last second, in bytes per second */
+} rs2_recording_queue_stats;
+
 /**
  * Creates a recording device to record the given device and save it to the given file
  * \param[in]  device    The device to record
@@ -71,6 +92,32 @@ void rs2_record_device_resume(const rs2_device* device, rs2_error** error);
 */
 const char* rs2_record_device_filename(const rs2_device* device, rs2_error** error);
 
+/**
+* Limits the memory used by frames waiting to be written to file, and selects what to do when the limit is reached
+* \param[in]  device    A recording device
+* \param[in]  max_bytes Maximal size of queued frame data in bytes, 0 means unlimited
+* \param[in]  policy    How to handle frames arriving while the queue is full
+* \param[out] error     If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_record_device_set_queue_budget(const rs2_device* device, unsigned long long max_bytes, rs2_recording_queue_policy policy, rs2_error** error);
+
+/**
+* Retrieves live statistics of the recording device write queue
+* \param[in]  device    A recording device
+* \param[out] stats     Receives the current queue statistics
+* \param[out] error     If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_record_device_get_queue_stats(const rs2_device* device, rs2_recording_queue_stats* stats, rs2_error** error);
+
+/**
+* Configures how the recording device compresses the file. Takes effect from the next chunk of data written to file
+* \param[in]  device              A recording device
+* \param[in]  chunk_size          Size in bytes of uncompressed data grouped into a single compressed chunk, 0 keeps the current size
+* \param[in]  compression_threads Number of threads compressing chunks in parallel, 0 compresses on the recording thread
+* \param[out] error               If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_record_device_set_compression_options(const rs2_device* device, unsigned int chunk_size, unsigned int compression_threads, rs2_error** error);
+
 /**
 * Creates a playback device to play the content of the given file
 * \param[in]  file      Path to the file to play
@@ -103,6 +150,17 @@ unsigned long long int rs2_playback_get_duration(const rs2_device* device, rs2_e
  */
 void rs2_playback_seek(const rs2_device* device, long long int time, rs2_error** error);
 
+/**
+ * Set the playback to a specified frame of one of the played streams.
+ * Frame numbers are expected to grow along the file, playback resumes from the first frame of the stream numbered frame_number or above
+ * \param[in] device        A playback device.
+ * \param[in] stream        Type of the stream the frame number refers to
+ * \param[in] index         Index of the stream the frame number refers to
+ * \param[in] frame_number  The frame number to which playback should seek
+ * \param[out] error        If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ */
+void rs2_playback_seek_to_frame(const rs2_device* device, rs2_stream stream, int index, unsigned long long int frame_number, rs2_error** error);
+
 /**
  * Gets the current position of the playback in the file in terms of time. Units are expressed in nanoseconds
  * \param[in] device     A playback device
@@ -150,6 +208,23 @@ void rs2_playback_device_set_real_time(const rs2_device* device, int real_time,
  */
 int rs2_playback_device_is_real_time(const rs2_device* device, rs2_error** error);
 
+/**
+ * Set how many samples the playback device decodes ahead of the one being played.
+ * Upcoming chunks of the file are decompressed on worker threads, and the decoded samples wait in a bounded window
+ * \param[in] device     A playback device
+ * \param[in] max_items  Maximal number of decoded samples kept ready, 0 disables reading ahead
+ * \param[out] error     If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ */
+void rs2_playback_device_set_read_ahead(const rs2_device* device, unsigned int max_items, rs2_error** error);
+
+/**
+ * Gets the number of samples currently decoded ahead and ready to be played
+ * \param[in] device A playback device
+ * \param[out] error     If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ * \return Number of decoded samples waiting in the read-ahead window
+ */
+unsigned int rs2_playback_device_get_read_ahead_fill(const rs2_device* device, rs2_error** error);
+
 /**
  * Register to receive callback from playback device upon its status changes
  *
@@ -172,6 +172,10 @@ typedef enum rs2_extension
     RS2_EXTENSION_UPDATE_DEVICE,
     RS2_EXTENSION_L500_DEPTH_SENSOR,
     RS2_EXTENSION_TM2_SENSOR,
+    RS2_EXTENSION_VOXEL_FILTER,
+    RS2_EXTENSION_DEPTH_LUT_TRANSFORM,
+    RS2_EXTENSION_DEPTH_POST_PROCESSING_CHAIN,
+    RS2_EXTENSION_PIPELINED_PROCESSING_BLOCK,
     RS2_EXTENSION_COUNT
 } rs2_extension;
 const char* rs2_extension_type_to_string(rs2_extension type);
@@ -210,6 +214,7 @@ typedef struct rs2_error rs2_error;
 typedef struct rs2_raw_data_buffer rs2_raw_data_buffer;
 typedef struct rs2_frame rs2_frame;
 typedef struct rs2_frame_queue rs2_frame_queue;
+typedef struct rs2_points_exporter rs2_points_exporter;
 typedef struct rs2_pipeline rs2_pipeline;
 typedef struct rs2_pipeline_profile rs2_pipeline_profile;
 typedef struct rs2_config rs2_config;
@@ -223,6 +228,7 @@ typedef struct rs2_syncer rs2_syncer;
 typedef struct rs2_device_serializer rs2_device_serializer;
 typedef struct rs2_source rs2_source;
 typedef struct rs2_processing_block rs2_processing_block;
+typedef struct rs2_processing_graph rs2_processing_graph;
 typedef struct rs2_frame_processor_callback rs2_frame_processor_callback;
 typedef struct rs2_playback_status_changed_callback rs2_playback_status_changed_callback;
 typedef struct rs2_update_progress_callback rs2_update_progress_callback;
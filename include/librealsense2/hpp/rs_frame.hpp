@@ -12,11 +12,13 @@ namespace rs2
     class frame_queue;
     class syncer;
     class processing_block;
+    class processing_graph;
     class pointcloud;
     class sensor;
     class frame;
     class pipeline_profile;
     class points;
+    class points_exporter;
     class video_stream_profile;
 
     class stream_profile
@@ -615,8 +617,10 @@ namespace rs2
         friend class rs2::frame_queue;
         friend class rs2::syncer;
         friend class rs2::processing_block;
+        friend class rs2::processing_graph;
         friend class rs2::pointcloud;
         friend class rs2::points;
+        friend class rs2::points_exporter;
 
         rs2_frame* frame_ref;
 
@@ -762,6 +766,23 @@ namespace rs2
             rs2_export_to_ply(get(), fname.c_str(), ptr, &e);
             error::handle(e);
         }
+
+        /**
+        * Export the point cloud to a binary PLY or PCD file
+        * \param[in] string fname - file name
+        * \param[in] video_frame texture - the texture for the point colors, may be empty
+        * \param[in] rs2_points_file_format format - file format
+        * \param[in] int flags - combination of rs2_points_export_flags
+        */
+        void export_to(const std::string& fname, video_frame texture, rs2_points_file_format format,
+            int flags = RS2_POINTS_EXPORT_DROP_INVALID | RS2_POINTS_EXPORT_COLORS | RS2_POINTS_EXPORT_FACES) const
+        {
+            rs2_frame* ptr = nullptr;
+            std::swap(texture.frame_ref, ptr);
+            rs2_error* e = nullptr;
+            rs2_export_points(get(), fname.c_str(), ptr, format, flags, &e);
+            error::handle(e);
+        }
         /**
         * Retrieve the texture coordinates (uv map) for the point cloud
         * \return texture_coordinate* - pointer of texture coordinates.
@@ -774,6 +795,18 @@ namespace rs2
             return (const texture_coordinate*)res;
         }
 
+        /**
+        * Retrieve the index of the depth pixel each vertex was computed from
+        * \return int* - pointer of pixel indices, null unless requested with RS2_OPTION_POINTS_PIXEL_INDICES
+        */
+        const int* get_pixel_indices() const
+        {
+            rs2_error* e = nullptr;
+            auto res = rs2_get_frame_pixel_indices(get(), &e);
+            error::handle(e);
+            return res;
+        }
+
         size_t size() const
         {
             return _size;
@@ -783,6 +816,56 @@ namespace rs2
         size_t _size;
     };
 
+    class points_exporter
+    {
+    public:
+        /**
+        * Create an exporter writing points frames to <prefix><frame number>.ply or .pcd on a background thread
+        * \param[in] string prefix - path and name prefix of the files
+        * \param[in] rs2_points_file_format format - file format
+        * \param[in] int flags - combination of rs2_points_export_flags
+        * \param[in] int capacity - frames that may wait for the writer before enqueue blocks
+        */
+        points_exporter(const std::string& prefix, rs2_points_file_format format = RS2_POINTS_FILE_FORMAT_PLY,
+            int flags = RS2_POINTS_EXPORT_DROP_INVALID | RS2_POINTS_EXPORT_COLORS | RS2_POINTS_EXPORT_FACES, int capacity = 4)
+        {
+            rs2_error* e = nullptr;
+            _exporter = std::shared_ptr<rs2_points_exporter>(
+                rs2_create_points_exporter(prefix.c_str(), format, flags, capacity, &e),
+                rs2_delete_points_exporter);
+            error::handle(e);
+        }
+
+        /**
+        * Queue a point cloud for export, blocks only while the queue is full
+        * \param[in] points p - the point cloud
+        * \param[in] video_frame texture - the texture for the point colors, may be empty
+        */
+        void enqueue(points p, video_frame texture = frame()) const
+        {
+            rs2_frame* cloud = nullptr;
+            rs2_frame* ptr = nullptr;
+            std::swap(p.frame_ref, cloud);
+            std::swap(texture.frame_ref, ptr);
+            rs2_error* e = nullptr;
+            rs2_points_exporter_enqueue(_exporter.get(), cloud, ptr, &e);
+            error::handle(e);
+        }
+
+        /**
+        * Wait until every queued point cloud is written, throws the first error of the writer since the last flush
+        */
+        void flush() const
+        {
+            rs2_error* e = nullptr;
+            rs2_points_exporter_flush(_exporter.get(), &e);
+            error::handle(e);
+        }
+
+    private:
+        std::shared_ptr<rs2_points_exporter> _exporter;
+    };
+
     class depth_frame : public video_frame
     {
     public:
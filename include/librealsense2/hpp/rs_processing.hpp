@@ -964,6 +964,105 @@ namespace rs2
         }
     };
 
+    class voxel_filter : public filter
+    {
+    public:
+        /**
+        * Create voxel filter
+        * The filter downsamples a point cloud to a single point for every occupied voxel
+        */
+        voxel_filter() : filter(init(), 1) {}
+
+        /**
+        * Create voxel filter
+        * \param[in] leaf_size - voxel edge length in meters
+        */
+        voxel_filter(float leaf_size) : filter(init(), 1)
+        {
+            set_option(RS2_OPTION_VOXEL_LEAF_SIZE, leaf_size);
+        }
+
+        voxel_filter(filter f) : filter(f)
+        {
+            rs2_error* e = nullptr;
+            if (!rs2_is_processing_block_extendable_to(f.get(), RS2_EXTENSION_VOXEL_FILTER, &e) && !e)
+            {
+                _block.reset();
+            }
+            error::handle(e);
+        }
+
+    private:
+        friend class context;
+
+        std::shared_ptr<rs2_processing_block> init()
+        {
+            rs2_error* e = nullptr;
+            auto block = std::shared_ptr<rs2_processing_block>(
+                rs2_create_voxel_filter_block(&e),
+                rs2_delete_processing_block);
+            error::handle(e);
+
+            return block;
+        }
+    };
+
+    class depth_lut_transform : public filter
+    {
+    public:
+        /**
+        * Create depth lookup table transform
+        * The block thresholds depth and optionally converts it to disparity or meters, mapping every pixel through a single table
+        */
+        depth_lut_transform() : filter(init(), 1) {}
+
+        /**
+        * Create depth lookup table transform
+        * \param[in] min_dist - minimal distance in meters kept by the threshold
+        * \param[in] max_dist - maximal distance in meters kept by the threshold
+        * \param[in] format   - RS2_FORMAT_Z16 for thresholded depth, RS2_FORMAT_DISPARITY32 (depth of a non-stereo sensor stays thresholded Z16) or RS2_FORMAT_DISTANCE
+        */
+        depth_lut_transform(float min_dist, float max_dist, rs2_format format = RS2_FORMAT_Z16) : filter(init(), 1)
+        {
+            // The block refuses a min above its max, so a range beyond the default one gets its max first
+            if (min_dist > get_option(RS2_OPTION_MAX_DISTANCE))
+            {
+                set_option(RS2_OPTION_MAX_DISTANCE, max_dist);
+                set_option(RS2_OPTION_MIN_DISTANCE, min_dist);
+            }
+            else
+            {
+                set_option(RS2_OPTION_MIN_DISTANCE, min_dist);
+                set_option(RS2_OPTION_MAX_DISTANCE, max_dist);
+            }
+            set_option(RS2_OPTION_DEPTH_LUT_OUTPUT, format == RS2_FORMAT_DISPARITY32 ? 1.f : format == RS2_FORMAT_DISTANCE ? 2.f : 0.f);
+        }
+
+        depth_lut_transform(filter f) : filter(f)
+        {
+            rs2_error* e = nullptr;
+            if (!rs2_is_processing_block_extendable_to(f.get(), RS2_EXTENSION_DEPTH_LUT_TRANSFORM, &e) && !e)
+            {
+                _block.reset();
+            }
+            error::handle(e);
+        }
+
+    private:
+        friend class context;
+
+        std::shared_ptr<rs2_processing_block> init()
+        {
+            rs2_error* e = nullptr;
+            auto block = std::shared_ptr<rs2_processing_block>(
+                rs2_create_depth_lut_transform_block(&e),
+                rs2_delete_processing_block);
+            error::handle(e);
+
+            return block;
+        }
+    };
+
     class hole_filling_filter : public filter
     {
     public:
@@ -1013,6 +1112,189 @@ namespace rs2
         }
     };
 
+    class depth_post_processing_chain : public filter
+    {
+    public:
+        /**
+        * Create depth post-processing chain
+        * The block runs decimation, depth to disparity, spatial filtering, temporal filtering, disparity to depth and hole filling
+        * fused over tiles of rows, with the results of the separate filters. Each stage follows the options of its filter, so
+        * setting an option on one of the filters changes the chain. An empty filter skips its stage
+        * \param[in] decimation    - decimation filter of the chain
+        * \param[in] spatial       - spatial filter of the chain
+        * \param[in] temporal      - temporal filter of the chain
+        * \param[in] hole_filling  - hole filling filter of the chain
+        */
+        depth_post_processing_chain(decimation_filter decimation, spatial_filter spatial,
+            temporal_filter temporal, hole_filling_filter hole_filling)
+            : filter(init(decimation, spatial, temporal, hole_filling), 1) {}
+
+        depth_post_processing_chain(filter f) : filter(f)
+        {
+            rs2_error* e = nullptr;
+            if (!rs2_is_processing_block_extendable_to(f.get(), RS2_EXTENSION_DEPTH_POST_PROCESSING_CHAIN, &e) && !e)
+            {
+                _block.reset();
+            }
+            error::handle(e);
+        }
+
+    private:
+        friend class context;
+
+        std::shared_ptr<rs2_processing_block> init(const filter& decimation, const filter& spatial,
+            const filter& temporal, const filter& hole_filling)
+        {
+            rs2_error* e = nullptr;
+            auto block = std::shared_ptr<rs2_processing_block>(
+                rs2_create_depth_post_processing_chain_block(decimation.get(), spatial.get(), temporal.get(), hole_filling.get(), &e),
+                rs2_delete_processing_block);
+            error::handle(e);
+
+            return block;
+        }
+    };
+
+    class pipelined_processing_block : public processing_block
+    {
+    public:
+        /**
+        * Create pipelined processing block
+        * The block runs a chain of processing blocks with every stage on a worker of its own, handing frames over through
+        * bounded queues, so a stage works on a frame while the stage before it works on the next one. Every stage sees its
+        * frames in order. invoke returns once the frame is queued at the first stage, the frames of the last stage go to
+        * the callback given to start, on the worker of that stage. The stages deliver their frames to the block from then on
+        * \param[in] stages     - processing blocks of the chain, in order
+        * \param[in] queue_size - frames waiting between two stages at most
+        */
+        pipelined_processing_block(const std::vector<std::reference_wrapper<const processing_block>>& stages, int queue_size = 1)
+            : processing_block(init(stages, queue_size)) {}
+
+        pipelined_processing_block(processing_block b) : processing_block(b)
+        {
+            rs2_error* e = nullptr;
+            if (!rs2_is_processing_block_extendable_to(b.get(), RS2_EXTENSION_PIPELINED_PROCESSING_BLOCK, &e) && !e)
+            {
+                _block.reset();
+            }
+            error::handle(e);
+        }
+
+        operator bool() const { return _block.get() != nullptr; }
+
+    private:
+        std::shared_ptr<rs2_processing_block> init(const std::vector<std::reference_wrapper<const processing_block>>& stages, int queue_size)
+        {
+            std::vector<rs2_processing_block*> blocks;
+            for (auto&& stage : stages)
+                blocks.push_back(stage.get().get());
+
+            rs2_error* e = nullptr;
+            auto block = std::shared_ptr<rs2_processing_block>(
+                rs2_create_pipelined_processing_block(blocks.data(), int(blocks.size()), queue_size, &e),
+                rs2_delete_processing_block);
+            error::handle(e);
+
+            return block;
+        }
+    };
+
+    class processing_graph
+    {
+    public:
+        /**
+        * Create processing graph
+        * The graph runs processing blocks as the nodes of a tree, independent nodes concurrently on a pool of workers
+        * shared by the graph, every node one frame at a time in the order of its input. Branches of the graph that do
+        * not depend on each other, such as a colorizer and a pointcloud on the same depth, take the time of the longest one
+        * \param[in] threads - number of workers of the graph, 0 for one per core
+        */
+        explicit processing_graph(int threads = 0)
+        {
+            rs2_error* e = nullptr;
+            _graph = std::shared_ptr<rs2_processing_graph>(
+                rs2_create_processing_graph(threads, &e),
+                rs2_delete_processing_graph);
+            error::handle(e);
+        }
+
+        /**
+        * Add a processing block to the graph, fed by the frames of parent that pass the stream filter of the edge.
+        * A filter of any stream, format and index passes framesets whole, others pass the matching frame, alone or
+        * out of a frameset. The block delivers its frames to the graph from then on
+        * \param[in] block  - processing block of the node, not a pipelined_processing_block
+        * \param[in] parent - node feeding the block, -1 for the frames given to invoke
+        * \param[in] stream - stream type of the frames passed to the block
+        * \param[in] format - format of the frames passed to the block
+        * \param[in] index  - stream index of the frames passed to the block, -1 for any
+        * \return the node of the block
+        */
+        int add(const processing_block& block, int parent = -1, rs2_stream stream = RS2_STREAM_ANY,
+            rs2_format format = RS2_FORMAT_ANY, int index = -1)
+        {
+            rs2_error* e = nullptr;
+            auto node = rs2_processing_graph_add_node(_graph.get(), block.get(), parent, stream, format, index, &e);
+            error::handle(e);
+            return node;
+        }
+
+        /**
+        * Receive the frames of a node, on the worker that ran it
+        * \param[in] node     - node of the graph
+        * \param[in] on_frame - callback receiving the frames, or a frame_queue
+        */
+        template<class S>
+        void start(int node, S on_frame)
+        {
+            rs2_error* e = nullptr;
+            rs2_processing_graph_start(_graph.get(), node, new frame_callback<S>(on_frame), &e);
+            error::handle(e);
+        }
+
+        /**
+        * Queue a frame at the roots of the graph, returns once the graph holds few enough frames.
+        * Called from a callback of the graph, it queues the frame at once
+        * \param[in] f - frame to process
+        */
+        void invoke(frame f) const
+        {
+            rs2_frame* ptr = nullptr;
+            std::swap(f.frame_ref, ptr);
+
+            rs2_error* e = nullptr;
+            rs2_processing_graph_invoke(_graph.get(), ptr, &e);
+            error::handle(e);
+        }
+
+        /**
+        * Wait until all the frames given to invoke went through the graph. Throws when called from a callback of the graph
+        */
+        void wait() const
+        {
+            rs2_error* e = nullptr;
+            rs2_processing_graph_wait(_graph.get(), &e);
+            error::handle(e);
+        }
+
+        /**
+        * Retrieve the latency of a node, over the frames it processed so far
+        * \param[in] node - node of the graph
+        */
+        rs2_processing_node_stats get_stats(int node) const
+        {
+            rs2_error* e = nullptr;
+            rs2_processing_node_stats stats;
+            rs2_processing_graph_get_stats(_graph.get(), node, &stats, &e);
+            error::handle(e);
+            return stats;
+        }
+
+        rs2_processing_graph* get() const { return _graph.get(); }
+
+    private:
+        std::shared_ptr<rs2_processing_graph> _graph;
+    };
+
     class rates_printer : public filter
     {
     public:
@@ -96,6 +96,19 @@ namespace rs2
             error::handle(e);
         }
 
+        /**
+        * Sets the playback to a specified frame of one of the played streams
+        * \param[in] stream        Type of the stream the frame number refers to
+        * \param[in] index         Index of the stream the frame number refers to
+        * \param[in] frame_number  The frame number to seek to, playback resumes from the first frame numbered frame_number or above
+        */
+        void seek_to_frame(rs2_stream stream, int index, unsigned long long frame_number)
+        {
+            rs2_error* e = nullptr;
+            rs2_playback_seek_to_frame(_dev.get(), stream, index, frame_number, &e);
+            error::handle(e);
+        }
+
         /**
         * Indicates if playback is in real time mode or non real time
         * \return True iff playback is in real time mode
@@ -126,6 +139,29 @@ namespace rs2
             error::handle(e);
         }
 
+        /**
+        * Set how many samples are decoded ahead of the one being played
+        * \param[in] max_items  Maximal number of decoded samples kept ready, 0 disables reading ahead
+        */
+        void set_read_ahead(unsigned int max_items) const
+        {
+            rs2_error* e = nullptr;
+            rs2_playback_device_set_read_ahead(_dev.get(), max_items, &e);
+            error::handle(e);
+        }
+
+        /**
+        * Retrieves the number of samples currently decoded ahead and ready to be played
+        * \return Number of decoded samples waiting in the read-ahead window
+        */
+        unsigned int get_read_ahead_fill() const
+        {
+            rs2_error* e = nullptr;
+            auto fill = rs2_playback_device_get_read_ahead_fill(_dev.get(), &e);
+            error::handle(e);
+            return fill;
+        }
+
         /**
         * Set the playing speed
         * \param[in] speed  Indicates a multiplication of the speed to play (e.g: 1 = normal, 0.5 twice as slow)
@@ -266,6 +302,43 @@ namespace rs2
             error::handle(e);
             return filename;
         }
+
+        /**
+        * Limits the memory used by frames waiting to be written to file
+        * \param[in]  max_bytes Maximal size of queued frame data in bytes, 0 means unlimited
+        * \param[in]  policy    How to handle frames arriving while the queue is full
+        */
+        void set_queue_budget(unsigned long long max_bytes, rs2_recording_queue_policy policy)
+        {
+            rs2_error* e = nullptr;
+            rs2_record_device_set_queue_budget(_dev.get(), max_bytes, policy, &e);
+            error::handle(e);
+        }
+
+        /**
+        * Retrieves live statistics of the write queue: queued bytes, dropped frames and write throughput
+        * \return Current statistics of the write queue
+        */
+        rs2_recording_queue_stats get_queue_stats() const
+        {
+            rs2_error* e = nullptr;
+            rs2_recording_queue_stats stats;
+            rs2_record_device_get_queue_stats(_dev.get(), &stats, &e);
+            error::handle(e);
+            return stats;
+        }
+
+        /**
+        * Configures how the recorder compresses the file. Takes effect from the next chunk of data written to file
+        * \param[in]  chunk_size          Size in bytes of uncompressed data grouped into a single compressed chunk, 0 keeps the current size
+        * \param[in]  compression_threads Number of threads compressing chunks in parallel, 0 compresses on the recording thread
+        */
+        void set_compression_options(unsigned int chunk_size, unsigned int compression_threads)
+        {
+            rs2_error* e = nullptr;
+            rs2_record_device_set_compression_options(_dev.get(), chunk_size, compression_threads, &e);
+            error::handle(e);
+        }
     protected:
         explicit recorder(std::shared_ptr<rs2_device> dev) : device(dev)
         {
@@ -66,6 +66,14 @@ namespace librealsense
         }
     };
 
+    // Frame buffers recycling statistics, shared by all the archives of a single frame source
+    struct frame_pool_stats
+    {
+        std::atomic<uint64_t> hits{ 0 };      // buffers reused from the pool
+        std::atomic<uint64_t> misses{ 0 };    // buffers that had to be allocated
+        std::atomic<uint64_t> evictions{ 0 }; // pooled buffers released after aging out
+    };
+
     class archive_interface : public sensor_part
     {
     public:
@@ -86,7 +94,8 @@ namespace librealsense
     std::shared_ptr<archive_interface> make_archive(rs2_extension type,
         std::atomic<uint32_t>* in_max_frame_queue_size,
         std::shared_ptr<platform::time_service> ts,
-        std::shared_ptr<metadata_parser_map> parsers);
+        std::shared_ptr<metadata_parser_map> parsers,
+        std::shared_ptr<frame_pool_stats> pool_stats = nullptr);
 
     // Define a movable but explicitly noncopyable buffer type to hold our frame data
     class LRS_EXTENSION_API frame : public frame_interface
@@ -178,6 +187,9 @@ namespace librealsense
         std::shared_ptr<stream_profile_interface> stream;
     };
 
+    // The buffer holds get_vertex_count() vertices in the vertex format, followed by as many texture
+    // coordinates and, when requested, as many depth pixel indices. It is allocated for a full depth
+    // image with room for the index channel, so packed frames recycle the same buffers
     class points : public frame
     {
     public:
@@ -185,6 +197,18 @@ namespace librealsense
         void export_to_ply(const std::string& fname, const frame_holder& texture);
         size_t get_vertex_count() const;
         float2* get_texture_coordinates();
+        int* get_pixel_indices(); // nullptr unless the frame carries pixel indices
+        int get_frame_data_size() const override;
+
+        void set_layout(size_t count, rs2_format vertex_format, bool pixel_indices);
+        rs2_format get_vertex_format() const { return _vertex_format; }
+
+        static size_t get_vertex_size(rs2_format vertex_format);
+
+    private:
+        size_t _count = 0;
+        rs2_format _vertex_format = RS2_FORMAT_XYZ32F;
+        bool _pixel_indices = false;
     };
 
     MAP_EXTENSION(RS2_EXTENSION_POINTS, librealsense::points);
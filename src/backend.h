@@ -172,6 +172,7 @@ namespace librealsense
             const void *    pixels;
             const void *    metadata;
             rs2_time_t      backend_time;
+            bool            copy_required;  // backend is running low on capture buffers and needs this one back promptly
         };
 
         typedef std::function<void(stream_profile, frame_object, std::function<void()>)> frame_callback;
@@ -8,31 +8,291 @@
 #include <thread>
 #include <atomic>
 #include <functional>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+#include <exception>
+#include <algorithm>
 
 const int QUEUE_MAX_SIZE = 10;
+
+// Selects the storage backing a single_consumer_queue
+enum class queue_mode
+{
+    locked,     // std::deque guarded by a mutex
+    lock_free   // bounded ring, producers and consumer only synchronize through atomics
+};
+
+// Bounded lock-free ring buffer (D. Vyukov's bounded MPMC queue)
+// Every cell carries a sequence number telling whether it is ready to be written or read,
+// so producers and consumers only contend on the position counters
+template<class T>
+class lock_free_ring
+{
+    struct cell
+    {
+        std::atomic<size_t> sequence;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage; // item is constructed in place
+        T* item() { return reinterpret_cast<T*>(&storage); }
+    };
+
+    static size_t round_up_to_power_of_two(size_t n)
+    {
+        size_t res = 2;
+        while (res < n) res <<= 1;
+        return res;
+    }
+
+    std::unique_ptr<cell[]> _buffer;
+    size_t _mask;
+    char _pad0[64]; // keep producer and consumer positions on separate cache lines
+    std::atomic<size_t> _enqueue_pos;
+    char _pad1[64];
+    std::atomic<size_t> _dequeue_pos;
+    char _pad2[64];
+
+    // Claims the next readable cell, returns its position or nullptr when empty
+    cell* claim_read(size_t& pos)
+    {
+        pos = _dequeue_pos.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            auto c = &_buffer[pos & _mask];
+            auto seq = c->sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+            if (diff == 0)
+            {
+                if (_dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    return c;
+            }
+            else if (diff < 0)
+                return nullptr; // empty
+            else
+                pos = _dequeue_pos.load(std::memory_order_relaxed);
+        }
+    }
+
+    void release_read(cell* c, size_t pos)
+    {
+        c->item()->~T();
+        c->sequence.store(pos + _mask + 1, std::memory_order_release);
+    }
+
+public:
+    explicit lock_free_ring(size_t capacity)
+        : _buffer(new cell[round_up_to_power_of_two(capacity)]),
+          _mask(round_up_to_power_of_two(capacity) - 1),
+          _enqueue_pos(0), _dequeue_pos(0)
+    {
+        for (size_t i = 0; i <= _mask; ++i)
+            _buffer[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    ~lock_free_ring()
+    {
+        while (try_drop()) {}
+    }
+
+    size_t capacity() const { return _mask + 1; }
+
+    bool try_push(T&& item)
+    {
+        cell* c;
+        auto pos = _enqueue_pos.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            c = &_buffer[pos & _mask];
+            auto seq = c->sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0)
+            {
+                if (_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+                return false; // full
+            else
+                pos = _enqueue_pos.load(std::memory_order_relaxed);
+        }
+        new (&c->storage) T(std::move(item));
+        c->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool try_pop(T* item)
+    {
+        size_t pos;
+        auto c = claim_read(pos);
+        if (!c) return false;
+        *item = std::move(*c->item());
+        release_read(c, pos);
+        return true;
+    }
+
+    // Discards the oldest item
+    bool try_drop()
+    {
+        size_t pos;
+        auto c = claim_read(pos);
+        if (!c) return false;
+        release_read(c, pos);
+        return true;
+    }
+
+    // Approximate while producers or consumers are active
+    size_t size() const
+    {
+        auto enq = _enqueue_pos.load(std::memory_order_acquire);
+        auto deq = _dequeue_pos.load(std::memory_order_acquire);
+        return enq > deq ? enq - deq : 0;
+    }
+};
+
 // Simplest implementation of a blocking concurrent queue for thread messaging
+// In queue_mode::lock_free enqueue and dequeue never take a lock unless the consumer
+// has to sleep on an empty queue or a blocking producer has to sleep on a full one
 template<class T>
 class single_consumer_queue
 {
     std::deque<T> _queue;
+    std::unique_ptr<lock_free_ring<T>> _ring;
     std::mutex _mutex;
     std::condition_variable _deq_cv; // not empty signal
     std::condition_variable _enq_cv; // not empty signal
 
     unsigned int _cap;
-    bool _accepting;
+    std::atomic<bool> _accepting;
 
     // flush mechanism is required to abort wait on cv
     // when need to stop
     std::atomic<bool> _need_to_flush;
     std::atomic<bool> _was_flushed;
+
+    // lock-free mode only: sleeping threads that producers / consumer must wake up
+    std::atomic<int> _waiting_consumers;
+    std::atomic<int> _waiting_producers;
+
+    // lock-free mode only: producers between their accepting check and their push, clear() waits for them
+    std::atomic<int> _producers_in_flight;
+
+    // lock-free mode only: the item handed out by peek(), taken off the ring so that no producer drops it
+    T _peeked;
+    std::atomic<bool> _has_peeked;
+
+    // Registers a producer about to push, fails once clear() stopped the queue accepting
+    bool enter_producer()
+    {
+        ++_producers_in_flight;
+        if (_accepting) return true;
+        --_producers_in_flight;
+        return false;
+    }
+
+    // The consumer accepts items again after a clear(), under the lock so not while clear() runs
+    void reopen()
+    {
+        if (_accepting) return;
+        std::lock_guard<std::mutex> lock(_mutex);
+        _accepting = true;
+    }
+
+    bool take_peeked(T* item)
+    {
+        if (!_has_peeked) return false;
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_has_peeked) return false;
+        *item = std::move(_peeked);
+        _peeked = T();
+        _has_peeked = false;
+        return true;
+    }
+
+    size_t ring_size() const
+    {
+        return _ring->size() + (_has_peeked ? 1 : 0);
+    }
+
+    void wake(std::atomic<int>& waiting, std::condition_variable& cv)
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiting.load())
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            cv.notify_all();
+        }
+    }
+
+    // Park the calling thread until ready() holds, the timeout expires or the queue is flushed
+    template<class Pred>
+    bool sleep_until(std::atomic<int>& waiting, std::condition_variable& cv, Pred ready, std::chrono::milliseconds timeout)
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        ++waiting;
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto res = cv.wait_for(lock, timeout, ready);
+        --waiting;
+        return res;
+    }
+
+    void ring_enqueue(T&& item)
+    {
+        if (!enter_producer()) return;
+
+        // Drop the oldest items to make room, the peeked item is the consumer's and stays
+        while (!_ring->try_push(std::move(item)))
+            _ring->try_drop();
+        while (ring_size() > _cap && _ring->try_drop()) {}
+        --_producers_in_flight;
+        wake(_waiting_consumers, _deq_cv);
+    }
+
+    void ring_blocking_enqueue(T&& item)
+    {
+        auto has_room = [this]() { return ring_size() <= _cap || !_accepting; };
+        while (true)
+        {
+            // Not in flight while asleep, so that clear() does not wait for the room it is making
+            if (!enter_producer()) return;
+            auto pushed = ring_size() <= _cap && _ring->try_push(std::move(item));
+            --_producers_in_flight;
+            if (pushed) break;
+            sleep_until(_waiting_producers, _enq_cv, has_room, std::chrono::milliseconds(100));
+        }
+        wake(_waiting_consumers, _deq_cv);
+    }
+
+    bool ring_dequeue(T* item, unsigned int timeout_ms)
+    {
+        reopen();
+        _was_flushed = false;
+        if (!take_peeked(item) && !_ring->try_pop(item))
+        {
+            auto ready = [this]() { return _ring->size() > 0 || _need_to_flush; };
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+            do
+            {
+                auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+                if (left.count() <= 0 || !sleep_until(_waiting_consumers, _deq_cv, ready, left) || _need_to_flush)
+                    return _ring->try_pop(item);
+            } while (!_ring->try_pop(item));
+        }
+        wake(_waiting_producers, _enq_cv);
+        return true;
+    }
+
 public:
-    explicit single_consumer_queue<T>(unsigned int cap = QUEUE_MAX_SIZE)
-        : _queue(), _mutex(), _deq_cv(), _enq_cv(), _cap(cap), _need_to_flush(false), _was_flushed(false), _accepting(true)
+    explicit single_consumer_queue<T>(unsigned int cap = QUEUE_MAX_SIZE, queue_mode mode = queue_mode::locked)
+        : _queue(), _ring(mode == queue_mode::lock_free ? new lock_free_ring<T>(size_t(cap) + 2) : nullptr),
+          _mutex(), _deq_cv(), _enq_cv(), _cap(cap), _accepting(true), _need_to_flush(false), _was_flushed(false),
+          _waiting_consumers(0), _waiting_producers(0), _producers_in_flight(0), _peeked(), _has_peeked(false)
     {}
 
     void enqueue(T&& item)
     {
+        if (_ring) return ring_enqueue(std::move(item));
+
         std::unique_lock<std::mutex> lock(_mutex);
         if (_accepting)
         {
@@ -48,6 +308,8 @@ public:
 
     void blocking_enqueue(T&& item)
     {
+        if (_ring) return ring_blocking_enqueue(std::move(item));
+
         auto pred = [this]()->bool { return _queue.size() <= _cap; };
 
         std::unique_lock<std::mutex> lock(_mutex);
@@ -63,6 +325,8 @@ public:
 
     bool dequeue(T* item ,unsigned int timeout_ms)
     {
+        if (_ring) return ring_dequeue(item, timeout_ms);
+
         std::unique_lock<std::mutex> lock(_mutex);
         _accepting = true;
         _was_flushed = false;
@@ -84,6 +348,14 @@ public:
 
     bool try_dequeue(T* item)
     {
+        if (_ring)
+        {
+            reopen();
+            if (!take_peeked(item) && !_ring->try_pop(item)) return false;
+            wake(_waiting_producers, _enq_cv);
+            return true;
+        }
+
         std::unique_lock<std::mutex> lock(_mutex);
         _accepting = true;
         if (_queue.size() > 0)
@@ -97,8 +369,21 @@ public:
         return false;
     }
 
+    // In lock_free mode the front item moves off the ring to the consumer, and is the next one dequeued
     bool peek(T** item)
     {
+        if (_ring)
+        {
+            if (!_has_peeked)
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                if (!_ring->try_pop(&_peeked)) return false;
+                _has_peeked = true;
+            }
+            *item = &_peeked;
+            return true;
+        }
+
         std::unique_lock<std::mutex> lock(_mutex);
 
         if (_queue.size() <= 0)
@@ -111,6 +396,23 @@ public:
 
     void clear()
     {
+        if (_ring)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _accepting = false;
+            _need_to_flush = true;
+
+            // A producer that found the queue accepting completes its push before the ring is emptied
+            while (_producers_in_flight) std::this_thread::yield();
+            while (_ring->try_drop()) {}
+            _peeked = T();
+            _has_peeked = false;
+
+            _deq_cv.notify_all();
+            _enq_cv.notify_all();
+            return;
+        }
+
         std::unique_lock<std::mutex> lock(_mutex);
 
         _accepting = false;
@@ -122,6 +424,7 @@ public:
             _queue.pop_front();
         }
         _deq_cv.notify_all();
+        _enq_cv.notify_all();
     }
 
     void start()
@@ -133,6 +436,8 @@ public:
 
     size_t size()
     {
+        if (_ring) return ring_size();
+
         std::unique_lock<std::mutex> lock(_mutex);
         return _queue.size();
     }
@@ -144,7 +449,8 @@ class single_consumer_frame_queue
     single_consumer_queue<T> _queue;
 
 public:
-    single_consumer_frame_queue<T>(unsigned int cap = QUEUE_MAX_SIZE) : _queue(cap) {}
+    single_consumer_frame_queue<T>(unsigned int cap = QUEUE_MAX_SIZE, queue_mode mode = queue_mode::locked)
+        : _queue(cap, mode) {}
 
     void enqueue(T&& item)
     {
@@ -154,6 +460,12 @@ public:
             _queue.enqueue(std::move(item));
     }
 
+    // Waits for room whatever the frame, for hand-offs that must not drop frames
+    void blocking_enqueue(T&& item)
+    {
+        _queue.blocking_enqueue(std::move(item));
+    }
+
     bool dequeue(T* item, unsigned int timeout_ms)
     {
         return _queue.dequeue(item, timeout_ms);
@@ -213,8 +525,8 @@ public:
         dispatcher* _owner;
     };
 
-    dispatcher(unsigned int cap)
-        : _queue(cap),
+    dispatcher(unsigned int cap, queue_mode mode = queue_mode::locked)
+        : _queue(cap, mode),
           _was_stopped(true),
           _was_flushed(false),
           _is_alive(true)
@@ -304,6 +616,7 @@ public:
         std::condition_variable cv;
         bool invoked = false;
         auto wait_sucess = std::make_shared<std::atomic_bool>(true);
+        // Waits for room behind the queued items, a full queue would otherwise drop the oldest of those it flushes
         invoke([&, wait_sucess](cancellable_timer t)
         {
             ///TODO: use _queue to flush, and implement properly
@@ -315,7 +628,7 @@ public:
                 invoked = true;
             }
             cv.notify_one();
-        });
+        }, true);
         std::unique_lock<std::mutex> locker(m);
         *wait_sucess = cv.wait_for(locker, std::chrono::seconds(10), [&]() { return invoked || _was_stopped; });
         return *wait_sucess;
@@ -342,6 +655,136 @@ private:
     std::atomic<bool> _is_alive;
 };
 
+// Fixed set of worker threads for data-parallel loops
+// parallel_for splits an index range into contiguous bands that the workers and the calling thread
+// claim one at a time, and returns once every band is done. Calls from different threads are serialized
+class thread_pool
+{
+public:
+    // The calling thread takes part in every loop, so threads - 1 workers are started
+    explicit thread_pool(unsigned int threads)
+        : _job(nullptr), _bands(0), _next_band(0), _pending(0), _stopping(false)
+    {
+        for (unsigned int i = 1; i < threads; i++)
+            _workers.emplace_back([this]() { work(); });
+    }
+
+    ~thread_pool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stopping = true;
+        }
+        _work_cv.notify_all();
+        for (auto&& t : _workers) t.join();
+    }
+
+    unsigned int size() const { return static_cast<unsigned int>(_workers.size()) + 1; }
+
+    // Runs body(begin, end) over [0, count) in bands of at least min_band indices
+    // Extra bands beyond the thread count balance uneven work, the first exception thrown is rethrown here
+    template<class T>
+    void parallel_for(int count, T body, int min_band = 1)
+    {
+        auto max_bands = std::max(1, count / std::max(1, min_band));
+        auto bands = std::min(max_bands, static_cast<int>(size()) * 4);
+        if (bands <= 1 || _workers.empty())
+        {
+            if (count > 0) body(0, count);
+            return;
+        }
+
+        std::function<void(int)> run_band = [&](int band)
+        {
+            body(int(int64_t(count) * band / bands), int(int64_t(count) * (band + 1) / bands));
+        };
+
+        // The workers serve one loop at a time. A loop nested in a band, or started while another thread's loop
+        // runs, is run whole by its caller, which neither deadlocks nor waits for the other loop to end
+        std::unique_lock<std::mutex> call_lock(_call_mutex, std::try_to_lock);
+        if (!call_lock.owns_lock())
+        {
+            body(0, count);
+            return;
+        }
+
+        std::unique_lock<std::mutex> lock(_mutex);
+        _job = &run_band;
+        _bands = bands;
+        _next_band = 0;
+        _pending = bands;
+        _error = nullptr;
+        _work_cv.notify_all();
+
+        run_bands(lock);
+        _done_cv.wait(lock, [this]() { return _pending == 0; });
+        _job = nullptr;
+
+        if (_error)
+        {
+            auto error = _error;
+            _error = nullptr;
+            std::rethrow_exception(error);
+        }
+    }
+
+private:
+    void work()
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        while (true)
+        {
+            _work_cv.wait(lock, [this]() { return _stopping || (_job && _next_band < _bands); });
+            if (_stopping) return;
+            run_bands(lock);
+        }
+    }
+
+    // Claims and runs bands of the current loop until none is left, called with _mutex held
+    void run_bands(std::unique_lock<std::mutex>& lock)
+    {
+        while (_job && _next_band < _bands)
+        {
+            auto band = _next_band++;
+            auto job = _job;
+            lock.unlock();
+            try
+            {
+                (*job)(band);
+            }
+            catch (...)
+            {
+                lock.lock();
+                if (!_error) _error = std::current_exception();
+                lock.unlock();
+            }
+            lock.lock();
+            if (--_pending == 0) _done_cv.notify_all();
+        }
+    }
+
+    std::vector<std::thread> _workers;
+    std::mutex _call_mutex;
+    std::mutex _mutex;
+    std::condition_variable _work_cv;
+    std::condition_variable _done_cv;
+    std::function<void(int)>* _job;
+    int _bands;
+    int _next_band;
+    int _pending;
+    std::exception_ptr _error;
+    bool _stopping;
+};
+
+// Pool the processing blocks share for their data-parallel loops, started on first use with a worker per core.
+// Loops of different blocks take turns on it instead of every block keeping workers of its own
+inline thread_pool& get_processing_pool()
+{
+    // Never destroyed, joining its workers from a static destructor can hang once the runtime stopped them on exit
+    static thread_pool* pool = new thread_pool(std::max(1u, std::thread::hardware_concurrency()));
+    return *pool;
+}
+
 template<class T = std::function<void(dispatcher::cancellable_timer)>>
 class active_object
 {
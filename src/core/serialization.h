@@ -330,6 +330,7 @@ namespace librealsense
             virtual void write_snapshot(const sensor_identifier& sensor_id, const nanoseconds& timestamp, rs2_extension type, const std::shared_ptr<extension_snapshot>& snapshot) = 0;
             virtual void write_notification(const sensor_identifier& stream_id, const nanoseconds& timestamp, const notification& n) = 0;
             virtual const std::string& get_file_name() const = 0;
+            virtual void set_compression_options(uint32_t chunk_size, uint32_t compression_threads) = 0;
             virtual ~writer() = default;
         };
 
@@ -346,6 +347,9 @@ namespace librealsense
             virtual void disable_stream(const std::vector<device_serializer::stream_identifier>& stream_ids) = 0;
             virtual const std::string& get_file_name() const = 0;
             virtual std::vector<std::shared_ptr<serialized_data>> fetch_last_frames(const nanoseconds& seek_time) = 0;
+            virtual void set_read_ahead(size_t max_items) = 0;
+            virtual size_t get_read_ahead_fill() const = 0;
+            virtual nanoseconds find_frame(rs2_stream stream, uint32_t stream_index, unsigned long long frame_number) = 0;
         };
     }
 }
@@ -0,0 +1,138 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#include "cpu-dispatch.h"
+#include "types.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+
+#if defined (ANDROID) || (defined (__linux__) && !defined (__x86_64__))
+#define RS2_NO_CPUID
+#else
+#ifdef _WIN32
+#include <intrin.h>
+#include <immintrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace librealsense
+{
+    const char* get_string(simd_level value)
+    {
+        switch (value)
+        {
+        case simd_level::scalar: return "scalar";
+        case simd_level::sse2: return "sse2";
+        case simd_level::ssse3: return "ssse3";
+        case simd_level::avx2: return "avx2";
+        case simd_level::avx512: return "avx512";
+        default: return "unknown";
+        }
+    }
+
+#ifdef RS2_NO_CPUID
+    simd_level detect_simd_level() { return simd_level::scalar; }
+#else
+    static void query_cpuid(int info[4], int leaf)
+    {
+#ifdef _WIN32
+        __cpuidex(info, leaf, 0);
+#else
+        __cpuid_count(leaf, 0, info[0], info[1], info[2], info[3]);
+#endif
+    }
+
+    // Register state the OS saves on context switch, see XCR0 in the Intel SDM
+    static unsigned long long query_xcr0()
+    {
+#ifdef _WIN32
+        return _xgetbv(0);
+#else
+        unsigned int eax, edx;
+        __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+        return (static_cast<unsigned long long>(edx) << 32) | eax;
+#endif
+    }
+
+    simd_level detect_simd_level()
+    {
+        int info[4];
+        query_cpuid(info, 0);
+        auto max_leaf = info[0];
+        if (max_leaf < 1) return simd_level::scalar;
+
+        query_cpuid(info, 1);
+        auto has_sse2 = (info[3] & (1 << 26)) != 0;
+        auto has_ssse3 = (info[2] & (1 << 9)) != 0;
+        auto has_osxsave = (info[2] & (1 << 27)) != 0;
+        auto has_avx = (info[2] & (1 << 28)) != 0;
+
+        if (!has_sse2) return simd_level::scalar;
+        if (!has_ssse3) return simd_level::sse2;
+        if (!has_osxsave || !has_avx || max_leaf < 7) return simd_level::ssse3;
+
+        auto xcr0 = query_xcr0();
+        if ((xcr0 & 0x6) != 0x6) return simd_level::ssse3; // XMM and YMM state
+
+        query_cpuid(info, 7);
+        auto has_avx2 = (info[1] & (1 << 5)) != 0;
+        auto has_avx512f = (info[1] & (1 << 16)) != 0;
+        auto has_avx512bw = (info[1] & (1 << 30)) != 0;
+
+        if (!has_avx2) return simd_level::ssse3;
+        if (!has_avx512f || !has_avx512bw || (xcr0 & 0xe6) != 0xe6) return simd_level::avx2; // Opmask and ZMM state
+        return simd_level::avx512;
+    }
+#endif
+
+    static simd_level get_requested_simd_level(simd_level detected)
+    {
+        static const char* simd_var_name = "LRS_SIMD_LEVEL";
+        auto content = getenv(simd_var_name);
+        if (!content) return detected;
+
+        std::string content_str(content);
+        std::transform(content_str.begin(), content_str.end(), content_str.begin(), ::tolower);
+
+        for (int i = 0; i < static_cast<int>(simd_level::count); i++)
+        {
+            auto level = static_cast<simd_level>(i);
+            if (content_str == get_string(level))
+            {
+                if (level > detected)
+                    LOG_WARNING(simd_var_name << "=" << content << " is not supported by this CPU, using " << get_string(detected));
+                return std::min(level, detected);
+            }
+        }
+
+        LOG_WARNING("Unknown " << simd_var_name << " value \"" << content << "\", using " << get_string(detected));
+        return detected;
+    }
+
+    static std::atomic<int>& current_simd_level()
+    {
+        static std::atomic<int> level([]()
+        {
+            auto selected = get_requested_simd_level(detect_simd_level());
+            LOG_INFO("Optimized routines dispatch on " << get_string(selected));
+            return static_cast<int>(selected);
+        }());
+        return level;
+    }
+
+    simd_level get_simd_level()
+    {
+        return static_cast<simd_level>(current_simd_level().load(std::memory_order_relaxed));
+    }
+
+    simd_level set_simd_level(simd_level level)
+    {
+        auto selected = std::min(level, detect_simd_level());
+        current_simd_level().store(static_cast<int>(selected));
+        return selected;
+    }
+}
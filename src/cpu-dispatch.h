@@ -0,0 +1,35 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#ifndef LIBREALSENSE_CPU_DISPATCH_H
+#define LIBREALSENSE_CPU_DISPATCH_H
+
+namespace librealsense
+{
+    // Instruction set levels selectable at runtime, ordered from the least to the most capable
+    enum class simd_level
+    {
+        scalar,
+        sse2,
+        ssse3,
+        avx2,
+        avx512,
+        count
+    };
+
+    const char* get_string(simd_level value);
+
+    // Best level supported by both the CPU and the operating system (via cpuid / xgetbv)
+    simd_level detect_simd_level();
+
+    // Level the optimized routines dispatch on. Detected on first use and optionally lowered
+    // through the LRS_SIMD_LEVEL environment variable (scalar / sse2 / ssse3 / avx2 / avx512),
+    // which lets different code paths be benchmarked against each other on the same machine
+    simd_level get_simd_level();
+
+    // Overrides the dispatch level, clamped to what the CPU supports. Returns the level in effect
+    simd_level set_simd_level(simd_level level);
+}
+
+#endif
@@ -4,8 +4,87 @@
 
 #include "archive.h"
 
+#include <algorithm>
+#include <deque>
+#include <unordered_map>
+
 namespace librealsense
 {
+    // Recycles frame buffers released by the user.
+    // Buffers are bucketed by their exact size so both lookup and return are O(1).
+    // Within a bucket the most recently returned buffer is reused first (it is the most likely
+    // to still be cache-warm), so every bucket stays ordered by return time and ages from its front.
+    template<class T>
+    class frame_pool
+    {
+    public:
+        explicit frame_pool(std::shared_ptr<frame_pool_stats> stats)
+            : _stats(stats ? stats : std::make_shared<frame_pool_stats>()),
+            _now(0), _next_aging(0)
+        {}
+
+        bool acquire(size_t size, T& out)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            auto it = _buckets.find(size);
+            if (it != _buckets.end() && !it->second.empty())
+            {
+                out = std::move(it->second.back().second);
+                it->second.pop_back();
+                ++_stats->hits;
+                return true;
+            }
+            ++_stats->misses;
+            return false;
+        }
+
+        void release(T&& f)
+        {
+            auto size = f.data.size();
+            if (!size) return; // Nothing to recycle
+
+            // Stamped with the time of the latest allocation, frames of other streams and frames held by the user
+            // come back out of timestamp order
+            std::lock_guard<std::mutex> lock(_mutex);
+            _buckets[size].emplace_back(_now, std::move(f));
+        }
+
+        // Discard buffers returned more than max_age milliseconds before the given timestamp.
+        // The pool ages at most once every max_age / 4, so that most allocations only note the time
+        void evict(rs2_time_t timestamp, rs2_time_t max_age)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _now = timestamp;
+            // A timestamp far behind the schedule is a clock that went back, which ages at once
+            if (timestamp < _next_aging && timestamp + max_age >= _next_aging)
+                return;
+            _next_aging = timestamp + max_age / 4;
+
+            for (auto&& bucket : _buckets)
+            {
+                auto& buffers = bucket.second;
+                while (!buffers.empty() && timestamp > buffers.front().first + max_age)
+                {
+                    buffers.pop_front();
+                    ++_stats->evictions;
+                }
+            }
+        }
+
+        void clear()
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _buckets.clear();
+        }
+
+    private:
+        std::mutex _mutex;
+        std::unordered_map<size_t, std::deque<std::pair<rs2_time_t, T>>> _buckets;
+        std::shared_ptr<frame_pool_stats> _stats;
+        rs2_time_t _now;            // Timestamp of the latest allocation
+        rs2_time_t _next_aging;
+    };
+
     // Defines general frames storage model
     template<class T>
     class frame_archive : public std::enable_shared_from_this<frame_archive<T>>, public archive_interface
@@ -16,7 +95,7 @@ namespace librealsense
         std::shared_ptr<metadata_parser_map> _metadata_parsers = nullptr;
         callbacks_heap callback_inflight;
 
-        std::vector<T> freelist; // return frames here
+        frame_pool<T> freelist; // return frames here
         std::atomic<bool> recycle_frames;
         int pending_frames = 0;
         std::recursive_mutex mutex;
@@ -30,30 +109,13 @@ namespace librealsense
         {
             T backbuffer;
             //const size_t size = modes[stream].get_image_size(stream);
-            {
-                std::lock_guard<std::recursive_mutex> guard(mutex);
 
-                if (requires_memory)
-                {
-                    // Attempt to obtain a buffer of the appropriate size from the freelist
-                    for (auto it = begin(freelist); it != end(freelist); ++it)
-                    {
-                        if (it->data.size() == size)
-                        {
-                            backbuffer = std::move(*it);
-                            freelist.erase(it);
-                            break;
-                        }
-                    }
-                }
+            // Attempt to obtain a buffer of the appropriate size from the freelist
+            if (requires_memory)
+                freelist.acquire(size, backbuffer);
 
-                // Discard buffers that have been in the freelist for longer than 1s
-                for (auto it = begin(freelist); it != end(freelist);)
-                {
-                    if (additional_data.timestamp > it->additional_data.timestamp + 1000) it = freelist.erase(it);
-                    else ++it;
-                }
-            }
+            // Discard buffers that have been in the freelist for longer than 1s
+            freelist.evict(additional_data.timestamp, 1000);
 
             if (requires_memory)
             {
@@ -87,12 +149,12 @@ namespace librealsense
                 std::unique_lock<std::recursive_mutex> lock(mutex);
 
                 frame->keep();
+                lock.unlock();
 
                 if (recycle_frames)
                 {
-                    freelist.push_back(std::move(*f));
+                    freelist.release(std::move(*f));
                 }
-                lock.unlock();
 
                 if (f->is_fixed())
                     published_frames.deallocate(f);
@@ -163,9 +225,10 @@ namespace librealsense
     public:
         explicit frame_archive(std::atomic<uint32_t>* in_max_frame_queue_size,
             std::shared_ptr<platform::time_service> ts,
-            std::shared_ptr<metadata_parser_map> parsers)
+            std::shared_ptr<metadata_parser_map> parsers,
+            std::shared_ptr<frame_pool_stats> pool_stats = nullptr)
             : max_frame_queue_size(in_max_frame_queue_size),
-            mutex(), recycle_frames(true), _time_service(ts),
+            freelist(pool_stats), mutex(), recycle_frames(true), _time_service(ts),
             _metadata_parsers(parsers)
         {
             published_frames_count = 0;
@@ -201,10 +264,7 @@ namespace librealsense
             // wait until user is done with all the stuff he chose to borrow
             callback_inflight.wait_until_empty();
 
-            {
-                std::lock_guard<std::recursive_mutex> guard(mutex);
-                freelist.clear();
-            }
+            freelist.clear();
 
             pending_frames = published_frames.get_size();
             if (pending_frames > 0)
@@ -168,6 +168,12 @@ namespace librealsense
                 0, 1, 0, 1, &_enabled, "GLSL enabled"); 
             register_option(RS2_OPTION_COUNT, opt);
 
+            // The shader renders RGB8 only
+            auto format_opt = std::make_shared<librealsense::ptr_option<int>>(
+                0, 0, 1, 0, &_format_index, "Format of the colorized frames");
+            format_opt->set_description(0.f, "RGB8");
+            register_option(RS2_OPTION_COLORIZER_FORMAT, format_opt);
+
             initialize();
         }
 
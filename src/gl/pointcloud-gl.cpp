@@ -218,6 +218,11 @@ pointcloud_gl::pointcloud_gl()
         0, 1, 0, 1, &_enabled, "GLSL enabled"); 
     register_option(RS2_OPTION_COUNT, opt);
 
+    // Packing on the CPU would be overwritten by the next fetch from the GPU
+    unregister_option(RS2_OPTION_POINTS_COMPACT);
+    unregister_option(RS2_OPTION_POINTS_PIXEL_INDICES);
+    unregister_option(RS2_OPTION_POINTS_ENCODING);
+
     initialize();
 }
 
@@ -42,11 +42,10 @@
                 if (FORMAT == RS2_FORMAT_Y8)
                 {
                     // Align all Y components and output 32 pixels (32 bytes) at once
-                    __m256i y0 = _mm256_shuffle_epi8(s0, _mm256_setr_epi8(1, 3, 5, 7, 9, 11, 13, 15, 0, 2, 4, 6, 8, 10, 12, 14,
-                        1, 3, 5, 7, 9, 11, 13, 15, 0, 2, 4, 6, 8, 10, 12, 14));
-                    __m256i y1 = _mm256_shuffle_epi8(s1, _mm256_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15,
-                        0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15));
-                    _mm256_storeu_si256(&dst[i], _mm256_alignr_epi8(y0, y1, 8));
+                    __m256i y0 = _mm256_shuffle_epi8(s0, evens_odds);
+                    __m256i y1 = _mm256_shuffle_epi8(s1, evens_odds);
+                    // Unpacking works per 128-bit lane, restore the pixel order across lanes
+                    _mm256_storeu_si256(&dst[i], _mm256_permute4x64_epi64(_mm256_unpacklo_epi64(y0, y1), _MM_SHUFFLE(3, 1, 2, 0)));
                     continue;
                 }
 
@@ -218,11 +217,11 @@
                         // Shuffle rgb triples to the start and end of each register
                         __m128i bgr0 = _mm_shuffle_epi8(rgba0, _mm_setr_epi8(3, 7, 11, 15, 0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14));
                         __m128i bgr1 = _mm_shuffle_epi8(rgba1, _mm_setr_epi8(0, 1, 2, 4, 3, 7, 11, 15, 5, 6, 8, 9, 10, 12, 13, 14));
-                        __m128i bgr2 = _mm_shuffle_epi8(rgba2, _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 3, 7, 11, 15, 10, 12, 13, 1));
+                        __m128i bgr2 = _mm_shuffle_epi8(rgba2, _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 3, 7, 11, 15, 10, 12, 13, 14));
                         __m128i bgr3 = _mm_shuffle_epi8(rgba3, _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, 3, 7, 11, 15));
                         __m128i bgr4 = _mm_shuffle_epi8(rgba4, _mm_setr_epi8(3, 7, 11, 15, 0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14));
                         __m128i bgr5 = _mm_shuffle_epi8(rgba5, _mm_setr_epi8(0, 1, 2, 4, 3, 7, 11, 15, 5, 6, 8, 9, 10, 12, 13, 14));
-                        __m128i bgr6 = _mm_shuffle_epi8(rgba6, _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 3, 7, 11, 15, 10, 12, 13, 1));
+                        __m128i bgr6 = _mm_shuffle_epi8(rgba6, _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 3, 7, 11, 15, 10, 12, 13, 14));
                         __m128i bgr7 = _mm_shuffle_epi8(rgba7, _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, 3, 7, 11, 15));
 
                         __m128i a1 = _mm_alignr_epi8(bgr1, bgr0, 4);
@@ -274,6 +273,82 @@
         {
             unpack_yuy2<RS2_FORMAT_BGRA8>(d, s, n);
         }
+
+        static inline __m256i load_two_halves(const uint8_t * lo, const uint8_t * hi)
+        {
+            return _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(lo))),
+                _mm_loadu_si128(reinterpret_cast<const __m128i *>(hi)), 1);
+        }
+
+        int unpack_y10bpack_avx(uint16_t * to, const uint8_t * from, int count)
+        {
+            // See unpack_y10bpack_ssse3, each 128-bit lane converts 2 macro-pixels
+            const __m256i spread = _mm256_setr_epi8(4, 0, 4, 1, 4, 2, 4, 3, 9, 5, 9, 6, 9, 7, 9, 8,
+                4, 0, 4, 1, 4, 2, 4, 3, 9, 5, 9, 6, 9, 7, 9, 8);
+            const __m256i lsb_shift = _mm256_setr_epi16(64, 16, 4, 1, 64, 16, 4, 1, 64, 16, 4, 1, 64, 16, 4, 1);
+            const __m256i low_byte = _mm256_set1_epi16(0x00ff);
+            const __m256i lsb_bits = _mm256_set1_epi16(0x00c0);
+            const __m256i high_byte = _mm256_set1_epi16((short)0xff00);
+
+            int i = 0;
+            for (; i + 24 <= count; i += 16, from += 20, to += 16) // The upper load reads 16 bytes from offset 10
+            {
+                __m256i v = _mm256_shuffle_epi8(load_two_halves(from, from + 10), spread);
+                __m256i lsb = _mm256_and_si256(_mm256_mullo_epi16(_mm256_and_si256(v, low_byte), lsb_shift), lsb_bits);
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(to), _mm256_or_si256(_mm256_and_si256(v, high_byte), lsb));
+            }
+            return i;
+        }
+
+        int unpack_y8_from_rw10_avx(uint8_t * dst, const uint8_t * src, int count)
+        {
+            // Each lane gathers the MSB bytes of 3 macro-pixels, then the two 12-byte results are made contiguous
+            const __m256i mask = _mm256_setr_epi8(0x0, 0x1, 0x2, 0x3, 0x5, 0x6, 0x7, 0x8, 0xa, 0xb, 0xc, 0xd, -1, -1, -1, -1,
+                0x0, 0x1, 0x2, 0x3, 0x5, 0x6, 0x7, 0x8, 0xa, 0xb, 0xc, 0xd, -1, -1, -1, -1);
+            const __m256i compact = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7);
+
+            int i = 0;
+            for (; i + 28 <= count; i += 24, src += 30, dst += 24) // The upper load reads 16 bytes from offset 15
+            {
+                __m256i v = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(load_two_halves(src, src + 15), mask), compact);
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm256_castsi256_si128(v));
+                _mm_storel_epi64(reinterpret_cast<__m128i *>(dst + 16), _mm256_extracti128_si256(v, 1));
+            }
+            return i;
+        }
+
+        int unpack_y8_from_y16_10_avx(uint8_t * dst, const uint16_t * src, int count)
+        {
+            const __m256i low_byte = _mm256_set1_epi16(0x00ff);
+            int i = 0;
+            for (; i + 32 <= count; i += 32, src += 32, dst += 32)
+            {
+                __m256i lo = _mm256_and_si256(_mm256_srli_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(src)), 2), low_byte);
+                __m256i hi = _mm256_and_si256(_mm256_srli_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + 16)), 2), low_byte);
+                // Packing interleaves the 128-bit lanes, restore the pixel order
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst), _mm256_permute4x64_epi64(_mm256_packus_epi16(lo, hi), _MM_SHUFFLE(3, 1, 2, 0)));
+            }
+            return i;
+        }
+
+        int unpack_y16_from_y16_10_avx(uint16_t * dst, const uint16_t * src, int count)
+        {
+            int i = 0;
+            for (; i + 16 <= count; i += 16, src += 16, dst += 16)
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst), _mm256_slli_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(src)), 6));
+            return i;
+        }
+
+        int unpack_y16_from_y8_avx(uint16_t * dst, const uint8_t * src, int count)
+        {
+            int i = 0;
+            for (; i + 16 <= count; i += 16, src += 16, dst += 16)
+            {
+                __m256i v = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src)));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst), _mm256_or_si256(v, _mm256_slli_epi16(v, 8)));
+            }
+            return i;
+        }
     }
 
     #pragma pack(pop)
@@ -10,13 +10,25 @@
 namespace librealsense
 {
 #ifndef ANDROID
-    #if defined(__SSSE3__) && defined(__AVX2__)
+    #if defined(__SSSE3__) && defined(__AVX2__) && !defined(RS2_HAVE_AVX2_UNPACKERS)
+    #define RS2_HAVE_AVX2_UNPACKERS
+    #endif
+
+    // Only call these after get_simd_level() reported AVX2 support
+    #ifdef RS2_HAVE_AVX2_UNPACKERS
     void unpack_yuy2_avx_y8(byte * const d[], const byte * s, int n);
     void unpack_yuy2_avx_y16(byte * const d[], const byte * s, int n);
     void unpack_yuy2_avx_rgb8(byte * const d[], const byte * s, int n);
     void unpack_yuy2_avx_rgba8(byte * const d[], const byte * s, int n);
     void unpack_yuy2_avx_bgr8(byte * const d[], const byte * s, int n);
     void unpack_yuy2_avx_bgra8(byte * const d[], const byte * s, int n);
+
+    // 10-bit and IR kernels, each returns the number of leading pixels it converted
+    int unpack_y10bpack_avx(uint16_t * to, const uint8_t * from, int count);
+    int unpack_y8_from_rw10_avx(uint8_t * dst, const uint8_t * src, int count);
+    int unpack_y8_from_y16_10_avx(uint8_t * dst, const uint16_t * src, int count);
+    int unpack_y16_from_y16_10_avx(uint16_t * dst, const uint16_t * src, int count);
+    int unpack_y16_from_y8_avx(uint16_t * dst, const uint8_t * src, int count);
     #endif
 #endif
 }
@@ -3,6 +3,7 @@
 
 #include "image.h"
 #include "image-avx.h"
+#include "cpu-dispatch.h"
 #include "types.h"
 
 #define STB_IMAGE_STATIC
@@ -16,32 +17,6 @@
 #include <tmmintrin.h> // For SSSE3 intrinsics
 #endif
 
-#if defined (ANDROID) || (defined (__linux__) && !defined (__x86_64__))
-
-bool has_avx() { return false; }
-
-#else
-
-#ifdef _WIN32
-#include <intrin.h>
-#define cpuid(info, x)    __cpuidex(info, x, 0)
-#else
-#include <cpuid.h>
-void cpuid(int info[4], int info_type){
-    __cpuid_count(info_type, 0, info[0], info[1], info[2], info[3]);
-}
-#endif
-
-bool has_avx()
-{
-    int info[4];
-    cpuid(info, 0);
-    cpuid(info, 0x80000000);
-    return (info[2] & ((int)1 << 28)) != 0;
-}
-
-#endif
-
 #pragma pack(push, 1) // All structs in this file are assumed to be byte-packed
 namespace librealsense
 {
@@ -65,6 +40,8 @@ namespace librealsense
         case RS2_FORMAT_DISPARITY16: return 16;
         case RS2_FORMAT_DISPARITY32: return 32;
         case RS2_FORMAT_XYZ32F: return 12 * 8;
+        case RS2_FORMAT_XYZ16: return 6 * 8;
+        case RS2_FORMAT_XYZ16F: return 6 * 8;
         case RS2_FORMAT_YUYV:  return 16;
         case RS2_FORMAT_RGB8: return 24;
         case RS2_FORMAT_BGR8: return 24;
@@ -225,121 +202,220 @@ namespace librealsense
         librealsense::copy(dest[0], source, size_t(5.0 * (count / 4.0)));
     }
 
+    //////////////////////////////////////
+    // 10-bit and IR unpacking routines //
+    //////////////////////////////////////
+    // Each format has a scalar loop that is always compiled and starts where the vectorized kernels stop.
+    // The kernels return the number of pixels they handled and never read or write past the image, so the
+    // scalar tail also covers resolutions that are not a multiple of the vector width.
+
+#ifdef __SSSE3__
+    // Y10BPACK: 4 pixels in 5 bytes, the first four hold the 8 MSB and the last one the 2 LSB of each pixel
+    static int unpack_y10bpack_ssse3(uint16_t * to, const uint8_t * from, int count)
+    {
+        // Place each MSB in the high byte and the shared LSB byte in the low byte of a 16-bit lane
+        const __m128i spread = _mm_setr_epi8(4, 0, 4, 1, 4, 2, 4, 3, 9, 5, 9, 6, 9, 7, 9, 8);
+        // Move the 2 LSB of lane k (bits 2k and 2k+1 of the low byte) to bits 6 and 7
+        const __m128i lsb_shift = _mm_setr_epi16(64, 16, 4, 1, 64, 16, 4, 1);
+        const __m128i low_byte = _mm_set1_epi16(0x00ff);
+        const __m128i lsb_bits = _mm_set1_epi16(0x00c0);
+        const __m128i high_byte = _mm_set1_epi16((short)0xff00);
+
+        int i = 0;
+        for (; i + 16 <= count; i += 8, from += 10, to += 8) // 8 pixels per iteration, the 16-byte load must stay inside the image
+        {
+            __m128i v = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(from)), spread);
+            __m128i lsb = _mm_and_si128(_mm_mullo_epi16(_mm_and_si128(v, low_byte), lsb_shift), lsb_bits);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(to), _mm_or_si128(_mm_and_si128(v, high_byte), lsb));
+        }
+        return i;
+    }
+
+    // RAW10: same packing as Y10BPACK, only the 8 MSB of each pixel are kept
+    static int unpack_y8_from_rw10_ssse3(uint8_t * dst, const uint8_t * src, int count)
+    {
+        // The mask will reorder the input so the 12 bytes with pixels' MSB values will come first
+        const __m128i mask = _mm_setr_epi8(0x0, 0x1, 0x2, 0x3, 0x5, 0x6, 0x7, 0x8, 0xa, 0xb, 0xc, 0xd, -1, -1, -1, -1);
+
+        int i = 0;
+        for (; (i + 48) < count; i += 48, src += 60, dst += 48) // We process 12 macro-pixels simultaneously to achieve performance boost
+        {
+            __m128i res[4];
+            res[0] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src)), mask);
+            res[1] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 15)), mask);
+            res[2] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 30)), mask);
+            res[3] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 45)), mask);
+
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), res[0]);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 12), res[1]);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 24), res[2]);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 36), res[3]);
+        }
+        return i;
+    }
+
+    static int unpack_y8_from_y16_10_sse2(uint8_t * dst, const uint16_t * src, int count)
+    {
+        const __m128i low_byte = _mm_set1_epi16(0x00ff);
+        int i = 0;
+        for (; i + 16 <= count; i += 16, src += 16, dst += 16)
+        {
+            // Mask before packing so values above 10 bit wrap exactly like the scalar cast instead of saturating
+            __m128i lo = _mm_and_si128(_mm_srli_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src)), 2), low_byte);
+            __m128i hi = _mm_and_si128(_mm_srli_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 8)), 2), low_byte);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_packus_epi16(lo, hi));
+        }
+        return i;
+    }
+
+    static int unpack_y16_from_y16_10_sse2(uint16_t * dst, const uint16_t * src, int count)
+    {
+        int i = 0;
+        for (; i + 8 <= count; i += 8, src += 8, dst += 8)
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_slli_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src)), 6));
+        return i;
+    }
+
+    static int unpack_y16_from_y8_sse2(uint16_t * dst, const uint8_t * src, int count)
+    {
+        int i = 0;
+        for (; i + 16 <= count; i += 16, src += 16, dst += 16)
+        {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_unpacklo_epi8(v, v));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 8), _mm_unpackhi_epi8(v, v));
+        }
+        return i;
+    }
+#endif
+
     void unpack_y10bpack(byte * const dest[], const byte * source, int width, int height, int actual_size)
     {
-         auto count = width * height / 4; // num of pixels
-         uint8_t  * from = (uint8_t*)(source);
-         uint16_t * to = (uint16_t*)(dest[0]);
+        auto count = width * height; // num of pixels
+        auto from = reinterpret_cast<const uint8_t *>(source);
+        auto to = reinterpret_cast<uint16_t *>(dest[0]);
+        int done = 0;
+
+        auto level = get_simd_level();
+#ifdef RS2_HAVE_AVX2_UNPACKERS
+        if (level >= simd_level::avx2)
+            done = unpack_y10bpack_avx(to, from, count);
+#endif
+#ifdef __SSSE3__
+        if (level >= simd_level::ssse3)
+            done += unpack_y10bpack_ssse3(to + done, from + done / 4 * 5, count - done);
+#endif
+        from += done / 4 * 5;
+        to += done;
 
         // Put the 10 bit into the msb of uint16_t
-         for (int i = 0; i < count; i++, from +=5) // traverse macro-pixels
-         {
+        for (int i = done; i < count; i += 4, from += 5) // traverse macro-pixels
+        {
             *to++ = ((from[0] << 2) | ( from[4] & 3)) << 6;
             *to++ = ((from[1] << 2) | ((from[4] >> 2) & 3)) << 6;
             *to++ = ((from[2] << 2) | ((from[4] >> 4) & 3)) << 6;
             *to++ = ((from[3] << 2) | ((from[4] >> 6) & 3)) << 6;
-         }
+        }
     }
 
-    template<class SOURCE, class UNPACK> void unpack_pixels(byte * const dest[], int count, const SOURCE * source, UNPACK unpack, int actual_size)
+    template<class SOURCE, class UNPACK> void unpack_pixels(byte * const dest[], int count, const SOURCE * source, UNPACK unpack, int actual_size, int done = 0)
     {
-        auto out = reinterpret_cast<decltype(unpack(SOURCE())) *>(dest[0]);
-        for (int i = 0; i < count; ++i) *out++ = unpack(*source++);
+        auto out = reinterpret_cast<decltype(unpack(SOURCE())) *>(dest[0]) + done;
+        source += done;
+        for (int i = done; i < count; ++i) *out++ = unpack(*source++);
     }
 
-    void unpack_y16_from_y8(byte * const d[], const byte * s, int width, int height, int actual_size) { unpack_pixels(d, width * height, reinterpret_cast<const uint8_t *>(s), [](uint8_t  pixel) -> uint16_t { return pixel | pixel << 8; }, actual_size); }
-    void unpack_y16_from_y16_10(byte * const d[], const byte * s, int width, int height, int actual_size) { unpack_pixels(d, width * height, reinterpret_cast<const uint16_t*>(s), [](uint16_t pixel) -> uint16_t { return pixel << 6; }, actual_size); }
-    void unpack_y8_from_y16_10(byte * const d[], const byte * s, int width, int height, int actual_size) { unpack_pixels(d, width * height, reinterpret_cast<const uint16_t*>(s), [](uint16_t pixel) -> uint8_t  { return pixel >> 2; }, actual_size); }
-    void unpack_rw10_from_rw8(byte *  const d[], const byte * s, int width, int height, int actual_size)
+    void unpack_y16_from_y8(byte * const d[], const byte * s, int width, int height, int actual_size)
     {
-#ifdef __SSSE3__
-        auto src = reinterpret_cast<const __m128i *>(s);
-        auto dst = reinterpret_cast<__m128i *>(d[0]);
-
-        __m128i * xin = (__m128i *)src;
-        __m128i * xout = (__m128i *) dst;
-        for (int i = 0; i < width * height; i += 16, ++xout, xin += 2)
-        {
-            __m128i  in1_16 = _mm_load_si128((__m128i *)(xin));
-            __m128i  in2_16 = _mm_load_si128((__m128i *)(xin + 1));
-            __m128i  out1_16 = _mm_srli_epi16(in1_16, 2);
-            __m128i  out2_16 = _mm_srli_epi16(in2_16, 2);
-            __m128i  out8 = _mm_packus_epi16(out1_16, out2_16);
-            _mm_store_si128(xout, out8);
-        }
-#else  // Generic code for when SSSE3 is not available.
-        unsigned short* from = (unsigned short*)s;
-        byte * to = d[0];
+        auto count = width * height;
+        auto src = reinterpret_cast<const uint8_t *>(s);
+        auto dst = reinterpret_cast<uint16_t *>(d[0]);
+        int done = 0;
 
-        for(int i = 0; i < width * height; ++i)
-        {
-            byte temp = (byte)(*from >> 2);
-            *to = temp;
-            ++from;
-            ++to;
-        }
+        auto level = get_simd_level();
+#ifdef RS2_HAVE_AVX2_UNPACKERS
+        if (level >= simd_level::avx2)
+            done = unpack_y16_from_y8_avx(dst, src, count);
+#endif
+#ifdef __SSSE3__
+        if (level >= simd_level::sse2)
+            done += unpack_y16_from_y8_sse2(dst + done, src + done, count - done);
 #endif
+        unpack_pixels(d, count, src, [](uint8_t  pixel) -> uint16_t { return pixel | pixel << 8; }, actual_size, done);
     }
 
-    // Unpack luminocity 8 bit from 10-bit packed macro-pixels (4 pixels in 5 bytes):
-    // The first four bytes store the 8 MSB of each pixel, and the last byte holds the 2 LSB for each pixel :8888[2222]
-    void unpack_y8_from_rw10(byte *  const d[], const byte * s, int width, int height, int actual_size)
+    void unpack_y16_from_y16_10(byte * const d[], const byte * s, int width, int height, int actual_size)
     {
+        auto count = width * height;
+        auto src = reinterpret_cast<const uint16_t *>(s);
+        auto dst = reinterpret_cast<uint16_t *>(d[0]);
+        int done = 0;
+
+        auto level = get_simd_level();
+#ifdef RS2_HAVE_AVX2_UNPACKERS
+        if (level >= simd_level::avx2)
+            done = unpack_y16_from_y16_10_avx(dst, src, count);
+#endif
 #ifdef __SSSE3__
-        auto n = width * height;
-        assert(!(n % 48));  //We process 12 macro-pixels simultaneously to achieve performance boost
-        auto src = reinterpret_cast<const uint8_t *>(s);
-        auto dst = reinterpret_cast<uint8_t *>(d[0]);
-
-        const __m128i * blk_0_in = reinterpret_cast<const __m128i *>(src);
-        const __m128i * blk_1_in = reinterpret_cast<const __m128i *>(src + 15);
-        const __m128i * blk_2_in = reinterpret_cast<const __m128i *>(src + 30);
-        const __m128i * blk_3_in = reinterpret_cast<const __m128i *>(src + 45);
+        if (level >= simd_level::sse2)
+            done += unpack_y16_from_y16_10_sse2(dst + done, src + done, count - done);
+#endif
+        unpack_pixels(d, count, src, [](uint16_t pixel) -> uint16_t { return pixel << 6; }, actual_size, done);
+    }
 
-        auto blk_0_out = reinterpret_cast<__m128i *>(dst);
-        auto blk_1_out = reinterpret_cast<__m128i *>(dst + 12);
-        auto blk_2_out = reinterpret_cast<__m128i *>(dst + 24);
-        auto blk_3_out = reinterpret_cast<__m128i *>(dst + 36);
+    void unpack_y8_from_y16_10(byte * const d[], const byte * s, int width, int height, int actual_size)
+    {
+        auto count = width * height;
+        auto src = reinterpret_cast<const uint16_t *>(s);
+        auto dst = reinterpret_cast<uint8_t *>(d[0]);
+        int done = 0;
 
-        __m128i res[4];
-        // The mask will reorder the input so the 12 bytes with pixels' MSB values will come first
-        static const __m128i mask = _mm_setr_epi8(0x0, 0x1, 0x2, 0x3, 0x5, 0x6, 0x7, 0x8, 0xa, 0xb, 0xc, 0xd, -1, -1, -1, -1);
+        auto level = get_simd_level();
+#ifdef RS2_HAVE_AVX2_UNPACKERS
+        if (level >= simd_level::avx2)
+            done = unpack_y8_from_y16_10_avx(dst, src, count);
+#endif
+#ifdef __SSSE3__
+        if (level >= simd_level::sse2)
+            done += unpack_y8_from_y16_10_sse2(dst + done, src + done, count - done);
+#endif
+        unpack_pixels(d, count, src, [](uint16_t pixel) -> uint8_t  { return pixel >> 2; }, actual_size, done);
+    }
 
+    // Keeps the 8 MSB of 10-bit pixels stored in 16-bit words, the same conversion as unpack_y8_from_y16_10
+    void unpack_rw10_from_rw8(byte *  const d[], const byte * s, int width, int height, int actual_size)
+    {
+        unpack_y8_from_y16_10(d, s, width, height, actual_size);
+    }
 
-        for (int i = 0; (i + 48) < n; i += 48, src += 60, dst += 48)
-        {
-            blk_0_in = reinterpret_cast<const __m128i *>(src);
-            blk_1_in = reinterpret_cast<const __m128i *>(src + 15);
-            blk_2_in = reinterpret_cast<const __m128i *>(src + 30);
-            blk_3_in = reinterpret_cast<const __m128i *>(src + 45);
-
-            blk_0_out = reinterpret_cast<__m128i *>(dst);
-            blk_1_out = reinterpret_cast<__m128i *>(dst + 12);
-            blk_2_out = reinterpret_cast<__m128i *>(dst + 24);
-            blk_3_out = reinterpret_cast<__m128i *>(dst + 36);
-
-            res[0] = _mm_shuffle_epi8(_mm_loadu_si128(blk_0_in), mask);
-            res[1] = _mm_shuffle_epi8(_mm_loadu_si128(blk_1_in), mask);
-            res[2] = _mm_shuffle_epi8(_mm_loadu_si128(blk_2_in), mask);
-            res[3] = _mm_shuffle_epi8(_mm_loadu_si128(blk_3_in), mask);
-
-            _mm_storeu_si128(blk_0_out, res[0]);
-            _mm_storeu_si128(blk_1_out, res[1]);
-            _mm_storeu_si128(blk_2_out, res[2]);
-            _mm_storeu_si128(blk_3_out, res[3]);
-        }
-#else  // Generic code for when SSSE3 is not available.
+    // Unpack luminocity 8 bit from 10-bit packed macro-pixels (4 pixels in 5 bytes):
+    // The first four bytes store the 8 MSB of each pixel, and the last byte holds the 2 LSB for each pixel :8888[2222]
+    void unpack_y8_from_rw10(byte *  const d[], const byte * s, int width, int height, int actual_size)
+    {
+        auto count = width * height;
         auto from = reinterpret_cast<const uint8_t *>(s);
         uint8_t * tgt = d[0];
+        int done = 0;
 
-        for (int i = 0; i < width * height; i += 4, from += 5)
+        auto level = get_simd_level();
+#ifdef RS2_HAVE_AVX2_UNPACKERS
+        if (level >= simd_level::avx2)
+            done = unpack_y8_from_rw10_avx(tgt, from, count);
+#endif
+#ifdef __SSSE3__
+        if (level >= simd_level::ssse3)
+            done += unpack_y8_from_rw10_ssse3(tgt + done, from + done / 4 * 5, count - done);
+#endif
+        from += done / 4 * 5;
+        tgt += done;
+
+        for (int i = done; i < count; i += 4, from += 5)
         {
             *tgt++ = from[0];
             *tgt++ = from[1];
             *tgt++ = from[2];
             *tgt++ = from[3];
         }
-#endif
     }
 
     /////////////////////////////
@@ -356,20 +432,20 @@ namespace librealsense
         return;
 #endif
 #if defined __SSSE3__ && ! defined ANDROID
-        static bool do_avx = has_avx();
-        #ifdef __AVX2__
-
-                if (do_avx)
-                {
-                    if (FORMAT == RS2_FORMAT_Y8) unpack_yuy2_avx_y8(d, s, n);
-                    if (FORMAT == RS2_FORMAT_Y16) unpack_yuy2_avx_y16(d, s, n);
-                    if (FORMAT == RS2_FORMAT_RGB8) unpack_yuy2_avx_rgb8(d, s, n);
-                    if (FORMAT == RS2_FORMAT_RGBA8) unpack_yuy2_avx_rgba8(d, s, n);
-                    if (FORMAT == RS2_FORMAT_BGR8) unpack_yuy2_avx_bgr8(d, s, n);
-                    if (FORMAT == RS2_FORMAT_BGRA8) unpack_yuy2_avx_bgra8(d, s, n);
-                }
-                else
+        auto level = get_simd_level();
+        #ifdef RS2_HAVE_AVX2_UNPACKERS
+        if (level >= simd_level::avx2)
+        {
+            if (FORMAT == RS2_FORMAT_Y8) unpack_yuy2_avx_y8(d, s, n);
+            if (FORMAT == RS2_FORMAT_Y16) unpack_yuy2_avx_y16(d, s, n);
+            if (FORMAT == RS2_FORMAT_RGB8) unpack_yuy2_avx_rgb8(d, s, n);
+            if (FORMAT == RS2_FORMAT_RGBA8) unpack_yuy2_avx_rgba8(d, s, n);
+            if (FORMAT == RS2_FORMAT_BGR8) unpack_yuy2_avx_bgr8(d, s, n);
+            if (FORMAT == RS2_FORMAT_BGRA8) unpack_yuy2_avx_bgra8(d, s, n);
+            return;
+        }
         #endif
+        if (level >= simd_level::ssse3)
         {
             auto src = reinterpret_cast<const __m128i *>(s);
             auto dst = reinterpret_cast<__m128i *>(d[0]);
@@ -392,9 +468,9 @@ namespace librealsense
                 if (FORMAT == RS2_FORMAT_Y8)
                 {
                     // Align all Y components and output 16 pixels (16 bytes) at once
-                    __m128i y0 = _mm_shuffle_epi8(s0, _mm_setr_epi8(1, 3, 5, 7, 9, 11, 13, 15, 0, 2, 4, 6, 8, 10, 12, 14));
-                    __m128i y1 = _mm_shuffle_epi8(s1, _mm_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15));
-                    _mm_storeu_si128(&dst[i], _mm_alignr_epi8(y0, y1, 8));
+                    __m128i y0 = _mm_shuffle_epi8(s0, evens_odds);
+                    __m128i y1 = _mm_shuffle_epi8(s1, evens_odds);
+                    _mm_storeu_si128(&dst[i], _mm_unpacklo_epi64(y0, y1));
                     continue;
                 }
 
@@ -514,8 +590,10 @@ namespace librealsense
                     }
                 }
             }
+            return;
         }
-#else  // Generic code for when SSSE3 is not available.
+#endif
+        // Generic code for when SSSE3 is not available or disabled
         auto src = reinterpret_cast<const uint8_t *>(s);
         auto dst = reinterpret_cast<uint8_t *>(d[0]);
         for (; n; n -= 16, src += 32)
@@ -647,7 +725,6 @@ namespace librealsense
                 continue;
             }
         }
-    #endif
     }
 
     void unpack_yuy2_y8(byte * const d[], const byte * s, int w, int h, int actual_size)
@@ -682,133 +759,138 @@ namespace librealsense
         auto n = width * height;
         assert(n % 16 == 0); // All currently supported color resolutions are multiples of 16 pixels. Could easily extend support to other resolutions by copying final n<16 pixels into a zero-padded buffer and recursively calling self for final iteration.
 #ifdef __SSSE3__
-        auto src = reinterpret_cast<const __m128i *>(s);
-        auto dst = reinterpret_cast<__m128i *>(d[0]);
-        for (; n; n -= 16)
+        if (get_simd_level() >= simd_level::ssse3)
         {
-            const __m128i zero = _mm_set1_epi8(0);
-            const __m128i n100 = _mm_set1_epi16(100 << 4);
-            const __m128i n208 = _mm_set1_epi16(208 << 4);
-            const __m128i n298 = _mm_set1_epi16(298 << 4);
-            const __m128i n409 = _mm_set1_epi16(409 << 4);
-            const __m128i n516 = _mm_set1_epi16(516 << 4);
-            const __m128i evens_odds = _mm_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15);
-
-            // Load 8 UYVY pixels each into two 16-byte registers
-            __m128i s0 = _mm_loadu_si128(src++);
-            __m128i s1 = _mm_loadu_si128(src++);
-
-
-            // Shuffle all Y components to the low order bytes of the register, and all U/V components to the high order bytes
-            const __m128i evens_odd1s_odd3s = _mm_setr_epi8(1, 3, 5, 7, 9, 11, 13, 15, 0, 4, 8, 12, 2, 6, 10, 14); // to get yyyyyyyyuuuuvvvv
-            __m128i yyyyyyyyuuuuvvvv0 = _mm_shuffle_epi8(s0, evens_odd1s_odd3s);
-            __m128i yyyyyyyyuuuuvvvv8 = _mm_shuffle_epi8(s1, evens_odd1s_odd3s);
-
-            // Retrieve all 16 Y components as 16-bit values (8 components per register))
-            __m128i y16__0_7 = _mm_unpacklo_epi8(yyyyyyyyuuuuvvvv0, zero);         // convert to 16 bit
-            __m128i y16__8_F = _mm_unpacklo_epi8(yyyyyyyyuuuuvvvv8, zero);         // convert to 16 bit
-
-
-            // Retrieve all 16 U and V components as 16-bit values (8 components per register)
-            __m128i uv = _mm_unpackhi_epi32(yyyyyyyyuuuuvvvv0, yyyyyyyyuuuuvvvv8); // uuuuuuuuvvvvvvvv
-            __m128i u = _mm_unpacklo_epi8(uv, uv);                                 //  uu uu uu uu uu uu uu uu  u's duplicated
-            __m128i v = _mm_unpackhi_epi8(uv, uv);                                 //  vv vv vv vv vv vv vv vv
-            __m128i u16__0_7 = _mm_unpacklo_epi8(u, zero);                         // convert to 16 bit
-            __m128i u16__8_F = _mm_unpackhi_epi8(u, zero);                         // convert to 16 bit
-            __m128i v16__0_7 = _mm_unpacklo_epi8(v, zero);                         // convert to 16 bit
-            __m128i v16__8_F = _mm_unpackhi_epi8(v, zero);                         // convert to 16 bit
-
-                                                                                   // Compute R, G, B values for first 8 pixels
-            __m128i c16__0_7 = _mm_slli_epi16(_mm_subs_epi16(y16__0_7, _mm_set1_epi16(16)), 4);
-            __m128i d16__0_7 = _mm_slli_epi16(_mm_subs_epi16(u16__0_7, _mm_set1_epi16(128)), 4); // perhaps could have done these u,v to d,e before the duplication
-            __m128i e16__0_7 = _mm_slli_epi16(_mm_subs_epi16(v16__0_7, _mm_set1_epi16(128)), 4);
-            __m128i r16__0_7 = _mm_min_epi16(_mm_set1_epi16(255), _mm_max_epi16(zero, ((_mm_add_epi16(_mm_mulhi_epi16(c16__0_7, n298), _mm_mulhi_epi16(e16__0_7, n409))))));                                                 // (298 * c + 409 * e + 128) ; //
-            __m128i g16__0_7 = _mm_min_epi16(_mm_set1_epi16(255), _mm_max_epi16(zero, ((_mm_sub_epi16(_mm_sub_epi16(_mm_mulhi_epi16(c16__0_7, n298), _mm_mulhi_epi16(d16__0_7, n100)), _mm_mulhi_epi16(e16__0_7, n208)))))); // (298 * c - 100 * d - 208 * e + 128)
-            __m128i b16__0_7 = _mm_min_epi16(_mm_set1_epi16(255), _mm_max_epi16(zero, ((_mm_add_epi16(_mm_mulhi_epi16(c16__0_7, n298), _mm_mulhi_epi16(d16__0_7, n516))))));                                                 // clampbyte((298 * c + 516 * d + 128) >> 8);
-
-                                                                                                                                                                                                                             // Compute R, G, B values for second 8 pixels
-            __m128i c16__8_F = _mm_slli_epi16(_mm_subs_epi16(y16__8_F, _mm_set1_epi16(16)), 4);
-            __m128i d16__8_F = _mm_slli_epi16(_mm_subs_epi16(u16__8_F, _mm_set1_epi16(128)), 4); // perhaps could have done these u,v to d,e before the duplication
-            __m128i e16__8_F = _mm_slli_epi16(_mm_subs_epi16(v16__8_F, _mm_set1_epi16(128)), 4);
-            __m128i r16__8_F = _mm_min_epi16(_mm_set1_epi16(255), _mm_max_epi16(zero, ((_mm_add_epi16(_mm_mulhi_epi16(c16__8_F, n298), _mm_mulhi_epi16(e16__8_F, n409))))));                                                 // (298 * c + 409 * e + 128) ; //
-            __m128i g16__8_F = _mm_min_epi16(_mm_set1_epi16(255), _mm_max_epi16(zero, ((_mm_sub_epi16(_mm_sub_epi16(_mm_mulhi_epi16(c16__8_F, n298), _mm_mulhi_epi16(d16__8_F, n100)), _mm_mulhi_epi16(e16__8_F, n208)))))); // (298 * c - 100 * d - 208 * e + 128)
-            __m128i b16__8_F = _mm_min_epi16(_mm_set1_epi16(255), _mm_max_epi16(zero, ((_mm_add_epi16(_mm_mulhi_epi16(c16__8_F, n298), _mm_mulhi_epi16(d16__8_F, n516))))));                                                 // clampbyte((298 * c + 516 * d + 128) >> 8);
-
-            if (FORMAT == RS2_FORMAT_RGB8 || FORMAT == RS2_FORMAT_RGBA8)
+            auto src = reinterpret_cast<const __m128i *>(s);
+            auto dst = reinterpret_cast<__m128i *>(d[0]);
+            for (; n; n -= 16)
             {
-                // Shuffle separate R, G, B values into four registers storing four pixels each in (R, G, B, A) order
-                __m128i rg8__0_7 = _mm_unpacklo_epi8(_mm_shuffle_epi8(r16__0_7, evens_odds), _mm_shuffle_epi8(g16__0_7, evens_odds)); // hi to take the odds which are the upper bytes we care about
-                __m128i ba8__0_7 = _mm_unpacklo_epi8(_mm_shuffle_epi8(b16__0_7, evens_odds), _mm_set1_epi8(-1));
-                __m128i rgba_0_3 = _mm_unpacklo_epi16(rg8__0_7, ba8__0_7);
-                __m128i rgba_4_7 = _mm_unpackhi_epi16(rg8__0_7, ba8__0_7);
-
-                __m128i rg8__8_F = _mm_unpacklo_epi8(_mm_shuffle_epi8(r16__8_F, evens_odds), _mm_shuffle_epi8(g16__8_F, evens_odds)); // hi to take the odds which are the upper bytes we care about
-                __m128i ba8__8_F = _mm_unpacklo_epi8(_mm_shuffle_epi8(b16__8_F, evens_odds), _mm_set1_epi8(-1));
-                __m128i rgba_8_B = _mm_unpacklo_epi16(rg8__8_F, ba8__8_F);
-                __m128i rgba_C_F = _mm_unpackhi_epi16(rg8__8_F, ba8__8_F);
-
-                if (FORMAT == RS2_FORMAT_RGBA8)
-                {
-                    // Store 16 pixels (64 bytes) at once
-                    _mm_storeu_si128(dst++, rgba_0_3);
-                    _mm_storeu_si128(dst++, rgba_4_7);
-                    _mm_storeu_si128(dst++, rgba_8_B);
-                    _mm_storeu_si128(dst++, rgba_C_F);
-                }
+                const __m128i zero = _mm_set1_epi8(0);
+                const __m128i n100 = _mm_set1_epi16(100 << 4);
+                const __m128i n208 = _mm_set1_epi16(208 << 4);
+                const __m128i n298 = _mm_set1_epi16(298 << 4);
+                const __m128i n409 = _mm_set1_epi16(409 << 4);
+                const __m128i n516 = _mm_set1_epi16(516 << 4);
+                const __m128i evens_odds = _mm_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15);
 
-                if (FORMAT == RS2_FORMAT_RGB8)
-                {
-                    // Shuffle rgb triples to the start and end of each register
-                    __m128i rgb0 = _mm_shuffle_epi8(rgba_0_3, _mm_setr_epi8(3, 7, 11, 15, 0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14));
-                    __m128i rgb1 = _mm_shuffle_epi8(rgba_4_7, _mm_setr_epi8(0, 1, 2, 4, 3, 7, 11, 15, 5, 6, 8, 9, 10, 12, 13, 14));
-                    __m128i rgb2 = _mm_shuffle_epi8(rgba_8_B, _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 3, 7, 11, 15, 10, 12, 13, 14));
-                    __m128i rgb3 = _mm_shuffle_epi8(rgba_C_F, _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, 3, 7, 11, 15));
-
-                    // Align registers and store 16 pixels (48 bytes) at once
-                    _mm_storeu_si128(dst++, _mm_alignr_epi8(rgb1, rgb0, 4));
-                    _mm_storeu_si128(dst++, _mm_alignr_epi8(rgb2, rgb1, 8));
-                    _mm_storeu_si128(dst++, _mm_alignr_epi8(rgb3, rgb2, 12));
-                }
-            }
+                // Load 8 UYVY pixels each into two 16-byte registers
+                __m128i s0 = _mm_loadu_si128(src++);
+                __m128i s1 = _mm_loadu_si128(src++);
 
-            if (FORMAT == RS2_FORMAT_BGR8 || FORMAT == RS2_FORMAT_BGRA8)
-            {
-                // Shuffle separate R, G, B values into four registers storing four pixels each in (B, G, R, A) order
-                __m128i bg8__0_7 = _mm_unpacklo_epi8(_mm_shuffle_epi8(b16__0_7, evens_odds), _mm_shuffle_epi8(g16__0_7, evens_odds)); // hi to take the odds which are the upper bytes we care about
-                __m128i ra8__0_7 = _mm_unpacklo_epi8(_mm_shuffle_epi8(r16__0_7, evens_odds), _mm_set1_epi8(-1));
-                __m128i bgra_0_3 = _mm_unpacklo_epi16(bg8__0_7, ra8__0_7);
-                __m128i bgra_4_7 = _mm_unpackhi_epi16(bg8__0_7, ra8__0_7);
-
-                __m128i bg8__8_F = _mm_unpacklo_epi8(_mm_shuffle_epi8(b16__8_F, evens_odds), _mm_shuffle_epi8(g16__8_F, evens_odds)); // hi to take the odds which are the upper bytes we care about
-                __m128i ra8__8_F = _mm_unpacklo_epi8(_mm_shuffle_epi8(r16__8_F, evens_odds), _mm_set1_epi8(-1));
-                __m128i bgra_8_B = _mm_unpacklo_epi16(bg8__8_F, ra8__8_F);
-                __m128i bgra_C_F = _mm_unpackhi_epi16(bg8__8_F, ra8__8_F);
-
-                if (FORMAT == RS2_FORMAT_BGRA8)
+
+                // Shuffle all Y components to the low order bytes of the register, and all U/V components to the high order bytes
+                const __m128i evens_odd1s_odd3s = _mm_setr_epi8(1, 3, 5, 7, 9, 11, 13, 15, 0, 4, 8, 12, 2, 6, 10, 14); // to get yyyyyyyyuuuuvvvv
+                __m128i yyyyyyyyuuuuvvvv0 = _mm_shuffle_epi8(s0, evens_odd1s_odd3s);
+                __m128i yyyyyyyyuuuuvvvv8 = _mm_shuffle_epi8(s1, evens_odd1s_odd3s);
+
+                // Retrieve all 16 Y components as 16-bit values (8 components per register))
+                __m128i y16__0_7 = _mm_unpacklo_epi8(yyyyyyyyuuuuvvvv0, zero);         // convert to 16 bit
+                __m128i y16__8_F = _mm_unpacklo_epi8(yyyyyyyyuuuuvvvv8, zero);         // convert to 16 bit
+
+
+                // Retrieve all 16 U and V components as 16-bit values (8 components per register)
+                __m128i uv = _mm_unpackhi_epi32(yyyyyyyyuuuuvvvv0, yyyyyyyyuuuuvvvv8); // uuuuuuuuvvvvvvvv
+                __m128i u = _mm_unpacklo_epi8(uv, uv);                                 //  uu uu uu uu uu uu uu uu  u's duplicated
+                __m128i v = _mm_unpackhi_epi8(uv, uv);                                 //  vv vv vv vv vv vv vv vv
+                __m128i u16__0_7 = _mm_unpacklo_epi8(u, zero);                         // convert to 16 bit
+                __m128i u16__8_F = _mm_unpackhi_epi8(u, zero);                         // convert to 16 bit
+                __m128i v16__0_7 = _mm_unpacklo_epi8(v, zero);                         // convert to 16 bit
+                __m128i v16__8_F = _mm_unpackhi_epi8(v, zero);                         // convert to 16 bit
+
+                                                                                       // Compute R, G, B values for first 8 pixels
+                __m128i c16__0_7 = _mm_slli_epi16(_mm_subs_epi16(y16__0_7, _mm_set1_epi16(16)), 4);
+                __m128i d16__0_7 = _mm_slli_epi16(_mm_subs_epi16(u16__0_7, _mm_set1_epi16(128)), 4); // perhaps could have done these u,v to d,e before the duplication
+                __m128i e16__0_7 = _mm_slli_epi16(_mm_subs_epi16(v16__0_7, _mm_set1_epi16(128)), 4);
+                __m128i r16__0_7 = _mm_min_epi16(_mm_set1_epi16(255), _mm_max_epi16(zero, ((_mm_add_epi16(_mm_mulhi_epi16(c16__0_7, n298), _mm_mulhi_epi16(e16__0_7, n409))))));                                                 // (298 * c + 409 * e + 128) ; //
+                __m128i g16__0_7 = _mm_min_epi16(_mm_set1_epi16(255), _mm_max_epi16(zero, ((_mm_sub_epi16(_mm_sub_epi16(_mm_mulhi_epi16(c16__0_7, n298), _mm_mulhi_epi16(d16__0_7, n100)), _mm_mulhi_epi16(e16__0_7, n208)))))); // (298 * c - 100 * d - 208 * e + 128)
+                __m128i b16__0_7 = _mm_min_epi16(_mm_set1_epi16(255), _mm_max_epi16(zero, ((_mm_add_epi16(_mm_mulhi_epi16(c16__0_7, n298), _mm_mulhi_epi16(d16__0_7, n516))))));                                                 // clampbyte((298 * c + 516 * d + 128) >> 8);
+
+                                                                                                                                                                                                                                 // Compute R, G, B values for second 8 pixels
+                __m128i c16__8_F = _mm_slli_epi16(_mm_subs_epi16(y16__8_F, _mm_set1_epi16(16)), 4);
+                __m128i d16__8_F = _mm_slli_epi16(_mm_subs_epi16(u16__8_F, _mm_set1_epi16(128)), 4); // perhaps could have done these u,v to d,e before the duplication
+                __m128i e16__8_F = _mm_slli_epi16(_mm_subs_epi16(v16__8_F, _mm_set1_epi16(128)), 4);
+                __m128i r16__8_F = _mm_min_epi16(_mm_set1_epi16(255), _mm_max_epi16(zero, ((_mm_add_epi16(_mm_mulhi_epi16(c16__8_F, n298), _mm_mulhi_epi16(e16__8_F, n409))))));                                                 // (298 * c + 409 * e + 128) ; //
+                __m128i g16__8_F = _mm_min_epi16(_mm_set1_epi16(255), _mm_max_epi16(zero, ((_mm_sub_epi16(_mm_sub_epi16(_mm_mulhi_epi16(c16__8_F, n298), _mm_mulhi_epi16(d16__8_F, n100)), _mm_mulhi_epi16(e16__8_F, n208)))))); // (298 * c - 100 * d - 208 * e + 128)
+                __m128i b16__8_F = _mm_min_epi16(_mm_set1_epi16(255), _mm_max_epi16(zero, ((_mm_add_epi16(_mm_mulhi_epi16(c16__8_F, n298), _mm_mulhi_epi16(d16__8_F, n516))))));                                                 // clampbyte((298 * c + 516 * d + 128) >> 8);
+
+                if (FORMAT == RS2_FORMAT_RGB8 || FORMAT == RS2_FORMAT_RGBA8)
                 {
-                    // Store 16 pixels (64 bytes) at once
-                    _mm_storeu_si128(dst++, bgra_0_3);
-                    _mm_storeu_si128(dst++, bgra_4_7);
-                    _mm_storeu_si128(dst++, bgra_8_B);
-                    _mm_storeu_si128(dst++, bgra_C_F);
+                    // Shuffle separate R, G, B values into four registers storing four pixels each in (R, G, B, A) order
+                    __m128i rg8__0_7 = _mm_unpacklo_epi8(_mm_shuffle_epi8(r16__0_7, evens_odds), _mm_shuffle_epi8(g16__0_7, evens_odds)); // hi to take the odds which are the upper bytes we care about
+                    __m128i ba8__0_7 = _mm_unpacklo_epi8(_mm_shuffle_epi8(b16__0_7, evens_odds), _mm_set1_epi8(-1));
+                    __m128i rgba_0_3 = _mm_unpacklo_epi16(rg8__0_7, ba8__0_7);
+                    __m128i rgba_4_7 = _mm_unpackhi_epi16(rg8__0_7, ba8__0_7);
+
+                    __m128i rg8__8_F = _mm_unpacklo_epi8(_mm_shuffle_epi8(r16__8_F, evens_odds), _mm_shuffle_epi8(g16__8_F, evens_odds)); // hi to take the odds which are the upper bytes we care about
+                    __m128i ba8__8_F = _mm_unpacklo_epi8(_mm_shuffle_epi8(b16__8_F, evens_odds), _mm_set1_epi8(-1));
+                    __m128i rgba_8_B = _mm_unpacklo_epi16(rg8__8_F, ba8__8_F);
+                    __m128i rgba_C_F = _mm_unpackhi_epi16(rg8__8_F, ba8__8_F);
+
+                    if (FORMAT == RS2_FORMAT_RGBA8)
+                    {
+                        // Store 16 pixels (64 bytes) at once
+                        _mm_storeu_si128(dst++, rgba_0_3);
+                        _mm_storeu_si128(dst++, rgba_4_7);
+                        _mm_storeu_si128(dst++, rgba_8_B);
+                        _mm_storeu_si128(dst++, rgba_C_F);
+                    }
+
+                    if (FORMAT == RS2_FORMAT_RGB8)
+                    {
+                        // Shuffle rgb triples to the start and end of each register
+                        __m128i rgb0 = _mm_shuffle_epi8(rgba_0_3, _mm_setr_epi8(3, 7, 11, 15, 0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14));
+                        __m128i rgb1 = _mm_shuffle_epi8(rgba_4_7, _mm_setr_epi8(0, 1, 2, 4, 3, 7, 11, 15, 5, 6, 8, 9, 10, 12, 13, 14));
+                        __m128i rgb2 = _mm_shuffle_epi8(rgba_8_B, _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 3, 7, 11, 15, 10, 12, 13, 14));
+                        __m128i rgb3 = _mm_shuffle_epi8(rgba_C_F, _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, 3, 7, 11, 15));
+
+                        // Align registers and store 16 pixels (48 bytes) at once
+                        _mm_storeu_si128(dst++, _mm_alignr_epi8(rgb1, rgb0, 4));
+                        _mm_storeu_si128(dst++, _mm_alignr_epi8(rgb2, rgb1, 8));
+                        _mm_storeu_si128(dst++, _mm_alignr_epi8(rgb3, rgb2, 12));
+                    }
                 }
 
-                if (FORMAT == RS2_FORMAT_BGR8)
+                if (FORMAT == RS2_FORMAT_BGR8 || FORMAT == RS2_FORMAT_BGRA8)
                 {
-                    // Shuffle rgb triples to the start and end of each register
-                    __m128i bgr0 = _mm_shuffle_epi8(bgra_0_3, _mm_setr_epi8(3, 7, 11, 15, 0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14));
-                    __m128i bgr1 = _mm_shuffle_epi8(bgra_4_7, _mm_setr_epi8(0, 1, 2, 4, 3, 7, 11, 15, 5, 6, 8, 9, 10, 12, 13, 14));
-                    __m128i bgr2 = _mm_shuffle_epi8(bgra_8_B, _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 3, 7, 11, 15, 10, 12, 13, 14));
-                    __m128i bgr3 = _mm_shuffle_epi8(bgra_C_F, _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, 3, 7, 11, 15));
-
-                    // Align registers and store 16 pixels (48 bytes) at once
-                    _mm_storeu_si128(dst++, _mm_alignr_epi8(bgr1, bgr0, 4));
-                    _mm_storeu_si128(dst++, _mm_alignr_epi8(bgr2, bgr1, 8));
-                    _mm_storeu_si128(dst++, _mm_alignr_epi8(bgr3, bgr2, 12));
+                    // Shuffle separate R, G, B values into four registers storing four pixels each in (B, G, R, A) order
+                    __m128i bg8__0_7 = _mm_unpacklo_epi8(_mm_shuffle_epi8(b16__0_7, evens_odds), _mm_shuffle_epi8(g16__0_7, evens_odds)); // hi to take the odds which are the upper bytes we care about
+                    __m128i ra8__0_7 = _mm_unpacklo_epi8(_mm_shuffle_epi8(r16__0_7, evens_odds), _mm_set1_epi8(-1));
+                    __m128i bgra_0_3 = _mm_unpacklo_epi16(bg8__0_7, ra8__0_7);
+                    __m128i bgra_4_7 = _mm_unpackhi_epi16(bg8__0_7, ra8__0_7);
+
+                    __m128i bg8__8_F = _mm_unpacklo_epi8(_mm_shuffle_epi8(b16__8_F, evens_odds), _mm_shuffle_epi8(g16__8_F, evens_odds)); // hi to take the odds which are the upper bytes we care about
+                    __m128i ra8__8_F = _mm_unpacklo_epi8(_mm_shuffle_epi8(r16__8_F, evens_odds), _mm_set1_epi8(-1));
+                    __m128i bgra_8_B = _mm_unpacklo_epi16(bg8__8_F, ra8__8_F);
+                    __m128i bgra_C_F = _mm_unpackhi_epi16(bg8__8_F, ra8__8_F);
+
+                    if (FORMAT == RS2_FORMAT_BGRA8)
+                    {
+                        // Store 16 pixels (64 bytes) at once
+                        _mm_storeu_si128(dst++, bgra_0_3);
+                        _mm_storeu_si128(dst++, bgra_4_7);
+                        _mm_storeu_si128(dst++, bgra_8_B);
+                        _mm_storeu_si128(dst++, bgra_C_F);
+                    }
+
+                    if (FORMAT == RS2_FORMAT_BGR8)
+                    {
+                        // Shuffle rgb triples to the start and end of each register
+                        __m128i bgr0 = _mm_shuffle_epi8(bgra_0_3, _mm_setr_epi8(3, 7, 11, 15, 0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14));
+                        __m128i bgr1 = _mm_shuffle_epi8(bgra_4_7, _mm_setr_epi8(0, 1, 2, 4, 3, 7, 11, 15, 5, 6, 8, 9, 10, 12, 13, 14));
+                        __m128i bgr2 = _mm_shuffle_epi8(bgra_8_B, _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 3, 7, 11, 15, 10, 12, 13, 14));
+                        __m128i bgr3 = _mm_shuffle_epi8(bgra_C_F, _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, 3, 7, 11, 15));
+
+                        // Align registers and store 16 pixels (48 bytes) at once
+                        _mm_storeu_si128(dst++, _mm_alignr_epi8(bgr1, bgr0, 4));
+                        _mm_storeu_si128(dst++, _mm_alignr_epi8(bgr2, bgr1, 8));
+                        _mm_storeu_si128(dst++, _mm_alignr_epi8(bgr3, bgr2, 12));
+                    }
                 }
             }
+            return;
         }
-#else  // Generic code for when SSSE3 is not available.
+#endif
+        // Generic code for when SSSE3 is not available or disabled
         auto src = reinterpret_cast<const uint8_t *>(s);
         auto dst = reinterpret_cast<uint8_t *>(d[0]);
         for (; n; n -= 16, src += 32)
@@ -913,7 +995,6 @@ namespace librealsense
                 continue;
             }
         }
-#endif
     }
 
     void copy_mjpeg(byte * const dest[], const byte * source, int width, int height, int actual_size)
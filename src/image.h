@@ -16,6 +16,13 @@ namespace librealsense
     void unpack_yuy2_bgr8(byte * const d[], const byte * s, int w, int h, int actual_size);
     void unpack_yuy2_bgra8(byte * const d[], const byte * s, int w, int h, int actual_size);
 
+    void unpack_y10bpack(byte * const dest[], const byte * source, int width, int height, int actual_size);
+    void unpack_y8_from_rw10(byte * const d[], const byte * s, int width, int height, int actual_size);
+    void unpack_rw10_from_rw8(byte * const d[], const byte * s, int width, int height, int actual_size);
+    void unpack_y8_from_y16_10(byte * const d[], const byte * s, int width, int height, int actual_size);
+    void unpack_y16_from_y16_10(byte * const d[], const byte * s, int width, int height, int actual_size);
+    void unpack_y16_from_y8(byte * const d[], const byte * s, int width, int height, int actual_size);
+
     size_t           get_image_size                 (int width, int height, rs2_format format);
     int              get_image_bpp                  (rs2_format format);
     void             deproject_z                    (float * points, const rs2_intrinsics & z_intrin, const uint16_t * z_pixels, float z_scale);
@@ -252,6 +252,12 @@ namespace librealsense
             _must_enqueue = true;
         }
 
+        bool buffer::is_attached()
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            return _must_enqueue;
+        }
+
         void buffer::detach_buffer()
         {
             std::lock_guard<std::mutex> lock(_mutex);
@@ -884,8 +890,14 @@ namespace librealsense
 
                                     if (val > 1)
                                         LOG_INFO("Frame buf ready, md size: " << std::dec << (int)buf_mgr.metadata_size() << " seq. id: " << buf.sequence);
+                                    // When the consumer holds on to most of the capture buffers, ask for this one
+                                    // to be copied and returned immediately so the kernel never runs dry
+                                    auto free_buffers = get_free_buffers_count();
+                                    auto low_watermark = std::max<size_t>(1, _buffers.size() / 2);
+
                                     frame_object fo{ buf.bytesused - MAX_META_DATA_SIZE, buf_mgr.metadata_size(),
-                                        buffer->get_frame_start(), buf_mgr.metadata_start(), timestamp };
+                                        buffer->get_frame_start(), buf_mgr.metadata_start(), timestamp,
+                                        free_buffers < low_watermark };
 
                                      buffer->attach_buffer(buf);
                                      buf_mgr.handle_buffer(e_video_buf,-1); // transfer new buffer request to the frame callback
@@ -918,6 +930,14 @@ namespace librealsense
             }
         }
 
+        // Number of video buffers currently queued in the kernel, excluding the one being dispatched
+        size_t v4l_uvc_device::get_free_buffers_count() const
+        {
+            auto held = std::count_if(_buffers.begin(), _buffers.end(),
+                [](const std::shared_ptr<buffer>& b) { return b->is_attached(); });
+            return _buffers.size() - held - 1;
+        }
+
         void v4l_uvc_device::acquire_metadata(buffers_mgr & buf_mgr,fd_set &)
         {
             if (has_metadata())
@@ -134,6 +134,9 @@ namespace librealsense
 
             bool use_memory_map() const { return _use_memory_map; }
 
+            // The buffer was passed on with a frame and is not queued in the kernel until released
+            bool is_attached();
+
         private:
             v4l2_buf_type _type;
             uint8_t* _start;
@@ -307,6 +310,8 @@ namespace librealsense
             virtual void stop_data_capture() override;
             virtual void acquire_metadata(buffers_mgr & buf_mgr,fd_set &fds) override;
 
+            size_t get_free_buffers_count() const;
+
             power_state _state = D3;
             std::string _name = "";
             std::string _device_path = "";
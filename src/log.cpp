@@ -24,6 +24,15 @@ void librealsense::log_to_file(rs2_log_severity min_severity, const char * file_
     logger.log_to_file(min_severity, file_path);
 }
 
+bool librealsense::is_debug_log_enabled()
+{
+#if defined(RS2_USE_ANDROID_BACKEND) && !defined(NDEBUG)
+    return true; // Android debug builds always forward LOG_DEBUG to logcat
+#else
+    return logger.is_debug_enabled();
+#endif
+}
+
 #else // BUILD_EASYLOGGINGPP
 
 void librealsense::log_to_console(rs2_log_severity min_severity)
@@ -34,5 +43,10 @@ void librealsense::log_to_file(rs2_log_severity min_severity, const char * file_
 {
 }
 
+bool librealsense::is_debug_log_enabled()
+{
+    return false;
+}
+
 #endif // BUILD_EASYLOGGINGPP
 
@@ -23,6 +23,13 @@ namespace librealsense
         std::string filename;
         const std::string log_id = NAME;
 
+        std::atomic<bool> debug_enabled{ false };
+
+        void update_debug_enabled()
+        {
+            debug_enabled = (std::min)(minimum_console_severity, minimum_file_severity) <= RS2_LOG_SEVERITY_DEBUG;
+        }
+
     public:
         static el::Level severity_to_level(rs2_log_severity severity)
         {
@@ -118,9 +125,12 @@ namespace librealsense
             return false;
         }
 
+        bool is_debug_enabled() const { return debug_enabled; }
+
         void log_to_console(rs2_log_severity min_severity)
         {
             minimum_console_severity = min_severity;
+            update_debug_enabled();
             open();
         }
 
@@ -132,6 +142,7 @@ namespace librealsense
             if (file_path)
                 filename = file_path;
 
+            update_debug_enabled();
             open();
         }
     };
@@ -259,6 +259,14 @@ void playback_device::seek_to_time(std::chrono::nanoseconds time)
     }
 }
 
+void playback_device::seek_to_frame(rs2_stream stream, uint32_t stream_index, unsigned long long frame_number)
+{
+    LOG_INFO("Request to seek to frame " << frame_number << " of " << stream << " " << stream_index);
+    // Resolved on the caller's thread so that a missing frame is reported to the caller
+    auto time = m_reader->find_frame(stream, stream_index, frame_number);
+    seek_to_time(time);
+}
+
 rs2_playback_status playback_device::get_current_status() const
 {
     return m_is_started ?
@@ -348,6 +356,16 @@ bool playback_device::is_real_time() const
     return m_real_time;
 }
 
+void playback_device::set_read_ahead(size_t max_items)
+{
+    m_reader->set_read_ahead(max_items);
+}
+
+size_t playback_device::get_read_ahead_fill() const
+{
+    return m_reader->get_read_ahead_fill();
+}
+
 platform::backend_device_group playback_device::get_device_data() const
 {
     return platform::backend_device_group({ platform::playback_device_info{ m_reader->get_file_name() } });
@@ -33,6 +33,7 @@ namespace librealsense
 
         void set_frame_rate(double rate);
         void seek_to_time(std::chrono::nanoseconds time);
+        void seek_to_frame(rs2_stream stream, uint32_t stream_index, unsigned long long frame_number);
         rs2_playback_status get_current_status() const;
         uint64_t get_duration() const;
         void pause();
@@ -40,6 +41,8 @@ namespace librealsense
         void stop();
         void set_real_time(bool real_time);
         bool is_real_time() const;
+        void set_read_ahead(size_t max_items);
+        size_t get_read_ahead_fill() const;
         const std::string& get_file_name() const;
         uint64_t get_position() const;
         signal<playback_device, rs2_playback_status> playback_status_changed;
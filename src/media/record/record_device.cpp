@@ -11,9 +11,18 @@ using namespace librealsense;
 
 librealsense::record_device::record_device(std::shared_ptr<librealsense::device_interface> device,
                                       std::shared_ptr<librealsense::device_serializer::writer> serializer):
-    m_write_thread([](){return std::make_shared<dispatcher>(std::numeric_limits<unsigned int>::max());}),
+    m_write_thread([](){return std::make_shared<dispatcher>(QUEUE_MAX_SIZE);}),
     m_is_recording(true),
-    m_record_pause_time(0)
+    m_record_pause_time(0),
+    m_write_scheduled(false),
+    m_queue_budget(MAX_CACHED_DATA_SIZE),
+    m_queue_policy(RS2_RECORDING_QUEUE_POLICY_DROP_OLDEST),
+    m_queued_bytes(0),
+    m_dropped_frames(0),
+    m_written_bytes(0),
+    m_window_bytes(0),
+    m_window_start(std::chrono::steady_clock::now()),
+    m_write_throughput(0)
 {
     if (device == nullptr)
     {
@@ -111,6 +120,28 @@ std::chrono::nanoseconds librealsense::record_device::get_capture_time() const
     return (now - m_capture_time_base) - m_record_pause_time;
 }
 
+namespace
+{
+    uint64_t get_frame_size(const frame_holder& f)
+    {
+        uint64_t size = f.frame->get_frame_data_size();
+        // Zero-copy frames don't own a buffer, account for the data they point to
+        if (size == 0)
+        {
+            if (auto vf = dynamic_cast<video_frame*>(f.frame))
+                size = static_cast<uint64_t>(vf->get_stride()) * vf->get_height();
+        }
+        return size;
+    }
+
+    bool is_same_stream(const frame_holder& a, const frame_holder& b)
+    {
+        auto sa = a.frame->get_stream();
+        auto sb = b.frame->get_stream();
+        return sa && sb && sa->get_stream_type() == sb->get_stream_type() && sa->get_stream_index() == sb->get_stream_index();
+    }
+}
+
 void librealsense::record_device::write_data(size_t sensor_index, librealsense::frame_holder frame, std::function<void(std::string const&)> on_error)
 {
     //write_data is called from the sensors, when the live sensor raises a frame
@@ -122,51 +153,195 @@ void librealsense::record_device::write_data(size_t sensor_index, librealsense::
         initialize_recording();
     });
 
-    //TODO: restore: uint64_t data_size = frame.frame->get_frame_data_size();
-    uint64_t cached_data_size = m_cached_data_size; //TODO: restore: (+ data_size)
-    if (cached_data_size > MAX_CACHED_DATA_SIZE)
+    auto size = get_frame_size(frame);
+    auto capture_time = get_capture_time();
     {
-        LOG_WARNING("Recorder reached maximum cache size, frame dropped");
-        on_error("Recorder reached maximum cache size, frame dropped");
-        return;
+        std::vector<frame_holder> dropped; // released after the lock
+        std::unique_lock<std::mutex> lock(m_queue_mutex);
+        if (!make_room_for(frame, sensor_index, size, lock, dropped))
+            return;
+
+        m_pending_writes.push_back({ sensor_index, capture_time, std::move(frame), size, on_error, nullptr });
+        m_queued_bytes += size;
+        schedule_write(lock);
     }
+}
 
-    m_cached_data_size = cached_data_size;
-    auto capture_time = get_capture_time();
-    //TODO: remove usage of shared pointer when frame_holder is copyable
-    auto frame_holder_ptr = std::make_shared<frame_holder>();
-    *frame_holder_ptr = std::move(frame);
-    (*m_write_thread)->invoke([this, frame_holder_ptr, sensor_index, capture_time/*, data_size*/, on_error](dispatcher::cancellable_timer t) {
-        if (m_is_recording == false)
+// Queues a write other than a frame, behind everything queued before it
+void librealsense::record_device::enqueue_write(std::function<void()> action)
+{
+    std::unique_lock<std::mutex> lock(m_queue_mutex);
+    m_pending_writes.push_back({ 0, std::chrono::nanoseconds(0), frame_holder(), 0, nullptr, std::move(action) });
+    schedule_write(lock);
+}
+
+// The write thread has at most one task draining the queue at a time, queued writes are all it waits for
+void librealsense::record_device::schedule_write(std::unique_lock<std::mutex>& lock)
+{
+    if (m_write_scheduled)
+        return;
+    m_write_scheduled = true;
+    lock.unlock();
+
+    (*m_write_thread)->invoke([this](dispatcher::cancellable_timer t) {
+        write_pending();
+    });
+}
+
+// Applies the queue policy until the new frame fits into the budget.
+// Returns false if the new frame itself should be dropped
+bool librealsense::record_device::make_room_for(const frame_holder& f, size_t sensor_index, uint64_t size,
+    std::unique_lock<std::mutex>& lock, std::vector<frame_holder>& dropped)
+{
+    // Only the queued frames take room and can make room
+    auto is_full = [&]() { return m_queue_budget && m_queued_bytes > 0 && m_queued_bytes + size > m_queue_budget; };
+    auto is_frame = [](const pending_write& p) { return bool(p.frame); };
+
+    while (is_full())
+    {
+        if (m_queue_policy == RS2_RECORDING_QUEUE_POLICY_BLOCK)
+        {
+            m_queue_cv.wait(lock, [&]() { return !is_full() || m_queue_policy != RS2_RECORDING_QUEUE_POLICY_BLOCK; });
+            continue;
+        }
+
+        auto victim = m_pending_writes.end();
+        if (m_queue_policy == RS2_RECORDING_QUEUE_POLICY_DROP_OLDEST)
         {
-            return; //Recording is paused
+            victim = std::find_if(m_pending_writes.begin(), m_pending_writes.end(),
+                [&](const pending_write& p) { return is_frame(p) && p.sensor_index == sensor_index && is_same_stream(p.frame, f); });
         }
-        std::call_once(m_first_frame_flag, [&]()
+        else if (m_queue_policy == RS2_RECORDING_QUEUE_POLICY_DROP_NON_DEPTH_FIRST)
+        {
+            victim = std::find_if(m_pending_writes.begin(), m_pending_writes.end(),
+                [&](const pending_write& p) { return is_frame(p) && (!p.frame.frame->get_stream() || p.frame.frame->get_stream()->get_stream_type() != RS2_STREAM_DEPTH); });
+
+            // A depth frame is only worth a queued depth frame
+            auto stream = f.frame->get_stream();
+            if (victim == m_pending_writes.end() && stream && stream->get_stream_type() != RS2_STREAM_DEPTH)
+            {
+                if (!m_dropped_frames++) LOG_WARNING("Recorder write queue is full, dropping frames");
+                return false;
+            }
+        }
+        if (victim == m_pending_writes.end())
+            victim = std::find_if(m_pending_writes.begin(), m_pending_writes.end(), is_frame);
+
+        if (!m_dropped_frames++) LOG_WARNING("Recorder write queue is full, dropping frames");
+        m_queued_bytes -= victim->size;
+        dropped.push_back(std::move(victim->frame));
+        m_pending_writes.erase(victim);
+    }
+    return true;
+}
+
+// Writes the queued frames and actions in their order, until the queue is empty
+void librealsense::record_device::write_pending()
+{
+    std::unique_lock<std::mutex> lock(m_queue_mutex);
+    while (!m_pending_writes.empty())
+    {
+        auto next = std::move(m_pending_writes.front());
+        m_pending_writes.pop_front();
+        m_queued_bytes -= next.size;
+        lock.unlock();
+        m_queue_cv.notify_all();
+
+        if (next.action)
         {
             try
             {
-                write_header();
+                next.action();
             }
             catch (const std::exception& e)
             {
-                LOG_ERROR("Failed to write header. " << e.what());
-                on_error(to_string() << "Failed to write header. " << e.what());
+                LOG_ERROR(e.what());
             }
-        });
+        }
+        else
+        {
+            write_frame(next.sensor_index, next.capture_time, std::move(next.frame), next.size, next.on_error);
+        }
+        lock.lock();
+    }
+    m_write_scheduled = false;
+}
 
+void librealsense::record_device::write_frame(size_t sensor_index, std::chrono::nanoseconds capture_time, frame_holder frame, uint64_t size, std::function<void(std::string const&)> on_error)
+{
+    if (m_is_recording == false)
+    {
+        return; //Recording is paused
+    }
+    std::call_once(m_first_frame_flag, [&]()
+    {
         try
         {
-            const uint32_t device_index = 0;
-            auto stream_type = frame_holder_ptr->frame->get_stream()->get_stream_type();
-            auto stream_index = static_cast<uint32_t>(frame_holder_ptr->frame->get_stream()->get_stream_index());
-            m_ros_writer->write_frame({ device_index, static_cast<uint32_t>(sensor_index), stream_type, stream_index }, capture_time, std::move(*frame_holder_ptr));
-            //TODO: restore: std::lock_guard<std::mutex> locker(m_mutex);  m_cached_data_size -= data_size;
+            write_header();
         }
-        catch(std::exception& e)
+        catch (const std::exception& e)
         {
-            on_error(to_string() << "Failed to write frame. " << e.what());
+            LOG_ERROR("Failed to write header. " << e.what());
+            on_error(to_string() << "Failed to write header. " << e.what());
         }
     });
+
+    try
+    {
+        const uint32_t device_index = 0;
+        auto stream_type = frame.frame->get_stream()->get_stream_type();
+        auto stream_index = static_cast<uint32_t>(frame.frame->get_stream()->get_stream_index());
+        m_ros_writer->write_frame({ device_index, static_cast<uint32_t>(sensor_index), stream_type, stream_index }, capture_time, std::move(frame));
+    }
+    catch(std::exception& e)
+    {
+        on_error(to_string() << "Failed to write frame. " << e.what());
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_queue_mutex);
+    m_written_bytes += size;
+    m_window_bytes += size;
+    auto now = std::chrono::steady_clock::now();
+    auto elapsed = std::chrono::duration_cast<std::chrono::duration<double>>(now - m_window_start).count();
+    if (elapsed >= 1.0)
+    {
+        m_write_throughput = m_window_bytes / elapsed;
+        m_window_bytes = 0;
+        m_window_start = now;
+    }
+}
+
+void librealsense::record_device::set_queue_budget(uint64_t max_bytes, rs2_recording_queue_policy policy)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_queue_mutex);
+        m_queue_budget = max_bytes;
+        m_queue_policy = policy;
+    }
+    m_queue_cv.notify_all(); // Producers blocked under the previous settings re-evaluate
+}
+
+void librealsense::record_device::set_compression_options(uint32_t chunk_size, uint32_t compression_threads)
+{
+    // Applied between two writes, the writer is only used from the write thread
+    enqueue_write([this, chunk_size, compression_threads]()
+    {
+        m_ros_writer->set_compression_options(chunk_size, compression_threads);
+    });
+}
+
+rs2_recording_queue_stats librealsense::record_device::get_queue_stats()
+{
+    std::lock_guard<std::mutex> lock(m_queue_mutex);
+    rs2_recording_queue_stats stats;
+    stats.queued_bytes = m_queued_bytes;
+    stats.queued_frames = std::count_if(m_pending_writes.begin(), m_pending_writes.end(),
+        [](const pending_write& p) { return bool(p.frame); });
+    stats.dropped_frames = m_dropped_frames;
+    stats.written_bytes = m_written_bytes;
+    stats.write_throughput = m_write_throughput;
+    return stats;
 }
 
 const std::string& librealsense::record_device::get_info(rs2_camera_info info) const
@@ -270,7 +445,7 @@ void librealsense::record_device::write_device_extension_changes(const T& ext)
         return;
     }
     auto capture_time = get_capture_time();
-    (*m_write_thread)->invoke([this, capture_time, ext_snapshot](dispatcher::cancellable_timer t)
+    enqueue_write([this, capture_time, ext_snapshot]()
     {
         try
         {
@@ -290,7 +465,7 @@ void record_device::write_sensor_extension_snapshot(size_t sensor_index,
     std::function<void(std::string const&)> on_error)
 {
     auto capture_time = get_capture_time();
-    (*m_write_thread)->invoke([this, sensor_index, capture_time, ext, snapshot, on_error](dispatcher::cancellable_timer t)
+    enqueue_write([this, sensor_index, capture_time, ext, snapshot, on_error]()
     {
         try
         {
@@ -307,7 +482,7 @@ void record_device::write_sensor_extension_snapshot(size_t sensor_index,
 void librealsense::record_device::write_notification(size_t sensor_index, const notification& n)
 {
     auto capture_time = get_capture_time();
-    (*m_write_thread)->invoke([this, sensor_index, capture_time, n](dispatcher::cancellable_timer t)
+    enqueue_write([this, sensor_index, capture_time, n]()
     {
         try
         {
@@ -370,7 +545,7 @@ void librealsense::record_device::pause_recording()
 {
     LOG_INFO("Record Pause called");
 
-    (*m_write_thread)->invoke([this](dispatcher::cancellable_timer c)
+    enqueue_write([this]()
     {
         LOG_DEBUG("Record pause invoked");
 
@@ -388,7 +563,7 @@ void librealsense::record_device::pause_recording()
 void librealsense::record_device::resume_recording()
 {
     LOG_INFO("Record resume called");
-    (*m_write_thread)->invoke([this](dispatcher::cancellable_timer c)
+    enqueue_write([this]()
     {
         LOG_DEBUG("Record resume invoked");
         if (m_is_recording)
@@ -419,7 +594,6 @@ void record_device::initialize_recording()
 {
     //Expected to be called once when recording to file actually starts
     m_capture_time_base = std::chrono::high_resolution_clock::now();
-    m_cached_data_size = 0;
 }
 void record_device::stop_gracefully(to_string error_msg)
 {
@@ -39,6 +39,9 @@ namespace librealsense
         void pause_recording();
         void resume_recording();
         const std::string& get_filename() const;
+        void set_queue_budget(uint64_t max_bytes, rs2_recording_queue_policy policy);
+        rs2_recording_queue_stats get_queue_stats();
+        void set_compression_options(uint32_t chunk_size, uint32_t compression_threads);
         platform::backend_device_group get_device_data() const override;
         std::pair<uint32_t, rs2_extrinsics> get_extrinsics(const stream_interface& stream) const override;
         bool is_valid() const override;
@@ -55,6 +58,11 @@ namespace librealsense
         void write_header();
         std::chrono::nanoseconds get_capture_time() const;
         void write_data(size_t sensor_index, frame_holder f, std::function<void(std::string const&)> on_error);
+        bool make_room_for(const frame_holder& f, size_t sensor_index, uint64_t size, std::unique_lock<std::mutex>& lock, std::vector<frame_holder>& dropped);
+        void enqueue_write(std::function<void()> action);
+        void schedule_write(std::unique_lock<std::mutex>& lock);
+        void write_pending();
+        void write_frame(size_t sensor_index, std::chrono::nanoseconds capture_time, frame_holder frame, uint64_t size, std::function<void(std::string const&)> on_error);
         void write_sensor_extension_snapshot(size_t sensor_index, rs2_extension ext, std::shared_ptr<extension_snapshot> snapshot, std::function<void(std::string const&)> on_error);
         void write_notification(size_t sensor_index, const notification& n);
         std::vector<std::shared_ptr<record_sensor>> create_record_sensors(std::shared_ptr<device_interface> m_device);
@@ -76,8 +84,32 @@ namespace librealsense
         int m_on_notification_token;
         int m_on_frame_token;
         int m_on_extension_change_token;
-        uint64_t m_cached_data_size;
         std::once_flag m_first_call_flag;
+
+        // Writes waiting for the write thread, in arrival order. Frames carry the frame, every other write
+        // (notifications, snapshots, writer settings, pause and resume) an action. Only frames are dropped
+        struct pending_write
+        {
+            size_t sensor_index;
+            std::chrono::nanoseconds capture_time;
+            frame_holder frame;
+            uint64_t size;
+            std::function<void(std::string const&)> on_error;
+            std::function<void()> action;
+        };
+        std::deque<pending_write> m_pending_writes;
+        bool m_write_scheduled;
+        std::mutex m_queue_mutex;
+        std::condition_variable m_queue_cv;
+        uint64_t m_queue_budget;
+        rs2_recording_queue_policy m_queue_policy;
+        uint64_t m_queued_bytes;
+        uint64_t m_dropped_frames;
+        uint64_t m_written_bytes;
+        uint64_t m_window_bytes;
+        std::chrono::steady_clock::time_point m_window_start;
+        double m_write_throughput;
+
         void initialize_recording();
         void stop_gracefully(to_string error_msg);
     };
@@ -24,26 +24,155 @@ namespace librealsense
         m_total_duration(0),
         m_file_path(file),
         m_context(ctx),
-        m_version(0)
+        m_version(0),
+        m_last_frame_time(0),
+        m_read_ahead_size(DEFAULT_READ_AHEAD_SIZE),
+        m_read_ahead_failed(false),
+        m_stop_read_ahead(false),
+        m_decoding(false)
     {
         try
         {
             reset(); //Note: calling a virtual function inside c'tor, safe while base function is pure virtual
             m_total_duration = get_file_duration(m_file, m_version);
+            build_frames_index();
         }
         catch (const std::exception& e)
         {
             //Rethrowing with better clearer message
             throw io_exception(to_string() << "Failed to create ros reader: " << e.what());
         }
+        m_read_ahead_thread = std::thread([this]() { read_ahead_loop(); });
+    }
+
+    ros_reader::~ros_reader()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop_read_ahead = true;
+        }
+        m_read_ahead_cv.notify_all();
+        m_read_ahead_thread.join();
+    }
+
+    std::unique_lock<std::mutex> ros_reader::lock_file()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_read_ahead_cv.wait(lock, [this]() { return !m_decoding; });
+        return lock;
+    }
+
+    void ros_reader::set_file_read_ahead()
+    {
+        auto threads = m_read_ahead_size ? std::max(1u, std::min(4u, std::thread::hardware_concurrency())) : 0u;
+        m_file.setReadAhead(threads, threads);
     }
 
     device_snapshot ros_reader::query_device_description(const nanoseconds& time)
     {
+        auto lock = lock_file();
         return read_device_description(time);
     }
 
     std::shared_ptr<serialized_data> ros_reader::read_next_data()
+    {
+        // A sample being decoded ahead is the next one, it is waited for rather than read past
+        auto lock = lock_file();
+        std::shared_ptr<serialized_data> data;
+        if (!m_read_ahead.empty())
+        {
+            data = m_read_ahead.front().data;
+            m_read_ahead.pop_front();
+        }
+        else
+        {
+            data = read_next_data_from_file();
+        }
+        lock.unlock();
+        m_read_ahead_cv.notify_all();
+        return data;
+    }
+
+    void ros_reader::set_read_ahead(size_t max_items)
+    {
+        {
+            auto lock = lock_file();
+            auto was_reading_ahead = m_read_ahead_size > 0;
+            m_read_ahead_size = max_items;
+            while (m_read_ahead.size() > m_read_ahead_size)
+            {
+                m_samples_itrator = m_read_ahead.back().position;
+                m_read_ahead.pop_back();
+            }
+            // Chunks are decompressed ahead only along with the samples
+            if (was_reading_ahead != (m_read_ahead_size > 0))
+                set_file_read_ahead();
+        }
+        m_read_ahead_cv.notify_all();
+    }
+
+    size_t ros_reader::get_read_ahead_fill() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_read_ahead.size();
+    }
+
+    // Decodes upcoming samples while the consumer is busy with (or sleeping until) the previous ones.
+    // The file is decompressed ahead by the bag, this keeps the decoded frames ready as well.
+    // The sample is decoded without the lock, which then only publishes it, while m_decoding tells the
+    // other threads the file and the view are taken
+    void ros_reader::read_ahead_loop()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true)
+        {
+            m_read_ahead_cv.wait(lock, [this]()
+            {
+                return m_stop_read_ahead || (!m_read_ahead_failed && m_read_ahead.size() < m_read_ahead_size &&
+                    m_samples_view != nullptr && m_samples_itrator != m_samples_view->end());
+            });
+            if (m_stop_read_ahead)
+                return;
+
+            m_decoding = true;
+            lock.unlock();
+
+            auto position = m_samples_itrator;
+            std::shared_ptr<serialized_data> data;
+            try
+            {
+                data = read_next_data_from_file();
+            }
+            catch (const std::exception& e)
+            {
+                // Leave the sample to the consumer, so the error is reported on its thread
+                LOG_DEBUG("Read-ahead stopped: " << e.what());
+                m_samples_itrator = position;
+            }
+
+            lock.lock();
+            m_decoding = false;
+            if (data)
+                m_read_ahead.push_back({ position, data });
+            else
+                m_read_ahead_failed = true;
+            m_read_ahead_cv.notify_all();
+        }
+    }
+
+    // Returns the view to the consumer's position, so it can be safely modified. Called under lock_file()
+    void ros_reader::rewind_read_ahead()
+    {
+        if (!m_read_ahead.empty())
+        {
+            m_samples_itrator = m_read_ahead.front().position;
+            m_read_ahead.clear();
+        }
+        m_read_ahead_failed = false;
+        m_read_ahead_cv.notify_all(); // Resumes once the caller is done with the view
+    }
+
+    std::shared_ptr<serialized_data> ros_reader::read_next_data_from_file()
     {
         if (m_samples_view == nullptr || m_samples_itrator == m_samples_view->end())
         {
@@ -91,7 +220,10 @@ namespace librealsense
 
     void ros_reader::seek_to_time(const nanoseconds& seek_time)
     {
-        if (seek_time > m_total_duration)
+        auto lock = lock_file();
+        rewind_read_ahead();
+        // Frame times are relative to the start of recording, so the last frames may lie past the duration
+        if (seek_time > m_total_duration && seek_time > m_last_frame_time)
         {
             throw invalid_value_exception(to_string() << "Requested time is out of playback length. (Requested = " << seek_time.count() << ", Duration = " << m_total_duration.count() << ")");
         }
@@ -112,34 +244,124 @@ namespace librealsense
 
     std::vector<std::shared_ptr<serialized_data>> ros_reader::fetch_last_frames(const nanoseconds& seek_time)
     {
+        auto lock = lock_file();
         std::vector<std::shared_ptr<serialized_data>> result;
-        rosbag::View view(m_file, FalseQuery());
         auto as_rostime = to_rostime(seek_time);
         auto start_time = to_rostime(get_static_file_info_timestamp());
 
-        for (auto topic : m_enabled_streams_topics)
-        {
-            view.addQuery(m_file, rosbag::TopicQuery(topic), start_time, as_rostime);
-        }
-        std::map<device_serializer::stream_identifier, rs2rosinternal::Time> last_frames;
-        for (auto&& m : view)
+        std::map<device_serializer::stream_identifier, std::pair<std::string, rs2rosinternal::Time>> last_frames;
+        for (auto&& topic : m_enabled_streams_topics)
         {
-            if (m.isType<sensor_msgs::Image>() || m.isType<sensor_msgs::Imu>())
-            {
-                auto id = ros_topic::get_stream_identifier(m.getTopic());
-                last_frames[id] = m.getTime();
-            }
+            auto it = m_frames_index.find(topic);
+            if (it == m_frames_index.end() || !it->second.is_image_or_imu)
+                continue;
+            auto&& times = it->second.times;
+            auto last = std::upper_bound(times.begin(), times.end(), as_rostime);
+            if (last == times.begin() || *std::prev(last) < start_time)
+                continue;
+            last_frames[it->second.stream_id] = { topic, *std::prev(last) };
         }
         for (auto&& kvp : last_frames)
         {
-            auto topic = ros_topic::frame_data_topic(kvp.first);
-            rosbag::View view(m_file, rosbag::TopicQuery(topic), kvp.second, kvp.second);
+            rosbag::View view(m_file, rosbag::TopicQuery(kvp.second.first), kvp.second.second, kvp.second.second);
             auto msg = view.begin();
             auto new_frame = create_frame(*msg);
             result.push_back(new_frame);
         }
         return result;
     }
+
+    void ros_reader::build_frames_index()
+    {
+        std::function<bool(rosbag::ConnectionInfo const* info)> query;
+        if (m_version == legacy_file_format::file_version())
+            query = legacy_file_format::FrameQuery();
+        else
+            query = FrameQuery();
+
+        // Only the bag's index is walked here, no message is read
+        rosbag::View frames_view(m_file, query);
+        for (auto&& msg : frames_view)
+        {
+            auto&& topic = msg.getTopic();
+            auto it = m_frames_index.find(topic);
+            if (it == m_frames_index.end())
+            {
+                stream_frames_index index;
+                index.stream_id = (m_version == legacy_file_format::file_version()) ?
+                    legacy_file_format::get_stream_identifier(topic) : ros_topic::get_stream_identifier(topic);
+                index.is_image_or_imu = msg.isType<sensor_msgs::Image>() || msg.isType<sensor_msgs::Imu>();
+                it = m_frames_index.emplace(topic, std::move(index)).first;
+            }
+            it->second.times.push_back(msg.getTime());
+        }
+
+        for (auto&& kvp : m_frames_index)
+        {
+            if (!kvp.second.times.empty())
+                m_last_frame_time = std::max(m_last_frame_time, to_nanoseconds(kvp.second.times.back()));
+        }
+    }
+
+    unsigned long long ros_reader::read_frame_number(const std::string& topic, size_t position)
+    {
+        auto&& index = m_frames_index.at(topic);
+        auto known = index.frame_numbers.find(position);
+        if (known != index.frame_numbers.end())
+            return known->second;
+
+        // Frames of the same stream sharing a timestamp are told apart by their order in the file
+        auto time = index.times[position];
+        auto skip = position - (std::lower_bound(index.times.begin(), index.times.end(), time) - index.times.begin());
+        rosbag::View view(m_file, rosbag::TopicQuery(topic), time, time);
+        auto msg = view.begin();
+        for (; skip > 0 && msg != view.end(); --skip)
+            ++msg;
+        if (msg == view.end())
+            throw io_exception(to_string() << "Frame " << position << " of " << topic << " is missing from the file");
+
+        auto frame = create_frame(*msg);
+        if (!frame->is<serialized_frame>())
+            throw io_exception(to_string() << "Failed to read frame " << position << " of " << topic);
+        auto frame_number = frame->as<serialized_frame>()->frame->get_frame_number();
+        index.frame_numbers[position] = frame_number;
+        return frame_number;
+    }
+
+    nanoseconds ros_reader::find_frame(rs2_stream stream, uint32_t stream_index, unsigned long long frame_number)
+    {
+        auto lock = lock_file();
+        for (auto&& kvp : m_frames_index)
+        {
+            auto&& index = kvp.second;
+            if (index.stream_id.stream_type != stream || index.stream_id.stream_index != stream_index || index.times.empty())
+                continue;
+
+            // Frame numbers grow along the file, the first frame numbered frame_number or above is found in O(log n) reads
+            size_t first = 0, count = index.times.size();
+            while (count > 0)
+            {
+                auto step = count / 2;
+                auto middle = first + step;
+                if (read_frame_number(kvp.first, middle) < frame_number)
+                {
+                    first = middle + 1;
+                    count -= step + 1;
+                }
+                else
+                {
+                    count = step;
+                }
+            }
+            if (first == index.times.size())
+            {
+                throw invalid_value_exception(to_string() << "Frame number " << frame_number << " is past the last frame of " << stream << " " << stream_index);
+            }
+            return to_nanoseconds(index.times[first]);
+        }
+        throw invalid_value_exception(to_string() << "Stream " << stream << " " << stream_index << " is not found in " << m_file_path);
+    }
+
     nanoseconds ros_reader::query_duration() const
     {
         return m_total_duration;
@@ -147,8 +369,11 @@ namespace librealsense
 
     void ros_reader::reset()
     {
+        auto lock = lock_file();
+        rewind_read_ahead();
         m_file.close();
         m_file.open(m_file_path, rosbag::BagMode::Read);
+        set_file_read_ahead();
         m_version = read_file_version(m_file);
         m_samples_view = nullptr;
         m_frame_source = std::make_shared<frame_source>(m_version == 1 ? 128 : 32);
@@ -158,6 +383,8 @@ namespace librealsense
 
     void ros_reader::enable_stream(const std::vector<device_serializer::stream_identifier>& stream_ids)
     {
+        auto lock = lock_file();
+        rewind_read_ahead();
         rs2rosinternal::Time start_time = rs2rosinternal::TIME_MIN + rs2rosinternal::Duration{ 0, 1 }; //first non 0 timestamp and afterward
         if (m_samples_view == nullptr) //Starting to stream
         {
@@ -202,6 +429,8 @@ namespace librealsense
 
     void ros_reader::disable_stream(const std::vector<device_serializer::stream_identifier>& stream_ids)
     {
+        auto lock = lock_file();
+        rewind_read_ahead();
         if (m_samples_view == nullptr)
         {
             return;
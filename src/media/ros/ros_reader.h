@@ -2,6 +2,10 @@
 // Copyright(c) 2017 Intel Corporation. All Rights Reserved.
 
 #pragma once
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
 #include <core/serialization.h>
 #include "rosbag/view.h"
 #include "ros_file_format.h"
@@ -14,6 +18,7 @@ namespace librealsense
     {
     public:
         ros_reader(const std::string& file, const std::shared_ptr<context>& ctx);
+        ~ros_reader();
         device_snapshot query_device_description(const nanoseconds& time) override;
         std::shared_ptr<serialized_data> read_next_data() override;
         void seek_to_time(const nanoseconds& seek_time) override;
@@ -23,8 +28,22 @@ namespace librealsense
         virtual void enable_stream(const std::vector<device_serializer::stream_identifier>& stream_ids) override;
         virtual void disable_stream(const std::vector<device_serializer::stream_identifier>& stream_ids) override;
         const std::string& get_file_name() const override;
+        void set_read_ahead(size_t max_items) override;
+        size_t get_read_ahead_fill() const override;
+        nanoseconds find_frame(rs2_stream stream, uint32_t stream_index, unsigned long long frame_number) override;
+
+        static const size_t DEFAULT_READ_AHEAD_SIZE = 8;
 
     private:
+        std::shared_ptr<serialized_data> read_next_data_from_file();
+        void read_ahead_loop();
+        void rewind_read_ahead();
+        // Locks the reader once the read-ahead thread is done decoding, the file and the view are then the caller's
+        std::unique_lock<std::mutex> lock_file();
+        // Decompresses chunks ahead on worker threads while samples are read ahead, and not otherwise
+        void set_file_read_ahead();
+        void build_frames_index();
+        unsigned long long read_frame_number(const std::string& topic, size_t position);
 
         template <typename ROS_TYPE>
         static typename ROS_TYPE::ConstPtr instantiate_msg(const rosbag::MessageInstance& msg)
@@ -141,5 +160,32 @@ namespace librealsense
         std::vector<std::string>                m_enabled_streams_topics;
         std::shared_ptr<context>                m_context;
         uint32_t                                m_version;
+
+        // Time of every frame of every stream in the file, built once from the bag index on open.
+        // Frame numbers are read from the file on demand, and kept as they are found
+        struct stream_frames_index
+        {
+            device_serializer::stream_identifier                stream_id;
+            bool                                                is_image_or_imu;
+            std::vector<rs2rosinternal::Time>                   times;
+            std::map<size_t, unsigned long long>                frame_numbers;
+        };
+        std::map<std::string, stream_frames_index>  m_frames_index; // By frame data topic
+        nanoseconds                                 m_last_frame_time;
+
+        // Decoded samples read past the consumer's position, with the position each was read from
+        struct read_ahead_item
+        {
+            rosbag::View::iterator              position;
+            std::shared_ptr<serialized_data>    data;
+        };
+        std::deque<read_ahead_item>             m_read_ahead;
+        size_t                                  m_read_ahead_size;
+        bool                                    m_read_ahead_failed;
+        bool                                    m_stop_read_ahead;
+        bool                                    m_decoding;     // The read-ahead thread holds the file and the view
+        mutable std::mutex                      m_mutex; // Guards the read-ahead window, and the file and the view while not decoding
+        std::condition_variable                 m_read_ahead_cv;
+        std::thread                             m_read_ahead_thread;
     };
 }
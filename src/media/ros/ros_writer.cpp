@@ -23,10 +23,22 @@ namespace librealsense
         if (compress_while_record)
         {
             m_bag.setCompression(rosbag::CompressionType::LZ4);
+            // Keep the record thread free for serialization, chunks are compressed on worker threads
+            m_bag.setCompressionThreads(std::max(1u, std::min(4u, std::thread::hardware_concurrency())));
         }
         write_file_version();
     }
 
+    void ros_writer::set_compression_options(uint32_t chunk_size, uint32_t compression_threads)
+    {
+        LOG_INFO("Recording compression set to chunks of " << chunk_size << " bytes on " << compression_threads << " threads");
+        if (chunk_size > 0)
+        {
+            m_bag.setChunkThreshold(chunk_size);
+        }
+        m_bag.setCompressionThreads(compression_threads);
+    }
+
     void ros_writer::write_device_description(const librealsense::device_snapshot& device_description)
     {
         for (auto&& device_extension_snapshot : device_description.get_device_extensions_snapshots().get_snapshots())
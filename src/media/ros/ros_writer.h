@@ -18,6 +18,7 @@ namespace librealsense
         void write_snapshot(uint32_t device_index, const nanoseconds& timestamp, rs2_extension type, const std::shared_ptr<extension_snapshot>& snapshot) override;
         void write_snapshot(const sensor_identifier& sensor_id, const nanoseconds& timestamp, rs2_extension type, const std::shared_ptr<extension_snapshot>& snapshot) override;
         const std::string& get_file_name() const override;
+        void set_compression_options(uint32_t chunk_size, uint32_t compression_threads) override;
 
     private:
         void write_file_version();
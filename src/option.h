@@ -83,6 +83,27 @@ namespace librealsense
         std::string _desc;
     };
 
+    // Exposes a statistics counter maintained by its owner as a read-only option.
+    // The raw pointer form requires the owner to outlive the option, the shared form keeps the counter alive
+    class counter_option : public readonly_option
+    {
+    public:
+        counter_option(const std::atomic<uint64_t>* counter, std::string desc)
+            : _counter(counter, [](const std::atomic<uint64_t>*) {}), _desc(std::move(desc)) {}
+
+        counter_option(std::shared_ptr<const std::atomic<uint64_t>> counter, std::string desc)
+            : _counter(std::move(counter)), _desc(std::move(desc)) {}
+
+        float query() const override { return static_cast<float>(_counter->load()); }
+        option_range get_range() const override { return { 0, std::numeric_limits<float>::max(), 1, 0 }; }
+        bool is_enabled() const override { return true; }
+
+        const char* get_description() const override { return _desc.c_str(); }
+    private:
+        std::shared_ptr<const std::atomic<uint64_t>> _counter;
+        std::string _desc;
+    };
+
     class LRS_EXTENSION_API option_base : public option
     {
     public:
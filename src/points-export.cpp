@@ -0,0 +1,379 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#include "points-export.h"
+#include "core/video.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+
+#define MIN_DISTANCE 1e-6
+
+namespace librealsense
+{
+    // Output is staged in blocks this large, so the file system sees few large writes
+    static const size_t EXPORT_BUFFER_SIZE = 4 << 20;
+
+    // Neighbouring depth pixels further apart than this are not connected by faces or used for normals
+    static const float EXPORT_EDGE_THRESHOLD = 0.05f;
+
+    class export_file
+    {
+    public:
+        explicit export_file(const std::string& fname)
+            : _fname(fname), _file(fopen(fname.c_str(), "wb")), _buffer(new uint8_t[EXPORT_BUFFER_SIZE])
+        {
+            if (!_file)
+                throw io_exception(to_string() << "Failed to open " << fname << " for writing");
+        }
+
+        ~export_file()
+        {
+            if (_file) fclose(_file);
+        }
+
+        void put(const void* data, size_t size)
+        {
+            if (_used + size > EXPORT_BUFFER_SIZE)
+                flush();
+            memcpy(_buffer.get() + _used, data, size);
+            _used += size;
+        }
+
+        void put(const std::string& text) { put(text.data(), text.size()); }
+
+        void close()
+        {
+            flush();
+            auto res = fclose(_file);
+            _file = nullptr;
+            if (res)
+                throw io_exception(to_string() << "Failed to write " << _fname);
+        }
+
+    private:
+        void flush()
+        {
+            if (_used && fwrite(_buffer.get(), 1, _used, _file) != _used)
+                throw io_exception(to_string() << "Failed to write " << _fname);
+            _used = 0;
+        }
+
+        std::string _fname;
+        FILE* _file;
+        std::unique_ptr<uint8_t[]> _buffer;
+        size_t _used = 0;
+    };
+
+    static bool has_depth(const float3& v)
+    {
+        return fabs(v.x) >= MIN_DISTANCE || fabs(v.y) >= MIN_DISTANCE || fabs(v.z) >= MIN_DISTANCE;
+    }
+
+    static void texcolor(const video_frame& texture, float u, float v, uint8_t* rgb)
+    {
+        const int w = texture.get_width(), h = texture.get_height();
+        int x = std::min(std::max(int(u*w + .5f), 0), w - 1);
+        int y = std::min(std::max(int(v*h + .5f), 0), h - 1);
+        auto texel = reinterpret_cast<const uint8_t*>(texture.get_frame_data()) + x * texture.get_bpp() / 8 + y * texture.get_stride();
+        rgb[0] = texel[0];
+        rgb[1] = texel[1];
+        rgb[2] = texel[2];
+    }
+
+    // Normal from the central differences of the depth image, pointing towards the camera. Neighbours
+    // across a depth edge are replaced by the point itself, isolated points get a zero normal
+    static void estimate_normals(const float3* vertices, const std::vector<int>& point_at, int width, int height,
+        std::vector<float3>& normals)
+    {
+        auto neighbour = [&](const float3& p, int x, int y) -> float3
+        {
+            if (x < 0 || y < 0 || x >= width || y >= height) return p;
+            auto i = point_at[y * width + x];
+            if (i < 0 || !vertices[i].z || std::abs(vertices[i].z - p.z) >= EXPORT_EDGE_THRESHOLD) return p;
+            return vertices[i];
+        };
+
+        for (int y = 0; y < height; ++y)
+        {
+            for (int x = 0; x < width; ++x)
+            {
+                auto i = point_at[y * width + x];
+                if (i < 0 || !vertices[i].z)
+                    continue;
+
+                auto& p = vertices[i];
+                auto h = neighbour(p, x + 1, y) - neighbour(p, x - 1, y);
+                auto v = neighbour(p, x, y + 1) - neighbour(p, x, y - 1);
+                float3 n = { h.y * v.z - h.z * v.y, h.z * v.x - h.x * v.z, h.x * v.y - h.y * v.x };
+                auto length = std::sqrt(n.x * n.x + n.y * n.y + n.z * n.z);
+                if (length <= 0.f)
+                    continue;
+                if (n.x * p.x + n.y * p.y + n.z * p.z > 0.f)
+                    length = -length;
+                normals[i] = n * (1.f / length);
+            }
+        }
+    }
+
+    void export_points(points& cloud, const frame_holder& texture, const std::string& fname,
+        rs2_points_file_format format, int flags)
+    {
+        auto video_stream_profile = dynamic_cast<video_stream_profile_interface*>(cloud.get_stream().get());
+        if (!video_stream_profile)
+            throw invalid_value_exception("stream must be video stream");
+        if (!is_valid(format))
+            throw invalid_value_exception(to_string() << "Unsupported points file format " << static_cast<int>(format));
+
+        const video_frame* colors = nullptr;
+        if ((flags & RS2_POINTS_EXPORT_COLORS) && texture)
+        {
+            colors = dynamic_cast<video_frame*>(texture.frame);
+            if (!colors)
+                throw invalid_value_exception("frame must be video frame");
+        }
+
+        const auto vertices = cloud.get_vertices();
+        const auto texcoords = cloud.get_texture_coordinates();
+        const auto count = cloud.get_vertex_count();
+        const auto width = video_stream_profile->get_width();
+        const auto height = video_stream_profile->get_height();
+        const bool ply = format == RS2_POINTS_FILE_FORMAT_PLY;
+        const bool drop_invalid = (flags & RS2_POINTS_EXPORT_DROP_INVALID) != 0;
+
+        // Depth pixel to point. Packed points keep their place in the depth image only through the pixel
+        // index channel, without it no faces or normals are written
+        std::vector<int> point_at;
+        bool organized = false;
+        if (auto indices = cloud.get_pixel_indices())
+        {
+            point_at.assign(width * height, -1);
+            for (size_t i = 0; i < count; ++i)
+                point_at[indices[i]] = static_cast<int>(i);
+        }
+        else if (count == size_t(width * height))
+        {
+            point_at.resize(width * height);
+            for (int i = 0; i < width * height; ++i)
+                point_at[i] = i;
+            organized = !drop_invalid;
+        }
+
+        // Position of every point in the file, -1 when it is dropped
+        std::vector<int> file_index(count);
+        int written = 0;
+        for (size_t i = 0; i < count; ++i)
+            file_index[i] = (!drop_invalid || has_depth(vertices[i])) ? written++ : -1;
+
+        std::vector<float3> normals;
+        if (flags & RS2_POINTS_EXPORT_NORMALS)
+        {
+            normals.assign(count, { 0.f, 0.f, 0.f });
+            if (!point_at.empty())
+                estimate_normals(vertices, point_at, width, height, normals);
+        }
+
+        std::vector<int> faces;
+        if (ply && (flags & RS2_POINTS_EXPORT_FACES) && !point_at.empty())
+        {
+            for (int x = 0; x < width - 1; ++x)
+            {
+                for (int y = 0; y < height - 1; ++y)
+                {
+                    auto a = point_at[y * width + x], b = point_at[y * width + x + 1], c = point_at[(y + 1)*width + x], d = point_at[(y + 1)*width + x + 1];
+                    if (a < 0 || b < 0 || c < 0 || d < 0)
+                        continue;
+                    if (vertices[a].z && vertices[b].z && vertices[c].z && vertices[d].z
+                        && std::abs(vertices[a].z - vertices[b].z) < EXPORT_EDGE_THRESHOLD && std::abs(vertices[a].z - vertices[c].z) < EXPORT_EDGE_THRESHOLD
+                        && std::abs(vertices[b].z - vertices[d].z) < EXPORT_EDGE_THRESHOLD && std::abs(vertices[c].z - vertices[d].z) < EXPORT_EDGE_THRESHOLD)
+                    {
+                        if (file_index[a] < 0 || file_index[b] < 0 || file_index[c] < 0 || file_index[d] < 0)
+                            continue;
+
+                        int quad[] = { file_index[a], file_index[d], file_index[b], file_index[d], file_index[a], file_index[c] };
+                        faces.insert(faces.end(), std::begin(quad), std::end(quad));
+                    }
+                }
+            }
+        }
+
+        std::stringstream header;
+        if (ply)
+        {
+            header << "ply\n";
+            header << "format binary_little_endian 1.0\n";
+            header << "comment pointcloud saved from Realsense Viewer\n";
+            header << "element vertex " << written << "\n";
+            header << "property float32 x\nproperty float32 y\nproperty float32 z\n";
+            if (!normals.empty())
+                header << "property float32 nx\nproperty float32 ny\nproperty float32 nz\n";
+            if (colors)
+                header << "property uchar red\nproperty uchar green\nproperty uchar blue\n";
+            if (flags & RS2_POINTS_EXPORT_FACES)
+            {
+                header << "element face " << faces.size() / 3 << "\n";
+                header << "property list uchar int vertex_indices\n";
+            }
+            header << "end_header\n";
+        }
+        else
+        {
+            header << "# .PCD v0.7 - Point Cloud Data file format\n";
+            header << "VERSION 0.7\n";
+            header << "FIELDS x y z" << (normals.empty() ? "" : " normal_x normal_y normal_z") << (colors ? " rgb" : "") << "\n";
+            header << "SIZE 4 4 4" << (normals.empty() ? "" : " 4 4 4") << (colors ? " 4" : "") << "\n";
+            header << "TYPE F F F" << (normals.empty() ? "" : " F F F") << (colors ? " U" : "") << "\n";
+            header << "COUNT 1 1 1" << (normals.empty() ? "" : " 1 1 1") << (colors ? " 1" : "") << "\n";
+            header << "WIDTH " << (organized ? width : written) << "\n";
+            header << "HEIGHT " << (organized ? height : 1) << "\n";
+            header << "VIEWPOINT 0 0 0 1 0 0 0\n";
+            header << "POINTS " << written << "\n";
+            header << "DATA binary\n";
+        }
+
+        export_file out(fname);
+        out.put(header.str());
+
+        // PLY keeps the viewer's y up, z towards the viewer convention, PCD the camera's own axes.
+        // PCD marks points without depth as NaN, PCL's convention for organized clouds
+        const float flip = ply ? -1.f : 1.f;
+        const auto nan = std::numeric_limits<float>::quiet_NaN();
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (file_index[i] < 0)
+                continue;
+
+            // we assume little endian architecture on your device
+            float record[7];
+            int fields = 0;
+            auto& v = vertices[i];
+            if (!ply && !has_depth(v))
+            {
+                record[fields++] = nan;
+                record[fields++] = nan;
+                record[fields++] = nan;
+            }
+            else
+            {
+                record[fields++] = v.x;
+                record[fields++] = flip * v.y;
+                record[fields++] = flip * v.z;
+            }
+            if (!normals.empty())
+            {
+                record[fields++] = normals[i].x;
+                record[fields++] = flip * normals[i].y;
+                record[fields++] = flip * normals[i].z;
+            }
+            size_t size = fields * sizeof(float);
+            if (colors)
+            {
+                uint8_t rgb[3];
+                texcolor(*colors, texcoords[i].x, texcoords[i].y, rgb);
+                auto bytes = reinterpret_cast<uint8_t*>(record) + size;
+                if (ply)
+                {
+                    memcpy(bytes, rgb, 3);
+                    size += 3;
+                }
+                else
+                {
+                    uint32_t packed = (uint32_t(rgb[0]) << 16) | (uint32_t(rgb[1]) << 8) | rgb[2];
+                    memcpy(bytes, &packed, sizeof(packed));
+                    size += sizeof(packed);
+                }
+            }
+            out.put(record, size);
+        }
+
+        for (size_t f = 0; f < faces.size(); f += 3)
+        {
+            uint8_t record[1 + 3 * sizeof(int)];
+            record[0] = 3;
+            memcpy(record + 1, &faces[f], 3 * sizeof(int));
+            out.put(record, sizeof(record));
+        }
+        out.close();
+    }
+
+    points_exporter::points_exporter(const std::string& prefix, rs2_points_file_format format, int flags, size_t capacity)
+        : _prefix(prefix), _format(format), _flags(flags), _capacity(std::max(size_t(1), capacity)),
+        _writer([this]() { run(); })
+    {}
+
+    points_exporter::~points_exporter()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stopping = true;
+        }
+        _queued.notify_all();
+        _writer.join();
+    }
+
+    void points_exporter::enqueue(frame_holder cloud, frame_holder texture)
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _written.wait(lock, [this]() { return _jobs.size() < _capacity; });
+        _jobs.push_back({ std::move(cloud), std::move(texture) });
+        lock.unlock();
+        _queued.notify_one();
+    }
+
+    void points_exporter::flush()
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _written.wait(lock, [this]() { return _jobs.empty() && !_writing; });
+        if (!_error.empty())
+        {
+            auto error = _error;
+            _error.clear();
+            throw io_exception(error);
+        }
+    }
+
+    void points_exporter::run()
+    {
+        // Frames still queued when the exporter is destroyed are written before the thread ends
+        while (true)
+        {
+            job next;
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _queued.wait(lock, [this]() { return !_jobs.empty() || _stopping; });
+                if (_jobs.empty())
+                    return;
+                next = std::move(_jobs.front());
+                _jobs.pop_front();
+                ++_writing;
+            }
+
+            std::string error;
+            try
+            {
+                auto cloud = dynamic_cast<points*>(next.cloud.frame);
+                if (!cloud)
+                    throw invalid_value_exception("frame must be points frame");
+
+                std::stringstream fname;
+                fname << _prefix << cloud->get_frame_number() << (_format == RS2_POINTS_FILE_FORMAT_PLY ? ".ply" : ".pcd");
+                export_points(*cloud, next.texture, fname.str(), _format, _flags);
+            }
+            catch (const std::exception& e)
+            {
+                error = e.what();
+            }
+            next = job();
+
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                if (_error.empty())
+                    _error = error;
+                --_writing;
+            }
+            _written.notify_all();
+        }
+    }
+}
@@ -0,0 +1,55 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "archive.h"
+
+#include <condition_variable>
+#include <deque>
+#include <thread>
+
+namespace librealsense
+{
+    // Writes a points frame to a binary little endian PLY or PCD file. flags combine rs2_points_export_flags,
+    // colors are sampled from texture when it is set
+    void export_points(points& cloud, const frame_holder& texture, const std::string& fname,
+        rs2_points_file_format format, int flags);
+
+    // Exports points frames on a writer thread. Frames queue up to the capacity, beyond it enqueue blocks
+    // so no frame is lost, and a failed write is reported by the next flush
+    class points_exporter
+    {
+    public:
+        points_exporter(const std::string& prefix, rs2_points_file_format format, int flags, size_t capacity);
+        ~points_exporter();
+
+        void enqueue(frame_holder cloud, frame_holder texture);
+
+        // Waits until every queued frame is written and rethrows the first write error since the last flush
+        void flush();
+
+    private:
+        struct job
+        {
+            frame_holder cloud;
+            frame_holder texture;
+        };
+
+        void run();
+
+        std::string _prefix;
+        rs2_points_file_format _format;
+        int _flags;
+        size_t _capacity;
+
+        std::mutex _mutex;
+        std::condition_variable _queued;    // A job was queued or the exporter is stopping
+        std::condition_variable _written;   // A job was written
+        std::deque<job> _jobs;
+        size_t _writing = 0;
+        bool _stopping = false;
+        std::string _error;
+        std::thread _writer;
+    };
+}
@@ -64,6 +64,20 @@ namespace librealsense
     align::align(rs2_stream to_stream) : align(to_stream, "Align")
     {}
 
+    void align_z_to_other(byte * z_aligned_to_other, const uint16_t * z_pixels, float z_scale, const rs2_intrinsics & z_intrin,
+        const rs2_extrinsics & z_to_other, const rs2_intrinsics & other_intrin)
+    {
+        auto out_z = (uint16_t *)(z_aligned_to_other);
+        align_images(z_intrin, z_to_other, other_intrin,
+            [z_pixels, z_scale](int z_pixel_index) { return z_scale * z_pixels[z_pixel_index]; },
+            [out_z, z_pixels](int z_pixel_index, int other_pixel_index)
+        {
+            out_z[other_pixel_index] = out_z[other_pixel_index] ?
+                std::min((int)out_z[other_pixel_index], (int)z_pixels[z_pixel_index]) :
+                z_pixels[z_pixel_index];
+        });
+    }
+
     void align::align_z_to_other(rs2::video_frame& aligned, 
         const rs2::video_frame& depth, const rs2::video_stream_profile& other_profile, float z_scale)
     {
@@ -78,16 +92,8 @@ namespace librealsense
         auto z_to_other = depth_profile.get_extrinsics_to(other_profile);
 
         auto z_pixels = reinterpret_cast<const uint16_t*>(depth.get_data());
-        auto out_z = (uint16_t *)(aligned_data);
 
-        align_images(z_intrin, z_to_other, other_intrin,
-            [z_pixels, z_scale](int z_pixel_index) { return z_scale * z_pixels[z_pixel_index]; },
-            [out_z, z_pixels](int z_pixel_index, int other_pixel_index)
-        {
-            out_z[other_pixel_index] = out_z[other_pixel_index] ?
-                std::min((int)out_z[other_pixel_index], (int)z_pixels[z_pixel_index]) :
-                z_pixels[z_pixel_index];
-        });
+        librealsense::align_z_to_other(aligned_data, z_pixels, z_scale, z_intrin, z_to_other, other_intrin);
     }
 
     template<int N, class GET_DEPTH>
@@ -124,6 +130,13 @@ namespace librealsense
         }
     }
 
+    void align_other_to_z(byte * other_aligned_to_z, const uint16_t * z_pixels, float z_scale, const rs2_intrinsics & z_intrin,
+        const rs2_extrinsics & z_to_other, const rs2_intrinsics & other_intrin, const byte * other_pixels, rs2_format other_format)
+    {
+        align_other_to_depth(other_aligned_to_z, [z_pixels, z_scale](int z_pixel_index) { return z_scale * z_pixels[z_pixel_index]; },
+            z_intrin, z_to_other, other_intrin, other_pixels, other_format);
+    }
+
     void align::align_other_to_z(rs2::video_frame& aligned, const rs2::video_frame& depth, const rs2::video_frame& other, float z_scale)
     {
         byte* aligned_data = reinterpret_cast<byte*>(const_cast<void*>(aligned.get_data()));
@@ -140,8 +153,36 @@ namespace librealsense
         auto z_pixels = reinterpret_cast<const uint16_t*>(depth.get_data());
         auto other_pixels = reinterpret_cast<const byte*>(other.get_data());
 
-        align_other_to_depth(aligned_data, [z_pixels, z_scale](int z_pixel_index) { return z_scale * z_pixels[z_pixel_index]; },
-            z_intrin, z_to_other, other_intrin, other_pixels, other_profile.format());
+        librealsense::align_other_to_z(aligned_data, z_pixels, z_scale, z_intrin, z_to_other, other_intrin, other_pixels, other_profile.format());
+    }
+
+    size_t align::get_cache_size() const
+    {
+        size_t size = 0;
+        for (auto&& t : _transforms)
+            size += t.second->size_bytes();
+        return size;
+    }
+
+    void align::reset_cache(rs2_stream from, rs2_stream to)
+    {
+        _transforms.clear();
+    }
+
+    align_transform* align::find_transform(stream_profile_interface* depth_profile, const rs2_intrinsics& depth, float depth_scale) const
+    {
+        auto it = _transforms.find(depth_profile);
+        if (it == _transforms.end() || !it->second->matches(depth, depth_scale))
+            return nullptr;
+        return it->second.get();
+    }
+
+    align_transform& align::cache_transform(stream_profile_interface* depth_profile, std::shared_ptr<align_transform> transform)
+    {
+        _transforms[depth_profile] = transform;
+        LOG_DEBUG(get_info(RS2_CAMERA_INFO_NAME) << " cached a transform of " << transform->size_bytes()
+            << " bytes, " << get_cache_size() << " bytes in all");
+        return *transform;
     }
 
     std::shared_ptr<rs2::video_stream_profile> align::create_aligned_profile(
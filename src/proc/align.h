@@ -12,11 +12,32 @@
 
 namespace librealsense
 {
+    // Reference (scalar) implementations behind align, the aligned image must be zeroed by the caller
+    void align_z_to_other(byte* z_aligned_to_other, const uint16_t* z_pixels, float z_scale, const rs2_intrinsics& z_intrin,
+        const rs2_extrinsics& z_to_other, const rs2_intrinsics& other_intrin);
+
+    void align_other_to_z(byte* other_aligned_to_z, const uint16_t* z_pixels, float z_scale, const rs2_intrinsics& z_intrin,
+        const rs2_extrinsics& z_to_other, const rs2_intrinsics& other_intrin, const byte* other_pixels, rs2_format other_format);
+
+    // Calibration-only state of a vectorized align, chiefly the corners of every depth pixel deprojected at
+    // unit depth. It depends on the depth profile alone, so align keeps one per depth profile across frames
+    class align_transform
+    {
+    public:
+        virtual ~align_transform() = default;
+
+        virtual bool matches(const rs2_intrinsics& depth, float depth_scale) const = 0;
+        virtual size_t size_bytes() const = 0;
+    };
+
     class LRS_EXTENSION_API align : public generic_processing_block
     {
     public:
         align(rs2_stream to_stream);
 
+        // Memory held by the transforms cached since the last reset_cache
+        size_t get_cache_size() const;
+
     protected:
         align(rs2_stream to_stream, const char* name)
             : generic_processing_block(name), 
@@ -26,7 +47,12 @@ namespace librealsense
         bool should_process(const rs2::frame& frame) override;
         rs2::frame process_frame(const rs2::frame_source& source, const rs2::frame& f) override;
 
-        virtual void reset_cache(rs2_stream from, rs2_stream to) {}
+        // Drops the cached transforms
+        virtual void reset_cache(rs2_stream from, rs2_stream to);
+
+        // The transform cached for the depth profile, nullptr when none was built for its current calibration
+        align_transform* find_transform(stream_profile_interface* depth_profile, const rs2_intrinsics& depth, float depth_scale) const;
+        align_transform& cache_transform(stream_profile_interface* depth_profile, std::shared_ptr<align_transform> transform);
 
         virtual void align_z_to_other(rs2::video_frame& aligned, 
                                       const rs2::video_frame& depth, 
@@ -50,6 +76,8 @@ namespace librealsense
         float _depth_scale;
 
     private:
+        std::map<stream_profile_interface*, std::shared_ptr<align_transform>> _transforms;
+
         rs2::video_frame allocate_aligned_frame(const rs2::frame_source& source, const rs2::video_frame& from, const rs2::video_frame& to);
         void align_frames(rs2::video_frame& aligned, const rs2::video_frame& from, const rs2::video_frame& to);
     };
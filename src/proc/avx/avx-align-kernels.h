@@ -0,0 +1,30 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include <cstdint>
+
+// Kept free of library headers, the kernels are built with -mavx2 / -mavx512f and must not
+// instantiate inline code that the rest of the library could end up sharing
+namespace librealsense
+{
+    // Depth to other-image projection, flattened from rs2_extrinsics / rs2_intrinsics
+    struct align_projection
+    {
+        float depth_scale;
+        float rotation[9];
+        float translation[3];
+        float fx, fy, ppx, ppy;
+        float coeffs[5];
+        bool distort;           // Apply the (modified / inverse) Brown-Conrady model of the other image
+    };
+
+    // Projects depth pixels onto the other image, given the deprojection of each pixel at unit depth
+    // (map_x, map_y). Follows the operation order of rsutil.h so the results match the scalar align
+    // exactly. Return the number of leading pixels processed, the caller finishes the rest
+    int project_to_other_avx2(const uint16_t * z_pixels, const float * map_x, const float * map_y, int count,
+        const align_projection & p, int * other_x, int * other_y);
+    int project_to_other_avx512(const uint16_t * z_pixels, const float * map_x, const float * map_y, int count,
+        const align_projection & p, int * other_x, int * other_y);
+}
@@ -0,0 +1,306 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#include "avx-align.h"
+#include "avx-align-kernels.h"
+#include "../include/librealsense2/hpp/rs_sensor.hpp"
+#include "../include/librealsense2/hpp/rs_processing.hpp"
+#include "../include/librealsense2/rsutil.h"
+
+#include "core/video.h"
+#include "cpu-dispatch.h"
+#include "stream.h"
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+
+using namespace librealsense;
+
+namespace
+{
+    template<int N> struct bytes { byte b[N]; };
+
+    // Depth rows per band, enough to amortize the hand-off to the pool
+    const int MIN_BAND_ROWS = 16;
+
+    typedef int(*project_function)(const uint16_t * z_pixels, const float * map_x, const float * map_y, int count,
+        const align_projection & p, int * other_x, int * other_y);
+
+    // Picks the widest kernel for the current dispatch level, nullptr when projection has to stay scalar
+    project_function select_kernel(const rs2_intrinsics& to)
+    {
+        // The kernels implement the no-op and the (modified / inverse) Brown-Conrady projections of rsutil.h
+        if (to.model == RS2_DISTORTION_FTHETA || to.model == RS2_DISTORTION_KANNALA_BRANDT4)
+            return nullptr;
+
+        auto level = get_simd_level();
+#ifdef RS2_HAVE_AVX512_ALIGN
+        if (level >= simd_level::avx512)
+            return project_to_other_avx512;
+#endif
+#ifdef RS2_HAVE_AVX2_ALIGN
+        if (level >= simd_level::avx2)
+            return project_to_other_avx2;
+#endif
+        return nullptr;
+    }
+
+    align_projection make_projection(float depth_scale, const rs2_intrinsics& to, const rs2_extrinsics& from_to_other)
+    {
+        align_projection p;
+        p.depth_scale = depth_scale;
+        std::copy(std::begin(from_to_other.rotation), std::end(from_to_other.rotation), p.rotation);
+        std::copy(std::begin(from_to_other.translation), std::end(from_to_other.translation), p.translation);
+        p.fx = to.fx;
+        p.fy = to.fy;
+        p.ppx = to.ppx;
+        p.ppy = to.ppy;
+        std::copy(std::begin(to.coeffs), std::end(to.coeffs), p.coeffs);
+        p.distort = to.model == RS2_DISTORTION_MODIFIED_BROWN_CONRADY || to.model == RS2_DISTORTION_INVERSE_BROWN_CONRADY;
+        return p;
+    }
+
+    // Same steps as align_images, with the deprojection at unit depth taken from the map
+    inline void project_pixel(float depth, float map_x, float map_y, const rs2_intrinsics& to,
+        const rs2_extrinsics& from_to_other, int* other_x, int* other_y)
+    {
+        float depth_point[3] = { depth * map_x, depth * map_y, depth }, other_point[3], other_pixel[2];
+        rs2_transform_point_to_point(other_point, &from_to_other, depth_point);
+        rs2_project_point_to_pixel(other_pixel, &to, other_point);
+        *other_x = static_cast<int>(other_pixel[0] + 0.5f);
+        *other_y = static_cast<int>(other_pixel[1] + 0.5f);
+    }
+}
+
+image_transform_avx::image_transform_avx(const rs2_intrinsics& from, float depth_scale, thread_pool& pool)
+    : _depth(from),
+    _depth_scale(depth_scale),
+    _pool(pool),
+    _top_left_x(from.width * from.height),
+    _top_left_y(from.width * from.height),
+    _bottom_right_x(from.width * from.height),
+    _bottom_right_y(from.width * from.height),
+    _row_span(from.height)
+{
+    pre_compute_x_y_map(_pre_compute_map_x_top_left, _pre_compute_map_y_top_left, -0.5f);
+    pre_compute_x_y_map(_pre_compute_map_x_bottom_right, _pre_compute_map_y_bottom_right, 0.5f);
+}
+
+bool image_transform_avx::matches(const rs2_intrinsics& from, float depth_scale) const
+{
+    return depth_scale == _depth_scale && !memcmp(&from, &_depth, sizeof(rs2_intrinsics));
+}
+
+size_t image_transform_avx::size_bytes() const
+{
+    return (_pre_compute_map_x_top_left.size() + _pre_compute_map_y_top_left.size() +
+        _pre_compute_map_x_bottom_right.size() + _pre_compute_map_y_bottom_right.size()) * sizeof(float) +
+        (_top_left_x.size() + _top_left_y.size() + _bottom_right_x.size() + _bottom_right_y.size()) * sizeof(int) +
+        _row_span.size() * sizeof(int2);
+}
+
+void image_transform_avx::pre_compute_x_y_map(std::vector<float>& pre_compute_map_x,
+    std::vector<float>& pre_compute_map_y,
+    float offset)
+{
+    pre_compute_map_x.resize(_depth.width * _depth.height);
+    pre_compute_map_y.resize(_depth.width * _depth.height);
+
+    for (int h = 0; h < _depth.height; ++h)
+    {
+        for (int w = 0; w < _depth.width; ++w)
+        {
+            // Deprojecting at depth 1 keeps depth * map bit-identical to deprojecting at the actual depth,
+            // for every model rs2_deproject_pixel_to_point supports
+            const float pixel[] = { w + offset, h + offset };
+            float point[3];
+            rs2_deproject_pixel_to_point(point, &_depth, pixel, 1.f);
+
+            pre_compute_map_x[h * _depth.width + w] = point[0];
+            pre_compute_map_y[h * _depth.width + w] = point[1];
+        }
+    }
+}
+
+void image_transform_avx::project_rows(const uint16_t* z_pixels, int begin, int end,
+    const rs2_intrinsics& to, const rs2_extrinsics& from_to_other)
+{
+    auto first = begin * _depth.width;
+    auto count = (end - begin) * _depth.width;
+
+    int done = 0;
+    if (auto kernel = select_kernel(to))
+    {
+        auto p = make_projection(_depth_scale, to, from_to_other);
+        done = kernel(z_pixels + first, _pre_compute_map_x_top_left.data() + first, _pre_compute_map_y_top_left.data() + first,
+            count, p, _top_left_x.data() + first, _top_left_y.data() + first);
+        kernel(z_pixels + first, _pre_compute_map_x_bottom_right.data() + first, _pre_compute_map_y_bottom_right.data() + first,
+            count, p, _bottom_right_x.data() + first, _bottom_right_y.data() + first);
+    }
+
+    for (auto i = first + done; i < first + count; ++i)
+    {
+        if (!z_pixels[i])
+            continue;
+
+        auto depth = _depth_scale * z_pixels[i];
+        project_pixel(depth, _pre_compute_map_x_top_left[i], _pre_compute_map_y_top_left[i], to, from_to_other,
+            &_top_left_x[i], &_top_left_y[i]);
+        project_pixel(depth, _pre_compute_map_x_bottom_right[i], _pre_compute_map_y_bottom_right[i], to, from_to_other,
+            &_bottom_right_x[i], &_bottom_right_y[i]);
+    }
+}
+
+inline bool image_transform_avx::is_valid(const uint16_t* z_pixels, int depth_pixel_index, const rs2_intrinsics& to) const
+{
+    // Pixels without depth, or whose footprint leaves the other image, are skipped like in align_images
+    return z_pixels[depth_pixel_index] &&
+        _top_left_x[depth_pixel_index] >= 0 && _top_left_y[depth_pixel_index] >= 0 &&
+        _bottom_right_x[depth_pixel_index] < to.width && _bottom_right_y[depth_pixel_index] < to.height;
+}
+
+void image_transform_avx::align_depth_to_other(const uint16_t* z_pixels, uint16_t* dest,
+    const rs2_intrinsics& to, const rs2_extrinsics& from_to_other)
+{
+    // Footprints of different depth rows overlap on the other image, so the projection is split by
+    // depth rows and the transfer by rows of the other image. Keeping the nearest depth is order
+    // independent, which leaves the result identical to the single-threaded scan
+    _pool.parallel_for(_depth.height, [&](int begin, int end)
+    {
+        project_rows(z_pixels, begin, end, to, from_to_other);
+
+        for (int y = begin; y < end; ++y)
+        {
+            int2 span = { std::numeric_limits<int>::max(), std::numeric_limits<int>::min() };
+            for (int i = y * _depth.width; i < (y + 1) * _depth.width; ++i)
+            {
+                if (!is_valid(z_pixels, i, to))
+                    continue;
+                span.x = std::min(span.x, _top_left_y[i]);
+                span.y = std::max(span.y, _bottom_right_y[i]);
+            }
+            _row_span[y] = span;
+        }
+    }, MIN_BAND_ROWS);
+
+    _pool.parallel_for(to.height, [&](int begin, int end)
+    {
+        for (int y = 0; y < _depth.height; ++y)
+        {
+            if (_row_span[y].y < begin || _row_span[y].x >= end)
+                continue;
+
+            for (int i = y * _depth.width; i < (y + 1) * _depth.width; ++i)
+            {
+                if (!is_valid(z_pixels, i, to))
+                    continue;
+
+                auto z = z_pixels[i];
+                auto other_y1 = std::min(_bottom_right_y[i], end - 1);
+                for (int other_y = std::max(_top_left_y[i], begin); other_y <= other_y1; ++other_y)
+                {
+                    for (int other_x = _top_left_x[i]; other_x <= _bottom_right_x[i]; ++other_x)
+                    {
+                        auto& out = dest[other_y * to.width + other_x];
+                        out = out ? std::min(out, z) : z;
+                    }
+                }
+            }
+        }
+    }, MIN_BAND_ROWS);
+}
+
+template<class T>
+void image_transform_avx::move_other_to_depth(const uint16_t* z_pixels, const T* source, T* dest,
+    const rs2_intrinsics& to, int begin, int end)
+{
+    for (int i = begin * _depth.width; i < end * _depth.width; ++i)
+    {
+        if (!is_valid(z_pixels, i, to))
+            continue;
+
+        // align_images visits the whole footprint and the last pixel written wins, which is its bottom-right corner
+        if (_top_left_x[i] <= _bottom_right_x[i] && _top_left_y[i] <= _bottom_right_y[i])
+            dest[i] = source[_bottom_right_y[i] * to.width + _bottom_right_x[i]];
+    }
+}
+
+void image_transform_avx::align_other_to_depth(const uint16_t* z_pixels, const byte* source, byte* dest, rs2_format format,
+    const rs2_intrinsics& to, const rs2_extrinsics& from_to_other)
+{
+    // Every depth pixel writes only to itself, so bands are independent end to end
+    _pool.parallel_for(_depth.height, [&](int begin, int end)
+    {
+        project_rows(z_pixels, begin, end, to, from_to_other);
+
+        switch (format)
+        {
+        case RS2_FORMAT_Y8:
+            move_other_to_depth(z_pixels, reinterpret_cast<const bytes<1>*>(source), reinterpret_cast<bytes<1>*>(dest), to, begin, end);
+            break;
+        case RS2_FORMAT_Y16:
+        case RS2_FORMAT_Z16:
+            move_other_to_depth(z_pixels, reinterpret_cast<const bytes<2>*>(source), reinterpret_cast<bytes<2>*>(dest), to, begin, end);
+            break;
+        case RS2_FORMAT_RGB8:
+        case RS2_FORMAT_BGR8:
+            move_other_to_depth(z_pixels, reinterpret_cast<const bytes<3>*>(source), reinterpret_cast<bytes<3>*>(dest), to, begin, end);
+            break;
+        case RS2_FORMAT_RGBA8:
+        case RS2_FORMAT_BGRA8:
+            move_other_to_depth(z_pixels, reinterpret_cast<const bytes<4>*>(source), reinterpret_cast<bytes<4>*>(dest), to, begin, end);
+            break;
+        default:
+            assert(false); // Same formats as align_other_to_depth in align.cpp
+        }
+    }, MIN_BAND_ROWS);
+}
+
+align_avx::align_avx(rs2_stream to_stream)
+    : align(to_stream, "Align (AVX)")
+{}
+
+image_transform_avx& align_avx::get_transform(stream_profile_interface* depth_profile, const rs2_intrinsics& depth, float z_scale)
+{
+    if (auto cached = find_transform(depth_profile, depth, z_scale))
+        return static_cast<image_transform_avx&>(*cached);
+    return static_cast<image_transform_avx&>(cache_transform(depth_profile,
+        std::make_shared<image_transform_avx>(depth, z_scale, get_processing_pool())));
+}
+
+void align_avx::align_z_to_other(rs2::video_frame& aligned, const rs2::video_frame& depth, const rs2::video_stream_profile& other_profile, float z_scale)
+{
+    byte* aligned_data = reinterpret_cast<byte*>(const_cast<void*>(aligned.get_data()));
+    auto aligned_profile = aligned.get_profile().as<rs2::video_stream_profile>();
+    memset(aligned_data, 0, aligned_profile.height() * aligned_profile.width() * aligned.get_bytes_per_pixel());
+
+    auto depth_profile = depth.get_profile().as<rs2::video_stream_profile>();
+
+    auto z_intrin = depth_profile.get_intrinsics();
+    auto other_intrin = other_profile.get_intrinsics();
+    auto z_to_other = depth_profile.get_extrinsics_to(other_profile);
+
+    auto z_pixels = reinterpret_cast<const uint16_t*>(depth.get_data());
+
+    get_transform(depth_profile.get()->profile, z_intrin, z_scale).align_depth_to_other(z_pixels, reinterpret_cast<uint16_t*>(aligned_data), other_intrin, z_to_other);
+}
+
+void align_avx::align_other_to_z(rs2::video_frame& aligned, const rs2::video_frame& depth, const rs2::video_frame& other, float z_scale)
+{
+    byte* aligned_data = reinterpret_cast<byte*>(const_cast<void*>(aligned.get_data()));
+    auto aligned_profile = aligned.get_profile().as<rs2::video_stream_profile>();
+    memset(aligned_data, 0, aligned_profile.height() * aligned_profile.width() * aligned.get_bytes_per_pixel());
+
+    auto depth_profile = depth.get_profile().as<rs2::video_stream_profile>();
+    auto other_profile = other.get_profile().as<rs2::video_stream_profile>();
+
+    auto z_intrin = depth_profile.get_intrinsics();
+    auto other_intrin = other_profile.get_intrinsics();
+    auto z_to_other = depth_profile.get_extrinsics_to(other_profile);
+
+    auto z_pixels = reinterpret_cast<const uint16_t*>(depth.get_data());
+    auto other_pixels = reinterpret_cast<const byte*>(other.get_data());
+
+    get_transform(depth_profile.get()->profile, z_intrin, z_scale).align_other_to_depth(z_pixels, other_pixels, aligned_data, other_profile.format(), other_intrin, z_to_other);
+}
@@ -0,0 +1,76 @@
+/* License: Apache 2.0. See LICENSE file in root directory. */
+/* Copyright(c) 2019 Intel Corporation. All Rights Reserved. */
+#pragma once
+
+#include "proc/align.h"
+#include "concurrency.h"
+
+namespace librealsense
+{
+    // Multithreaded counterpart of image_transform that reproduces the scalar align pixel for pixel.
+    // The depth image is split into row bands, each band projects the corners of its pixels with the
+    // widest kernel get_simd_level() allows (AVX-512 / AVX2, scalar for the remainder and for
+    // distortion models the kernels do not cover) and then transfers the pixels
+    class image_transform_avx : public align_transform
+    {
+    public:
+        image_transform_avx(const rs2_intrinsics& from, float depth_scale, thread_pool& pool);
+
+        // Both expect dest to be zeroed, as the scalar align_z_to_other / align_other_to_z do
+        void align_depth_to_other(const uint16_t* z_pixels, uint16_t* dest,
+            const rs2_intrinsics& to, const rs2_extrinsics& from_to_other);
+
+        void align_other_to_depth(const uint16_t* z_pixels, const byte* source, byte* dest, rs2_format format,
+            const rs2_intrinsics& to, const rs2_extrinsics& from_to_other);
+
+        bool matches(const rs2_intrinsics& from, float depth_scale) const override;
+        size_t size_bytes() const override;
+
+    private:
+        const rs2_intrinsics _depth;
+        float _depth_scale;
+        thread_pool& _pool;
+
+        // Deprojection of the top-left / bottom-right corner of every depth pixel at unit depth
+        std::vector<float> _pre_compute_map_x_top_left;
+        std::vector<float> _pre_compute_map_y_top_left;
+        std::vector<float> _pre_compute_map_x_bottom_right;
+        std::vector<float> _pre_compute_map_y_bottom_right;
+
+        // Corners projected onto the other image, per depth pixel
+        std::vector<int> _top_left_x;
+        std::vector<int> _top_left_y;
+        std::vector<int> _bottom_right_x;
+        std::vector<int> _bottom_right_y;
+
+        // Range of other-image rows written by each depth row, empty when x > y
+        std::vector<int2> _row_span;
+
+        void pre_compute_x_y_map(std::vector<float>& pre_compute_map_x,
+            std::vector<float>& pre_compute_map_y,
+            float offset);
+
+        void project_rows(const uint16_t* z_pixels, int begin, int end,
+            const rs2_intrinsics& to, const rs2_extrinsics& from_to_other);
+
+        bool is_valid(const uint16_t* z_pixels, int depth_pixel_index, const rs2_intrinsics& to) const;
+
+        template<class T>
+        void move_other_to_depth(const uint16_t* z_pixels, const T* source, T* dest, const rs2_intrinsics& to,
+            int begin, int end);
+    };
+
+    class align_avx : public align
+    {
+    public:
+        align_avx(rs2_stream to_stream);
+
+    protected:
+        void align_z_to_other(rs2::video_frame& aligned, const rs2::video_frame& depth, const rs2::video_stream_profile& other_profile, float z_scale) override;
+
+        void align_other_to_z(rs2::video_frame& aligned, const rs2::video_frame& depth, const rs2::video_frame& other, float z_scale) override;
+
+    private:
+        image_transform_avx& get_transform(stream_profile_interface* depth_profile, const rs2_intrinsics& depth, float z_scale);
+    };
+}
@@ -0,0 +1,17 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Plain-data interface for the same reason as avx-align-kernels.h
+namespace librealsense
+{
+    // Median of the non-zero values of every scale x scale block (scale 2 or 3) along one output row, block
+    // pointing at the first block and stride being the input row width. Picks the lower middle value for even
+    // counts and 0 for empty blocks, like the median networks of decimation_filter.
+    // Returns the number of leading outputs processed
+    int decimate_depth_median_avx2(const uint16_t * block, size_t stride, int scale, int count, uint16_t * out);
+}
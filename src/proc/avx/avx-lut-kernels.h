@@ -0,0 +1,16 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Plain-data interface for the same reason as avx-align-kernels.h
+namespace librealsense
+{
+    // Lookups of 16 bit values in tables of 65536 entries, through gathers of 8 entries. Every gather reads
+    // 32 bits, so the 16 bit table needs one entry of padding. Return the number of leading values processed
+    size_t lookup_u16_avx2(const uint16_t * in, const uint16_t * table, uint16_t * out, size_t count);
+    size_t lookup_float_avx2(const uint16_t * in, const float * table, float * out, size_t count);
+}
@@ -0,0 +1,35 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include <cstdint>
+
+// Plain-data interface for the same reason as avx-align-kernels.h
+namespace librealsense
+{
+    // Point to texture projection, flattened from rs2_extrinsics / rs2_intrinsics
+    struct texture_projection
+    {
+        // modified_brown_conrady stands for the polynomial rsutil.h applies to both the modified and inverse models
+        enum distortion { none, modified_brown_conrady, ftheta, kannala_brandt4 };
+
+        float rotation[9];
+        float translation[3];
+        float fx, fy, ppx, ppy;
+        float width, height;
+        float coeffs[5];
+        distortion model;       // How rs2_project_point_to_pixel distorts points for the other image
+    };
+
+    // Writes depth_scale * z * (map_x, map_y, 1) as interleaved xyz, bit-identical to rs2_deproject_pixel_to_point
+    // given maps deprojected at unit depth. Returns the number of leading pixels processed
+    int deproject_depth_avx2(const uint16_t * z_pixels, const float * map_x, const float * map_y, int count,
+        float depth_scale, float * points);
+
+    // Projects interleaved xyz points onto the other image, writing pixel and normalized texture
+    // coordinates (zero where z is zero). Follows the operation order of rsutil.h, so everything but the
+    // F-Theta and Kannala-Brandt models, which need an arctangent, matches the scalar path exactly.
+    // Returns the number of leading points processed
+    int texture_map_avx2(const float * points, int count, const texture_projection & p, float * pixels, float * texcoords);
+}
@@ -0,0 +1,154 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#include "../include/librealsense2/rs.hpp"
+#include "../include/librealsense2/rsutil.h"
+
+#include "proc/synthetic-stream.h"
+#include "proc/avx/avx-pointcloud.h"
+#include "avx-pointcloud-kernels.h"
+#include "cpu-dispatch.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace librealsense
+{
+    // Depth rows per band handed to the pool
+    static const int POINTCLOUD_BAND_ROWS = 16;
+
+    static texture_projection make_texture_projection(const rs2_intrinsics& other, const rs2_extrinsics& extr)
+    {
+        texture_projection p;
+        std::copy(std::begin(extr.rotation), std::end(extr.rotation), p.rotation);
+        std::copy(std::begin(extr.translation), std::end(extr.translation), p.translation);
+        p.fx = other.fx;
+        p.fy = other.fy;
+        p.ppx = other.ppx;
+        p.ppy = other.ppy;
+        p.width = static_cast<float>(other.width);
+        p.height = static_cast<float>(other.height);
+        std::copy(std::begin(other.coeffs), std::end(other.coeffs), p.coeffs);
+        switch (other.model)
+        {
+        case RS2_DISTORTION_MODIFIED_BROWN_CONRADY:
+        case RS2_DISTORTION_INVERSE_BROWN_CONRADY:
+            p.model = texture_projection::modified_brown_conrady;
+            break;
+        case RS2_DISTORTION_FTHETA:
+            p.model = texture_projection::ftheta;
+            break;
+        case RS2_DISTORTION_KANNALA_BRANDT4:
+            p.model = texture_projection::kannala_brandt4;
+            break;
+        default:
+            // rs2_project_point_to_pixel leaves BROWN_CONRADY points undistorted as well
+            p.model = texture_projection::none;
+            break;
+        }
+        return p;
+    }
+
+    pointcloud_transform_avx::pointcloud_transform_avx(const rs2_intrinsics& depth, thread_pool& pool)
+        : _depth(depth), _pool(pool),
+        _pre_compute_map_x(depth.width * depth.height), _pre_compute_map_y(depth.width * depth.height)
+    {
+        for (int h = 0; h < depth.height; ++h)
+        {
+            for (int w = 0; w < depth.width; ++w)
+            {
+                // Scaling by the depth is the last step of every model, so the unit-depth ray gives identical points
+                const float pixel[] = { (float)w, (float)h };
+                float point[3];
+                rs2_deproject_pixel_to_point(point, &depth, pixel, 1.f);
+                _pre_compute_map_x[h * depth.width + w] = point[0];
+                _pre_compute_map_y[h * depth.width + w] = point[1];
+            }
+        }
+    }
+
+    void pointcloud_transform_avx::depth_to_points(float3* points, const uint16_t* depth_image, float depth_scale)
+    {
+        _pool.parallel_for(_depth.height, [&](int begin, int end)
+        {
+            auto first = begin * _depth.width;
+            auto count = (end - begin) * _depth.width;
+
+            int done = 0;
+#ifdef RS2_HAVE_AVX2_POINTCLOUD
+            if (get_simd_level() >= simd_level::avx2)
+                done = deproject_depth_avx2(depth_image + first, _pre_compute_map_x.data() + first, _pre_compute_map_y.data() + first,
+                    count, depth_scale, &points[first].x);
+#endif
+            for (auto i = first + done; i < first + count; ++i)
+            {
+                auto depth = depth_scale * depth_image[i];
+                points[i] = { depth * _pre_compute_map_x[i], depth * _pre_compute_map_y[i], depth };
+            }
+        }, POINTCLOUD_BAND_ROWS);
+    }
+
+    void pointcloud_transform_avx::get_texture_map(float2* tex_ptr, float2* pixels_ptr, const float3* points,
+        const rs2_intrinsics& other_intrinsics, const rs2_extrinsics& extr)
+    {
+        auto projection = make_texture_projection(other_intrinsics, extr);
+
+        _pool.parallel_for(_depth.height, [&](int begin, int end)
+        {
+            auto first = begin * _depth.width;
+            auto count = (end - begin) * _depth.width;
+
+            int done = 0;
+#ifdef RS2_HAVE_AVX2_POINTCLOUD
+            if (get_simd_level() >= simd_level::avx2)
+                done = texture_map_avx2(&points[first].x, count, projection, &pixels_ptr[first].x, &tex_ptr[first].x);
+#endif
+            for (auto i = first + done; i < first + count; ++i)
+            {
+                if (points[i].z)
+                {
+                    float3 trans;
+                    rs2_transform_point_to_point(&trans.x, &extr, &points[i].x);
+                    rs2_project_point_to_pixel(&pixels_ptr[i].x, &other_intrinsics, &trans.x);
+                    tex_ptr[i] = { pixels_ptr[i].x / other_intrinsics.width, pixels_ptr[i].y / other_intrinsics.height };
+                }
+                else
+                {
+                    tex_ptr[i] = { 0.f, 0.f };
+                    pixels_ptr[i] = { 0.f, 0.f };
+                }
+            }
+        }, POINTCLOUD_BAND_ROWS);
+    }
+
+    pointcloud_avx::pointcloud_avx()
+        : pointcloud("Pointcloud (AVX)")
+    {}
+
+    void pointcloud_avx::preprocess()
+    {
+        _transform = std::make_shared<pointcloud_transform_avx>(*_depth_intrinsics, get_processing_pool());
+    }
+
+    const float3* pointcloud_avx::depth_to_points(rs2::points output,
+        const rs2_intrinsics &depth_intrinsics,
+        const rs2::depth_frame& depth_frame,
+        float depth_scale)
+    {
+        auto points = (float3*)output.get_vertices();
+        _transform->depth_to_points(points, (const uint16_t*)depth_frame.get_data(), depth_scale);
+        return points;
+    }
+
+    void pointcloud_avx::get_texture_map(rs2::points output,
+        const float3* points,
+        const unsigned int width,
+        const unsigned int height,
+        const rs2_intrinsics &other_intrinsics,
+        const rs2_extrinsics& extr,
+        float2* pixels_ptr)
+    {
+        auto tex_ptr = (float2*)output.get_texture_coordinates();
+        _transform->get_texture_map(tex_ptr, pixels_ptr, points, other_intrinsics, extr);
+    }
+}
@@ -0,0 +1,53 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include "../pointcloud.h"
+#include "concurrency.h"
+
+namespace librealsense
+{
+    // Frame-free core of pointcloud_avx. Rows of the depth image are processed in bands on the pool,
+    // with AVX2 when get_simd_level() allows and the scalar rsutil.h steps otherwise
+    class pointcloud_transform_avx
+    {
+    public:
+        pointcloud_transform_avx(const rs2_intrinsics& depth, thread_pool& pool);
+
+        void depth_to_points(float3* points, const uint16_t* depth_image, float depth_scale);
+
+        void get_texture_map(float2* tex_ptr, float2* pixels_ptr, const float3* points,
+            const rs2_intrinsics& other_intrinsics, const rs2_extrinsics& extr);
+
+    private:
+        const rs2_intrinsics _depth;
+        thread_pool& _pool;
+
+        // Deprojection of every depth pixel at unit depth, valid for every distortion model
+        std::vector<float> _pre_compute_map_x;
+        std::vector<float> _pre_compute_map_y;
+    };
+
+    class pointcloud_avx : public pointcloud
+    {
+    public:
+        pointcloud_avx();
+    private:
+        void preprocess() override;
+        const float3 * depth_to_points(
+            rs2::points output,
+            const rs2_intrinsics &depth_intrinsics,
+            const rs2::depth_frame& depth_frame,
+            float depth_scale) override;
+        void get_texture_map(
+            rs2::points output,
+            const float3* points,
+            const unsigned int width,
+            const unsigned int height,
+            const rs2_intrinsics &other_intrinsics,
+            const rs2_extrinsics& extr,
+            float2* pixels_ptr) override;
+
+        std::shared_ptr<pointcloud_transform_avx> _transform;
+    };
+}
@@ -0,0 +1,19 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include <cstdint>
+
+// Plain-data interface for the same reason as avx-align-kernels.h
+namespace librealsense
+{
+    // Domain transform recursion of the spatial filter over disparity, left to right then right to left,
+    // on 8 rows at a time (transposed in 8x8 blocks so every lane follows its own row). Gates and rounding
+    // follow spatial_filter_rows_fp exactly. Returns the number of leading rows processed
+    int spatial_rows_fp_avx2(float * image, int width, int rows, float alpha, float delta_z);
+
+    // Same recursion top to bottom then bottom to top, on columns side by side. image points at the
+    // first of the columns, stride is the row width. Returns the number of leading columns processed
+    int spatial_columns_fp_avx2(float * image, int stride, int height, int columns, float alpha, float delta_z);
+}
@@ -0,0 +1,73 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#include "avx-align-kernels.h"
+
+#ifdef __AVX2__
+#include <immintrin.h>
+
+namespace librealsense
+{
+    int project_to_other_avx2(const uint16_t * z_pixels, const float * map_x, const float * map_y, int count,
+        const align_projection & p, int * other_x, int * other_y)
+    {
+        __m256 r[9], t[3], c[5];
+        for (int i = 0; i < 9; ++i) r[i] = _mm256_set1_ps(p.rotation[i]);
+        for (int i = 0; i < 3; ++i) t[i] = _mm256_set1_ps(p.translation[i]);
+        for (int i = 0; i < 5; ++i) c[i] = _mm256_set1_ps(p.coeffs[i]);
+
+        const auto scale = _mm256_set1_ps(p.depth_scale);
+        const auto one = _mm256_set1_ps(1.f);
+        const auto two = _mm256_set1_ps(2.f);
+        const auto two_c2 = _mm256_set1_ps(2 * p.coeffs[2]);
+        const auto two_c3 = _mm256_set1_ps(2 * p.coeffs[3]);
+        const auto half = _mm256_set1_ps(0.5f);
+        const auto fx = _mm256_set1_ps(p.fx);
+        const auto fy = _mm256_set1_ps(p.fy);
+        const auto ppx = _mm256_set1_ps(p.ppx);
+        const auto ppy = _mm256_set1_ps(p.ppy);
+
+        int i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            auto z16 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(z_pixels + i));
+            auto depth = _mm256_mul_ps(scale, _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(z16)));
+
+            // rs2_deproject_pixel_to_point
+            auto px = _mm256_mul_ps(depth, _mm256_loadu_ps(map_x + i));
+            auto py = _mm256_mul_ps(depth, _mm256_loadu_ps(map_y + i));
+
+            // rs2_transform_point_to_point
+            auto ox = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(r[0], px), _mm256_mul_ps(r[3], py)), _mm256_mul_ps(r[6], depth)), t[0]);
+            auto oy = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(r[1], px), _mm256_mul_ps(r[4], py)), _mm256_mul_ps(r[7], depth)), t[1]);
+            auto oz = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(r[2], px), _mm256_mul_ps(r[5], py)), _mm256_mul_ps(r[8], depth)), t[2]);
+
+            // rs2_project_point_to_pixel
+            auto x = _mm256_div_ps(ox, oz);
+            auto y = _mm256_div_ps(oy, oz);
+            if (p.distort)
+            {
+                auto r2 = _mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y));
+                auto f = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(one, _mm256_mul_ps(c[0], r2)),
+                    _mm256_mul_ps(_mm256_mul_ps(c[1], r2), r2)),
+                    _mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(c[4], r2), r2), r2));
+                x = _mm256_mul_ps(x, f);
+                y = _mm256_mul_ps(y, f);
+                auto dx = _mm256_add_ps(_mm256_add_ps(x, _mm256_mul_ps(_mm256_mul_ps(two_c2, x), y)),
+                    _mm256_mul_ps(c[3], _mm256_add_ps(r2, _mm256_mul_ps(_mm256_mul_ps(two, x), x))));
+                auto dy = _mm256_add_ps(_mm256_add_ps(y, _mm256_mul_ps(_mm256_mul_ps(two_c3, x), y)),
+                    _mm256_mul_ps(c[2], _mm256_add_ps(r2, _mm256_mul_ps(_mm256_mul_ps(two, y), y))));
+                x = dx;
+                y = dy;
+            }
+
+            // Round to the nearest pixel the way the scalar code does, truncating after adding 0.5
+            auto u = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, fx), ppx), half);
+            auto v = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(y, fy), ppy), half);
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(other_x + i), _mm256_cvttps_epi32(u));
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(other_y + i), _mm256_cvttps_epi32(v));
+        }
+        return i;
+    }
+}
+#endif // __AVX2__
@@ -0,0 +1,124 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#include "avx-decimation-kernels.h"
+
+#ifdef __AVX2__
+#include <immintrin.h>
+
+namespace librealsense
+{
+    static inline void sort2(__m256i & a, __m256i & b)
+    {
+        auto low = _mm256_min_epu16(a, b);
+        b = _mm256_max_epu16(a, b);
+        a = low;
+    }
+
+    // Every lane holds a block sorted in full, zeros first. With k non-zero values the lower middle one has
+    // rank zeros + (k - 1) / 2; empty blocks pick the last value, which is 0 as well
+    template <int N>
+    static inline __m256i select_median(const __m256i s[N])
+    {
+        const auto zero = _mm256_setzero_si256();
+        auto zeros = zero;
+        for (int i = 0; i < N; ++i)
+            zeros = _mm256_sub_epi16(zeros, _mm256_cmpeq_epi16(s[i], zero));
+        auto valid = _mm256_sub_epi16(_mm256_set1_epi16(N), zeros);
+        auto rank = _mm256_add_epi16(zeros, _mm256_srai_epi16(_mm256_sub_epi16(valid, _mm256_set1_epi16(1)), 1));
+
+        auto median = zero;
+        for (int i = 0; i < N; ++i)
+            median = _mm256_or_si256(median, _mm256_and_si256(_mm256_cmpeq_epi16(rank, _mm256_set1_epi16(i)), s[i]));
+        return median;
+    }
+
+    // Even and odd elements of 32 values, in order
+    static inline void deinterleave2(const uint16_t * p, __m256i & even, __m256i & odd)
+    {
+        const auto low = _mm256_set1_epi32(0xffff);
+        auto x0 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+        auto x1 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + 16));
+        even = _mm256_permute4x64_epi64(_mm256_packus_epi32(_mm256_and_si256(x0, low), _mm256_and_si256(x1, low)), 0xD8);
+        odd = _mm256_permute4x64_epi64(_mm256_packus_epi32(_mm256_srli_epi32(x0, 16), _mm256_srli_epi32(x1, 16)), 0xD8);
+    }
+
+    static int decimate_median_2x2(const uint16_t * block, size_t stride, int count, uint16_t * out)
+    {
+        int i = 0;
+        for (; i + 16 <= count; i += 16)
+        {
+            __m256i s[4];
+            deinterleave2(block + 2 * i, s[0], s[1]);
+            deinterleave2(block + stride + 2 * i, s[2], s[3]);
+
+            sort2(s[0], s[1]); sort2(s[2], s[3]);
+            sort2(s[0], s[2]); sort2(s[1], s[3]);
+            sort2(s[1], s[2]);
+
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), select_median<4>(s));
+        }
+        return i;
+    }
+
+    static int decimate_median_3x3(const uint16_t * block, size_t stride, int count, uint16_t * out)
+    {
+        // Byte shuffles moving element 3j + c of 24 values, held in 3 vectors, to lane j: one per column c of
+        // the block and source vector. Each 128 bit half handles 8 outputs, so the shuffles stay in-lane
+        __m256i gather[3][3];
+        for (int c = 0; c < 3; ++c)
+            for (int src = 0; src < 3; ++src)
+            {
+                char bytes[16];
+                for (int j = 0; j < 8; ++j)
+                {
+                    auto e = 3 * j + c;
+                    bytes[2 * j] = (e / 8 == src) ? char(2 * (e % 8)) : char(0x80);
+                    bytes[2 * j + 1] = (e / 8 == src) ? char(2 * (e % 8) + 1) : char(0x80);
+                }
+                gather[c][src] = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(bytes)));
+            }
+
+        int i = 0;
+        for (; i + 16 <= count; i += 16)
+        {
+            __m256i s[9];
+            for (int r = 0; r < 3; ++r)
+            {
+                auto row = block + r * stride + 3 * i;
+                __m256i v[3];
+                for (int src = 0; src < 3; ++src)
+                    v[src] = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(row + 8 * src))),
+                        _mm_loadu_si128(reinterpret_cast<const __m128i *>(row + 24 + 8 * src)), 1);
+                for (int c = 0; c < 3; ++c)
+                    s[3 * r + c] = _mm256_or_si256(_mm256_or_si256(_mm256_shuffle_epi8(v[0], gather[c][0]),
+                        _mm256_shuffle_epi8(v[1], gather[c][1])), _mm256_shuffle_epi8(v[2], gather[c][2]));
+            }
+
+            // 25 comparator sorting network of 9 values: rows of three, columns, then the diagonals
+            sort2(s[0], s[1]); sort2(s[3], s[4]); sort2(s[6], s[7]);
+            sort2(s[1], s[2]); sort2(s[4], s[5]); sort2(s[7], s[8]);
+            sort2(s[0], s[1]); sort2(s[3], s[4]); sort2(s[6], s[7]);
+            sort2(s[0], s[3]); sort2(s[3], s[6]); sort2(s[0], s[3]);
+            sort2(s[1], s[4]); sort2(s[4], s[7]); sort2(s[1], s[4]);
+            sort2(s[2], s[5]); sort2(s[5], s[8]); sort2(s[2], s[5]);
+            sort2(s[1], s[3]); sort2(s[5], s[7]); sort2(s[2], s[6]);
+            sort2(s[4], s[6]); sort2(s[2], s[4]); sort2(s[2], s[3]);
+            sort2(s[5], s[6]);
+
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), select_median<9>(s));
+        }
+        return i;
+    }
+
+    int decimate_depth_median_avx2(const uint16_t * block, size_t stride, int scale, int count, uint16_t * out)
+    {
+        switch (scale)
+        {
+        case 2: return decimate_median_2x2(block, stride, count, out);
+        case 3: return decimate_median_3x3(block, stride, count, out);
+        default: return 0;
+        }
+    }
+}
+#endif // __AVX2__
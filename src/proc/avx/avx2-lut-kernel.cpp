@@ -0,0 +1,42 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#include "avx-lut-kernels.h"
+
+#ifdef __AVX2__
+#include <immintrin.h>
+
+namespace librealsense
+{
+    static inline __m256i load_indices(const uint16_t * in)
+    {
+        return _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(in)));
+    }
+
+    size_t lookup_u16_avx2(const uint16_t * in, const uint16_t * table, uint16_t * out, size_t count)
+    {
+        const auto low = _mm256_set1_epi32(0xffff);
+        auto words = reinterpret_cast<const int *>(table);
+        size_t i = 0;
+        for (; i + 16 <= count; i += 16)
+        {
+            // The entry is the low half of the 32 bits read at its address
+            auto a = _mm256_and_si256(_mm256_i32gather_epi32(words, load_indices(in + i), 2), low);
+            auto b = _mm256_and_si256(_mm256_i32gather_epi32(words, load_indices(in + i + 8), 2), low);
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), _mm256_permute4x64_epi64(_mm256_packus_epi32(a, b), 0xD8));
+        }
+        return i;
+    }
+
+    size_t lookup_float_avx2(const uint16_t * in, const float * table, float * out, size_t count)
+    {
+        size_t i = 0;
+        for (; i + 16 <= count; i += 16)
+        {
+            _mm256_storeu_ps(out + i, _mm256_i32gather_ps(table, load_indices(in + i), 4));
+            _mm256_storeu_ps(out + i + 8, _mm256_i32gather_ps(table, load_indices(in + i + 8), 4));
+        }
+        return i;
+    }
+}
+#endif // __AVX2__
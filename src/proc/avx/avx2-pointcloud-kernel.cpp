@@ -0,0 +1,178 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#include "avx-pointcloud-kernels.h"
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#include <cfloat>
+#include <cmath>
+
+namespace librealsense
+{
+    // Arctangent of non-negative values, Cephes atanf (about 1e-7 relative error)
+    static inline __m256 atan_positive(__m256 x)
+    {
+        const auto one = _mm256_set1_ps(1.f);
+        auto big = _mm256_cmp_ps(x, _mm256_set1_ps(2.414213562373095f), _CMP_GT_OQ);
+        auto mid = _mm256_andnot_ps(big, _mm256_cmp_ps(x, _mm256_set1_ps(0.4142135623730950f), _CMP_GT_OQ));
+
+        auto offset = _mm256_or_ps(_mm256_and_ps(big, _mm256_set1_ps(1.570796326794897f)),
+            _mm256_and_ps(mid, _mm256_set1_ps(0.7853981633974483f)));
+        x = _mm256_blendv_ps(x, _mm256_div_ps(_mm256_sub_ps(x, one), _mm256_add_ps(x, one)), mid);
+        x = _mm256_blendv_ps(x, _mm256_div_ps(_mm256_set1_ps(-1.f), x), big);
+
+        auto z = _mm256_mul_ps(x, x);
+        auto poly = _mm256_sub_ps(_mm256_mul_ps(_mm256_set1_ps(8.05374449538e-2f), z), _mm256_set1_ps(1.38776856032e-1f));
+        poly = _mm256_add_ps(_mm256_mul_ps(poly, z), _mm256_set1_ps(1.99777106478e-1f));
+        poly = _mm256_sub_ps(_mm256_mul_ps(poly, z), _mm256_set1_ps(3.33329491539e-1f));
+        poly = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(poly, z), x), x);
+        return _mm256_add_ps(offset, poly);
+    }
+
+    int deproject_depth_avx2(const uint16_t * z_pixels, const float * map_x, const float * map_y, int count,
+        float depth_scale, float * points)
+    {
+        // Lane sources for interleaving 8 x, y and z values into 3 registers of xyz triplets
+        const auto x0 = _mm256_setr_epi32(0, 0, 0, 1, 0, 0, 2, 0);
+        const auto y0 = _mm256_setr_epi32(0, 0, 0, 0, 1, 0, 0, 2);
+        const auto z0 = _mm256_setr_epi32(0, 0, 0, 0, 0, 1, 0, 0);
+        const auto x1 = _mm256_setr_epi32(0, 3, 0, 0, 4, 0, 0, 5);
+        const auto y1 = _mm256_setr_epi32(0, 0, 3, 0, 0, 4, 0, 0);
+        const auto z1 = _mm256_setr_epi32(2, 0, 0, 3, 0, 0, 4, 0);
+        const auto x2 = _mm256_setr_epi32(0, 0, 6, 0, 0, 7, 0, 0);
+        const auto y2 = _mm256_setr_epi32(5, 0, 0, 6, 0, 0, 7, 0);
+        const auto z2 = _mm256_setr_epi32(0, 5, 0, 0, 6, 0, 0, 7);
+        const auto scale = _mm256_set1_ps(depth_scale);
+
+        int i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            auto z16 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(z_pixels + i));
+            auto z = _mm256_mul_ps(scale, _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(z16)));
+            auto x = _mm256_mul_ps(z, _mm256_loadu_ps(map_x + i));
+            auto y = _mm256_mul_ps(z, _mm256_loadu_ps(map_y + i));
+
+            // Lanes 0,3,6 / 1,4,7 / 2,5 of each output hold x / y / z, rotating by one lane per output
+            auto xyz0 = _mm256_blend_ps(_mm256_blend_ps(_mm256_permutevar8x32_ps(x, x0), _mm256_permutevar8x32_ps(y, y0), 0x92), _mm256_permutevar8x32_ps(z, z0), 0x24);
+            auto xyz1 = _mm256_blend_ps(_mm256_blend_ps(_mm256_permutevar8x32_ps(x, x1), _mm256_permutevar8x32_ps(y, y1), 0x24), _mm256_permutevar8x32_ps(z, z1), 0x49);
+            auto xyz2 = _mm256_blend_ps(_mm256_blend_ps(_mm256_permutevar8x32_ps(x, x2), _mm256_permutevar8x32_ps(y, y2), 0x49), _mm256_permutevar8x32_ps(z, z2), 0x92);
+
+            _mm256_storeu_ps(points + i * 3, xyz0);
+            _mm256_storeu_ps(points + i * 3 + 8, xyz1);
+            _mm256_storeu_ps(points + i * 3 + 16, xyz2);
+        }
+        return i;
+    }
+
+    int texture_map_avx2(const float * points, int count, const texture_projection & p, float * pixels, float * texcoords)
+    {
+        // Inverse of the interleaving in deproject_depth_avx2
+        const auto x_order = _mm256_setr_epi32(0, 3, 6, 1, 4, 7, 2, 5);
+        const auto y_order = _mm256_setr_epi32(1, 4, 7, 2, 5, 0, 3, 6);
+        const auto z_order = _mm256_setr_epi32(2, 5, 0, 3, 6, 1, 4, 7);
+
+        __m256 r[9], t[3], c[5];
+        for (int i = 0; i < 9; ++i) r[i] = _mm256_set1_ps(p.rotation[i]);
+        for (int i = 0; i < 3; ++i) t[i] = _mm256_set1_ps(p.translation[i]);
+        for (int i = 0; i < 5; ++i) c[i] = _mm256_set1_ps(p.coeffs[i]);
+
+        const auto zero = _mm256_setzero_ps();
+        const auto one = _mm256_set1_ps(1.f);
+        const auto two = _mm256_set1_ps(2.f);
+        const auto two_c2 = _mm256_set1_ps(2 * p.coeffs[2]);
+        const auto two_c3 = _mm256_set1_ps(2 * p.coeffs[3]);
+        const auto epsilon = _mm256_set1_ps(FLT_EPSILON);
+        const auto inverse_c0 = _mm256_set1_ps(1.0f / p.coeffs[0]);
+        const auto ftheta_scale = _mm256_set1_ps(static_cast<float>(2 * tan(p.coeffs[0] / 2.0f)));
+        const auto fx = _mm256_set1_ps(p.fx);
+        const auto fy = _mm256_set1_ps(p.fy);
+        const auto ppx = _mm256_set1_ps(p.ppx);
+        const auto ppy = _mm256_set1_ps(p.ppy);
+        const auto width = _mm256_set1_ps(p.width);
+        const auto height = _mm256_set1_ps(p.height);
+
+        int i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            auto a0 = _mm256_loadu_ps(points + i * 3);
+            auto a1 = _mm256_loadu_ps(points + i * 3 + 8);
+            auto a2 = _mm256_loadu_ps(points + i * 3 + 16);
+            auto px = _mm256_permutevar8x32_ps(_mm256_blend_ps(_mm256_blend_ps(a0, a1, 0x92), a2, 0x24), x_order);
+            auto py = _mm256_permutevar8x32_ps(_mm256_blend_ps(_mm256_blend_ps(a0, a1, 0x24), a2, 0x49), y_order);
+            auto pz = _mm256_permutevar8x32_ps(_mm256_blend_ps(_mm256_blend_ps(a0, a1, 0x49), a2, 0x92), z_order);
+
+            // rs2_transform_point_to_point
+            auto ox = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(r[0], px), _mm256_mul_ps(r[3], py)), _mm256_mul_ps(r[6], pz)), t[0]);
+            auto oy = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(r[1], px), _mm256_mul_ps(r[4], py)), _mm256_mul_ps(r[7], pz)), t[1]);
+            auto oz = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(r[2], px), _mm256_mul_ps(r[5], py)), _mm256_mul_ps(r[8], pz)), t[2]);
+
+            // rs2_project_point_to_pixel
+            auto x = _mm256_div_ps(ox, oz);
+            auto y = _mm256_div_ps(oy, oz);
+            switch (p.model)
+            {
+            case texture_projection::modified_brown_conrady:
+            {
+                auto r2 = _mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y));
+                auto f = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(one, _mm256_mul_ps(c[0], r2)),
+                    _mm256_mul_ps(_mm256_mul_ps(c[1], r2), r2)),
+                    _mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(c[4], r2), r2), r2));
+                x = _mm256_mul_ps(x, f);
+                y = _mm256_mul_ps(y, f);
+                auto dx = _mm256_add_ps(_mm256_add_ps(x, _mm256_mul_ps(_mm256_mul_ps(two_c2, x), y)),
+                    _mm256_mul_ps(c[3], _mm256_add_ps(r2, _mm256_mul_ps(_mm256_mul_ps(two, x), x))));
+                auto dy = _mm256_add_ps(_mm256_add_ps(y, _mm256_mul_ps(_mm256_mul_ps(two_c3, x), y)),
+                    _mm256_mul_ps(c[2], _mm256_add_ps(r2, _mm256_mul_ps(_mm256_mul_ps(two, y), y))));
+                x = dx;
+                y = dy;
+                break;
+            }
+            case texture_projection::ftheta:
+            {
+                auto radius = _mm256_max_ps(_mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y))), epsilon);
+                auto rd = _mm256_mul_ps(inverse_c0, atan_positive(_mm256_mul_ps(radius, ftheta_scale)));
+                auto ratio = _mm256_div_ps(rd, radius);
+                x = _mm256_mul_ps(x, ratio);
+                y = _mm256_mul_ps(y, ratio);
+                break;
+            }
+            case texture_projection::kannala_brandt4:
+            {
+                auto radius = _mm256_max_ps(_mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y))), epsilon);
+                auto theta = atan_positive(radius);
+                auto theta2 = _mm256_mul_ps(theta, theta);
+                auto series = _mm256_add_ps(c[2], _mm256_mul_ps(theta2, c[3]));
+                series = _mm256_add_ps(c[1], _mm256_mul_ps(theta2, series));
+                series = _mm256_add_ps(c[0], _mm256_mul_ps(theta2, series));
+                series = _mm256_add_ps(one, _mm256_mul_ps(theta2, series));
+                auto ratio = _mm256_div_ps(_mm256_mul_ps(theta, series), radius);
+                x = _mm256_mul_ps(x, ratio);
+                y = _mm256_mul_ps(y, ratio);
+                break;
+            }
+            default:
+                break;
+            }
+
+            // Points without depth get zero coordinates, like in pointcloud::get_texture_map
+            auto valid = _mm256_cmp_ps(pz, zero, _CMP_NEQ_UQ);
+            auto u = _mm256_and_ps(_mm256_add_ps(_mm256_mul_ps(x, fx), ppx), valid);
+            auto v = _mm256_and_ps(_mm256_add_ps(_mm256_mul_ps(y, fy), ppy), valid);
+
+            auto lo = _mm256_unpacklo_ps(u, v);
+            auto hi = _mm256_unpackhi_ps(u, v);
+            _mm256_storeu_ps(pixels + i * 2, _mm256_permute2f128_ps(lo, hi, 0x20));
+            _mm256_storeu_ps(pixels + i * 2 + 8, _mm256_permute2f128_ps(lo, hi, 0x31));
+
+            u = _mm256_div_ps(u, width);
+            v = _mm256_div_ps(v, height);
+            lo = _mm256_unpacklo_ps(u, v);
+            hi = _mm256_unpackhi_ps(u, v);
+            _mm256_storeu_ps(texcoords + i * 2, _mm256_permute2f128_ps(lo, hi, 0x20));
+            _mm256_storeu_ps(texcoords + i * 2 + 8, _mm256_permute2f128_ps(lo, hi, 0x31));
+        }
+        return i;
+    }
+}
+#endif // __AVX2__
@@ -0,0 +1,202 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#include "avx-spatial-kernels.h"
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#include <algorithm>
+#include <cstring>
+
+namespace librealsense
+{
+    // One step of the recursion on 8 independent lines. A value is valid when its bits, read as an
+    // integer, are positive; the filtered value x * alpha + state * (1 - alpha) replaces x only where
+    // x and the previous input are both valid and closer than delta_z
+    struct spatial_recursion
+    {
+        spatial_recursion(float a, float delta_z)
+            : alpha(_mm256_set1_ps(a)), beta(_mm256_set1_ps(1.0f - a)),
+            dz(_mm256_set1_ps(delta_z)), neg_dz(_mm256_set1_ps(-delta_z))
+        {}
+
+        __m256 step(__m256 previous, __m256 x, __m256 state) const
+        {
+            const auto zero = _mm256_setzero_si256();
+            auto valid = _mm256_and_si256(_mm256_cmpgt_epi32(_mm256_castps_si256(previous), zero),
+                _mm256_cmpgt_epi32(_mm256_castps_si256(x), zero));
+            auto delta = _mm256_sub_ps(previous, x);
+            auto close = _mm256_and_ps(_mm256_cmp_ps(delta, dz, _CMP_LT_OQ), _mm256_cmp_ps(delta, neg_dz, _CMP_GT_OQ));
+            auto filtered = _mm256_add_ps(_mm256_mul_ps(x, alpha), _mm256_mul_ps(state, beta));
+            return _mm256_blendv_ps(x, filtered, _mm256_and_ps(_mm256_castsi256_ps(valid), close));
+        }
+
+        __m256 alpha, beta, dz, neg_dz;
+    };
+
+    static inline void transpose8(__m256 r[8])
+    {
+        __m256 t[8], u[8];
+        for (int i = 0; i < 8; i += 2)
+        {
+            t[i] = _mm256_unpacklo_ps(r[i], r[i + 1]);
+            t[i + 1] = _mm256_unpackhi_ps(r[i], r[i + 1]);
+        }
+        for (int i = 0; i < 8; i += 4)
+        {
+            u[i] = _mm256_shuffle_ps(t[i], t[i + 2], _MM_SHUFFLE(1, 0, 1, 0));
+            u[i + 1] = _mm256_shuffle_ps(t[i], t[i + 2], _MM_SHUFFLE(3, 2, 3, 2));
+            u[i + 2] = _mm256_shuffle_ps(t[i + 1], t[i + 3], _MM_SHUFFLE(1, 0, 1, 0));
+            u[i + 3] = _mm256_shuffle_ps(t[i + 1], t[i + 3], _MM_SHUFFLE(3, 2, 3, 2));
+        }
+        for (int i = 0; i < 4; ++i)
+        {
+            r[i] = _mm256_permute2f128_ps(u[i], u[i + 4], 0x20);
+            r[i + 4] = _mm256_permute2f128_ps(u[i], u[i + 4], 0x31);
+        }
+    }
+
+    // Columns [c, c + n) of 8 rows as 8 column vectors, a partial block goes through a padded copy
+    static inline void load_columns(const float * rows, int width, int c, int n, __m256 col[8])
+    {
+        if (n == 8)
+        {
+            for (int i = 0; i < 8; ++i)
+                col[i] = _mm256_loadu_ps(rows + size_t(i) * width + c);
+        }
+        else
+        {
+            float block[8][8] = {};
+            for (int i = 0; i < 8; ++i)
+                memcpy(block[i], rows + size_t(i) * width + c, n * sizeof(float));
+            for (int i = 0; i < 8; ++i)
+                col[i] = _mm256_loadu_ps(block[i]);
+        }
+        transpose8(col);
+    }
+
+    static inline void store_columns(float * rows, int width, int c, int n, __m256 col[8])
+    {
+        transpose8(col);
+        if (n == 8)
+        {
+            for (int i = 0; i < 8; ++i)
+                _mm256_storeu_ps(rows + size_t(i) * width + c, col[i]);
+        }
+        else
+        {
+            float block[8][8];
+            for (int i = 0; i < 8; ++i)
+                _mm256_storeu_ps(block[i], col[i]);
+            for (int i = 0; i < 8; ++i)
+                memcpy(rows + size_t(i) * width + c, block[i], n * sizeof(float));
+        }
+    }
+
+    int spatial_rows_fp_avx2(float * image, int width, int rows, float alpha, float delta_z)
+    {
+        if (width < 2)
+            return 0;
+
+        const spatial_recursion r(alpha, delta_z);
+        const int last_block = ((width - 1) / 8) * 8;
+        int v = 0;
+        for (; v + 8 <= rows; v += 8)
+        {
+            auto group = image + size_t(v) * width;
+            __m256 col[8], previous, state;
+
+            // Left to right, the first column seeds the recursion
+            for (int c = 0; c < width; c += 8)
+            {
+                auto n = std::min(8, width - c);
+                load_columns(group, width, c, n, col);
+                int j = 0;
+                if (c == 0)
+                {
+                    previous = state = col[0];
+                    j = 1;
+                }
+                for (; j < n; ++j)
+                {
+                    auto x = col[j];
+                    col[j] = state = r.step(previous, x, state);
+                    previous = x;
+                }
+                store_columns(group, width, c, n, col);
+            }
+
+            // Right to left over the output of the first pass, seeded by the last column
+            for (int c = last_block; c >= 0; c -= 8)
+            {
+                auto n = std::min(8, width - c);
+                load_columns(group, width, c, n, col);
+                int j = n - 1;
+                if (c == last_block)
+                {
+                    previous = state = col[j];
+                    --j;
+                }
+                for (; j >= 0; --j)
+                {
+                    auto x = col[j];
+                    col[j] = state = r.step(previous, x, state);
+                    previous = x;
+                }
+                store_columns(group, width, c, n, col);
+            }
+        }
+        return v;
+    }
+
+    // N vectors side by side keep N recursions in flight and read whole cache lines
+    template <int N>
+    static void spatial_column_strip(float * image, int stride, int height, const spatial_recursion & r)
+    {
+        __m256 previous[N], state[N];
+
+        for (int k = 0; k < N; ++k)
+            previous[k] = state[k] = _mm256_loadu_ps(image + 8 * k);
+        for (int v = 1; v < height; ++v)
+        {
+            auto row = image + size_t(v) * stride;
+            for (int k = 0; k < N; ++k)
+            {
+                auto x = _mm256_loadu_ps(row + 8 * k);
+                state[k] = r.step(previous[k], x, state[k]);
+                _mm256_storeu_ps(row + 8 * k, state[k]);
+                previous[k] = x;
+            }
+        }
+
+        auto bottom = image + size_t(height - 1) * stride;
+        for (int k = 0; k < N; ++k)
+            previous[k] = state[k] = _mm256_loadu_ps(bottom + 8 * k);
+        for (int v = height - 2; v >= 0; --v)
+        {
+            auto row = image + size_t(v) * stride;
+            for (int k = 0; k < N; ++k)
+            {
+                auto x = _mm256_loadu_ps(row + 8 * k);
+                state[k] = r.step(previous[k], x, state[k]);
+                _mm256_storeu_ps(row + 8 * k, state[k]);
+                previous[k] = x;
+            }
+        }
+    }
+
+    int spatial_columns_fp_avx2(float * image, int stride, int height, int columns, float alpha, float delta_z)
+    {
+        if (height < 2)
+            return 0;
+
+        const spatial_recursion r(alpha, delta_z);
+        int u = 0;
+        for (; u + 32 <= columns; u += 32)
+            spatial_column_strip<4>(image + u, stride, height, r);
+        for (; u + 8 <= columns; u += 8)
+            spatial_column_strip<1>(image + u, stride, height, r);
+        return u;
+    }
+}
+#endif // __AVX2__
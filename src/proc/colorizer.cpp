@@ -10,6 +10,7 @@
 #include "option.h"
 #include "colorizer.h"
 #include "disparity-transform.h"
+#include "image.h"
 
 namespace librealsense
 {
@@ -134,6 +135,24 @@ namespace librealsense
         { 0, 0, 0 },
         } };
 
+    void apply_color_lut(const uint16_t* depth, const uint32_t* lut, uint8_t* out, int bpp, int count)
+    {
+        if (bpp == 4)
+        {
+            for (auto i = 0; i < count; ++i)
+                memcpy(out + size_t(i) * 4, lut + depth[i], 4);
+            return;
+        }
+
+        // Whole words, the spare byte being overwritten by the next pixel; the last pixel is stored exactly
+        for (auto i = 0; i + 1 < count; ++i)
+            memcpy(out + size_t(i) * 3, lut + depth[i], 4);
+        if (count > 0)
+            memcpy(out + size_t(count - 1) * 3, lut + depth[count - 1], 3);
+    }
+
+    static const rs2_format colorizer_formats[] = { RS2_FORMAT_RGB8, RS2_FORMAT_RGBA8, RS2_FORMAT_BGR8 };
+
     colorizer::colorizer()
         : colorizer("Depth Visualization")
     {}
@@ -212,6 +231,12 @@ namespace librealsense
 
         auto hist_opt = std::make_shared<ptr_option<bool>>(false, true, true, true, &_equalize, "Perform histogram equalization");
         register_option(RS2_OPTION_HISTOGRAM_EQUALIZATION_ENABLED, hist_opt);
+
+        auto format_opt = std::make_shared<ptr_option<int>>(0, 2, 1, 0, &_format_index, "Format of the colorized frames");
+        format_opt->set_description(0.f, "RGB8");
+        format_opt->set_description(1.f, "RGBA8");
+        format_opt->set_description(2.f, "BGR8");
+        register_option(RS2_OPTION_COLORIZER_FORMAT, format_opt);
     }
 
     bool colorizer::should_process(const rs2::frame& frame)
@@ -227,17 +252,18 @@ namespace librealsense
 
     rs2::frame colorizer::process_frame(const rs2::frame_source& source, const rs2::frame& f)
     {
-        if (f.get_profile().get() != _source_stream_profile.get())
+        auto format = colorizer_formats[clamp_val(_format_index, 0, 2)];
+        if (f.get_profile().get() != _source_stream_profile.get() || _target_stream_profile.format() != format)
         {
             _source_stream_profile = f.get_profile();
-            _target_stream_profile = f.get_profile().clone(RS2_STREAM_DEPTH, 0, RS2_FORMAT_RGB8);
+            _target_stream_profile = f.get_profile().clone(RS2_STREAM_DEPTH, 0, format);
 
             auto info = disparity_info::update_info_from_frame(f);
             _depth_units = info.depth_units;
             _d2d_convert_factor = info.d2d_convert_factor;
         }
 
-        auto make_equalized_histogram = [this](const rs2::video_frame& depth, rs2::video_frame rgb)
+        auto make_equalized_histogram = [this, format](const rs2::video_frame& depth, rs2::video_frame rgb)
         {
             auto depth_format = depth.get_profile().format();
             const auto w = depth.get_width(), h = depth.get_height();
@@ -251,18 +277,25 @@ namespace librealsense
             if (depth_format == RS2_FORMAT_DISPARITY32)
             {
                 auto depth_data = reinterpret_cast<const float*>(depth.get_data());
-                update_histogram(_hist_data, depth_data, w, h);
-                make_rgb_data<float>(depth_data, rgb_data, w, h, coloring_function);
+                update_histogram(_hist_data, depth_data, w, h, get_processing_pool(), _partial_histograms);
+                make_rgb_data<float>(depth_data, rgb_data, w, h, format, coloring_function);
             }
             else if (depth_format == RS2_FORMAT_Z16)
             {
                 auto depth_data = reinterpret_cast<const uint16_t*>(depth.get_data());
-                update_histogram(_hist_data, depth_data, w, h);
-                make_rgb_data<uint16_t>(depth_data, rgb_data, w, h, coloring_function);
+                update_histogram(_hist_data, depth_data, w, h, get_processing_pool(), _partial_histograms);
+
+                // The colors change with every histogram, but only values present in the frame are looked up:
+                // those from the first non-zero count of the cumulative histogram up to where it reaches the total
+                auto pixels = _hist_data[MAX_DEPTH - 1];
+                auto first = int(std::lower_bound(_hist_data + 1, _hist_data + MAX_DEPTH, 1) - _hist_data);
+                auto last = int(std::lower_bound(_hist_data + 1, _hist_data + MAX_DEPTH, pixels) - _hist_data) + 1;
+                _lut_state.map = nullptr;
+                make_rgb_data_lut(depth_data, rgb_data, w, h, format, first, std::max(first, std::min(last, MAX_DEPTH)), coloring_function);
             }
         };
 
-        auto make_value_cropped_frame = [this](const rs2::video_frame& depth, rs2::video_frame rgb)
+        auto make_value_cropped_frame = [this, format](const rs2::video_frame& depth, rs2::video_frame rgb)
         {
             auto depth_format = depth.get_profile().format();
             const auto w = depth.get_width(), h = depth.get_height();
@@ -278,7 +311,7 @@ namespace librealsense
                 auto coloring_function = [&, this](float data) {
                     return (data - min) / (max - min);
                 };
-                make_rgb_data<float>(depth_data, rgb_data, w, h, coloring_function);
+                make_rgb_data<float>(depth_data, rgb_data, w, h, format, coloring_function);
             }
             else if (depth_format == RS2_FORMAT_Z16)
             {
@@ -288,14 +321,20 @@ namespace librealsense
                 auto coloring_function = [&, this](float data) {
                     return (data * _depth_units - min) / (max - min);
                 };
-                make_rgb_data<uint16_t>(depth_data, rgb_data, w, h, coloring_function);
+
+                // The colors only depend on the options, so the table is rebuilt when one of them changes
+                lut_state state = { _maps[_map_index], min, max, _depth_units, format };
+                auto first = (state == _lut_state) ? MAX_DEPTH : 0;
+                _lut_state = state;
+                make_rgb_data_lut(depth_data, rgb_data, w, h, format, first, MAX_DEPTH, coloring_function);
             }
         };
 
         rs2::frame ret;
 
         auto vf = f.as<rs2::video_frame>();
-        ret = source.allocate_video_frame(_target_stream_profile, f, 3, vf.get_width(), vf.get_height(), vf.get_width() * 3, RS2_EXTENSION_VIDEO_FRAME);
+        auto bpp = get_image_bpp(format) / 8;
+        ret = source.allocate_video_frame(_target_stream_profile, f, bpp, vf.get_width(), vf.get_height(), vf.get_width() * bpp, RS2_EXTENSION_VIDEO_FRAME);
 
         if (_equalize)
             make_equalized_histogram(f, ret);
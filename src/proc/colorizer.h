@@ -6,6 +6,8 @@
 #include <map>
 #include <vector>
 
+#include "concurrency.h"
+
 namespace rs2
 {
     class stream_profile;
@@ -95,6 +97,28 @@ namespace librealsense {
         size_t _size; float3* _data;
     };
 
+    // The bytes of one pixel of format (RGB8, RGBA8 or BGR8) of color c, as a word holding them in memory order
+    inline uint32_t pack_color(const float3& c, rs2_format format)
+    {
+        uint8_t bytes[4] = { (uint8_t)c.x, (uint8_t)c.y, (uint8_t)c.z, 255 };
+        if (format == RS2_FORMAT_BGR8) std::swap(bytes[0], bytes[2]);
+        uint32_t word;
+        memcpy(&word, bytes, sizeof(word));
+        return word;
+    }
+
+    // Entries [first, last) of the table of colors of all 16 bit values, value_of placing a value on the color map.
+    // Value 0 has no depth and stays black
+    template<class F>
+    void build_color_lut(uint32_t* lut, const color_map& cm, rs2_format format, int first, int last, F value_of)
+    {
+        for (auto i = first; i < last; ++i)
+            lut[i] = i ? pack_color(cm.get(value_of(float(i))), format) : pack_color({ 0.f, 0.f, 0.f }, format);
+    }
+
+    // Colors count pixels through a table of build_color_lut, writing bpp (3 or 4) bytes per pixel
+    void apply_color_lut(const uint16_t* depth, const uint32_t* lut, uint8_t* out, int bpp, int count);
+
     class LRS_EXTENSION_API colorizer : public stream_filter_processing_block
     {
     public:
@@ -114,6 +138,47 @@ namespace librealsense {
             for (auto i = 2; i < MAX_DEPTH; ++i) hist[i] += hist[i - 1]; // Build a cumulative histogram for the indices in [1,0xFFFF]
         }
 
+        // Same histogram with every thread of pool counting its own rows into a slice of partials
+        template<typename T>
+        static void update_histogram(int* hist, const T* depth_data, int w, int h, thread_pool& pool, std::vector<int>& partials)
+        {
+            const auto bands = std::min(static_cast<int>(pool.size()), h);
+            if (bands <= 1)
+            {
+                update_histogram(hist, depth_data, w, h);
+                return;
+            }
+
+            partials.resize(size_t(bands) * MAX_DEPTH);
+            pool.parallel_for(bands, [&](int begin, int end)
+            {
+                for (auto band = begin; band < end; ++band)
+                {
+                    auto partial = partials.data() + size_t(band) * MAX_DEPTH;
+                    memset(partial, 0, MAX_DEPTH * sizeof(int));
+                    auto first = size_t(h) * band / bands * w, last = size_t(h) * (band + 1) / bands * w;
+                    for (auto i = first; i < last; ++i)
+                    {
+                        T depth_val = depth_data[i];
+                        int index = depth_val;
+                        partial[index] += 1;
+                    }
+                }
+            });
+
+            pool.parallel_for(MAX_DEPTH, [&](int begin, int end)
+            {
+                memcpy(hist + begin, partials.data() + begin, (end - begin) * sizeof(int));
+                for (auto band = 1; band < bands; ++band)
+                {
+                    auto partial = partials.data() + size_t(band) * MAX_DEPTH;
+                    for (auto i = begin; i < end; ++i) hist[i] += partial[i];
+                }
+            }, 4096);
+
+            for (auto i = 2; i < MAX_DEPTH; ++i) hist[i] += hist[i - 1];
+        }
+
         static const int MAX_DEPTH = 0x10000;
         static const int MAX_DISPARITY = 0x2710;
 
@@ -124,35 +189,53 @@ namespace librealsense {
         rs2::frame process_frame(const rs2::frame_source& source, const rs2::frame& f) override;
 
         template<typename T, typename F>
-        void make_rgb_data(const T* depth_data, uint8_t* rgb_data, int width, int height, F coloring_func)
+        void make_rgb_data(const T* depth_data, uint8_t* rgb_data, int width, int height, rs2_format format, F coloring_func)
         {
             auto cm = _maps[_map_index];
-            for (auto i = 0; i < width*height; ++i)
+            auto bpp = format == RS2_FORMAT_RGBA8 ? 4 : 3;
+            get_processing_pool().parallel_for(height, [&](int begin, int end)
             {
-                auto d = depth_data[i];
-                colorize_pixel(rgb_data, i, cm, d, coloring_func);
-            }
+                for (auto i = begin * width; i < end * width; ++i)
+                {
+                    auto d = depth_data[i];
+                    colorize_pixel(rgb_data, i, bpp, format, cm, d, coloring_func);
+                }
+            }, BAND_ROWS);
         }
 
         template<typename T, typename F>
-        void colorize_pixel(uint8_t* rgb_data, int idx, color_map* cm, T data, F coloring_func)
+        void colorize_pixel(uint8_t* rgb_data, int idx, int bpp, rs2_format format, color_map* cm, T data, F coloring_func)
         {
+            float3 c{ 0.f, 0.f, 0.f };
             if (data)
+                c = cm->get(coloring_func(data)); // 0-1 based on histogram location
+            auto color = pack_color(c, format);
+            memcpy(rgb_data + size_t(idx) * bpp, &color, bpp);
+        }
+
+        // Colors Z16 through the table of colors, after rebuilding its entries [first, last) from coloring_func
+        template<typename F>
+        void make_rgb_data_lut(const uint16_t* depth_data, uint8_t* rgb_data, int width, int height, rs2_format format,
+            int first, int last, F coloring_func)
+        {
+            auto cm = _maps[_map_index];
+            _lut.resize(MAX_DEPTH);
+            build_color_lut(_lut.data(), *cm, format, 0, 1, coloring_func);
+            get_processing_pool().parallel_for(last - first, [&](int begin, int end)
             {
-                auto f = coloring_func(data); // 0-255 based on histogram locationcolorize_pixel
-                auto c = cm->get(f);
-                rgb_data[idx * 3 + 0] = (uint8_t)c.x;
-                rgb_data[idx * 3 + 1] = (uint8_t)c.y;
-                rgb_data[idx * 3 + 2] = (uint8_t)c.z;
-            }
-            else
+                build_color_lut(_lut.data(), *cm, format, first + begin, first + end, coloring_func);
+            }, 4096);
+
+            auto bpp = format == RS2_FORMAT_RGBA8 ? 4 : 3;
+            get_processing_pool().parallel_for(height, [&](int begin, int end)
             {
-                rgb_data[idx * 3 + 0] = 0;
-                rgb_data[idx * 3 + 1] = 0;
-                rgb_data[idx * 3 + 2] = 0;
-            }
+                apply_color_lut(depth_data + size_t(begin) * width, _lut.data(), rgb_data + size_t(begin) * width * bpp,
+                    bpp, (end - begin) * width);
+            }, BAND_ROWS);
         }
 
+        static const int BAND_ROWS = 8;
+
         float _min, _max;
         bool _equalize;
 
@@ -161,6 +244,26 @@ namespace librealsense {
 
         std::vector<int> _histogram;
         int* _hist_data;
+        std::vector<int> _partial_histograms;
+
+        // Colors of all Z16 values, and the options they were built for outside of histogram equalization.
+        // With equalization only the range of values present in the frame is rebuilt, every frame
+        struct lut_state
+        {
+            const color_map* map;
+            float min, max, depth_units;
+            rs2_format format;
+
+            bool operator==(const lut_state& other) const
+            {
+                return map == other.map && min == other.min && max == other.max &&
+                    depth_units == other.depth_units && format == other.format;
+            }
+        };
+        std::vector<uint32_t> _lut;
+        lut_state _lut_state = { nullptr, 0.f, 0.f, 0.f, RS2_FORMAT_ANY };
+
+        int _format_index = 0;
 
         int _preset = 0;
         rs2::stream_profile _target_stream_profile;
@@ -12,6 +12,13 @@
 #include "core/video.h"
 #include "proc/synthetic-stream.h"
 #include "proc/decimation-filter.h"
+#include "image.h"
+#include "proc/avx/avx-decimation-kernels.h"
+#include "cpu-dispatch.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 
 #define PIX_SORT(a,b) { if ((a)>(b)) PIX_SWAP((a),(b)); }
@@ -199,6 +206,8 @@ namespace librealsense
     const uint8_t decimation_default_val = 2;
     const uint8_t decimation_step = 1;    // Linear decimation
 
+    static const int DECIMATION_BAND_ROWS = 8;
+
     decimation_filter::decimation_filter() :
         stream_filter_processing_block("Decimation Filter"),
         _decimation_factor(decimation_default_val),
@@ -354,32 +363,32 @@ namespace librealsense
         return ret;
     }
 
-    void decimation_filter::decimate_depth(const uint16_t * frame_data_in, uint16_t * frame_data_out,
-        size_t width_in, size_t height_in, size_t scale)
+    void decimate_depth_rows(const uint16_t* in, size_t width_in, size_t scale, size_t out_width,
+        uint16_t* out, size_t out_stride, int first, int last)
     {
-        // Use median filtering
-        std::vector<uint16_t> working_kernel(_kernel_size);
-        auto wk_begin = working_kernel.data();
-        auto wk_itr = wk_begin;
-        std::vector<uint16_t*> pixel_raws(scale);
-        uint16_t* block_start = const_cast<uint16_t*>(frame_data_in);
-
-        if (scale == 2 || scale == 3)
+        uint16_t working_kernel[9];
+        auto wk_begin = working_kernel;
+
+        for (int j = first; j < last; j++)
         {
-            for (int j = 0; j < _real_height; j++)
-            {
-                uint16_t *p{};
-                // Mark the beginning of each of the N lines that the filter will run upon
-                for (size_t i = 0; i < pixel_raws.size(); i++)
-                    pixel_raws[i] = block_start + (width_in*i);
+            // The beginning of the N lines that the filter will run upon
+            auto block_start = in + j * scale * width_in;
+            auto frame_data_out = out + j * out_stride;
+            size_t i = 0;
 
-                for (size_t i = 0, chunk_offset = 0; i < _real_width; i++)
+            if (scale == 2 || scale == 3)
+            {
+#ifdef RS2_HAVE_AVX2_DECIMATION
+                if (get_simd_level() >= simd_level::avx2)
+                    i = decimate_depth_median_avx2(block_start, width_in, int(scale), int(out_width), frame_data_out);
+#endif
+                for (; i < out_width; i++)
                 {
-                    wk_itr = wk_begin;
+                    auto wk_itr = wk_begin;
                     // extract data the kernel to process
                     for (size_t n = 0; n < scale; ++n)
                     {
-                        p = pixel_raws[n] + chunk_offset;
+                        auto p = block_start + width_in * n + i * scale;
                         for (size_t m = 0; m < scale; ++m)
                         {
                             if (*(p + m))
@@ -389,63 +398,44 @@ namespace librealsense
 
                     // For even-size kernels pick the member one below the middle
                     auto ks = (int)(wk_itr - wk_begin);
-                    if (ks == 0)
-                        *frame_data_out++ = 0;
-                    else
+                    switch (ks)
                     {
-                        switch (ks)
-                        {
-                        case 1:
-                            *frame_data_out++ = working_kernel[0];
-                            break;
-                        case 2:
-                            *frame_data_out++ = PIX_MIN(working_kernel[0], working_kernel[1]);
-                            break;
-                        case 3:
-                            *frame_data_out++ = opt_med3<uint16_t>(working_kernel.data());
-                            break;
-                        case 4:
-                            *frame_data_out++ = opt_med4<uint16_t>(working_kernel.data());
-                            break;
-                        case 5:
-                            *frame_data_out++ = opt_med5<uint16_t>(working_kernel.data());
-                            break;
-                        case 6:
-                            *frame_data_out++ = opt_med6<uint16_t>(working_kernel.data());
-                            break;
-                        case 7:
-                            *frame_data_out++ = opt_med7<uint16_t>(working_kernel.data());
-                            break;
-                        case 8:
-                            *frame_data_out++ = opt_med8<uint16_t>(working_kernel.data());
-                            break;
-                        case 9:
-                            *frame_data_out++ = opt_med9<uint16_t>(working_kernel.data());
-                            break;
-                        }
+                    case 0:
+                        frame_data_out[i] = 0;
+                        break;
+                    case 1:
+                        frame_data_out[i] = working_kernel[0];
+                        break;
+                    case 2:
+                        frame_data_out[i] = PIX_MIN(working_kernel[0], working_kernel[1]);
+                        break;
+                    case 3:
+                        frame_data_out[i] = opt_med3<uint16_t>(working_kernel);
+                        break;
+                    case 4:
+                        frame_data_out[i] = opt_med4<uint16_t>(working_kernel);
+                        break;
+                    case 5:
+                        frame_data_out[i] = opt_med5<uint16_t>(working_kernel);
+                        break;
+                    case 6:
+                        frame_data_out[i] = opt_med6<uint16_t>(working_kernel);
+                        break;
+                    case 7:
+                        frame_data_out[i] = opt_med7<uint16_t>(working_kernel);
+                        break;
+                    case 8:
+                        frame_data_out[i] = opt_med8<uint16_t>(working_kernel);
+                        break;
+                    case 9:
+                        frame_data_out[i] = opt_med9<uint16_t>(working_kernel);
+                        break;
                     }
-
-                    chunk_offset += scale;
                 }
-
-                // Fill-in the padded colums with zeros
-                for (int j = _real_width; j < _padded_width; j++)
-                    *frame_data_out++ = 0;
-
-                // Skip N lines to the beginnig of the next processing segment
-                block_start += width_in * scale;
             }
-        }
-        else
-        {
-            for (int j = 0; j < _real_height; j++)
+            else
             {
-                uint16_t *p{};
-                // Mark the beginning of each of the N lines that the filter will run upon
-                for (size_t i = 0; i < pixel_raws.size(); i++)
-                    pixel_raws[i] = block_start + (width_in*i);
-
-                for (size_t i = 0, chunk_offset = 0; i < _real_width; i++)
+                for (; i < out_width; i++)
                 {
                     int sum = 0;
                     int counter = 0;
@@ -453,7 +443,7 @@ namespace librealsense
                     // extract data the kernel to process
                     for (size_t n = 0; n < scale; ++n)
                     {
-                        p = pixel_raws[n] + chunk_offset;
+                        auto p = block_start + width_in * n + i * scale;
                         for (size_t m = 0; m < scale; ++m)
                         {
                             if (*(p + m))
@@ -464,25 +454,86 @@ namespace librealsense
                         }
                     }
 
-                    *frame_data_out++ = (counter == 0 ? 0 : sum / counter);
-                    chunk_offset += scale;
+                    frame_data_out[i] = (counter == 0 ? 0 : sum / counter);
                 }
+            }
 
-                // Fill-in the padded colums with zeros
-                for (int j = _real_width; j < _padded_width; j++)
-                    *frame_data_out++ = 0;
+            // Fill-in the padded colums with zeros
+            std::fill(frame_data_out + out_width, frame_data_out + out_stride, uint16_t(0));
+        }
+    }
+
+    void decimate_bytes_rows(const uint8_t* in, size_t width_in, size_t bpp, size_t scale, size_t out_width,
+        uint8_t* out, size_t out_stride, int first, int last)
+    {
+        // Sums of up to 8x8 bytes fit 16 bits, and below 2^16 the division by the block size is exact as a
+        // multiplication by its rounded-up 32 bit reciprocal
+        auto patch_size = uint32_t(scale * scale);
+        auto reciprocal = uint64_t((uint64_t(1) << 32) + patch_size - 1) / patch_size;
+        auto row_bytes = width_in * bpp;
+        std::vector<uint16_t> sums(row_bytes);
+
+        for (int j = first; j < last; j++)
+        {
+            // The columns of the N input lines are summed first, then every block of the row from those sums
+            auto block_start = in + j * scale * row_bytes;
+            size_t x = 0;
+#ifdef __SSE2__
+            if (get_simd_level() >= simd_level::sse2)
+            {
+                const auto zero = _mm_setzero_si128();
+                for (; x + 16 <= row_bytes; x += 16)
+                {
+                    auto low = zero, high = zero;
+                    for (size_t n = 0; n < scale; ++n)
+                    {
+                        auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block_start + n * row_bytes + x));
+                        low = _mm_add_epi16(low, _mm_unpacklo_epi8(v, zero));
+                        high = _mm_add_epi16(high, _mm_unpackhi_epi8(v, zero));
+                    }
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(sums.data() + x), low);
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(sums.data() + x + 8), high);
+                }
+            }
+#endif
+            for (; x < row_bytes; ++x)
+            {
+                uint16_t sum = 0;
+                for (size_t n = 0; n < scale; ++n)
+                    sum += block_start[n * row_bytes + x];
+                sums[x] = sum;
+            }
 
-                // Skip N lines to the beginnig of the next processing segment
-                block_start += width_in * scale;
+            auto q = out + j * out_stride * bpp;
+            for (size_t i = 0; i < out_width; ++i)
+            {
+                auto p = sums.data() + i * scale * bpp;
+                for (size_t k = 0; k < bpp; ++k)
+                {
+                    uint32_t sum = 0;
+                    for (size_t m = 0; m < scale; ++m)
+                        sum += p[m * bpp + k];
+                    *q++ = uint8_t((sum * reciprocal) >> 32);
+                }
             }
+
+            // Fill-in the padded colums with zeros
+            std::fill(q, out + (j + 1) * out_stride * bpp, uint8_t(0));
         }
+    }
 
-        // Fill-in the padded rows with zeros
-        for (auto v = _real_height; v < _padded_height; ++v)
+    void decimation_filter::decimate_depth(const uint16_t * frame_data_in, uint16_t * frame_data_out,
+        size_t width_in, size_t height_in, size_t scale)
+    {
+        // Output rows are independent, bands of them run in parallel
+        get_processing_pool().parallel_for(_real_height, [&](int begin, int end)
         {
-            for (auto u = 0; u < _padded_width; ++u)
-                *frame_data_out++ = 0;
-        }
+            decimate_depth_rows(frame_data_in, width_in, scale, _real_width, frame_data_out, _padded_width, begin, end);
+        }, DECIMATION_BAND_ROWS);
+
+        // Fill-in the padded rows with zeros
+        std::fill(frame_data_out + size_t(_real_height) * _padded_width,
+            frame_data_out + size_t(_padded_height) * _padded_width, uint16_t(0));
     }
 
     void decimation_filter::decimate_others(rs2_format format, const void * frame_data_in, void * frame_data_out,
@@ -667,132 +718,20 @@ namespace librealsense
 
         case RS2_FORMAT_RGB8:
         case RS2_FORMAT_BGR8:
-        {
-            uint8_t* from = (uint8_t*)frame_data_in;
-            uint8_t* p = nullptr;
-            uint8_t* q = (uint8_t*)frame_data_out;;
-
-            for (int j = 0; j < _real_height; ++j)
-            {
-                for (int i = 0; i < _real_width; ++i)
-                {
-                    for (int k = 0; k < 3; ++k)
-                    {
-                        p = from + scale * (j * width_in + i) * 3 + k;
-                        sum = 0;
-                        for (int n = 0; n < scale; ++n)
-                        {
-                            for (int m = 0; m < scale; ++m)
-                                sum += p[m * 3];
-
-                            p += width_in * 3;
-                        }
-
-                        *q++ = (uint8_t)(sum / patch_size);
-                    }
-                }
-
-                for (int i = _real_width; i < _padded_width; ++i)
-                {
-                    *q++ = 0;
-                    *q++ = 0;
-                    *q++ = 0;
-                }
-            }
-
-            for (int j = _real_height; j < _padded_height; ++j)
-            {
-                for (int i = 0; i < _padded_width; ++i)
-                {
-                    *q++ = 0;
-                    *q++ = 0;
-                    *q++ = 0;
-                }
-            }
-        }
-        break;
-
         case RS2_FORMAT_RGBA8:
         case RS2_FORMAT_BGRA8:
-        {
-            uint8_t* from = (uint8_t*)frame_data_in;
-            uint8_t* p = nullptr;
-            uint8_t* q = (uint8_t*)frame_data_out;
-
-            for (int j = 0; j < _real_height; ++j)
-            {
-                for (int i = 0; i < _real_width; ++i)
-                {
-                    for (int k = 0; k < 4; ++k)
-                    {
-                        p = from + scale * (j * width_in + i) * 4 + k;
-                        sum = 0;
-                        for (int n = 0; n < scale; ++n)
-                        {
-                            for (int m = 0; m < scale; ++m)
-                                sum += p[m * 4];
-
-                            p += width_in * 4;
-                        }
-
-                        *q++ = (uint8_t)(sum / patch_size);
-                    }
-                }
-
-                for (int i = _real_width; i < _padded_width; ++i)
-                {
-                    *q++ = 0;
-                    *q++ = 0;
-                    *q++ = 0;
-                    *q++ = 0;
-                }
-            }
-
-            for (int j = _real_height; j < _padded_height; ++j)
-            {
-                for (int i = 0; i < _padded_width; ++i)
-                {
-                    *q++ = 0;
-                    *q++ = 0;
-                    *q++ = 0;
-                    *q++ = 0;
-                }
-            }
-        }
-        break;
-
         case RS2_FORMAT_Y8:
         {
-            uint8_t* from = (uint8_t*)frame_data_in;
-            uint8_t* p = nullptr;
-            uint8_t* q = (uint8_t*)frame_data_out;
+            auto bpp = size_t(get_image_bpp(format) / 8);
+            auto from = static_cast<const uint8_t*>(frame_data_in);
+            auto q = static_cast<uint8_t*>(frame_data_out);
 
-            for (int j = 0; j < _real_height; ++j)
+            get_processing_pool().parallel_for(_real_height, [&](int begin, int end)
             {
-                for (int i = 0; i < _real_width; ++i)
-                {
-                    p = from + scale * (j * width_in + i);
-                    sum = 0;
-                    for (int n = 0; n < scale; ++n)
-                    {
-                        for (int m = 0; m < scale; ++m)
-                            sum += p[m];
-
-                        p += width_in;
-                    }
-
-                    *q++ = (uint8_t)(sum / patch_size);
-                }
+                decimate_bytes_rows(from, width_in, bpp, scale, _real_width, q, _padded_width, begin, end);
+            }, DECIMATION_BAND_ROWS);
 
-                for (int i = _real_width; i < _padded_width; ++i)
-                    *q++ = 0;
-            }
-
-            for (int j = _real_height; j < _padded_height; ++j)
-            {
-                for (int i = 0; i < _padded_width; ++i)
-                    *q++ = 0;
-            }
+            std::fill(q + size_t(_real_height) * _padded_width * bpp, q + size_t(_padded_height) * _padded_width * bpp, uint8_t(0));
         }
         break;
 
@@ -6,9 +6,19 @@
 #include "../include/librealsense2/hpp/rs_frame.hpp"
 #include "../include/librealsense2/hpp/rs_processing.hpp"
 #include "proc/synthetic-stream.h"
+#include "concurrency.h"
 
 namespace librealsense
 {
+    // Output rows [first, last) of the decimation of a depth image by scale, padded with zeros up to out_stride
+    // pixels. Every output is the median of the non-zero values of its block for scales 2 and 3 (the lower
+    // middle one for even counts), their mean for other scales. Vectorized where the CPU allows, with identical results
+    void decimate_depth_rows(const uint16_t* in, size_t width_in, size_t scale, size_t out_width,
+        uint16_t* out, size_t out_stride, int first, int last);
+
+    // Same for images of bpp interleaved 8 bit channels, every channel of the output being the plain mean of its block
+    void decimate_bytes_rows(const uint8_t* in, size_t width_in, size_t bpp, size_t scale, size_t out_width,
+        uint8_t* out, size_t out_stride, int first, int last);
 
     class decimation_filter : public stream_filter_processing_block
     {
@@ -0,0 +1,226 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#include "../include/librealsense2/hpp/rs_sensor.hpp"
+#include "../include/librealsense2/hpp/rs_processing.hpp"
+
+#include <cmath>
+#include "option.h"
+#include "context.h"
+#include "core/video.h"
+#include "proc/synthetic-stream.h"
+#include "proc/depth-lut-transform.h"
+#include "proc/disparity-transform.h"
+#include "proc/avx/avx-lut-kernels.h"
+#include "cpu-dispatch.h"
+
+namespace librealsense
+{
+    static const int DEPTH_LUT_BAND_ROWS = 16;
+
+    void depth_lut::set(const std::vector<depth_mapping>& chain, float depth_units)
+    {
+        if (_format != RS2_FORMAT_ANY && chain == _chain && depth_units == _depth_units)
+            return;
+
+        for (size_t i = 0; i + 1 < chain.size(); i++)
+            if (chain[i].type != depth_mapping::threshold)
+                throw invalid_value_exception(to_string() << "Depth mapping " << i << " converts the depth and is not the last of the chain");
+
+        auto format = RS2_FORMAT_Z16;
+        if (!chain.empty() && chain.back().type == depth_mapping::to_meters) format = RS2_FORMAT_DISTANCE;
+        if (!chain.empty() && chain.back().type == depth_mapping::to_disparity) format = RS2_FORMAT_DISPARITY32;
+
+        // Same arithmetic as the per-pixel loops of the blocks, so that the table holds their exact results
+        _z16.assign(format == RS2_FORMAT_Z16 ? TABLE_SIZE + 1 : 0, 0);
+        _values.assign(format == RS2_FORMAT_Z16 ? 0 : TABLE_SIZE, 0.f);
+        for (int v = 0; v < TABLE_SIZE; v++)
+        {
+            auto value = static_cast<uint16_t>(v);
+            auto result = 0.f;
+            for (auto&& m : chain)
+            {
+                switch (m.type)
+                {
+                case depth_mapping::threshold:
+                {
+                    auto dist = depth_units * value;
+                    if (!(dist >= m.min && dist <= m.max)) value = 0;
+                    break;
+                }
+                case depth_mapping::to_meters:
+                    result = depth_units * value;
+                    break;
+                case depth_mapping::to_disparity:
+                {
+                    float input = value;
+                    result = std::isnormal(input) ? static_cast<float>(m.d2d_convert_factor / input) : 0.f;
+                    break;
+                }
+                }
+            }
+
+            if (format == RS2_FORMAT_Z16) _z16[v] = value;
+            else _values[v] = result;
+        }
+
+        _chain = chain;
+        _depth_units = depth_units;
+        _format = format;
+    }
+
+    void depth_lut::apply(const uint16_t* in, void* out, size_t count) const
+    {
+        size_t i = 0;
+        if (_format == RS2_FORMAT_Z16)
+        {
+            auto table = _z16.data();
+            auto z = static_cast<uint16_t*>(out);
+#ifdef RS2_HAVE_AVX2_DEPTH_LUT
+            if (get_simd_level() >= simd_level::avx2)
+                i = lookup_u16_avx2(in, table, z, count);
+#endif
+            for (; i < count; i++)
+                z[i] = table[in[i]];
+        }
+        else
+        {
+            auto table = _values.data();
+            auto values = static_cast<float*>(out);
+#ifdef RS2_HAVE_AVX2_DEPTH_LUT
+            if (get_simd_level() >= simd_level::avx2)
+                i = lookup_float_avx2(in, table, values, count);
+#endif
+            for (; i < count; i++)
+                values[i] = table[in[i]];
+        }
+    }
+
+    depth_lut_transform::depth_lut_transform()
+        : stream_filter_processing_block("Depth LUT Transform"),
+        _min_param(0.1f), _max_param(4.f),
+        _output_param(static_cast<uint8_t>(depth_lut_output::z16)),
+        _min(0.1f), _max(4.f),
+        _output(depth_lut_output::z16),
+        _stereoscopic_depth(false),
+        _d2d_convert_factor(0.f)
+    {
+        _stream_filter.format = RS2_FORMAT_Z16;
+        _stream_filter.stream = RS2_STREAM_DEPTH;
+
+        auto min_opt = std::make_shared<ptr_option<float>>(0.f, 16.f, 0.1f, 0.1f, &_min_param, "Min range in meters");
+        // The options write their own fields, the settings of a frame are copied under the lock.
+        // A range that would end before it starts is refused and the option keeps its value
+        min_opt->on_set([this](float val)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (val > _max)
+            {
+                _min_param = _min;
+                throw invalid_value_exception(to_string() << "Min range " << val << " is above the max range " << _max);
+            }
+            _min = val;
+        });
+        register_option(RS2_OPTION_MIN_DISTANCE, min_opt);
+
+        auto max_opt = std::make_shared<ptr_option<float>>(0.f, 16.f, 0.1f, 4.f, &_max_param, "Max range in meters");
+        max_opt->on_set([this](float val)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (val < _min)
+            {
+                _max_param = _max;
+                throw invalid_value_exception(to_string() << "Max range " << val << " is below the min range " << _min);
+            }
+            _max = val;
+        });
+        register_option(RS2_OPTION_MAX_DISTANCE, max_opt);
+
+        auto output = std::make_shared<ptr_option<uint8_t>>(
+            static_cast<uint8_t>(depth_lut_output::z16),
+            static_cast<uint8_t>(depth_lut_output::count) - 1, 1,
+            static_cast<uint8_t>(depth_lut_output::z16),
+            &_output_param, "Output of the transform");
+        output->set_description(static_cast<float>(depth_lut_output::z16), "Depth");
+        output->set_description(static_cast<float>(depth_lut_output::disparity), "Disparity");
+        output->set_description(static_cast<float>(depth_lut_output::meters), "Meters");
+        output->on_set([this](float val)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _output = static_cast<depth_lut_output>(static_cast<uint8_t>(val));
+        });
+        register_option(RS2_OPTION_DEPTH_LUT_OUTPUT, output);
+    }
+
+    depth_lut_output depth_lut_transform::update_target_profile(const rs2::frame& f, depth_lut_output output)
+    {
+        if (f.get_profile().get() != _source_stream_profile.get())
+        {
+            _source_stream_profile = f.get_profile();
+            _target_stream_profile = rs2::stream_profile();
+
+            auto info = disparity_info::update_info_from_frame(f);
+            _stereoscopic_depth = info.stereoscopic_depth;
+            _d2d_convert_factor = info.d2d_convert_factor;
+        }
+
+        // Like disparity_transform, disparity needs the baseline of a stereo sensor
+        auto no_disparity = output == depth_lut_output::disparity && !_stereoscopic_depth;
+        if (no_disparity)
+            output = depth_lut_output::z16;
+
+        auto format = RS2_FORMAT_Z16;
+        if (output == depth_lut_output::disparity) format = RS2_FORMAT_DISPARITY32;
+        if (output == depth_lut_output::meters) format = RS2_FORMAT_DISTANCE;
+        if (_target_stream_profile && _target_stream_profile.format() == format)
+            return output;
+
+        if (no_disparity)
+            LOG_WARNING("Depth LUT transform: the depth sensor is not a stereo sensor, its depth is thresholded but not converted to disparity");
+
+        _target_stream_profile = f.get_profile().clone(RS2_STREAM_DEPTH, 0, format);
+
+        auto src_vspi = dynamic_cast<video_stream_profile_interface*>(_source_stream_profile.get()->profile);
+        auto tgt_vspi = dynamic_cast<video_stream_profile_interface*>(_target_stream_profile.get()->profile);
+        rs2_intrinsics src_intrin = src_vspi->get_intrinsics();
+        tgt_vspi->set_intrinsics([src_intrin]() { return src_intrin; });
+        tgt_vspi->set_dims(src_intrin.width, src_intrin.height);
+        return output;
+    }
+
+    rs2::frame depth_lut_transform::process_frame(const rs2::frame_source& source, const rs2::frame& f)
+    {
+        if (!f.is<rs2::depth_frame>()) return f;
+
+        // The settings are read under the lock the block holds while processing
+        float min = _min, max = _max;
+        auto output = update_target_profile(f, _output);
+
+        auto orig = dynamic_cast<librealsense::depth_frame*>((frame_interface*)f.get());
+        std::vector<depth_mapping> chain{ depth_mapping::make_threshold(min, max) };
+        if (output == depth_lut_output::disparity) chain.push_back(depth_mapping::make_disparity(_d2d_convert_factor));
+        if (output == depth_lut_output::meters) chain.push_back(depth_mapping::make_meters());
+        _lut.set(chain, orig->get_units());
+
+        auto vf = f.as<rs2::depth_frame>();
+        auto width = vf.get_width();
+        auto height = vf.get_height();
+        auto bpp = _lut.get_bpp();
+        auto new_f = source.allocate_video_frame(_target_stream_profile, f, int(bpp), width, height, int(width * bpp),
+            output == depth_lut_output::disparity ? RS2_EXTENSION_DISPARITY_FRAME : RS2_EXTENSION_DEPTH_FRAME);
+        if (!new_f)
+            return f;
+
+        auto ptr = dynamic_cast<librealsense::depth_frame*>((frame_interface*)new_f.get());
+        ptr->set_sensor(orig->get_sensor());
+
+        auto in = reinterpret_cast<const uint16_t*>(orig->get_frame_data());
+        auto out = const_cast<uint8_t*>(ptr->get_frame_data());
+        get_processing_pool().parallel_for(height, [&](int begin, int end)
+        {
+            _lut.apply(in + size_t(begin) * width, out + size_t(begin) * width * bpp, size_t(end - begin) * width);
+        }, DEPTH_LUT_BAND_ROWS);
+
+        return new_f;
+    }
+}
@@ -0,0 +1,99 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "../include/librealsense2/hpp/rs_frame.hpp"
+#include "synthetic-stream.h"
+#include "concurrency.h"
+
+namespace librealsense
+{
+    // One mapping of Z16 depth values. A threshold keeps the values within [min, max] meters and zeroes the others,
+    // a conversion to meters or to disparity changes the output type and so ends a chain
+    struct depth_mapping
+    {
+        enum mapping_type
+        {
+            threshold,
+            to_meters,
+            to_disparity
+        };
+
+        mapping_type type;
+        float min, max;             // Threshold range in meters
+        float d2d_convert_factor;   // Disparity of a depth of one unit, see disparity_info
+
+        static depth_mapping make_threshold(float min, float max) { return{ threshold, min, max, 0.f }; }
+        static depth_mapping make_meters() { return{ to_meters, 0.f, 0.f, 0.f }; }
+        static depth_mapping make_disparity(float d2d_convert_factor) { return{ to_disparity, 0.f, 0.f, d2d_convert_factor }; }
+
+        bool operator==(const depth_mapping& other) const
+        {
+            return type == other.type && min == other.min && max == other.max && d2d_convert_factor == other.d2d_convert_factor;
+        }
+    };
+
+    // A chain of depth mappings folded into a table of its results for all 16 bit values, so that the whole chain
+    // costs one lookup per pixel. The results match the per-pixel arithmetic of threshold, units_transform and
+    // disparity_transform exactly
+    class depth_lut
+    {
+    public:
+        depth_lut() : _depth_units(0.f), _format(RS2_FORMAT_ANY) {}
+
+        // Rebuilds the table unless chain and depth_units are those of the last call.
+        // Throws when a conversion is followed by another mapping
+        void set(const std::vector<depth_mapping>& chain, float depth_units);
+
+        // Z16, DISPARITY32 or DISTANCE, according to the last mapping of the chain
+        rs2_format get_format() const { return _format; }
+        size_t get_bpp() const { return _format == RS2_FORMAT_Z16 ? sizeof(uint16_t) : sizeof(float); }
+
+        // Maps count values into out, of the type of get_format(). Vectorized where the CPU allows
+        void apply(const uint16_t* in, void* out, size_t count) const;
+
+        static const int TABLE_SIZE = 0x10000;
+
+    private:
+        std::vector<depth_mapping> _chain;
+        float _depth_units;
+        rs2_format _format;
+        std::vector<uint16_t> _z16;     // One entry of padding, the vectorized lookup reads 32 bits per value
+        std::vector<float> _values;
+    };
+
+    enum class depth_lut_output : uint8_t
+    {
+        z16,        // Thresholded depth
+        disparity,  // DISPARITY32 of stereo depth, other depth is only thresholded
+        meters,     // DISTANCE
+        count
+    };
+
+    // Thresholds Z16 depth and converts it to disparity or meters in a single pass, in place of a chain of
+    // threshold and disparity_transform or units_transform blocks each producing its own frame
+    class depth_lut_transform : public stream_filter_processing_block
+    {
+    public:
+        depth_lut_transform();
+
+    protected:
+        rs2::frame process_frame(const rs2::frame_source& source, const rs2::frame& f) override;
+
+    private:
+        // The output the frame gets, depth of a sensor without a stereo baseline has no disparity and is only thresholded
+        depth_lut_output update_target_profile(const rs2::frame& f, depth_lut_output output);
+
+        float                   _min_param, _max_param;
+        uint8_t                 _output_param;
+        float                   _min, _max;
+        depth_lut_output        _output;
+        rs2::stream_profile     _source_stream_profile;
+        rs2::stream_profile     _target_stream_profile;
+        bool                    _stereoscopic_depth;
+        float                   _d2d_convert_factor;
+        depth_lut               _lut;
+    };
+    MAP_EXTENSION(RS2_EXTENSION_DEPTH_LUT_TRANSFORM, librealsense::depth_lut_transform);
+}
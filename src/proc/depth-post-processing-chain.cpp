@@ -0,0 +1,269 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#include "../include/librealsense2/hpp/rs_sensor.hpp"
+#include "../include/librealsense2/hpp/rs_processing.hpp"
+
+#include <cmath>
+#include "option.h"
+#include "context.h"
+#include "core/video.h"
+#include "proc/synthetic-stream.h"
+#include "proc/depth-post-processing-chain.h"
+#include "proc/decimation-filter.h"
+#include "proc/spatial-filter.h"
+#include "proc/hole-filling-filter.h"
+
+namespace librealsense
+{
+    depth_chain::depth_chain(thread_pool& pool)
+        : _pool(pool),
+        _cur_frame_index(0),
+        _temporal_alpha(0.f),
+        _temporal_delta(0.f),
+        _temporal_persistence(0)
+    {
+        _persistence_map.fill(0);
+    }
+
+    void depth_chain::output_size(const depth_chain_settings& settings, size_t width, size_t height,
+        size_t& out_width, size_t& out_height)
+    {
+        out_width = width;
+        out_height = height;
+
+        // Same as decimation_filter, the decimated image is padded to multiples of 4
+        if (auto scale = settings.decimation_scale)
+        {
+            out_width = (width / scale + 3) / 4 * 4;
+            out_height = (height / scale + 3) / 4 * 4;
+        }
+    }
+
+    void depth_chain::update_temporal_state(const depth_chain_settings& settings, size_t pixels)
+    {
+        // The temporal filter restarts on a new profile and on every change of its options
+        if (_last_frame.size() == pixels && settings.temporal_alpha == _temporal_alpha
+            && settings.temporal_delta == _temporal_delta && settings.temporal_persistence == _temporal_persistence)
+            return;
+
+        _last_frame.assign(pixels, 0.f);
+        _history.assign(pixels, 0);
+        _cur_frame_index = 0;
+        _temporal_alpha = settings.temporal_alpha;
+        _temporal_delta = settings.temporal_delta;
+        _temporal_persistence = settings.temporal_persistence;
+        make_persistence_map(_temporal_persistence, _persistence_map);
+    }
+
+    void depth_chain::process(const uint16_t* in, size_t width, size_t height, uint16_t* out, const depth_chain_settings& settings)
+    {
+        size_t out_width, out_height;
+        output_size(settings, width, height, out_width, out_height);
+
+        auto scale = settings.decimation_scale;
+        auto real_width = scale ? width / scale : width;
+        auto real_height = scale ? int(height / scale) : int(height);
+        auto w = int(out_width);
+        auto h = int(out_height);
+        auto disparity = settings.spatial || settings.temporal;
+        auto spatial_passes = settings.spatial ? settings.spatial_iterations : 0;
+
+        if (disparity)
+        {
+            _to_disparity.set({ depth_mapping::make_disparity(settings.d2d_convert_factor) }, settings.depth_units);
+            _disparity.resize(out_width * out_height);
+            if (scale) _decimated.resize(out_width * out_height);
+        }
+        if (settings.temporal)
+            update_temporal_state(settings, out_width * out_height);
+
+        // Decimated depth, where the disparity stages read it from, or the output without them
+        auto depth = disparity ? _decimated.data() : out;
+        auto disp = _disparity.data();
+
+        // Decimation, depth to disparity and the first horizontal spatial pass, tile by tile
+        for_each_tile(h, [&](int first, int last)
+        {
+            if (scale)
+            {
+                auto real_last = std::min(last, real_height);
+                if (first < real_last)
+                    decimate_depth_rows(in, width, scale, real_width, depth, out_width, first, real_last);
+                if (real_last < last)
+                    std::fill(depth + size_t(std::max(first, real_last)) * out_width, depth + size_t(last) * out_width, uint16_t(0));
+            }
+            else if (!disparity)
+                std::copy(in + size_t(first) * out_width, in + size_t(last) * out_width, out + size_t(first) * out_width);
+
+            if (disparity)
+            {
+                auto source = scale ? depth : in;
+                _to_disparity.apply(source + size_t(first) * out_width, disp + size_t(first) * out_width, size_t(last - first) * out_width);
+            }
+
+            if (spatial_passes)
+                spatial_filter_rows_fp(disp, w, first, last, settings.spatial_alpha, settings.spatial_delta);
+        });
+
+        // The vertical spatial passes need whole columns, and every further iteration runs after them
+        for (int i = 0; i < spatial_passes; i++)
+        {
+            if (i > 0)
+            {
+                for_each_tile(h, [&](int first, int last)
+                {
+                    spatial_filter_rows_fp(disp, w, first, last, settings.spatial_alpha, settings.spatial_delta);
+                });
+            }
+
+            _pool.parallel_for((w + 7) / 8, [&](int begin, int end)
+            {
+                spatial_filter_columns_fp(disp, w, h, begin * 8, std::min(end * 8, w), settings.spatial_alpha, settings.spatial_delta);
+            }, SPATIAL_BAND_COLUMNS / 8);
+        }
+
+        // Spatial holes filling, temporal filter, disparity to depth and hole filling from the left, tile by tile
+        unsigned char mask = 1 << _cur_frame_index;
+        for_each_tile(h, [&](int first, int last)
+        {
+            auto offset = size_t(first) * out_width;
+            auto count = size_t(last - first) * out_width;
+
+            if (settings.spatial && settings.spatial_holes_radius)
+                spatial_holes_fill_rows(disp, out_width, first, last, settings.spatial_holes_radius);
+
+            if (settings.temporal)
+                temporal_smooth(disp + offset, _last_frame.data() + offset, _history.data() + offset, count,
+                    settings.temporal_alpha, 1.f - settings.temporal_alpha, settings.temporal_delta, mask, _persistence_map.data());
+
+            if (disparity)
+            {
+                // Same arithmetic as disparity_transform
+                for (size_t i = offset; i < offset + count; i++)
+                {
+                    float input = disp[i];
+                    out[i] = std::isnormal(input) ? static_cast<uint16_t>((settings.d2d_convert_factor / input) + 0.5f) : 0;
+                }
+            }
+
+            if (settings.hole_filling && settings.hole_filling_mode == hf_fill_from_left)
+                holes_fill_rows(out, out_width, out_height, first, last, settings.hole_filling_mode);
+        });
+
+        if (settings.temporal)
+            _cur_frame_index = (_cur_frame_index + 1) % 8;
+
+        // The fills from around read the filled row above, in raster order over the whole image
+        if (settings.hole_filling && settings.hole_filling_mode != hf_fill_from_left)
+            holes_fill_rows(out, out_width, out_height, 0, h, settings.hole_filling_mode);
+    }
+
+    depth_post_processing_chain::depth_post_processing_chain(std::shared_ptr<processing_block_interface> decimation,
+        std::shared_ptr<processing_block_interface> spatial,
+        std::shared_ptr<processing_block_interface> temporal,
+        std::shared_ptr<processing_block_interface> hole_filling)
+        : stream_filter_processing_block("Depth Post-Processing Chain"),
+        _decimation(decimation), _spatial(spatial), _temporal(temporal), _hole_filling(hole_filling),
+        _target_scale(0),
+        _d2d_convert_factor(0.f),
+        _chain(get_processing_pool())
+    {
+        _stream_filter.format = RS2_FORMAT_Z16;
+        _stream_filter.stream = RS2_STREAM_DEPTH;
+    }
+
+    depth_chain_settings depth_post_processing_chain::query_settings() const
+    {
+        depth_chain_settings settings;
+
+        if (_decimation)
+            settings.decimation_scale = static_cast<size_t>(_decimation->get_option(RS2_OPTION_FILTER_MAGNITUDE).query());
+
+        if ((settings.spatial = (_spatial != nullptr)))
+        {
+            settings.spatial_alpha = _spatial->get_option(RS2_OPTION_FILTER_SMOOTH_ALPHA).query();
+            settings.spatial_delta = static_cast<float>(static_cast<uint8_t>(_spatial->get_option(RS2_OPTION_FILTER_SMOOTH_DELTA).query()));
+            settings.spatial_iterations = static_cast<int>(_spatial->get_option(RS2_OPTION_FILTER_MAGNITUDE).query());
+            settings.spatial_holes_radius = spatial_holes_filling_radius(static_cast<uint8_t>(_spatial->get_option(RS2_OPTION_HOLES_FILL).query()));
+        }
+
+        if ((settings.temporal = (_temporal != nullptr)))
+        {
+            settings.temporal_alpha = _temporal->get_option(RS2_OPTION_FILTER_SMOOTH_ALPHA).query();
+            settings.temporal_delta = static_cast<float>(static_cast<uint8_t>(_temporal->get_option(RS2_OPTION_FILTER_SMOOTH_DELTA).query()));
+            settings.temporal_persistence = static_cast<uint8_t>(_temporal->get_option(RS2_OPTION_HOLES_FILL).query());
+        }
+
+        if ((settings.hole_filling = (_hole_filling != nullptr)))
+            settings.hole_filling_mode = static_cast<uint8_t>(_hole_filling->get_option(RS2_OPTION_HOLES_FILL).query());
+
+        return settings;
+    }
+
+    void depth_post_processing_chain::update_target_profile(const rs2::frame& f, size_t scale)
+    {
+        if (f.get_profile().get() == _source_stream_profile.get() && scale == _target_scale)
+            return;
+
+        _source_stream_profile = f.get_profile();
+        _target_stream_profile = _source_stream_profile.clone(_source_stream_profile.stream_type(), _source_stream_profile.stream_index(), _source_stream_profile.format());
+        _target_scale = scale;
+
+        // Intrinsics of the decimated image, as set by decimation_filter
+        auto src_vspi = dynamic_cast<video_stream_profile_interface*>(_source_stream_profile.get()->profile);
+        auto tgt_vspi = dynamic_cast<video_stream_profile_interface*>(_target_stream_profile.get()->profile);
+        rs2_intrinsics src_intrin = src_vspi->get_intrinsics();
+        rs2_intrinsics tgt_intrin = src_intrin;
+        if (scale)
+        {
+            size_t width, height;
+            depth_chain_settings settings;
+            settings.decimation_scale = scale;
+            depth_chain::output_size(settings, src_vspi->get_width(), src_vspi->get_height(), width, height);
+
+            tgt_intrin.width = int(width);
+            tgt_intrin.height = int(height);
+            tgt_intrin.fx = src_intrin.fx / scale;
+            tgt_intrin.fy = src_intrin.fy / scale;
+            tgt_intrin.ppx = src_intrin.ppx / scale;
+            tgt_intrin.ppy = src_intrin.ppy / scale;
+        }
+        tgt_vspi->set_intrinsics([tgt_intrin]() { return tgt_intrin; });
+        tgt_vspi->set_dims(tgt_intrin.width, tgt_intrin.height);
+
+        // The disparity stages of the separate blocks run on the decimated image, with its focal length
+        _info = disparity_info::update_info_from_frame(f);
+        if (_info.stereoscopic_depth)
+            _d2d_convert_factor = disparity_info::convert_factor(_info.stereo_baseline_meter, tgt_intrin.fx, _info.depth_units);
+    }
+
+    rs2::frame depth_post_processing_chain::process_frame(const rs2::frame_source& source, const rs2::frame& f)
+    {
+        if (!f.is<rs2::depth_frame>()) return f;
+
+        auto settings = query_settings();
+        update_target_profile(f, settings.decimation_scale);
+
+        if (!_info.stereoscopic_depth && (settings.spatial || settings.temporal))
+            return f;
+
+        settings.depth_units = _info.depth_units;
+        settings.d2d_convert_factor = _d2d_convert_factor;
+
+        auto vf = f.as<rs2::video_frame>();
+        size_t width = vf.get_width();
+        size_t height = vf.get_height();
+        size_t out_width, out_height;
+        depth_chain::output_size(settings, width, height, out_width, out_height);
+
+        auto tgt = source.allocate_video_frame(_target_stream_profile, f, int(sizeof(uint16_t)), int(out_width), int(out_height),
+            int(out_width * sizeof(uint16_t)), RS2_EXTENSION_DEPTH_FRAME);
+        if (!tgt)
+            return f;
+
+        _chain.process(static_cast<const uint16_t*>(vf.get_data()), width, height,
+            static_cast<uint16_t*>(const_cast<void*>(tgt.get_data())), settings);
+        return tgt;
+    }
+}
@@ -0,0 +1,113 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include <array>
+#include "../include/librealsense2/hpp/rs_frame.hpp"
+#include "synthetic-stream.h"
+#include "concurrency.h"
+#include "depth-lut-transform.h"
+#include "disparity-transform.h"
+#include "temporal-filter.h"
+
+namespace librealsense
+{
+    // Settings of the stages of a depth_chain, as set on the options of their filters
+    struct depth_chain_settings
+    {
+        size_t  decimation_scale = 0;       // 0 without a decimation stage
+        bool    spatial = false;
+        float   spatial_alpha = 0.f;
+        float   spatial_delta = 0.f;
+        int     spatial_iterations = 0;
+        uint8_t spatial_holes_radius = 0;   // See spatial_holes_filling_radius
+        bool    temporal = false;
+        float   temporal_alpha = 0.f;
+        float   temporal_delta = 0.f;
+        uint8_t temporal_persistence = 0;
+        bool    hole_filling = false;
+        uint8_t hole_filling_mode = 0;
+        float   depth_units = 0.f;
+        float   d2d_convert_factor = 0.f;   // Of the decimated image, see disparity_info
+    };
+
+    // The recommended depth post-processing chain: decimation, depth to disparity, spatial filter, temporal filter,
+    // disparity to depth and hole filling, with the results of the separate blocks. The stages local to pixels and
+    // rows run fused over tiles of rows that stay in cache, the tiles in parallel; only the column passes of the
+    // spatial filter and the hole filling from around, which depend on whole columns, walk the image on their own.
+    // The disparity stages run with the spatial or temporal stage only
+    class depth_chain
+    {
+    public:
+        explicit depth_chain(thread_pool& pool);
+
+        // Size of the output for an input of width x height, padded to multiples of 4 by a decimation stage
+        static void output_size(const depth_chain_settings& settings, size_t width, size_t height,
+            size_t& out_width, size_t& out_height);
+
+        // Filters a Z16 depth image of width x height into out, of output_size(). The temporal history carries
+        // from call to call, and restarts when the output size or the temporal settings change
+        void process(const uint16_t* in, size_t width, size_t height, uint16_t* out, const depth_chain_settings& settings);
+
+        // 16 rows of a 1280 x 720 image decimated by 2 take ~210KB over the input and all the buffers of the chain
+        static const int TILE_ROWS = 16;
+
+    private:
+        template<class T>
+        void for_each_tile(int height, T body)
+        {
+            _pool.parallel_for((height + TILE_ROWS - 1) / TILE_ROWS, [&](int begin, int end)
+            {
+                for (int tile = begin; tile < end; tile++)
+                    body(tile * TILE_ROWS, std::min((tile + 1) * TILE_ROWS, height));
+            });
+        }
+
+        void update_temporal_state(const depth_chain_settings& settings, size_t pixels);
+
+        thread_pool&            _pool;
+        depth_lut               _to_disparity;
+        std::vector<uint16_t>   _decimated;
+        std::vector<float>      _disparity;
+        std::vector<float>      _last_frame;    // Temporal filter state, see temporal_smooth
+        std::vector<uint8_t>    _history;
+        uint8_t                 _cur_frame_index;
+        float                   _temporal_alpha;
+        float                   _temporal_delta;
+        uint8_t                 _temporal_persistence;
+        std::array<uint8_t, PRESISTENCY_LUT_SIZE> _persistence_map;
+    };
+
+    // A single block in place of the chain decimation_filter, disparity_transform, spatial_filter, temporal_filter,
+    // disparity_transform and hole_filling_filter, each allocating and streaming a frame of its own. The stages
+    // follow the options of the filters given on construction, a missing filter skips its stage.
+    // With a spatial or temporal stage, which run on disparity, frames of depth sensors that are not stereo pass unchanged
+    class depth_post_processing_chain : public stream_filter_processing_block
+    {
+    public:
+        depth_post_processing_chain(std::shared_ptr<processing_block_interface> decimation,
+            std::shared_ptr<processing_block_interface> spatial,
+            std::shared_ptr<processing_block_interface> temporal,
+            std::shared_ptr<processing_block_interface> hole_filling);
+
+    protected:
+        rs2::frame process_frame(const rs2::frame_source& source, const rs2::frame& f) override;
+
+    private:
+        depth_chain_settings query_settings() const;
+        void update_target_profile(const rs2::frame& f, size_t scale);
+
+        std::shared_ptr<processing_block_interface> _decimation;
+        std::shared_ptr<processing_block_interface> _spatial;
+        std::shared_ptr<processing_block_interface> _temporal;
+        std::shared_ptr<processing_block_interface> _hole_filling;
+        rs2::stream_profile     _source_stream_profile;
+        rs2::stream_profile     _target_stream_profile;
+        size_t                  _target_scale;
+        disparity_info::info    _info;
+        float                   _d2d_convert_factor;    // Of the target profile
+        depth_chain             _chain;
+    };
+    MAP_EXTENSION(RS2_EXTENSION_DEPTH_POST_PROCESSING_CHAIN, librealsense::depth_post_processing_chain);
+}
@@ -73,7 +73,10 @@ namespace librealsense
             auto src = f.as<rs2::video_frame>();
 
             if (_transform_to_disparity)
-                convert<uint16_t, float>(src.get_data(), const_cast<void*>(tgt.get_data()));
+            {
+                _lut.set({ depth_mapping::make_disparity(_d2d_convert_factor) }, _depth_units);
+                _lut.apply(reinterpret_cast<const uint16_t*>(src.get_data()), const_cast<void*>(tgt.get_data()), _width * _height);
+            }
             else
                 convert<float, uint16_t>(src.get_data(), const_cast<void*>(tgt.get_data()));
         }
@@ -8,6 +8,7 @@
 #include "../include/librealsense2/hpp/rs_frame.hpp"
 #include "../include/librealsense2/hpp/rs_processing.hpp"
 #include "synthetic-stream.h"
+#include "depth-lut-transform.h"
 
 namespace librealsense
 {
@@ -62,6 +63,7 @@ namespace librealsense
         float                   _d2d_convert_factor;
         size_t                  _width, _height;
         size_t                  _bpp;
+        depth_lut               _lut;   // Depth to disparity, a function of the 16 bit depth value
     };
     MAP_EXTENSION(RS2_EXTENSION_DISPARITY_FILTER, librealsense::disparity_transform);
 
@@ -71,9 +73,18 @@ namespace librealsense
         struct info {
             bool stereoscopic_depth = false;
             float depth_units = 0;
+            float stereo_baseline_meter = 0;
             float d2d_convert_factor = 0;
         };
 
+        // Disparity of a depth of one unit, for a stereo baseline and the focal length of the depth image
+        static float convert_factor(float stereo_baseline_meter, float focal_lenght_mm, float depth_units)
+        {
+            const uint8_t fractional_bits = 5;
+            const uint8_t fractions = 1 << fractional_bits;
+            return (stereo_baseline_meter * focal_lenght_mm * fractions) / depth_units;
+        }
+
         static info update_info_from_frame(const rs2::frame& f)
         {
             // Check if the new frame originated from stereo-based depth sensor
@@ -81,7 +92,6 @@ namespace librealsense
             auto snr = ((frame_interface*)f.get())->get_sensor().get();
             librealsense::depth_stereo_sensor* dss;
             auto info = disparity_info::info();
-            float stereo_baseline_meter;
 
             // Playback sensor
             if (auto a = As<librealsense::extendable_interface>(snr))
@@ -91,7 +101,7 @@ namespace librealsense
                 {
                     dss = ptr;
                     info.depth_units = dss->get_depth_scale();
-                    stereo_baseline_meter = dss->get_stereo_baseline_mm()*0.001f;
+                    info.stereo_baseline_meter = dss->get_stereo_baseline_mm()*0.001f;
                 }
             }
             else // Live sensor
@@ -101,7 +111,7 @@ namespace librealsense
                 {
                     dss = As<librealsense::depth_stereo_sensor>(snr);
                     info.depth_units = dss->get_depth_scale();
-                    stereo_baseline_meter = dss->get_stereo_baseline_mm()* 0.001f;
+                    info.stereo_baseline_meter = dss->get_stereo_baseline_mm()* 0.001f;
                 }
             }
 
@@ -109,9 +119,7 @@ namespace librealsense
             {
                 auto vp = f.get_profile().as<rs2::video_stream_profile>();
                 auto focal_lenght_mm = vp.get_intrinsics().fx;
-                const uint8_t fractional_bits = 5;
-                const uint8_t fractions = 1 << fractional_bits;
-                info.d2d_convert_factor = (stereo_baseline_meter * focal_lenght_mm * fractions) / info.depth_units;
+                info.d2d_convert_factor = convert_factor(info.stereo_baseline_meter, focal_lenght_mm, info.depth_units);
             }
 
             return info;
@@ -13,147 +13,160 @@ namespace librealsense
         hf_max_value
     };
 
-    class hole_filling_filter : public depth_processing_block
+    // Implementations of the hole-filling methods, over the rows [first, last) of an image. Filling from the left
+    // is local to every row; the fills from around read the rows above and below, the one above already filled,
+    // so consecutive calls must cover the rows in order, after all rows below are final
+    template<typename T>
+    inline void holes_fill_left(T* image_data, size_t width, int first, int last)
     {
-    public:
-        hole_filling_filter();
+        std::function<bool(T*)> fp_oper = [](T* ptr) { return !*((int *)ptr); };
+        std::function<bool(T*)> uint_oper = [](T* ptr) { return !(*ptr); };
+        auto empty = (std::is_floating_point<T>::value) ? fp_oper : uint_oper;
 
-    protected:
-        void update_configuration(const rs2::frame& f);
-        rs2::frame process_frame(const rs2::frame_source& source, const rs2::frame& f) override;
+        T* p = image_data + first * width;
 
-        rs2::frame prepare_target_frame(const rs2::frame& f, const rs2::frame_source& source);
-
-        template<typename T>
-        void apply_hole_filling(void * image_data)
+        for (int j = first; j < last; ++j)
         {
-            bool fp = (std::is_floating_point<T>::value);
-            T* data = reinterpret_cast<T*>(image_data);
-
-            // Select and apply the appropriate hole filling method
-            switch (_hole_filling_mode)
+            ++p;
+            for (int i = 1; i < width; ++i)
             {
-            case hf_fill_from_left:
-                holes_fill_left(data, _width, _height, _stride);
-                break;
-            case hf_farest_from_around:
-                holes_fill_farest(data, _width, _height, _stride);
-                break;
-            case hf_nearest_from_around:
-                holes_fill_nearest(data, _width, _height, _stride);
-                break;
-            default:
-                throw invalid_value_exception(to_string()
-                    << "Unsupported hole filling mode: " << _hole_filling_mode << " is out of range.");
+                if (empty(p))
+                    *p = *(p - 1);
+                ++p;
             }
         }
+    }
 
-        // Implementations of the hole-filling methods
-        template<typename T>
-        inline void holes_fill_left(T* image_data, size_t width, size_t height, size_t stride)
-        {
-            std::function<bool(T*)> fp_oper = [](T* ptr) { return !*((int *)ptr); };
-            std::function<bool(T*)> uint_oper = [](T* ptr) { return !(*ptr); };
-            auto empty = (std::is_floating_point<T>::value) ? fp_oper : uint_oper;
+    template<typename T>
+    inline void holes_fill_farest(T* image_data, size_t width, size_t height, int first, int last)
+    {
+        std::function<bool(T*)> fp_oper = [](T* ptr) { return !*((int *)ptr); };
+        std::function<bool(T*)> uint_oper = [](T* ptr) { return !(*ptr); };
+        auto empty = (std::is_floating_point<T>::value) ? fp_oper : uint_oper;
 
-            T* p = image_data;
+        first = std::max(first, 1);
+        last = std::min(last, int(height) - 1);
 
-            for (int j = 0; j < height; ++j)
+        T tmp = 0;
+        T * p = image_data + first * width;
+        T * q = nullptr;
+        for (int j = first; j < last; ++j)
+        {
+            ++p;
+            for (int i = 1; i < width; ++i)
             {
-                ++p;
-                for (int i = 1; i < width; ++i)
+                if (empty(p))
                 {
-                    if (empty(p))
-                        *p = *(p - 1);
-                    ++p;
+                    tmp = *(p - width);
+
+                    q = p - width - 1;
+                    if (*q > tmp)
+                        tmp = *q;
+
+                    q = p - 1;
+                    if (*q > tmp)
+                        tmp = *q;
+
+                    q = p + width - 1;
+                    if (*q > tmp)
+                        tmp = *q;
+
+                    q = p + width;
+                    if (*q > tmp)
+                        tmp = *q;
+
+                    *p = tmp;
                 }
+
+                p++;
             }
         }
+    }
 
-        template<typename T>
-        inline void holes_fill_farest(T* image_data, size_t width, size_t height, size_t stride)
+    template<typename T>
+    inline void holes_fill_nearest(T* image_data, size_t width, size_t height, int first, int last)
+    {
+        std::function<bool(T*)> fp_oper = [](T* ptr) { return !*((int *)ptr); };
+        std::function<bool(T*)> uint_oper = [](T* ptr) { return !(*ptr); };
+        auto empty = (std::is_floating_point<T>::value) ? fp_oper : uint_oper;
+
+        first = std::max(first, 1);
+        last = std::min(last, int(height) - 1);
+
+        T tmp = 0;
+        T * p = image_data + first * width;
+        T * q = nullptr;
+        for (int j = first; j < last; ++j)
         {
-            std::function<bool(T*)> fp_oper = [](T* ptr) { return !*((int *)ptr); };
-            std::function<bool(T*)> uint_oper = [](T* ptr) { return !(*ptr); };
-            auto empty = (std::is_floating_point<T>::value) ? fp_oper : uint_oper;
-
-            T tmp = 0;
-            T * p = image_data + width;
-            T * q = nullptr;
-            for (int j = 1; j < height - 1; ++j)
+            ++p;
+            for (int i = 1; i < width; ++i)
             {
-                ++p;
-                for (int i = 1; i < width; ++i)
+                if (empty(p))
                 {
-                    if (empty(p))
-                    {
-                        tmp = *(p - width);
-
-                        q = p - width - 1;
-                        if (*q > tmp)
-                            tmp = *q;
+                    tmp = *(p - width);
 
-                        q = p - 1;
-                        if (*q > tmp)
-                            tmp = *q;
+                    q = p - width - 1;
+                    if (!empty(q) && (*q < tmp))
+                        tmp = *q;
 
-                        q = p + width - 1;
-                        if (*q > tmp)
-                            tmp = *q;
+                    q = p - 1;
+                    if (!empty(q) && (*q < tmp))
+                        tmp = *q;
 
-                        q = p + width;
-                        if (*q > tmp)
-                            tmp = *q;
+                    q = p + width - 1;
+                    if (!empty(q) && (*q < tmp))
+                        tmp = *q;
 
-                        *p = tmp;
-                    }
+                    q = p + width;
+                    if (!empty(q) && (*q < tmp))
+                        tmp = *q;
 
-                    p++;
+                    *p = tmp;
                 }
+
+                p++;
             }
         }
+    }
 
-        template<typename T>
-        inline void holes_fill_nearest(T* image_data, size_t width, size_t height, size_t stride)
+    // Selects and applies the hole filling method of mode
+    template<typename T>
+    void holes_fill_rows(T* image_data, size_t width, size_t height, int first, int last, uint8_t mode)
+    {
+        switch (mode)
         {
-            std::function<bool(T*)> fp_oper = [](T* ptr) { return !*((int *)ptr); };
-            std::function<bool(T*)> uint_oper = [](T* ptr) { return !(*ptr); };
-            auto empty = (std::is_floating_point<T>::value) ? fp_oper : uint_oper;
-
-            T tmp = 0;
-            T * p = image_data + width;
-            T * q = nullptr;
-            for (int j = 1; j < height - 1; ++j)
-            {
-                ++p;
-                for (int i = 1; i < width; ++i)
-                {
-                    if (empty(p))
-                    {
-                        tmp = *(p - width);
-
-                        q = p - width - 1;
-                        if (!empty(q) && (*q < tmp))
-                            tmp = *q;
+        case hf_fill_from_left:
+            holes_fill_left(image_data, width, first, last);
+            break;
+        case hf_farest_from_around:
+            holes_fill_farest(image_data, width, height, first, last);
+            break;
+        case hf_nearest_from_around:
+            holes_fill_nearest(image_data, width, height, first, last);
+            break;
+        default:
+            throw invalid_value_exception(to_string()
+                << "Unsupported hole filling mode: " << mode << " is out of range.");
+        }
+    }
 
-                        q = p - 1;
-                        if (!empty(q) && (*q < tmp))
-                            tmp = *q;
+    class hole_filling_filter : public depth_processing_block
+    {
+    public:
+        hole_filling_filter();
 
-                        q = p + width - 1;
-                        if (!empty(q) && (*q < tmp))
-                            tmp = *q;
+    protected:
+        void update_configuration(const rs2::frame& f);
+        rs2::frame process_frame(const rs2::frame_source& source, const rs2::frame& f) override;
 
-                        q = p + width;
-                        if (!empty(q) && (*q < tmp))
-                            tmp = *q;
+        rs2::frame prepare_target_frame(const rs2::frame& f, const rs2::frame_source& source);
 
-                        *p = tmp;
-                    }
+        template<typename T>
+        void apply_hole_filling(void * image_data)
+        {
+            T* data = reinterpret_cast<T*>(image_data);
 
-                    p++;
-                }
-            }
+            holes_fill_rows(data, _width, _height, 0, int(_height), _hole_filling_mode);
         }
 
     private:
@@ -6,9 +6,17 @@
 
 #include "proc/synthetic-stream.h"
 #include "proc/occlusion-filter.h"
+#include "cpu-dispatch.h"
+
+#ifdef __SSSE3__
+#include <emmintrin.h>
+#endif
 
 namespace librealsense
 {
+    static const float occZTh = 0.1f; //meters
+    static const int occDilationSz = 1;
+
     occlusion_filter::occlusion_filter() : _occlusion_filter(occlusion_none)
     {
     }
@@ -37,6 +45,135 @@ namespace librealsense
         }
     }
 
+    static void monotonic_scan_row(const float3* points, float2* uv_map, const float2* pixels_ptr, int points_width)
+    {
+        float maxInLine = -1;
+        float maxZ = 0;
+        int occDilationLeft = 0;
+
+        for (int x = 0; x < points_width; ++x)
+        {
+            if (points->z)
+            {
+                // Occlusion detection
+                if (pixels_ptr->x < maxInLine || (pixels_ptr->x == maxInLine && (points->z - maxZ) > occZTh))
+                {
+                    uv_map->x = 0.f;
+                    uv_map->y = 0.f;
+                    occDilationLeft = occDilationSz;
+                }
+                else
+                {
+                    maxInLine = pixels_ptr->x;
+                    maxZ = points->z;
+                    if (occDilationLeft > 0)
+                    {
+                        uv_map->x = 0.f;
+                        uv_map->y = 0.f;
+                        occDilationLeft--;
+                    }
+                }
+            }
+
+            ++points;
+            ++uv_map;
+            ++pixels_ptr;
+        }
+    }
+
+#ifdef __SSSE3__
+    // The running maximum of U over the valid pixels is exactly maxInLine of the scalar scan, so it is computed
+    // four pixels at a time as a prefix maximum. Only the tie case depends on maxZ, a row with a tie (or a NaN)
+    // returns false and is rescanned by monotonic_scan_row, which rewrites the same texels with the same result
+    static bool monotonic_scan_row_sse(const float3* points, float2* uv_map, const float2* pixels_ptr, int points_width)
+    {
+        static_assert(occDilationSz == 1, "The vector scan dilates by a single pixel");
+
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 lowest = _mm_set1_ps(-std::numeric_limits<float>::infinity());
+        __m128 carry = _mm_set1_ps(-1.f);
+        bool pending = false;
+
+        int x = 0;
+        for (; x + 4 <= points_width; x += 4)
+        {
+            auto xyz = reinterpret_cast<const float*>(points + x);
+            auto p0 = _mm_loadu_ps(xyz);
+            auto p1 = _mm_loadu_ps(xyz + 4);
+            auto p2 = _mm_loadu_ps(xyz + 8);
+            auto z01 = _mm_shuffle_ps(p0, p1, _MM_SHUFFLE(1, 1, 2, 2));
+            auto z23 = _mm_shuffle_ps(p2, p2, _MM_SHUFFLE(3, 3, 0, 0));
+            auto z = _mm_shuffle_ps(z01, z23, _MM_SHUFFLE(2, 0, 2, 0));
+
+            auto uv0 = _mm_loadu_ps(&pixels_ptr[x].x);
+            auto uv1 = _mm_loadu_ps(&pixels_ptr[x + 2].x);
+            auto u = _mm_shuffle_ps(uv0, uv1, _MM_SHUFFLE(2, 0, 2, 0));
+
+            auto valid = _mm_cmpneq_ps(z, zero);
+            auto valid_bits = _mm_movemask_ps(valid);
+            if (!valid_bits)
+                continue;
+
+            // Inclusive prefix maximum of the valid U values, then shifted by one lane for maxInLine
+            auto m = _mm_or_ps(_mm_and_ps(valid, u), _mm_andnot_ps(valid, lowest));
+            m = _mm_max_ps(m, _mm_move_ss(_mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(m), 4)), lowest));
+            m = _mm_max_ps(m, _mm_movelh_ps(lowest, m));
+            auto inclusive = _mm_max_ps(m, carry);
+            auto max_in_line = _mm_move_ss(_mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(inclusive), 4)), carry);
+
+            auto less = _mm_cmplt_ps(u, max_in_line);
+            auto greater = _mm_cmpgt_ps(u, max_in_line);
+            if (_mm_movemask_ps(_mm_andnot_ps(_mm_or_ps(less, greater), valid)))
+                return false;
+
+            carry = _mm_shuffle_ps(inclusive, inclusive, _MM_SHUFFLE(3, 3, 3, 3));
+            auto occluded_bits = _mm_movemask_ps(less) & valid_bits;
+            if (!occluded_bits && !pending)
+                continue;
+
+            for (int lane = 0; lane < 4; ++lane)
+            {
+                if (!(valid_bits & (1 << lane)))
+                    continue;
+                if (occluded_bits & (1 << lane))
+                {
+                    uv_map[x + lane] = { 0.f, 0.f };
+                    pending = true;
+                }
+                else if (pending)
+                {
+                    uv_map[x + lane] = { 0.f, 0.f };
+                    pending = false;
+                }
+            }
+        }
+
+        float maxInLine = _mm_cvtss_f32(carry);
+        for (; x < points_width; ++x)
+        {
+            if (!points[x].z)
+                continue;
+            if (!(pixels_ptr[x].x < maxInLine) && !(pixels_ptr[x].x > maxInLine))
+                return false;
+            if (pixels_ptr[x].x < maxInLine)
+            {
+                uv_map[x] = { 0.f, 0.f };
+                pending = true;
+            }
+            else
+            {
+                maxInLine = pixels_ptr[x].x;
+                if (pending)
+                {
+                    uv_map[x] = { 0.f, 0.f };
+                    pending = false;
+                }
+            }
+        }
+        return true;
+    }
+#endif
+
     // IMPORTANT! This implementation is based on the assumption that the RGB sensor is positioned strictly to the left of the depth sensor.
     // namely D415/D435 and SR300. The implementation WILL NOT work properly for different setups
     // Heuristic occlusion invalidation algorithm:
@@ -45,49 +182,28 @@ namespace librealsense
     // -  The occlusion is designated as U coordinate for a given pixel is less than the U coordinate of the predecessing pixel.
     // -  The UV mapping for the occluded pixel is reset to (0,0). Later on the (0,0) coordinate in the texture map is overwritten
     //    with a invalidation color such as black/magenta according to the purpose (production/debugging)
+    // Every line is scanned on its own, so the lines are split between the threads of the pool
     void occlusion_filter::monotonic_heuristic_invalidation(float3* points, float2* uv_map, const std::vector<float2> & pix_coord) const
     {
-        float occZTh = 0.1f; //meters
-        int occDilationSz = 1;
         auto pixels_ptr = pix_coord.data();
-        auto points_width = _depth_intrinsics->width;
-        auto points_height = _depth_intrinsics->height;
+        int points_width = _depth_intrinsics->width;
+        int points_height = _depth_intrinsics->height;
+#ifdef __SSSE3__
+        auto vectorized = get_simd_level() >= simd_level::sse2;
+#endif
 
-        for (size_t y = 0; y < points_height; ++y)
+        get_processing_pool().parallel_for(points_height, [&](int begin, int end)
         {
-            float maxInLine = -1;
-            float maxZ = 0;
-            int occDilationLeft = 0;
-
-            for (size_t x = 0; x < points_width; ++x)
+            for (int y = begin; y < end; ++y)
             {
-                if (points->z)
-                {
-                    // Occlusion detection
-                    if (pixels_ptr->x < maxInLine || (pixels_ptr->x == maxInLine && (points->z - maxZ) > occZTh))
-                    {
-                        uv_map->x = 0.f;
-                        uv_map->y = 0.f;
-                        occDilationLeft = occDilationSz;
-                    }
-                    else
-                    {
-                        maxInLine = pixels_ptr->x;
-                        maxZ = points->z;
-                        if (occDilationLeft > 0)
-                        {
-                            uv_map->x = 0.f;
-                            uv_map->y = 0.f;
-                            occDilationLeft--;
-                        }
-                    }
-                }
-
-                ++points;
-                ++uv_map;
-                ++pixels_ptr;
+                auto offset = size_t(y) * points_width;
+#ifdef __SSSE3__
+                if (vectorized && monotonic_scan_row_sse(points + offset, uv_map + offset, pixels_ptr + offset, points_width))
+                    continue;
+#endif
+                monotonic_scan_row(points + offset, uv_map + offset, pixels_ptr + offset, points_width);
             }
-        }
+        }, 16);
     }
 
     // Prepare texture map without occlusion that for every texture coordinate there no more than one depth point that is mapped to it
@@ -134,31 +250,35 @@ namespace librealsense
             }
         }
 
-        mapped_pix = pix_coord.data();
-        depth_points = points;
-        auto uv_ptr = uv_map;
-
-        // Pass2 -invalidate depth texels with occlusion traits
-        for (size_t i = 0; i < points_height; i++)
+        // Pass2 -invalidate depth texels with occlusion traits, the texels are only read so the lines run in parallel
+        get_processing_pool().parallel_for(static_cast<int>(points_height), [&](int begin, int end)
         {
-            for (size_t j = 0; j < points_width; j++)
+            auto offset = size_t(begin) * points_width;
+            auto mapped_pix = pix_coord.data() + offset;
+            auto depth_points = points + offset;
+            auto uv_ptr = uv_map + offset;
+
+            for (size_t i = begin; i < size_t(end); i++)
             {
-                if ((depth_points->z > 0.0001f) &&
-                    (mapped_pix->x > 0.f) && (mapped_pix->x < mapped_tex_width) &&
-                    (mapped_pix->y > 0.f) && (mapped_pix->y < mapped_tex_height))
+                for (size_t j = 0; j < points_width; j++)
                 {
-                    size_t texel_index = (size_t)(mapped_pix->y)*mapped_tex_width + (size_t)(mapped_pix->x);
-
-                    if ((_texels_depth[texel_index] > 0.0001f) && ((_texels_depth[texel_index] + z_threshold) < depth_points->z))
+                    if ((depth_points->z > 0.0001f) &&
+                        (mapped_pix->x > 0.f) && (mapped_pix->x < mapped_tex_width) &&
+                        (mapped_pix->y > 0.f) && (mapped_pix->y < mapped_tex_height))
                     {
-                        *uv_ptr = { 0.f, 0.f };
+                        size_t texel_index = (size_t)(mapped_pix->y)*mapped_tex_width + (size_t)(mapped_pix->x);
+
+                        if ((_texels_depth[texel_index] > 0.0001f) && ((_texels_depth[texel_index] + z_threshold) < depth_points->z))
+                        {
+                            *uv_ptr = { 0.f, 0.f };
+                        }
                     }
-                }
 
-                ++depth_points;
-                ++mapped_pix;
-                ++uv_ptr;
+                    ++depth_points;
+                    ++mapped_pix;
+                    ++uv_ptr;
+                }
             }
-        }
+        }, 16);
     }
 }
@@ -3,6 +3,7 @@
 
 #pragma once
 #include "../include/librealsense2/hpp/rs_frame.hpp"
+#include "concurrency.h"
 namespace librealsense
 {
     enum occlusion_rect_type : uint8_t {
@@ -0,0 +1,109 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#include "proc/pipelined-processing-block.h"
+#include <limits>
+
+namespace librealsense
+{
+    pipelined_processing_block::pipelined_processing_block(std::vector<std::shared_ptr<processing_block_interface>> stages,
+        unsigned int queue_size)
+        : processing_block("Pipelined Processing Block"),
+        _pending(0)
+    {
+        if (stages.empty())
+            throw invalid_value_exception("Pipelined processing block requires at least one stage");
+        for (size_t i = 0; i < stages.size(); i++)
+        {
+            if (!stages[i])
+                throw invalid_value_exception(to_string() << "Stage " << i << " of the pipelined processing block is null");
+            if (std::find(stages.begin(), stages.begin() + i, stages[i]) != stages.begin() + i)
+                throw invalid_value_exception(to_string() << "Stage " << i << " of the pipelined processing block is already a stage of it");
+        }
+
+        for (size_t i = 0; i < stages.size(); i++)
+        {
+            std::unique_ptr<stage> s(new stage(queue_size));
+            s->block = stages[i];
+
+            // Every stage feeds the next, the last one the output of the block
+            if (i + 1 < stages.size())
+            {
+                auto to_next = [this, i](frame_holder fref) { hand_over(i + 1, std::move(fref)); };
+                s->block->set_output_callback({
+                    new internal_frame_callback<decltype(to_next)>(to_next),
+                    [](rs2_frame_callback* p) { p->release(); }
+                });
+            }
+            else
+            {
+                auto to_output = [this](frame_holder fref) { _source.invoke_callback(std::move(fref)); };
+                s->block->set_output_callback({
+                    new internal_frame_callback<decltype(to_output)>(to_output),
+                    [](rs2_frame_callback* p) { p->release(); }
+                });
+            }
+            _stages.push_back(std::move(s));
+        }
+
+        for (auto&& s : _stages)
+        {
+            auto target = s.get();
+            s->worker = std::thread([this, target]()
+            {
+                // Waits for frames until the destructor clears the queue, which wakes the worker up
+                while (target->alive)
+                {
+                    frame_holder f;
+                    if (!target->queue.dequeue(&f, std::numeric_limits<unsigned int>::max()))
+                        continue;
+
+                    target->block->invoke(std::move(f));
+                    done();
+                }
+            });
+        }
+    }
+
+    pipelined_processing_block::~pipelined_processing_block()
+    {
+        // From the first stage on, so that a stage waiting for room ahead is let go by the next one, still running
+        for (auto&& s : _stages)
+        {
+            s->alive = false;
+            s->queue.clear();
+            s->worker.join();
+        }
+
+        for (auto&& s : _stages)
+            s->block->set_output_callback(nullptr);
+    }
+
+    void pipelined_processing_block::hand_over(size_t index, frame_holder frame)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_pending_mutex);
+            _pending++;
+        }
+        _stages[index]->queue.blocking_enqueue(std::move(frame));
+    }
+
+    void pipelined_processing_block::done()
+    {
+        std::lock_guard<std::mutex> lock(_pending_mutex);
+        if (--_pending == 0)
+            _pending_cv.notify_all();
+    }
+
+    void pipelined_processing_block::invoke(frame_holder frame)
+    {
+        if (frame)
+            hand_over(0, std::move(frame));
+    }
+
+    void pipelined_processing_block::wait()
+    {
+        std::unique_lock<std::mutex> lock(_pending_mutex);
+        _pending_cv.wait(lock, [this]() { return _pending == 0; });
+    }
+}
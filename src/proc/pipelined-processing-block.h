@@ -0,0 +1,53 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include <condition_variable>
+#include <thread>
+#include "synthetic-stream.h"
+#include "concurrency.h"
+
+namespace librealsense
+{
+    // Runs a chain of processing blocks with every stage on a worker of its own. The stages hand their frames over
+    // through bounded queues, so a stage works on a frame while the stage before it works on the next one and the
+    // throughput of the chain is that of its slowest stage rather than the sum of all. Every stage sees its frames
+    // one at a time and in order, ordering-sensitive stages such as temporal_filter included.
+    // The stages must deliver their frames from invoke(), as every block of the library does, and deliver them
+    // to the pipelined block from its construction on
+    class pipelined_processing_block : public processing_block
+    {
+    public:
+        // queue_size frames wait between two stages at most, a stage with a full queue ahead waits for room
+        pipelined_processing_block(std::vector<std::shared_ptr<processing_block_interface>> stages, unsigned int queue_size);
+        ~pipelined_processing_block();
+
+        // Queues the frame at the first stage and returns, waiting only while the queue is full. The frames of the last
+        // stage go to the output callback, on the worker of that stage
+        void invoke(frame_holder frame) override;
+
+        // Waits until all the frames invoked so far went through the chain
+        void wait();
+
+    private:
+        struct stage
+        {
+            explicit stage(unsigned int queue_size) : queue(queue_size), alive(true) {}
+
+            std::shared_ptr<processing_block_interface> block;
+            single_consumer_frame_queue<frame_holder>   queue;
+            std::atomic<bool>                           alive;
+            std::thread                                 worker;
+        };
+
+        void hand_over(size_t index, frame_holder frame);
+        void done();
+
+        std::vector<std::unique_ptr<stage>> _stages;
+        std::mutex                          _pending_mutex;
+        std::condition_variable             _pending_cv;
+        int                                 _pending;   // Frames queued or processed by any stage
+    };
+    MAP_EXTENSION(RS2_EXTENSION_PIPELINED_PROCESSING_BLOCK, librealsense::pipelined_processing_block);
+}
@@ -13,12 +13,15 @@
 #include "context.h"
 
 #include <iostream>
+#include <cstring>
 
 #ifdef RS2_USE_CUDA
 #include "proc/cuda/cuda-pointcloud.h"
 #endif
 #ifdef __SSSE3__
 #include "proc/sse/sse-pointcloud.h"
+#include "proc/avx/avx-pointcloud.h"
+#include "cpu-dispatch.h"
 #endif
 
 
@@ -67,10 +70,11 @@ namespace librealsense
 
     void pointcloud::inspect_depth_frame(const rs2::frame& depth)
     {
-        if (!_output_stream || _depth_stream.get_profile().get() != depth.get_profile().get())
+        if (!_output_stream || _depth_stream.get_profile().get() != depth.get_profile().get()
+            || _output_stream.format() != get_vertex_format())
         {
             _output_stream = depth.get_profile().as<rs2::video_stream_profile>().clone(
-                RS2_STREAM_DEPTH, depth.get_profile().stream_index(), RS2_FORMAT_XYZ32F);
+                RS2_STREAM_DEPTH, depth.get_profile().stream_index(), get_vertex_format());
             _depth_stream = depth;
             _depth_intrinsics = optional_value<rs2_intrinsics>();
             _depth_units = optional_value<float>();
@@ -208,15 +212,131 @@ namespace librealsense
                 _occlusion_filter->process(pframe->get_vertices(), pframe->get_texture_coordinates(), _pixels_map);
             }
         }
+
+        auto vertex_format = res.get_profile().format();
+        if (_compact_points || _pixel_indices || vertex_format != RS2_FORMAT_XYZ32F)
+            pack_points(*pframe, vertex_format);
         return res;
     }
 
+    rs2_format pointcloud::get_vertex_format() const
+    {
+        switch (_vertex_encoding)
+        {
+        case 1: return RS2_FORMAT_XYZ16;
+        case 2: return RS2_FORMAT_XYZ16F;
+        default: return RS2_FORMAT_XYZ32F;
+        }
+    }
+
+    // Round to nearest even, coordinates in meters never reach the subnormal or overflow paths in practice
+    static uint16_t float_to_half(float value)
+    {
+        uint32_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        uint32_t sign = (bits >> 16) & 0x8000;
+        bits &= 0x7fffffff;
+
+        if (bits >= 0x47800000) // Beyond the half range, infinity or NaN
+            return static_cast<uint16_t>(sign | (bits > 0x7f800000 ? 0x7e00 : 0x7c00));
+        if (bits < 0x38800000) // Subnormal half, let the float adder align and round the mantissa
+        {
+            float f;
+            memcpy(&f, &bits, sizeof(f));
+            f += 0.5f;
+            memcpy(&bits, &f, sizeof(bits));
+            return static_cast<uint16_t>(sign | (bits - 0x3f000000));
+        }
+        bits += 0xc8000fff + ((bits >> 13) & 1); // Rebias the exponent and round
+        return static_cast<uint16_t>(sign | (bits >> 13));
+    }
+
+    // XYZ16 keeps z unsigned like Z16 depth, so every depth value is exact. x and y are signed and a point
+    // far off the optical axis can leave their range, such a point is written as a point without depth
+    static bool fits_fixed(const float3& v, float units)
+    {
+        auto limit = 32767.5f * units;
+        return std::abs(v.x) < limit && std::abs(v.y) < limit;
+    }
+
+    static int16_t float_to_fixed(float value, float units)
+    {
+        return static_cast<int16_t>(std::max(-32767.f, std::min(32767.f, std::round(value / units))));
+    }
+
+    static uint16_t float_to_unsigned_fixed(float value, float units)
+    {
+        return static_cast<uint16_t>(std::max(0.f, std::min(65535.f, std::round(value / units))));
+    }
+
+    // Moves the requested points to the front of the frame in the requested encoding, one channel
+    // at a time. Every element is written at or before the place it is read from, so it packs in place
+    void pointcloud::pack_points(librealsense::points& output, rs2_format vertex_format)
+    {
+        auto count = static_cast<int>(output.get_vertex_count());
+        auto vertices = output.get_vertices();
+        auto texcoords = output.get_texture_coordinates();
+
+        auto units = *_depth_units;
+        auto fixed = vertex_format == RS2_FORMAT_XYZ16;
+        _packed_pixels.clear();
+        for (int i = 0; i < count; ++i)
+            if (!_compact_points || (vertices[i].z && (!fixed || fits_fixed(vertices[i], units))))
+                _packed_pixels.push_back(i);
+        auto packed = _packed_pixels.size();
+
+        switch (vertex_format)
+        {
+        case RS2_FORMAT_XYZ16:
+        {
+            auto xyz = reinterpret_cast<uint16_t*>(vertices);
+            for (size_t k = 0; k < packed; ++k)
+            {
+                auto v = vertices[_packed_pixels[k]];
+                if (!fits_fixed(v, units))
+                    v = { 0.f, 0.f, 0.f };
+                xyz[3 * k] = static_cast<uint16_t>(float_to_fixed(v.x, units));
+                xyz[3 * k + 1] = static_cast<uint16_t>(float_to_fixed(v.y, units));
+                xyz[3 * k + 2] = float_to_unsigned_fixed(v.z, units);
+            }
+            break;
+        }
+        case RS2_FORMAT_XYZ16F:
+        {
+            auto xyz = reinterpret_cast<uint16_t*>(vertices);
+            for (size_t k = 0; k < packed; ++k)
+            {
+                auto v = vertices[_packed_pixels[k]];
+                xyz[3 * k] = float_to_half(v.x);
+                xyz[3 * k + 1] = float_to_half(v.y);
+                xyz[3 * k + 2] = float_to_half(v.z);
+            }
+            break;
+        }
+        default:
+            if (_compact_points)
+                for (size_t k = 0; k < packed; ++k)
+                    vertices[k] = vertices[_packed_pixels[k]];
+            break;
+        }
+
+        auto packed_texcoords = reinterpret_cast<float2*>(reinterpret_cast<byte*>(vertices) + packed * points::get_vertex_size(vertex_format));
+        for (size_t k = 0; k < packed; ++k)
+            packed_texcoords[k] = texcoords[_packed_pixels[k]];
+
+        if (_pixel_indices)
+            std::copy(_packed_pixels.begin(), _packed_pixels.end(), reinterpret_cast<int*>(packed_texcoords + packed));
+
+        output.set_layout(packed, vertex_format, _pixel_indices);
+    }
+
     pointcloud::pointcloud()
         : pointcloud("Pointcloud")
     {}
 
     pointcloud::pointcloud(const char* name)
-        : stream_filter_processing_block(name)
+        : stream_filter_processing_block(name),
+        _compact_points(false), _pixel_indices(false), _vertex_encoding(0)
     {
         _occlusion_filter = std::make_shared<occlusion_filter>();
 
@@ -240,6 +360,18 @@ namespace librealsense
         occlusion_invalidation->set_description(1.f, "Heuristic");
         occlusion_invalidation->set_description(2.f, "Exhaustive");
         register_option(RS2_OPTION_FILTER_MAGNITUDE, occlusion_invalidation);
+
+        auto compact = std::make_shared<ptr_option<bool>>(false, true, true, false, &_compact_points, "Emit only points with valid depth");
+        register_option(RS2_OPTION_POINTS_COMPACT, compact);
+
+        auto pixel_indices = std::make_shared<ptr_option<bool>>(false, true, true, false, &_pixel_indices, "Add the depth pixel index of every point");
+        register_option(RS2_OPTION_POINTS_PIXEL_INDICES, pixel_indices);
+
+        auto encoding = std::make_shared<ptr_option<int>>(0, 2, 1, 0, &_vertex_encoding, "Point coordinates encoding");
+        encoding->set_description(0.f, "32-bit float");
+        encoding->set_description(1.f, "16-bit fixed point in depth units, signed x and y, unsigned z");
+        encoding->set_description(2.f, "16-bit half float");
+        register_option(RS2_OPTION_POINTS_ENCODING, encoding);
     }
 
     bool pointcloud::should_process(const rs2::frame& frame)
@@ -316,6 +448,10 @@ namespace librealsense
             return std::make_shared<librealsense::pointcloud_cuda>();
         #else
         #ifdef __SSSE3__
+            #ifdef RS2_HAVE_AVX2_POINTCLOUD
+            if (get_simd_level() >= simd_level::avx2)
+                return std::make_shared<librealsense::pointcloud_avx>();
+            #endif
             return std::make_shared<librealsense::pointcloud_sse>();
         #else
             return std::make_shared<librealsense::pointcloud>();
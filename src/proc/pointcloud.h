@@ -51,10 +51,18 @@ namespace librealsense
         rs2::frame _other_stream;
         rs2::frame _depth_stream;
 
+        // Output layout requested through the options, applied by pack_points
+        bool                                   _compact_points;
+        bool                                   _pixel_indices;
+        int                                    _vertex_encoding;
+        std::vector<int>                       _packed_pixels;
+
         void inspect_depth_frame(const rs2::frame& depth);
         void inspect_other_frame(const rs2::frame& other);
         rs2::frame process_depth_frame(const rs2::frame_source& source, const rs2::depth_frame& depth);
         void set_extrinsics();
+        rs2_format get_vertex_format() const;
+        void pack_points(librealsense::points& output, rs2_format vertex_format);
 
         stream_filter _prev_stream_filter;
     };
@@ -3,7 +3,9 @@
 
 #include "processing-blocks-factory.h"
 #include "sse/sse-align.h"
+#include "avx/avx-align.h"
 #include "cuda/cuda-align.h"
+#include "cpu-dispatch.h"
 
 namespace librealsense
 {
@@ -16,6 +18,10 @@ namespace librealsense
 #ifdef __SSSE3__
     std::shared_ptr<librealsense::align> create_align(rs2_stream align_to)
     {
+#ifdef RS2_HAVE_AVX2_ALIGN
+        if (get_simd_level() >= simd_level::avx2)
+            return std::make_shared<librealsense::align_avx>(align_to);
+#endif
         return std::make_shared<librealsense::align_sse>(align_to);
     }
 #else // No optimizations
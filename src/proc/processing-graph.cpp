@@ -0,0 +1,232 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#include "proc/processing-graph.h"
+#include "proc/pipelined-processing-block.h"
+#include "archive.h"
+
+namespace librealsense
+{
+    // Frames the graph holds per node before invoke() waits, enough to keep every node busy
+    static const int GRAPH_FRAMES_PER_NODE = 2;
+
+    static bool matches(stream_filter filter, frame_interface* f)
+    {
+        auto profile = f->get_stream();
+        return filter.match(stream_filter(profile->get_stream_type(), profile->get_format(), profile->get_stream_index()));
+    }
+
+    // The part of frame that passes filter, empty when none
+    static frame_holder select(const stream_filter& filter, const frame_holder& frame)
+    {
+        if (filter.stream == RS2_STREAM_ANY && filter.format == RS2_FORMAT_ANY && filter.index == -1)
+            return frame.clone();
+
+        if (auto composite = dynamic_cast<composite_frame*>(frame.frame))
+        {
+            for (size_t i = 0; i < composite->get_embedded_frames_count(); i++)
+            {
+                auto f = composite->get_frame(int(i));
+                if (f && matches(filter, f))
+                {
+                    f->acquire();
+                    return frame_holder(f);
+                }
+            }
+            return frame_holder();
+        }
+
+        return matches(filter, frame.frame) ? frame.clone() : frame_holder();
+    }
+
+    processing_graph::processing_graph(unsigned int threads)
+        : _jobs(0), _started(false), _stopping(false),
+        _threads(threads ? threads : std::max(1u, std::thread::hardware_concurrency()))
+    {
+        for (unsigned int i = 0; i < _threads; i++)
+            _workers.emplace_back([this]() { work(); });
+    }
+
+    processing_graph::~processing_graph()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stopping = true;
+        }
+        _work_cv.notify_all();
+        _idle_cv.notify_all();
+        for (auto&& t : _workers) t.join();
+
+        for (auto&& n : _nodes)
+            n->block->set_output_callback(nullptr);
+    }
+
+    int processing_graph::add_node(std::shared_ptr<processing_block_interface> block, int parent, const stream_filter& filter)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        if (_started)
+            throw wrong_api_call_sequence_exception("Nodes can not be added to a processing graph that already processes frames");
+        if (!block)
+            throw invalid_value_exception("Processing graph node requires a processing block");
+        if (Is<pipelined_processing_block>(block))
+            throw invalid_value_exception("Pipelined processing block delivers its frames on workers of its own and can not be a node of a processing graph");
+        if (parent < -1 || parent >= int(_nodes.size()))
+            throw invalid_value_exception(to_string() << "Processing graph has no node " << parent);
+        for (auto&& n : _nodes)
+            if (n->block == block)
+                throw invalid_value_exception("Processing block is already a node of the processing graph");
+
+        auto index = int(_nodes.size());
+        std::unique_ptr<node> n(new node());
+        n->block = block;
+        n->filter = filter;
+
+        // The block runs on the worker that took its input, so its frames come back before invoke() returns
+        auto target = n.get();
+        auto to_graph = [target](frame_holder fref)
+        {
+            target->outputs.push_back(std::move(fref));
+        };
+        block->set_output_callback({
+            new internal_frame_callback<decltype(to_graph)>(to_graph),
+            [](rs2_frame_callback* p) { p->release(); }
+        });
+
+        _nodes.push_back(std::move(n));
+        if (parent == -1)
+            _roots.push_back(index);
+        else
+            _nodes[parent]->children.push_back(index);
+        return index;
+    }
+
+    void processing_graph::set_output_callback(int index, frame_callback_ptr callback)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        const_cast<node&>(get_node(index)).callback = callback;
+    }
+
+    const processing_graph::node& processing_graph::get_node(int index) const
+    {
+        if (index < 0 || index >= int(_nodes.size()))
+            throw invalid_value_exception(to_string() << "Processing graph has no node " << index);
+        return *_nodes[index];
+    }
+
+    processing_graph::node_stats processing_graph::get_stats(int index) const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return get_node(index).stats;
+    }
+
+    void processing_graph::deliver(const std::vector<int>& nodes, const frame_holder& frame)
+    {
+        auto now = clock::now();
+        for (auto index : nodes)
+        {
+            auto& n = *_nodes[index];
+            auto f = select(n.filter, frame);
+            if (!f) continue;
+
+            // A node is ready when it has inputs and does not run, the worker ending a run takes care of the rest
+            if (!n.running && n.inputs.empty())
+                _ready.push_back(index);
+            n.inputs.push_back({ std::move(f), now });
+            _jobs++;
+        }
+        _work_cv.notify_all();
+    }
+
+    bool processing_graph::on_worker() const
+    {
+        auto id = std::this_thread::get_id();
+        return std::any_of(_workers.begin(), _workers.end(), [id](const std::thread& t) { return t.get_id() == id; });
+    }
+
+    void processing_graph::invoke(frame_holder frame)
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _started = true;
+
+        // An output callback invoking the graph holds a worker the graph may be waiting for, so it queues without waiting
+        if (!on_worker())
+            _idle_cv.wait(lock, [this]() { return _stopping || _jobs < std::max(1, GRAPH_FRAMES_PER_NODE * int(_nodes.size())); });
+        deliver(_roots, frame);
+    }
+
+    void processing_graph::wait()
+    {
+        if (on_worker())
+            throw wrong_api_call_sequence_exception("Processing graph can not be waited for from one of its output callbacks");
+
+        std::unique_lock<std::mutex> lock(_mutex);
+        _idle_cv.wait(lock, [this]() { return _stopping || _jobs == 0; });
+    }
+
+    void processing_graph::work()
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        while (true)
+        {
+            _work_cv.wait(lock, [this]() { return _stopping || !_ready.empty(); });
+            if (_stopping)
+                return;
+
+            auto index = _ready.front();
+            _ready.pop_front();
+            auto& n = *_nodes[index];
+            auto in = std::move(n.inputs.front());
+            n.inputs.pop_front();
+            n.running = true;
+            auto callback = n.callback;
+            lock.unlock();
+
+            auto start = clock::now();
+            n.block->invoke(std::move(in.frame));
+            auto end = clock::now();
+
+            std::vector<frame_holder> outputs;
+            std::swap(outputs, n.outputs);
+            if (callback)
+            {
+                for (auto&& f : outputs)
+                {
+                    try
+                    {
+                        auto ref = f.clone();
+                        frame_interface* ptr = nullptr;
+                        std::swap(ref.frame, ptr);
+                        callback->on_frame((rs2_frame*)ptr);
+                    }
+                    catch (...)
+                    {
+                        LOG_ERROR("Exception was thrown during processing graph output callback!");
+                    }
+                }
+            }
+
+            lock.lock();
+            using ms = std::chrono::duration<double, std::milli>;
+            auto& s = n.stats;
+            auto run = std::chrono::duration_cast<ms>(end - start).count();
+            auto wait = std::chrono::duration_cast<ms>(start - in.queued).count();
+            s.frames++;
+            s.average_ms += (run - s.average_ms) / s.frames;
+            s.average_wait_ms += (wait - s.average_wait_ms) / s.frames;
+            s.max_ms = std::max(s.max_ms, run);
+
+            for (auto&& f : outputs)
+                deliver(n.children, f);
+
+            n.running = false;
+            if (!n.inputs.empty())
+            {
+                _ready.push_back(index);
+                _work_cv.notify_one();
+            }
+            _jobs--;
+            _idle_cv.notify_all();
+        }
+    }
+}
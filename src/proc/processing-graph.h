@@ -0,0 +1,89 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <thread>
+#include "synthetic-stream.h"
+
+namespace librealsense
+{
+    // Runs processing blocks as the nodes of a tree fed by the frames given to invoke(). Every node receives the
+    // frames of its parent, or of invoke() for the roots, through the stream filter of its edge: a filter of any
+    // stream, format and index passes framesets whole, others pass the matching frame, alone or out of a frameset.
+    // Nodes run concurrently on a pool of workers shared by the graph, each node one frame at a time and in the
+    // order of its input, so independent branches take the time of the longest one
+    class processing_graph
+    {
+    public:
+        struct node_stats
+        {
+            unsigned long long frames = 0;
+            double average_ms = 0;          // Processing time of the block
+            double max_ms = 0;
+            double average_wait_ms = 0;     // Time in the queue of the node, waiting for the block or a worker
+        };
+
+        // 0 threads for one per core
+        explicit processing_graph(unsigned int threads);
+        ~processing_graph();
+
+        // Adds a node below parent, -1 for a root, and returns its index. The block delivers its frames to the graph
+        // from then on, and to no one once the graph is gone. Nodes can not be added once frames were invoked.
+        // The block must deliver its frames from invoke(), which rules out a pipelined_processing_block
+        int add_node(std::shared_ptr<processing_block_interface> block, int parent, const stream_filter& filter);
+
+        // Frames produced by the node go to callback as well as to its children, on the worker that ran the node
+        void set_output_callback(int node, frame_callback_ptr callback);
+
+        // Queues a frame at the roots and returns, once the graph holds less than a few frames per node.
+        // Called from an output callback, it queues the frame at once
+        void invoke(frame_holder frame);
+
+        // Waits until all the frames invoked so far went through the graph. Throws when called from an output callback
+        void wait();
+
+        node_stats get_stats(int node) const;
+
+    private:
+        typedef std::chrono::steady_clock clock;
+
+        struct input
+        {
+            frame_holder frame;
+            clock::time_point queued;
+        };
+
+        struct node
+        {
+            std::shared_ptr<processing_block_interface> block;
+            stream_filter filter;
+            std::vector<int> children;
+            std::deque<input> inputs;
+            bool running = false;
+            std::vector<frame_holder> outputs;  // Of the frame being processed, only the running worker touches them
+            frame_callback_ptr callback;
+            node_stats stats;
+        };
+
+        void deliver(const std::vector<int>& nodes, const frame_holder& frame);
+        void work();
+        bool on_worker() const;
+        const node& get_node(int index) const;
+
+        std::vector<std::unique_ptr<node>>  _nodes;
+        std::vector<int>                    _roots;
+        std::deque<int>                     _ready;     // Nodes with inputs that are not running
+        int                                 _jobs;      // Inputs queued or running
+        bool                                _started;
+        bool                                _stopping;
+        unsigned int                        _threads;
+        mutable std::mutex                  _mutex;
+        std::condition_variable             _work_cv;
+        std::condition_variable             _idle_cv;
+        std::vector<std::thread>            _workers;
+    };
+}
@@ -10,6 +10,8 @@
 #include "proc/synthetic-stream.h"
 #include "proc/hole-filling-filter.h"
 #include "proc/spatial-filter.h"
+#include "cpu-dispatch.h"
+#include "proc/avx/avx-spatial-kernels.h"
 
 namespace librealsense
 {
@@ -48,6 +50,25 @@ namespace librealsense
     const uint8_t holes_fill_step = 1;
     const uint8_t holes_fill_def = sp_hf_disabled;
 
+    uint8_t spatial_holes_filling_radius(uint8_t mode)
+    {
+        switch (mode)
+        {
+        case sp_hf_disabled:
+            return 0;      // disabled
+        case sp_hf_unlimited_radius:
+            return 0xff;   // Unrealistic smearing; not particulary useful
+        case sp_hf_2_pixel_radius:
+        case sp_hf_4_pixel_radius:
+        case sp_hf_8_pixel_radius:
+        case sp_hf_16_pixel_radius:
+            return 0x1 << mode; // 2's exponential radius
+        default:
+            throw invalid_value_exception(to_string()
+                << "Unsupported spatial hole-filling requested: value " << mode << " is out of range.");
+        }
+    }
+
     spatial_filter::spatial_filter() :
         depth_processing_block("Spatial Filter"),
         _spatial_alpha_param(alpha_default_val),
@@ -120,25 +141,7 @@ namespace librealsense
                     << "Unsupported mode for spatial holes filling selected: value " << val << " is out of range.");
 
             _holes_filling_mode = static_cast<uint8_t>(val);
-            switch (_holes_filling_mode)
-            {
-            case sp_hf_disabled:
-                _holes_filling_radius = 0;      // disabled
-                break;
-            case sp_hf_unlimited_radius:
-                _holes_filling_radius = 0xff;   // Unrealistic smearing; not particulary useful
-                break;
-            case sp_hf_2_pixel_radius:
-            case sp_hf_4_pixel_radius:
-            case sp_hf_8_pixel_radius:
-            case sp_hf_16_pixel_radius:
-                _holes_filling_radius = 0x1 << _holes_filling_mode; // 2's exponential radius
-                break;
-            default:
-                throw invalid_value_exception(to_string()
-                    << "Unsupported spatial hole-filling requested: value " << _holes_filling_mode << " is out of range.");
-                break;
-            }
+            _holes_filling_radius = spatial_holes_filling_radius(_holes_filling_mode);
         });
 
         register_option(RS2_OPTION_FILTER_SMOOTH_ALPHA, spatial_filter_alpha);
@@ -226,21 +229,24 @@ namespace librealsense
         return tgt;
     }
 
-    void spatial_filter::recursive_filter_horizontal_fp(void * image_data, float alpha, float deltaZ)
+    void spatial_filter_rows_fp(float* image, int width, int first, int last, float alpha, float deltaZ)
     {
-        float *image = reinterpret_cast<float*>(image_data);
+        int v = first, u;
 
-        int v, u;
+#ifdef RS2_HAVE_AVX2_SPATIAL
+        if (get_simd_level() >= simd_level::avx2)
+            v += spatial_rows_fp_avx2(image + size_t(first) * width, width, last - first, alpha, deltaZ);
+#endif
 
-        for (v = 0; v < _height;) {
+        for (; v < last;) {
             // left to right
-            float *im = image + v * _width;
+            float *im = image + size_t(v) * width;
             float state = *im;
             float previousInnovation = state;
 
             im++;
             float innovation = *im;
-            u = int(_width) - 1;
+            u = width - 1;
             if (!(*(int*)&previousInnovation > 0))
                 goto CurrentlyInvalidLR;
             // else fall through
@@ -295,9 +301,9 @@ namespace librealsense
         DoneLR:
 
             // right to left
-            im = image + (v + 1) * _width - 2;  // end of row - two pixels
+            im = image + size_t(v + 1) * width - 2;  // end of row - two pixels
             previousInnovation = state = im[1];
-            u = int(_width) - 1;
+            u = width - 1;
             innovation = *im;
             if (!(*(int*)&previousInnovation > 0))
                 goto CurrentlyInvalidRL;
@@ -354,22 +360,25 @@ namespace librealsense
         }
     }
 
-    void spatial_filter::recursive_filter_vertical_fp(void * image_data, float alpha, float deltaZ)
+    void spatial_filter_columns_fp(float* image, int width, int height, int first, int last, float alpha, float deltaZ)
     {
-        float *image = reinterpret_cast<float*>(image_data);
+        int v, u = first;
 
-        int v, u;
+#ifdef RS2_HAVE_AVX2_SPATIAL
+        if (get_simd_level() >= simd_level::avx2)
+            u += spatial_columns_fp_avx2(image + first, width, height, last - first, alpha, deltaZ);
+#endif
 
         // we'll do one column at a time, top to bottom, bottom to top, left to right,
 
-        for (u = 0; u < _width;) {
+        for (; u < last;) {
 
             float *im = image + u;
             float state = im[0];
             float previousInnovation = state;
 
-            v = int(_height) - 1;
-            im += _width;
+            v = height - 1;
+            im += width;
             float innovation = *im;
 
             if (!(*(int*)&previousInnovation > 0))
@@ -393,7 +402,7 @@ namespace librealsense
                     if (v <= 0)
                         goto DoneTB;
                     previousInnovation = innovation;
-                    im += _width;
+                    im += width;
                     innovation = *im;
                 }
                 else {  // switch to CurrentlyInvalid state
@@ -401,7 +410,7 @@ namespace librealsense
                     if (v <= 0)
                         goto DoneTB;
                     previousInnovation = innovation;
-                    im += _width;
+                    im += width;
                     innovation = *im;
                     goto CurrentlyInvalidTB;
                 }
@@ -414,22 +423,22 @@ namespace librealsense
                     goto DoneTB;
                 if (*(int*)&innovation > 0) { // switch to CurrentlyValid state
                     previousInnovation = state = innovation;
-                    im += _width;
+                    im += width;
                     innovation = *im;
                     goto CurrentlyValidTB;
                 }
                 else {
-                    im += _width;
+                    im += width;
                     innovation = *im;
                 }
             }
         DoneTB:
 
-            im = image + u + (_height - 2) * _width;
-            state = im[_width];
+            im = image + u + size_t(height - 2) * width;
+            state = im[width];
             previousInnovation = state;
             innovation = *im;
-            v = int(_height) - 1;
+            v = height - 1;
             if (!(*(int*)&previousInnovation > 0))
                 goto CurrentlyInvalidBT;
             // else fall through
@@ -450,7 +459,7 @@ namespace librealsense
                     if (v <= 0)
                         goto DoneBT;
                     previousInnovation = innovation;
-                    im -= _width;
+                    im -= width;
                     innovation = *im;
                 }
                 else {  // switch to CurrentlyInvalid state
@@ -458,7 +467,7 @@ namespace librealsense
                     if (v <= 0)
                         goto DoneBT;
                     previousInnovation = innovation;
-                    im -= _width;
+                    im -= width;
                     innovation = *im;
                     goto CurrentlyInvalidBT;
                 }
@@ -471,12 +480,12 @@ namespace librealsense
                     goto DoneBT;
                 if (*(int*)&innovation > 0) { // switch to CurrentlyValid state
                     previousInnovation = state = innovation;
-                    im -= _width;
+                    im -= width;
                     innovation = *im;
                     goto CurrentlyValidBT;
                 }
                 else {
-                    im -= _width;
+                    im -= width;
                     innovation = *im;
                 }
             }
@@ -484,4 +493,30 @@ namespace librealsense
             u++;
         }
     }
+
+    void spatial_filter::recursive_filter_horizontal_fp(void * image_data, float alpha, float deltaZ)
+    {
+        auto image = reinterpret_cast<float*>(image_data);
+        auto width = int(_width);
+        auto height = int(_height);
+
+        // Bands of whole 8 row groups, so only the last rows of the frame miss the vectorized pass
+        get_processing_pool().parallel_for((height + 7) / 8, [&](int begin, int end)
+        {
+            spatial_filter_rows_fp(image, width, begin * 8, std::min(end * 8, height), alpha, deltaZ);
+        }, SPATIAL_BAND_LINES / 8);
+    }
+
+    void spatial_filter::recursive_filter_vertical_fp(void * image_data, float alpha, float deltaZ)
+    {
+        auto image = reinterpret_cast<float*>(image_data);
+        auto width = int(_width);
+        auto height = int(_height);
+
+        // Same for 8 column groups, a scalar column is a strided walk over the whole frame
+        get_processing_pool().parallel_for((width + 7) / 8, [&](int begin, int end)
+        {
+            spatial_filter_columns_fp(image, width, height, begin * 8, std::min(end * 8, width), alpha, deltaZ);
+        }, SPATIAL_BAND_COLUMNS / 8);
+    }
 }
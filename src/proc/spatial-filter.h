@@ -9,12 +9,77 @@
 #include <map>
 #include <vector>
 #include <cmath>
+#include <functional>
 
 #include "../include/librealsense2/hpp/rs_frame.hpp"
 #include "../include/librealsense2/hpp/rs_processing.hpp"
+#include "concurrency.h"
 
 namespace librealsense
 {
+    // Domain transform recursion over disparity, on the rows [first, last) of the image (left to right, then right
+    // to left) or on its columns [first, last) (top to bottom, then bottom to top). Lines are independent of each
+    // other, so bands of them can run in parallel; vectorized where the CPU allows, with identical results
+    void spatial_filter_rows_fp(float* image, int width, int first, int last, float alpha, float delta_z);
+    void spatial_filter_columns_fp(float* image, int width, int height, int first, int last, float alpha, float delta_z);
+
+    // Radius of the horizontal holes filling of a spatial holes filling mode, 0 when disabled
+    uint8_t spatial_holes_filling_radius(uint8_t mode);
+
+    // Holes filling over disparity that follows the spatial passes: on the rows [first, last), every hole takes
+    // the value of its left, then of its right neighbour, up to radius - 1 pixels away from valid data
+    template<typename T>
+    void spatial_holes_fill_rows(T* image_data, size_t width, int first, int last, uint8_t radius)
+    {
+        std::function<bool(T*)> fp_oper = [](T* ptr) { return !*((int *)ptr); };
+        std::function<bool(T*)> uint_oper = [](T* ptr) { return !(*ptr); };
+        auto empty = (std::is_floating_point<T>::value) ? fp_oper : uint_oper;
+
+        size_t cur_fill = 0;
+
+        for (int j = first; j < last; ++j)
+        {
+            T* p = image_data + j * width;
+            ++p;
+            cur_fill = 0;
+
+            //Left to Right
+            for (size_t i = 1; i < width; ++i)
+            {
+                if (empty(p))
+                {
+                    if (++cur_fill < radius)
+                        *p = *(p - 1);
+                }
+                else
+                    cur_fill = 0;
+
+                ++p;
+            }
+
+            // Back to the second last pixel, the right neighbour of the last one is in the next row
+            p -= 2;
+            cur_fill = 0;
+            //Right to left
+            for (size_t i = 1; i < width; ++i)
+            {
+                if (empty(p))
+                {
+                    if (++cur_fill < radius)
+                        *p = *(p + 1);
+                }
+                else
+                    cur_fill = 0;
+                --p;
+            }
+        }
+    }
+
+    // Smallest bands of the parallel passes: 8 rows fill the lanes of the vectorized row pass,
+    // 64 columns keep the bands of the column pass on separate cache lines
+    const int SPATIAL_BAND_LINES = 8;
+    const int SPATIAL_BAND_COLUMNS = 64;
+
     class spatial_filter : public depth_processing_block
     {
     public:
@@ -58,8 +123,6 @@ namespace librealsense
         template <typename T>
         void  recursive_filter_horizontal(void * image_data, float alpha, float deltaZ)
         {
-            size_t v{}, u{};
-
             // Handle conversions for invalid input data
             bool fp = (std::is_floating_point<T>::value);
 
@@ -70,91 +133,92 @@ namespace librealsense
             const T delta_z = static_cast<T>(deltaZ);
 
             auto image = reinterpret_cast<T*>(image_data);
-            size_t cur_fill = 0;
 
-            for (v = 0; v < _height; v++)
+            // Rows are independent, bands of them run in parallel
+            get_processing_pool().parallel_for(int(_height), [&](int begin, int end)
             {
-                // left to right
-                T *im = image + v * _width;
-                T val0 = im[0];
-                cur_fill = 0;
-
-                for (u = 1; u < _width - 1; u++)
+                for (size_t v = begin; v < size_t(end); v++)
                 {
-                    T val1 = im[1];
+                    // left to right
+                    T *im = image + v * _width;
+                    T val0 = im[0];
+                    size_t cur_fill = 0;
 
-                    if (fabs(val0) >= valid_threshold)
+                    for (size_t u = 1; u < _width - 1; u++)
                     {
-                        if (fabs(val1) >= valid_threshold)
-                        {
-                            cur_fill = 0;
-                            T diff = static_cast<T>(fabs(val1 - val0));
+                        T val1 = im[1];
 
-                            if (diff >= valid_threshold && diff <= delta_z)
+                        if (fabs(val0) >= valid_threshold)
+                        {
+                            if (fabs(val1) >= valid_threshold)
                             {
-                                float filtered = val1 * alpha + val0 * (1.0f - alpha);
-                                val1 = static_cast<T>(filtered + round);
-                                im[1] = val1;
+                                cur_fill = 0;
+                                T diff = static_cast<T>(fabs(val1 - val0));
+
+                                if (diff >= valid_threshold && diff <= delta_z)
+                                {
+                                    float filtered = val1 * alpha + val0 * (1.0f - alpha);
+                                    val1 = static_cast<T>(filtered + round);
+                                    im[1] = val1;
+                                }
                             }
-                        }
-                        else // Only the old value is valid - appy holes filling
-                        {
-                            if (_holes_filling_radius)
+                            else // Only the old value is valid - appy holes filling
                             {
-                                if (++cur_fill <_holes_filling_radius)
-                                    im[1] = val1 = val0;
+                                if (_holes_filling_radius)
+                                {
+                                    if (++cur_fill <_holes_filling_radius)
+                                        im[1] = val1 = val0;
+                                }
                             }
                         }
-                    }
 
-                    val0 = val1;
-                    im += 1;
-                }
-
-                // right to left
-                im = image + (v + 1) * _width - 2;  // end of row - two pixels
-                T val1 = im[1];
-                cur_fill = 0;
+                        val0 = val1;
+                        im += 1;
+                    }
 
-                for (u = _width - 1; u > 0; u--)
-                {
-                    T val0 = im[0];
+                    // right to left
+                    im = image + (v + 1) * _width - 2;  // end of row - two pixels
+                    T val1 = im[1];
+                    cur_fill = 0;
 
-                    if (val1 >= valid_threshold)
+                    for (size_t u = _width - 1; u > 0; u--)
                     {
-                        if (val0 > valid_threshold)
-                        {
-                            cur_fill = 0;
-                            T diff = static_cast<T>(fabs(val1 - val0));
+                        T val0 = im[0];
 
-                            if (diff <= delta_z)
+                        if (val1 >= valid_threshold)
+                        {
+                            if (val0 > valid_threshold)
                             {
-                                float filtered = val0 * alpha + val1 * (1.0f - alpha);
-                                val0 = static_cast<T>(filtered + round);
-                                im[0] = val0;
+                                cur_fill = 0;
+                                T diff = static_cast<T>(fabs(val1 - val0));
+
+                                if (diff <= delta_z)
+                                {
+                                    float filtered = val0 * alpha + val1 * (1.0f - alpha);
+                                    val0 = static_cast<T>(filtered + round);
+                                    im[0] = val0;
+                                }
                             }
-                        }
-                        else // 'inertial' hole filling
-                        {
-                            if (_holes_filling_radius)
+                            else // 'inertial' hole filling
                             {
-                                if (++cur_fill <_holes_filling_radius)
-                                    im[0] = val0 = val1;
+                                if (_holes_filling_radius)
+                                {
+                                    if (++cur_fill <_holes_filling_radius)
+                                        im[0] = val0 = val1;
+                                }
                             }
                         }
-                    }
 
-                    val1 = val0;
-                    im -= 1;
+                        val1 = val0;
+                        im -= 1;
+                    }
                 }
-            }
+            }, SPATIAL_BAND_LINES);
         }
 
         template <typename T>
         void recursive_filter_vertical(void * image_data, float alpha, float deltaZ)
         {
-            size_t v{}, u{};
-
             // Handle conversions for invalid input data
             bool fp = (std::is_floating_point<T>::value);
 
@@ -166,101 +230,63 @@ namespace librealsense
 
             auto image = reinterpret_cast<T*>(image_data);
 
-            // we'll do one row at a time, top to bottom, then bottom to top
-
-            // top to bottom
-
-            T *im = image;
-            T im0{};
-            T imw{};
-            for (v = 1; v < _height; v++)
+            // Columns are independent, bands of them run in parallel, each one walking down and then up
+            // its rows so the band stays in cache
+            get_processing_pool().parallel_for(int(_width), [&](int begin, int end)
             {
-                for (u = 0; u < _width; u++)
-                {
-                    im0 = im[0];
-                    imw = im[_width];
+                T im0{};
+                T imw{};
 
-                    //if ((fabs(im0) >= valid_threshold) && (fabs(imw) >= valid_threshold))
+                // top to bottom
+                for (size_t v = 1; v < _height; v++)
+                {
+                    T *im = image + (v - 1) * _width + begin;
+                    for (size_t u = begin; u < size_t(end); u++)
                     {
-                        T diff = static_cast<T>(fabs(im0 - imw));
-                        if (diff < delta_z)
+                        im0 = im[0];
+                        imw = im[_width];
+
+                        //if ((fabs(im0) >= valid_threshold) && (fabs(imw) >= valid_threshold))
                         {
-                            float filtered = imw * alpha + im0 * (1.f - alpha);
-                            im[_width] = static_cast<T>(filtered + round);
+                            T diff = static_cast<T>(fabs(im0 - imw));
+                            if (diff < delta_z)
+                            {
+                                float filtered = imw * alpha + im0 * (1.f - alpha);
+                                im[_width] = static_cast<T>(filtered + round);
+                            }
                         }
+                        im += 1;
                     }
-                    im += 1;
                 }
-            }
 
-            // bottom to top
-            im = image + (_height - 2) * _width;
-            for (v = 1; v < _height; v++, im -= (_width * 2))
-            {
-                for (u = 0; u < _width; u++)
+                // bottom to top
+                for (size_t v = _height; v > 1; v--)
                 {
-                    im0 = im[0];
-                    imw = im[_width];
-
-                    if ((fabs(im0) >= valid_threshold) && (fabs(imw) >= valid_threshold))
+                    T *im = image + (v - 2) * _width + begin;
+                    for (size_t u = begin; u < size_t(end); u++)
                     {
-                        T diff = static_cast<T>(fabs(im0 - imw));
-                        if (diff < delta_z)
+                        im0 = im[0];
+                        imw = im[_width];
+
+                        if ((fabs(im0) >= valid_threshold) && (fabs(imw) >= valid_threshold))
                         {
-                            float filtered = im0 * alpha + imw * (1.f - alpha);
-                            im[0] = static_cast<T>(filtered + round);
+                            T diff = static_cast<T>(fabs(im0 - imw));
+                            if (diff < delta_z)
+                            {
+                                float filtered = im0 * alpha + imw * (1.f - alpha);
+                                im[0] = static_cast<T>(filtered + round);
+                            }
                         }
+                        im += 1;
                     }
-                    im += 1;
                 }
-            }
+            }, SPATIAL_BAND_COLUMNS);
         }
 
         template<typename T>
         inline void intertial_holes_fill(T* image_data)
         {
-            std::function<bool(T*)> fp_oper = [](T* ptr) { return !*((int *)ptr); };
-            std::function<bool(T*)> uint_oper = [](T* ptr) { return !(*ptr); };
-            auto empty = (std::is_floating_point<T>::value) ? fp_oper : uint_oper;
-
-            size_t cur_fill = 0;
-
-            T* p = image_data;
-            for (int j = 0; j < _height; ++j)
-            {
-                ++p;
-                cur_fill = 0;
-
-                //Left to Right
-                for (size_t i = 1; i < _width; ++i)
-                {
-                    if (empty(p))
-                    {
-                        if (++cur_fill < _holes_filling_radius)
-                            *p = *(p - 1);
-                    }
-                    else
-                        cur_fill = 0;
-
-                    ++p;
-                }
-
-                --p;
-                cur_fill = 0;
-                //Right to left
-                for (size_t i = 1; i < _width; ++i)
-                {
-                    if (empty(p))
-                    {
-                        if (++cur_fill < _holes_filling_radius)
-                            *p = *(p + 1);
-                    }
-                    else
-                        cur_fill = 0;
-                    --p;
-                }
-                p += _width;
-            }
+            spatial_holes_fill_rows(image_data, _width, 0, int(_height), _holes_filling_radius);
         }
 
     private:
@@ -202,6 +202,18 @@ image_transform::image_transform(const rs2_intrinsics& from, float depth_scale)
 {
 }
 
+bool image_transform::matches(const rs2_intrinsics& from, float depth_scale) const
+{
+    return depth_scale == _depth_scale && !memcmp(&from, &_depth, sizeof(rs2_intrinsics));
+}
+
+size_t image_transform::size_bytes() const
+{
+    return (_pre_compute_map_x_top_left.size() + _pre_compute_map_y_top_left.size() +
+        _pre_compute_map_x_bottom_right.size() + _pre_compute_map_y_bottom_right.size()) * sizeof(float) +
+        (_pixel_top_left_int.size() + _pixel_bottom_right_int.size()) * sizeof(int2);
+}
+
 void image_transform::pre_compute_x_y_map_corners()
 {
     pre_compute_x_y_map(_pre_compute_map_x_top_left, _pre_compute_map_y_top_left, -0.5f);
@@ -396,9 +408,14 @@ void image_transform::move_other_to_depth(const uint16_t* z_pixels,
     }
 }
 
-void align_sse::reset_cache(rs2_stream from, rs2_stream to)
+image_transform& align_sse::get_transform(stream_profile_interface* depth_profile, const rs2_intrinsics& depth, float z_scale)
 {
-    _stream_transform = nullptr;
+    if (auto cached = find_transform(depth_profile, depth, z_scale))
+        return static_cast<image_transform&>(*cached);
+
+    auto transform = std::make_shared<image_transform>(depth, z_scale);
+    transform->pre_compute_x_y_map_corners();
+    return static_cast<image_transform&>(cache_transform(depth_profile, transform));
 }
 
 void align_sse::align_z_to_other(rs2::video_frame& aligned, const rs2::video_frame& depth, const rs2::video_stream_profile& other_profile, float z_scale)
@@ -415,12 +432,7 @@ void align_sse::align_z_to_other(rs2::video_frame& aligned, const rs2::video_fra
 
     auto z_pixels = reinterpret_cast<const uint16_t*>(depth.get_data());
 
-    if (_stream_transform == nullptr)
-    {
-        _stream_transform = std::make_shared<image_transform>(z_intrin, z_scale);
-        _stream_transform->pre_compute_x_y_map_corners();
-    }
-    _stream_transform->align_depth_to_other(z_pixels, reinterpret_cast<uint16_t*>(aligned_data), 2, z_intrin, other_intrin, z_to_other);
+    get_transform(depth_profile.get()->profile, z_intrin, z_scale).align_depth_to_other(z_pixels, reinterpret_cast<uint16_t*>(aligned_data), 2, z_intrin, other_intrin, z_to_other);
 }
 
 void align_sse::align_other_to_z(rs2::video_frame& aligned, const rs2::video_frame& depth, const rs2::video_frame& other, float z_scale)
@@ -439,12 +451,6 @@ void align_sse::align_other_to_z(rs2::video_frame& aligned, const rs2::video_fra
     auto z_pixels = reinterpret_cast<const uint16_t*>(depth.get_data());
     auto other_pixels = reinterpret_cast<const byte*>(other.get_data());
 
-    if (_stream_transform == nullptr)
-    {
-        _stream_transform = std::make_shared<image_transform>(z_intrin, z_scale);
-        _stream_transform->pre_compute_x_y_map_corners();
-    }
-
-    _stream_transform->align_other_to_depth(z_pixels, other_pixels, aligned_data, other.get_bytes_per_pixel(), other_intrin, z_to_other);
+    get_transform(depth_profile.get()->profile, z_intrin, z_scale).align_other_to_depth(z_pixels, other_pixels, aligned_data, other.get_bytes_per_pixel(), other_intrin, z_to_other);
 }
 #endif
@@ -7,13 +7,16 @@
 
 namespace librealsense
 {
-    class image_transform
+    class image_transform : public align_transform
     {
     public:
 
         image_transform(const rs2_intrinsics& from,
             float depth_scale);
 
+        bool matches(const rs2_intrinsics& from, float depth_scale) const override;
+        size_t size_bytes() const override;
+
         inline void align_depth_to_other(const uint16_t* z_pixels,
             uint16_t* dest, int bpp,
             const rs2_intrinsics& depth,
@@ -76,14 +79,12 @@ namespace librealsense
         align_sse(rs2_stream to_stream) : align(to_stream, "Align (SSE3)") {}
 
     protected:
-        void reset_cache(rs2_stream from, rs2_stream to) override;
-
         void align_z_to_other(rs2::video_frame& aligned, const rs2::video_frame& depth, const rs2::video_stream_profile& other_profile, float z_scale) override;
 
         void align_other_to_z(rs2::video_frame& aligned, const rs2::video_frame& depth, const rs2::video_frame& other, float z_scale) override;
 
     private:
-        std::shared_ptr<image_transform> _stream_transform;
+        image_transform& get_transform(stream_profile_interface* depth_profile, const rs2_intrinsics& depth, float z_scale);
     };
 }
 #endif // __SSSE3__
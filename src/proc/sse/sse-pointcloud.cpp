@@ -55,22 +55,10 @@ namespace librealsense
         }
     }
 
-    const float3* pointcloud_sse::depth_to_points(rs2::points output,
-            const rs2_intrinsics &depth_intrinsics, 
-            const rs2::depth_frame& depth_frame,
-            float depth_scale)
-    {
 #ifdef __SSSE3__
-
-        auto depth_image = (const uint16_t*)depth_frame.get_data();
-
-        float* pre_compute_x = _pre_compute_map_x.data();
-        float* pre_compute_y = _pre_compute_map_y.data();
-
-        uint32_t size = depth_intrinsics.height * depth_intrinsics.width;
-
-        auto point = (float*)output.get_vertices();
-
+    void deproject_depth_sse(float* point, const uint16_t* depth_image, const float* pre_compute_x, const float* pre_compute_y,
+        unsigned int size, float depth_scale)
+    {
         //mask for shuffle
         const __m128i mask0 = _mm_set_epi8((char)0xff, (char)0xff, (char)7, (char)6, (char)0xff, (char)0xff, (char)5, (char)4,
             (char)0xff, (char)0xff, (char)3, (char)2, (char)0xff, (char)0xff, (char)1, (char)0);
@@ -135,25 +123,11 @@ namespace librealsense
             _mm_stream_ps(&point[20], xyz13);
             point += 24;
         }
-#endif
-        return (float3*)output.get_vertices();
     }
 
-    void pointcloud_sse::get_texture_map(rs2::points output,
-        const float3* points,
-        const unsigned int width,
-        const unsigned int height,
-        const rs2_intrinsics &other_intrinsics,
-        const rs2_extrinsics& extr,
-        float2* pixels_ptr)
+    void get_texture_map_sse(float* res, float* res1, const float* point, unsigned int size,
+        const rs2_intrinsics& other_intrinsics, const rs2_extrinsics& extr)
     {
-        auto tex_ptr = (float2*)output.get_texture_coordinates();
-
-#ifdef __SSSE3__
-        auto point = reinterpret_cast<const float*>(points);
-        auto res = reinterpret_cast<float*>(tex_ptr);
-        auto res1 = reinterpret_cast<float*>(pixels_ptr);
-
         __m128 r[9];
         __m128 t[3];
         __m128 c[5];
@@ -182,7 +156,7 @@ namespace librealsense
         auto one = _mm_set_ps1(1);
         auto two = _mm_set_ps1(2);
 
-        for (auto i = 0UL; i < height*width * 3; i += 12)
+        for (auto i = 0UL; i < size * 3; i += 12)
         {
             //load 4 points (x,y,z)
             auto xyz1 = _mm_load_ps(point + i);
@@ -259,7 +233,32 @@ namespace librealsense
             _mm_stream_ps(res + 4, xyxy2);
             res += 8;
         }
+    }
 #endif
 
+    const float3* pointcloud_sse::depth_to_points(rs2::points output,
+            const rs2_intrinsics &depth_intrinsics, 
+            const rs2::depth_frame& depth_frame,
+            float depth_scale)
+    {
+#ifdef __SSSE3__
+        deproject_depth_sse((float*)output.get_vertices(), (const uint16_t*)depth_frame.get_data(),
+            _pre_compute_map_x.data(), _pre_compute_map_y.data(), depth_intrinsics.height * depth_intrinsics.width, depth_scale);
+#endif
+        return (float3*)output.get_vertices();
+    }
+
+    void pointcloud_sse::get_texture_map(rs2::points output,
+        const float3* points,
+        const unsigned int width,
+        const unsigned int height,
+        const rs2_intrinsics &other_intrinsics,
+        const rs2_extrinsics& extr,
+        float2* pixels_ptr)
+    {
+#ifdef __SSSE3__
+        get_texture_map_sse((float*)output.get_texture_coordinates(), (float*)pixels_ptr, (const float*)points, width * height,
+            other_intrinsics, extr);
+#endif
     }
 }
@@ -6,6 +6,14 @@
 
 namespace librealsense
 {
+#ifdef __SSSE3__
+    // Kernels behind pointcloud_sse. Size must be a multiple of 8 and the buffers 16-byte aligned
+    void deproject_depth_sse(float* points, const uint16_t* depth_image, const float* pre_compute_x, const float* pre_compute_y,
+        unsigned int size, float depth_scale);
+    void get_texture_map_sse(float* tex_ptr, float* pixels_ptr, const float* points, unsigned int size,
+        const rs2_intrinsics& other_intrinsics, const rs2_extrinsics& extr);
+#endif
+
     class pointcloud_sse : public pointcloud
     {
     public:
@@ -266,10 +266,14 @@ namespace librealsense
             data.system_time = _actual_source.get_time();
             data.is_blocking = original->is_blocking();
 
-            auto res = _actual_source.alloc_frame(frame_type, vid_stream->get_width() * vid_stream->get_height() * sizeof(float) * 5, data, true);
+            auto pixels = vid_stream->get_width() * vid_stream->get_height();
+            auto res = _actual_source.alloc_frame(frame_type, pixels * (sizeof(float3) + sizeof(float2) + sizeof(int)), data, true);
             if (!res) throw wrong_api_call_sequence_exception("Out of frame resources!");
             res->set_sensor(original->get_sensor());
             res->set_stream(stream);
+            // Recycled buffers keep the layout of their previous frame
+            if (auto points = dynamic_cast<librealsense::points*>(res))
+                points->set_layout(pixels, RS2_FORMAT_XYZ32F, false);
             return res;
         }
         return nullptr;
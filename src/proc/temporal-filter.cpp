@@ -9,6 +9,11 @@
 #include "context.h"
 #include "proc/synthetic-stream.h"
 #include "proc/temporal-filter.h"
+#include "cpu-dispatch.h"
+
+#ifdef __SSSE3__
+#include <tmmintrin.h>
+#endif
 
 namespace librealsense
 {
@@ -171,7 +176,7 @@ namespace librealsense
             _last_frame.resize(_current_frm_size_pixels*_bpp);
 
             _history.clear();
-            _history.resize(_current_frm_size_pixels*_bpp);
+            _history.resize(_current_frm_size_pixels);
 
         }
     }
@@ -185,11 +190,11 @@ namespace librealsense
         return tgt;
     }
 
-    void temporal_filter::recalc_persistence_map()
+    void make_persistence_map(uint8_t persistence_param, std::array<uint8_t, PRESISTENCY_LUT_SIZE>& persistence_map)
     {
-        _persistence_map.fill(0);
+        persistence_map.fill(0);
 
-        for (size_t i = 0; i < _persistence_map.size(); i++)
+        for (size_t i = 0; i < persistence_map.size(); i++)
         {
             unsigned char last_7 = !!(i & 1);  // old
             unsigned char last_6 = !!(i & 2);
@@ -200,51 +205,51 @@ namespace librealsense
             unsigned char last_1 = !!(i & 64);
             unsigned char lastFrame = !!(i & 128); // new
 
-            if (_persistence_param == 1)
+            if (persistence_param == 1)
             {
                 int sum = lastFrame + last_1 + last_2 + last_3 + last_4 + last_5 + last_6 + last_7;
                 if (sum >= 8)  // valid in eight of the last eight frames
-                    _persistence_map[i] = 1;
+                    persistence_map[i] = 1;
             }
-            else if (_persistence_param == 2) // <--- default choice in current libRS implementation
+            else if (persistence_param == 2) // <--- default choice in current libRS implementation
             {
                 int sum = lastFrame + last_1 + last_2;
                 if (sum >= 2) // valid in two of the last three frames
-                    _persistence_map[i] = 1;
+                    persistence_map[i] = 1;
             }
-            else if (_persistence_param == 3) // <--- default choice recommended
+            else if (persistence_param == 3) // <--- default choice recommended
             {
                 int sum = lastFrame + last_1 + last_2 + last_3;
                 if (sum >= 2)  // valid in two of the last four frames
-                    _persistence_map[i] = 1;
+                    persistence_map[i] = 1;
             }
-            else if (_persistence_param == 4)
+            else if (persistence_param == 4)
             {
                 int sum = lastFrame + last_1 + last_2 + last_3 + last_4 + last_5 + last_6 + last_7;
                 if (sum >= 2) // valid in two of the last eight frames
-                    _persistence_map[i] = 1;
+                    persistence_map[i] = 1;
             }
-            else if (_persistence_param == 5)
+            else if (persistence_param == 5)
             {
                 int sum = lastFrame + last_1;
                 if (sum >= 1) // valid in one of the last two frames
-                    _persistence_map[i] = 1;
+                    persistence_map[i] = 1;
             }
-            else if (_persistence_param == 6)
+            else if (persistence_param == 6)
             {
                 int sum = lastFrame + last_1 + last_2 + last_3 + last_4;
                 if (sum >= 1)  // valid in one of the last five frames
-                    _persistence_map[i] = 1;
+                    persistence_map[i] = 1;
             }
-            else if (_persistence_param == 7) //  <--- most filling
+            else if (persistence_param == 7) //  <--- most filling
             {
                 int sum = lastFrame + last_1 + last_2 + last_3 + last_4 + last_5 + last_6 + last_7;
                 if (sum >= 1) // valid in one of the last eight frames
-                    _persistence_map[i] = 1;
+                    persistence_map[i] = 1;
             }
-            else if (_persistence_param == 8) //  <--- all 1's
+            else if (persistence_param == 8) //  <--- all 1's
             {
-                _persistence_map[i] = 1;
+                persistence_map[i] = 1;
             }
             else // all others, including 0, no persistance
             {
@@ -264,11 +269,198 @@ namespace librealsense
 
             for (i = 0; i < 256; i++) {
                 unsigned char pos = (unsigned char)((i << (8 - phase)) | (i >> phase));
-                if (_persistence_map[pos])
+                if (persistence_map[pos])
                     credible_threshold[i] |= mask;
             }
         }
         // Store results
-        _persistence_map = credible_threshold;
+        persistence_map = credible_threshold;
+    }
+
+    void temporal_filter::recalc_persistence_map()
+    {
+        make_persistence_map(_persistence_param, _persistence_map);
+    }
+
+#ifdef __SSSE3__
+    static inline __m128i select(__m128i mask, __m128i a, __m128i b)
+    {
+        return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+    }
+
+    static inline __m128 select(__m128 mask, __m128 a, __m128 b)
+    {
+        return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+    }
+
+    // Whether persistence_map[history] & mask is set, for 16 history bytes at once. The 256 answers are
+    // packed into bits, two 16 byte tables indexed by the high nibble hold those of low nibbles 0-7 and 8-15
+    class persistence_lookup
+    {
+    public:
+        persistence_lookup(const uint8_t* persistence_map, unsigned char mask)
+        {
+            uint8_t lows[16] = {}, highs[16] = {};
+            for (int i = 0; i < 256; i++)
+                if (persistence_map[i] & mask)
+                    ((i & 8) ? highs : lows)[i >> 4] |= uint8_t(1 << (i & 7));
+            _lows = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lows));
+            _highs = _mm_loadu_si128(reinterpret_cast<const __m128i*>(highs));
+        }
+
+        // 0xff in the bytes whose history may fill a hole
+        __m128i operator()(__m128i history) const
+        {
+            const auto nibble = _mm_set1_epi8(0x0f);
+            const auto bits = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+            auto high = _mm_and_si128(_mm_srli_epi16(history, 4), nibble);
+            auto low = _mm_and_si128(history, nibble);
+            auto row = select(_mm_cmpgt_epi8(low, _mm_set1_epi8(7)), _mm_shuffle_epi8(_highs, high), _mm_shuffle_epi8(_lows, high));
+            auto bit = _mm_shuffle_epi8(bits, low);
+            return _mm_cmpeq_epi8(_mm_and_si128(row, bit), bit);
+        }
+
+    private:
+        __m128i _lows, _highs;
+    };
+
+    // The new history of 16 pixels: the current bit alone where a valid value broke the streak, added where
+    // the value agrees with the last one and cleared where it is missing
+    static inline __m128i update_history(__m128i history, __m128i bit, __m128i valid, __m128i agree)
+    {
+        return select(valid, select(agree, _mm_or_si128(history, bit), bit), _mm_andnot_si128(bit, history));
+    }
+
+    // 16 pixels per iteration, as many as a vector of history bytes
+    static size_t temporal_smooth_sse(uint16_t* frame, uint16_t* last_frame, uint8_t* history, size_t count,
+        float alpha, float one_minus_alpha, uint16_t delta_z, unsigned char mask, const persistence_lookup& credible)
+    {
+        const auto zero = _mm_setzero_si128();
+        const auto sign = _mm_set1_epi16(-0x8000);
+        const auto threshold = _mm_set1_epi16(static_cast<int16_t>(delta_z ^ 0x8000));
+        const auto half_range = _mm_set1_epi32(0x8000);
+        const auto a = _mm_set1_ps(alpha);
+        const auto b = _mm_set1_ps(one_minus_alpha);
+        const auto bit = _mm_set1_epi8(static_cast<char>(mask));
+
+        size_t i = 0;
+        for (; i + 16 <= count; i += 16)
+        {
+            __m128i cur[2], prev[2], valid[2], agree[2], filtered[2];
+            for (int k = 0; k < 2; k++)
+            {
+                cur[k] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(frame + i + 8 * k));
+                prev[k] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(last_frame + i + 8 * k));
+                auto no_cur = _mm_cmpeq_epi16(cur[k], zero);
+                auto missing = _mm_or_si128(no_cur, _mm_cmpeq_epi16(prev[k], zero));
+                valid[k] = _mm_xor_si128(no_cur, _mm_cmpeq_epi16(zero, zero));
+
+                // Unsigned |cur - prev| < delta_z, compared as signed with the sign bits flipped
+                auto diff = _mm_or_si128(_mm_subs_epu16(cur[k], prev[k]), _mm_subs_epu16(prev[k], cur[k]));
+                agree[k] = _mm_andnot_si128(missing, _mm_cmplt_epi16(_mm_xor_si128(diff, sign), threshold));
+
+                // Truncated to integers like the scalar cast, then packed around the middle of the range
+                __m128i halves[2];
+                for (int h = 0; h < 2; h++)
+                {
+                    auto c = _mm_cvtepi32_ps(h ? _mm_unpackhi_epi16(cur[k], zero) : _mm_unpacklo_epi16(cur[k], zero));
+                    auto p = _mm_cvtepi32_ps(h ? _mm_unpackhi_epi16(prev[k], zero) : _mm_unpacklo_epi16(prev[k], zero));
+                    auto f = _mm_add_ps(_mm_mul_ps(a, c), _mm_mul_ps(b, p));
+                    halves[h] = _mm_sub_epi32(_mm_cvttps_epi32(f), half_range);
+                }
+                filtered[k] = _mm_xor_si128(_mm_packs_epi32(halves[0], halves[1]), sign);
+            }
+
+            auto hist = _mm_loadu_si128(reinterpret_cast<const __m128i*>(history + i));
+            auto fill = credible(hist);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(history + i), update_history(hist, bit,
+                _mm_packs_epi16(valid[0], valid[1]), _mm_packs_epi16(agree[0], agree[1])));
+
+            // Where cur is missing, prev is either a value or 0 like cur, so no need to test it
+            for (int k = 0; k < 2; k++)
+            {
+                auto fill_k = k ? _mm_unpackhi_epi8(fill, fill) : _mm_unpacklo_epi8(fill, fill);
+                auto filled = select(_mm_andnot_si128(valid[k], fill_k), prev[k], cur[k]);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(frame + i + 8 * k), select(agree[k], filtered[k], filled));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(last_frame + i + 8 * k),
+                    select(agree[k], filtered[k], select(valid[k], cur[k], prev[k])));
+            }
+        }
+        return i;
+    }
+
+    // 4 vectors of 32 bit lane masks to one of byte masks
+    static inline __m128i pack_masks(const __m128 m[4])
+    {
+        return _mm_packs_epi16(_mm_packs_epi32(_mm_castps_si128(m[0]), _mm_castps_si128(m[1])),
+            _mm_packs_epi32(_mm_castps_si128(m[2]), _mm_castps_si128(m[3])));
+    }
+
+    static size_t temporal_smooth_sse(float* frame, float* last_frame, uint8_t* history, size_t count,
+        float alpha, float one_minus_alpha, float delta_z, unsigned char mask, const persistence_lookup& credible)
+    {
+        const auto zero = _mm_setzero_ps();
+        const auto abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+        const auto threshold = _mm_set1_ps(delta_z);
+        const auto a = _mm_set1_ps(alpha);
+        const auto b = _mm_set1_ps(one_minus_alpha);
+        const auto bit = _mm_set1_epi8(static_cast<char>(mask));
+
+        size_t i = 0;
+        for (; i + 16 <= count; i += 16)
+        {
+            // NaN counts as a value and never agrees, -0 is missing, like the scalar tests
+            __m128 cur[4], prev[4], valid[4], agree[4], fill_from[4], filtered[4];
+            for (int k = 0; k < 4; k++)
+            {
+                cur[k] = _mm_loadu_ps(frame + i + 4 * k);
+                prev[k] = _mm_loadu_ps(last_frame + i + 4 * k);
+                valid[k] = _mm_cmpneq_ps(cur[k], zero);
+                fill_from[k] = _mm_andnot_ps(valid[k], _mm_cmpneq_ps(prev[k], zero));
+                auto close = _mm_cmplt_ps(_mm_and_ps(_mm_sub_ps(cur[k], prev[k]), abs_mask), threshold);
+                agree[k] = _mm_and_ps(_mm_and_ps(valid[k], _mm_cmpneq_ps(prev[k], zero)), close);
+                filtered[k] = _mm_add_ps(_mm_mul_ps(a, cur[k]), _mm_mul_ps(b, prev[k]));
+            }
+
+            auto hist = _mm_loadu_si128(reinterpret_cast<const __m128i*>(history + i));
+            auto fill = credible(hist);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(history + i), update_history(hist, bit, pack_masks(valid), pack_masks(agree)));
+
+            for (int k = 0; k < 4; k++)
+            {
+                auto fill16 = k < 2 ? _mm_unpacklo_epi8(fill, fill) : _mm_unpackhi_epi8(fill, fill);
+                auto fill_k = _mm_castsi128_ps((k % 2) ? _mm_unpackhi_epi16(fill16, fill16) : _mm_unpacklo_epi16(fill16, fill16));
+                auto filled = select(_mm_and_ps(fill_from[k], fill_k), prev[k], cur[k]);
+                _mm_storeu_ps(frame + i + 4 * k, select(agree[k], filtered[k], filled));
+                _mm_storeu_ps(last_frame + i + 4 * k, select(agree[k], filtered[k], select(valid[k], cur[k], prev[k])));
+            }
+        }
+        return i;
+    }
+#endif
+
+    template<typename T>
+    static void temporal_smooth_dispatch(T* frame, T* last_frame, uint8_t* history, size_t count,
+        float alpha, float one_minus_alpha, T delta_z, unsigned char mask, const uint8_t* persistence_map)
+    {
+        size_t done = 0;
+#ifdef __SSSE3__
+        if (get_simd_level() >= simd_level::ssse3)
+            done = temporal_smooth_sse(frame, last_frame, history, count, alpha, one_minus_alpha, delta_z, mask,
+                persistence_lookup(persistence_map, mask));
+#endif
+        temporal_smooth_scalar(frame, last_frame, history, done, count, alpha, one_minus_alpha, delta_z, mask, persistence_map);
+    }
+
+    void temporal_smooth(uint16_t* frame, uint16_t* last_frame, uint8_t* history, size_t count,
+        float alpha, float one_minus_alpha, uint16_t delta_z, unsigned char mask, const uint8_t* persistence_map)
+    {
+        temporal_smooth_dispatch(frame, last_frame, history, count, alpha, one_minus_alpha, delta_z, mask, persistence_map);
+    }
+
+    void temporal_smooth(float* frame, float* last_frame, uint8_t* history, size_t count,
+        float alpha, float one_minus_alpha, float delta_z, unsigned char mask, const uint8_t* persistence_map)
+    {
+        temporal_smooth_dispatch(frame, last_frame, history, count, alpha, one_minus_alpha, delta_z, mask, persistence_map);
     }
 }
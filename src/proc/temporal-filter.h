@@ -8,6 +8,71 @@ namespace librealsense
 {
     const size_t PRESISTENCY_LUT_SIZE = 256;
 
+    // Temporal smoothing of one frame, pixel by pixel from first on: frame is filtered in place against last_frame,
+    // the running result, and history holds the validity of every pixel over the last 8 frames, 1 bit per frame.
+    // mask is the bit of the current frame and persistence_map tells, per history and bit, whether a hole may be
+    // filled from last_frame
+    template<typename T>
+    void temporal_smooth_scalar(T* frame, T* last_frame, uint8_t* history, size_t first, size_t count,
+        float alpha, float one_minus_alpha, T delta_z, unsigned char mask, const uint8_t* persistence_map)
+    {
+        for (size_t i = first; i < count; i++)
+        {
+            T cur_val = frame[i];
+            T prev_val = last_frame[i];
+
+            if (cur_val)
+            {
+                if (!prev_val)
+                {
+                    last_frame[i] = cur_val;
+                    history[i] = mask;
+                }
+                else
+                {  // old and new val
+                    T diff = static_cast<T>(fabs(cur_val - prev_val));
+
+                    if (diff < delta_z)
+                    {  // old and new val agree
+                        history[i] |= mask;
+                        float filtered = alpha * cur_val + one_minus_alpha * prev_val;
+                        T result = static_cast<T>(filtered);
+                        frame[i] = result;
+                        last_frame[i] = result;
+                    }
+                    else
+                    {
+                        last_frame[i] = cur_val;
+                        history[i] = mask;
+                    }
+                }
+            }
+            else
+            {  // no cur_val
+                if (prev_val)
+                { // only case we can help
+                    unsigned char hist = history[i];
+                    unsigned char classification = persistence_map[hist];
+                    if (classification & mask)
+                    { // we have had enough samples lately
+                        frame[i] = prev_val;
+                    }
+                }
+                history[i] &= ~mask;
+            }
+        }
+    }
+
+    // Same smoothing over the whole frame, vectorized where the CPU allows. The results are identical to the scalar path
+    void temporal_smooth(uint16_t* frame, uint16_t* last_frame, uint8_t* history, size_t count,
+        float alpha, float one_minus_alpha, uint16_t delta_z, unsigned char mask, const uint8_t* persistence_map);
+    void temporal_smooth(float* frame, float* last_frame, uint8_t* history, size_t count,
+        float alpha, float one_minus_alpha, float delta_z, unsigned char mask, const uint8_t* persistence_map);
+
+    // Fills persistence_map for a persistence mode of the temporal filter: bit k of entry h is set when the
+    // 8 frames history h, read with the current frame at bit k, is credible enough to fill a hole
+    void make_persistence_map(uint8_t persistence_param, std::array<uint8_t, PRESISTENCY_LUT_SIZE>& persistence_map);
+
     class temporal_filter : public depth_processing_block
     {
     public:
@@ -24,8 +89,6 @@ namespace librealsense
         {
             static_assert((std::is_arithmetic<T>::value), "temporal filter assumes numeric types");
 
-            const bool fp = (std::is_floating_point<T>::value);
-
             T delta_z = static_cast<T>(_delta_param);
 
             auto frame          = reinterpret_cast<T*>(frame_data);
@@ -33,52 +96,8 @@ namespace librealsense
 
             unsigned char mask = 1 << _cur_frame_index;
 
-            // pass one -- go through image and update all
-            for (size_t i = 0; i < _current_frm_size_pixels; i++)
-            {
-                T cur_val = frame[i];
-                T prev_val = _last_frame[i];
-
-                if (cur_val)
-                {
-                    if (!prev_val)
-                    {
-                        _last_frame[i] = cur_val;
-                        history[i] = mask;
-                    }
-                    else
-                    {  // old and new val
-                        T diff = static_cast<T>(fabs(cur_val - prev_val));
-
-                        if (diff < delta_z)
-                        {  // old and new val agree
-                            history[i] |= mask;
-                            float filtered = _alpha_param * cur_val + _one_minus_alpha * prev_val;
-                            T result = static_cast<T>(filtered);
-                            frame[i] = result;
-                            _last_frame[i] = result;
-                        }
-                        else
-                        {
-                            _last_frame[i] = cur_val;
-                            history[i] = mask;
-                        }
-                    }
-                }
-                else
-                {  // no cur_val
-                    if (prev_val)
-                    { // only case we can help
-                        unsigned char hist = history[i];
-                        unsigned char classification = _persistence_map[hist];
-                        if (classification & mask)
-                        { // we have had enough samples lately
-                            frame[i] = prev_val;
-                        }
-                    }
-                    history[i] &= ~mask;
-                }
-            }
+            temporal_smooth(frame, _last_frame, history, _current_frm_size_pixels,
+                _alpha_param, _one_minus_alpha, delta_z, mask, _persistence_map.data());
 
             _cur_frame_index = (_cur_frame_index + 1) % 8;  // at end of cycle
         }
@@ -101,7 +120,7 @@ namespace librealsense
         rs2::stream_profile     _source_stream_profile;
         rs2::stream_profile     _target_stream_profile;
         std::vector<uint8_t>    _last_frame;                // Hold the last frame received for the current profile
-        std::vector<uint8_t>    _history;                   // represents the history over the last 8 frames, 1 bit per frame
+        std::vector<uint8_t>    _history;                   // represents the history over the last 8 frames, 1 bit per frame, 1 byte per pixel
         uint8_t                 _cur_frame_index;
         // encodes whether a particular 8 bit history is good enough for all 8 phases of storage
         std::array<uint8_t, PRESISTENCY_LUT_SIZE> _persistence_map;
@@ -52,12 +52,8 @@ namespace librealsense
             ptr->set_sensor(orig->get_sensor());
             auto du = orig->get_units();
 
-            memset(new_data, 0, width * height * sizeof(uint16_t));
-            for (int i = 0; i < width * height; i++)
-            {
-                auto dist = du * depth_data[i];
-                if (dist >= _min && dist <= _max) new_data[i] = depth_data[i];
-            }
+            _lut.set({ depth_mapping::make_threshold(_min, _max) }, du);
+            _lut.apply(depth_data, new_data, size_t(width) * height);
 
             return new_f;
         }
@@ -4,6 +4,7 @@
 #pragma once
 
 #include "synthetic-stream.h"
+#include "depth-lut-transform.h"
 
 namespace rs2
 {
@@ -25,6 +26,7 @@ namespace librealsense
         rs2::stream_profile _source_stream_profile;
 
         float _min, _max;
+        depth_lut _lut;
     };
     MAP_EXTENSION(RS2_EXTENSION_THRESHOLD_FILTER, librealsense::threshold);
 }
@@ -64,12 +64,8 @@ namespace librealsense
 
             ptr->set_sensor(orig->get_sensor());
 
-            memset(new_data, 0, _width * _height * sizeof(float));
-            for (int i = 0; i < _width * _height; i++)
-            {
-                float dist = *_depth_units * depth_data[i];
-                new_data[i] = dist;
-            }
+            _lut.set({ depth_mapping::make_meters() }, *_depth_units);
+            _lut.apply(depth_data, new_data, _width * _height);
 
             return new_f;
         }
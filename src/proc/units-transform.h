@@ -4,6 +4,7 @@
 #pragma once
 
 #include "synthetic-stream.h"
+#include "depth-lut-transform.h"
 
 namespace rs2
 {
@@ -29,5 +30,6 @@ namespace librealsense
         optional_value<float>   _depth_units;
         size_t                  _width, _height, _stride;
         size_t                  _bpp;
+        depth_lut               _lut;
     };
 }
@@ -0,0 +1,277 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#include "../include/librealsense2/hpp/rs_sensor.hpp"
+#include "../include/librealsense2/hpp/rs_processing.hpp"
+
+#include <cmath>
+#include "option.h"
+#include "proc/synthetic-stream.h"
+#include "proc/voxel-filter.h"
+
+namespace librealsense
+{
+    // 64 partitions give every thread several to balance uneven scenes
+    static const int VOXEL_PARTITION_BITS = 6;
+    static const int VOXEL_PARTITIONS = 1 << VOXEL_PARTITION_BITS;
+
+    // Points per chunk of the key and scatter passes
+    static const int VOXEL_CHUNK = 16384;
+
+    // 21 bits per axis, about 1km either way at 1mm voxels
+    static const int VOXEL_AXIS_BITS = 21;
+    static const int64_t VOXEL_AXIS_OFFSET = int64_t(1) << (VOXEL_AXIS_BITS - 1);
+    static const uint64_t INVALID_VOXEL = ~uint64_t(0);
+
+    const float voxel_leaf_min = 0.001f;
+    const float voxel_leaf_max = 1.f;
+    const float voxel_leaf_step = 0.001f;
+    const float voxel_leaf_default = 0.01f;
+
+    static uint64_t voxel_axis(float coordinate, float inv_leaf)
+    {
+        // Inline floor, the library call dominates the key pass otherwise
+        auto scaled = coordinate * inv_leaf;
+        auto cell = static_cast<int64_t>(scaled);
+        if (cell > scaled) --cell;
+        cell += VOXEL_AXIS_OFFSET;
+        return static_cast<uint64_t>(std::max(int64_t(0), std::min((int64_t(1) << VOXEL_AXIS_BITS) - 1, cell)));
+    }
+
+    static uint64_t voxel_key(const float3& p, float inv_leaf)
+    {
+        return (voxel_axis(p.x, inv_leaf) << (2 * VOXEL_AXIS_BITS)) | (voxel_axis(p.y, inv_leaf) << VOXEL_AXIS_BITS) | voxel_axis(p.z, inv_leaf);
+    }
+
+    // Fibonacci hashing, the top bits pick the partition and the bits below them the table slot
+    static uint64_t voxel_hash(uint64_t key) { return key * 0x9E3779B97F4A7C15ull; }
+    static int voxel_partition(uint64_t key) { return static_cast<int>(voxel_hash(key) >> (64 - VOXEL_PARTITION_BITS)); }
+
+    voxel_grid::voxel_grid(thread_pool& pool)
+        : _pool(pool), _voxels(VOXEL_PARTITIONS), _tables(VOXEL_PARTITIONS)
+    {}
+
+    size_t voxel_grid::reduce(const float3* vertices, const float2* texcoords, size_t count,
+        float leaf_size, voxel_policy policy)
+    {
+        auto chunks = static_cast<int>((count + VOXEL_CHUNK - 1) / VOXEL_CHUNK);
+        auto inv_leaf = 1.f / leaf_size;
+        _keys.resize(count);
+        _chunk_offsets.assign(size_t(chunks) * VOXEL_PARTITIONS, 0);
+
+        // Keys and per chunk partition sizes
+        _pool.parallel_for(chunks, [&](int begin, int end)
+        {
+            for (auto c = begin; c < end; ++c)
+            {
+                auto sizes = &_chunk_offsets[size_t(c) * VOXEL_PARTITIONS];
+                auto last = std::min(count, size_t(c + 1) * VOXEL_CHUNK);
+                for (auto i = size_t(c) * VOXEL_CHUNK; i < last; ++i)
+                {
+                    if (!vertices[i].z)
+                    {
+                        _keys[i] = INVALID_VOXEL;
+                        continue;
+                    }
+                    _keys[i] = voxel_key(vertices[i], inv_leaf);
+                    sizes[voxel_partition(_keys[i])]++;
+                }
+            }
+        });
+
+        // Partition-major offsets, so within a partition the points stay in input order
+        _partition_begin.resize(VOXEL_PARTITIONS + 1);
+        uint32_t points = 0;
+        for (int p = 0; p < VOXEL_PARTITIONS; ++p)
+        {
+            _partition_begin[p] = points;
+            for (int c = 0; c < chunks; ++c)
+            {
+                auto& offset = _chunk_offsets[size_t(c) * VOXEL_PARTITIONS + p];
+                auto size = offset;
+                offset = points;
+                points += size;
+            }
+        }
+        _partition_begin[VOXEL_PARTITIONS] = points;
+        _points.resize(points);
+
+        // The points themselves are scattered, so every partition is then reduced from contiguous memory
+        _pool.parallel_for(chunks, [&](int begin, int end)
+        {
+            for (auto c = begin; c < end; ++c)
+            {
+                auto offsets = &_chunk_offsets[size_t(c) * VOXEL_PARTITIONS];
+                auto last = std::min(count, size_t(c + 1) * VOXEL_CHUNK);
+                for (auto i = size_t(c) * VOXEL_CHUNK; i < last; ++i)
+                    if (_keys[i] != INVALID_VOXEL)
+                        _points[offsets[voxel_partition(_keys[i])]++] = { _keys[i], vertices[i], texcoords[i] };
+            }
+        });
+
+        _pool.parallel_for(VOXEL_PARTITIONS, [&](int begin, int end)
+        {
+            for (auto p = begin; p < end; ++p)
+                reduce_partition(p, policy);
+        });
+
+        size_t voxels = 0;
+        for (auto&& partition : _voxels)
+            voxels += partition.size();
+        return voxels;
+    }
+
+    void voxel_grid::reduce_partition(int partition, voxel_policy policy)
+    {
+        auto begin = _partition_begin[partition];
+        auto end = _partition_begin[partition + 1];
+        auto& voxels = _voxels[partition];
+        auto& table = _tables[partition];
+        voxels.clear();
+
+        // At least twice as many slots as points keeps the probe sequences short
+        int bits = 4;
+        while ((size_t(1) << bits) < 2 * size_t(end - begin)) ++bits;
+        table.assign(size_t(1) << bits, -1);
+        auto mask = (uint32_t(1) << bits) - 1;
+
+        // Neighbouring pixels mostly share a voxel, so the last one found is checked before the table
+        auto last_key = INVALID_VOXEL;
+        int32_t last = -1;
+        for (auto k = begin; k < end; ++k)
+        {
+            auto& p = _points[k];
+            if (p.key != last_key)
+            {
+                auto slot = static_cast<uint32_t>((voxel_hash(p.key) << VOXEL_PARTITION_BITS) >> (64 - bits));
+                while (table[slot] >= 0 && voxels[table[slot]].key != p.key)
+                    slot = (slot + 1) & mask;
+
+                last_key = p.key;
+                if (table[slot] < 0)
+                {
+                    last = table[slot] = static_cast<int32_t>(voxels.size());
+                    voxels.push_back({ p.key, p.vertex, p.texcoord, 1 });
+                    continue;
+                }
+                last = table[slot];
+            }
+
+            if (policy == voxel_policy::centroid)
+            {
+                auto& v = voxels[last];
+                v.vertex.x += p.vertex.x;
+                v.vertex.y += p.vertex.y;
+                v.vertex.z += p.vertex.z;
+                v.texcoord.x += p.texcoord.x;
+                v.texcoord.y += p.texcoord.y;
+                v.points++;
+            }
+        }
+
+        if (policy == voxel_policy::centroid)
+        {
+            for (auto&& v : voxels)
+            {
+                auto inv = 1.f / v.points;
+                v.vertex = { v.vertex.x * inv, v.vertex.y * inv, v.vertex.z * inv };
+                v.texcoord = { v.texcoord.x * inv, v.texcoord.y * inv };
+            }
+        }
+    }
+
+    void voxel_grid::write(float3* out_vertices, float2* out_texcoords)
+    {
+        // _partition_begin is free again once the partitions are reduced
+        uint32_t voxels = 0;
+        for (int p = 0; p < VOXEL_PARTITIONS; ++p)
+        {
+            _partition_begin[p] = voxels;
+            voxels += static_cast<uint32_t>(_voxels[p].size());
+        }
+
+        _pool.parallel_for(VOXEL_PARTITIONS, [&](int begin, int end)
+        {
+            for (auto p = begin; p < end; ++p)
+            {
+                auto out = _partition_begin[p];
+                for (auto&& v : _voxels[p])
+                {
+                    out_vertices[out] = v.vertex;
+                    out_texcoords[out] = v.texcoord;
+                    ++out;
+                }
+            }
+        });
+    }
+
+    voxel_filter::voxel_filter()
+        : stream_filter_processing_block("Voxel Filter"),
+        _leaf_size_param(voxel_leaf_default),
+        _policy_param(static_cast<uint8_t>(voxel_policy::centroid)),
+        _leaf_size(voxel_leaf_default),
+        _policy(voxel_policy::centroid),
+        _grid(get_processing_pool())
+    {
+        _stream_filter.format = RS2_FORMAT_XYZ32F;
+
+        auto leaf_size = std::make_shared<ptr_option<float>>(
+            voxel_leaf_min,
+            voxel_leaf_max,
+            voxel_leaf_step,
+            voxel_leaf_default,
+            &_leaf_size_param, "Voxel edge length in meters");
+        // The options write their own fields, the settings of a frame are copied under the lock
+        leaf_size->on_set([this](float val)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _leaf_size = val;
+        });
+        register_option(RS2_OPTION_VOXEL_LEAF_SIZE, leaf_size);
+
+        auto policy = std::make_shared<ptr_option<uint8_t>>(
+            static_cast<uint8_t>(voxel_policy::centroid),
+            static_cast<uint8_t>(voxel_policy::count) - 1, 1,
+            static_cast<uint8_t>(voxel_policy::centroid),
+            &_policy_param, "Point kept for every voxel");
+        policy->set_description(static_cast<float>(voxel_policy::centroid), "Centroid");
+        policy->set_description(static_cast<float>(voxel_policy::first_hit), "First point");
+        policy->on_set([this](float val)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _policy = static_cast<voxel_policy>(static_cast<uint8_t>(val));
+        });
+        register_option(RS2_OPTION_VOXEL_POLICY, policy);
+    }
+
+    bool voxel_filter::should_process(const rs2::frame& frame)
+    {
+        return frame.is<rs2::points>() && stream_filter_processing_block::should_process(frame);
+    }
+
+    rs2::frame voxel_filter::process_frame(const rs2::frame_source& source, const rs2::frame& f)
+    {
+        if (f.get_profile().get() != _source_stream_profile.get())
+        {
+            _source_stream_profile = f.get_profile();
+            _target_stream_profile = f.get_profile().clone(f.get_profile().stream_type(), f.get_profile().stream_index(), RS2_FORMAT_XYZ32F);
+        }
+
+        auto input = dynamic_cast<librealsense::points*>((frame_interface*)f.get());
+        if (!input)
+            return f;
+
+        // The settings are read under the lock the block holds while processing
+        auto voxels = _grid.reduce(input->get_vertices(), input->get_texture_coordinates(), input->get_vertex_count(), _leaf_size, _policy);
+
+        auto res = source.allocate_points(_target_stream_profile, f);
+        auto output = dynamic_cast<librealsense::points*>((frame_interface*)res.get());
+        if (!output)
+            return f;
+
+        auto vertices = output->get_vertices();
+        _grid.write(vertices, reinterpret_cast<float2*>(vertices + voxels));
+        output->set_layout(voxels, RS2_FORMAT_XYZ32F, false);
+        return res;
+    }
+}
@@ -0,0 +1,80 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "../include/librealsense2/hpp/rs_frame.hpp"
+#include "synthetic-stream.h"
+#include "concurrency.h"
+
+namespace librealsense
+{
+    enum class voxel_policy : uint8_t
+    {
+        centroid,   // Average of the points, and of their texture coordinates, in the voxel
+        first_hit,  // First point of the voxel in input order
+        count
+    };
+
+    // Hash-grid voxelization in linear time. Points are radix-partitioned on the hash of their voxel
+    // and every partition is reduced by its own hash table, so partitions run in parallel without locks.
+    // The output order (partition, then first point in input order) does not depend on the thread count
+    class voxel_grid
+    {
+    public:
+        explicit voxel_grid(thread_pool& pool);
+
+        // Points with z == 0 carry no depth and are skipped. Returns the number of voxels
+        size_t reduce(const float3* vertices, const float2* texcoords, size_t count,
+            float leaf_size, voxel_policy policy);
+
+        // Writes the voxels of the last reduce, the caller sizes the output from its result
+        void write(float3* out_vertices, float2* out_texcoords);
+
+    private:
+        struct point
+        {
+            uint64_t key;
+            float3 vertex;
+            float2 texcoord;
+        };
+
+        struct voxel
+        {
+            uint64_t key;
+            float3 vertex;
+            float2 texcoord;
+            uint32_t points;
+        };
+
+        void reduce_partition(int partition, voxel_policy policy);
+
+        thread_pool& _pool;
+        std::vector<uint64_t> _keys;            // Voxel key per input point
+        std::vector<point> _points;             // Valid input points grouped by partition, in input order
+        std::vector<uint32_t> _chunk_offsets;   // Per chunk and partition scatter offsets
+        std::vector<uint32_t> _partition_begin; // Start of every partition in _points, then in the output
+        std::vector<std::vector<voxel>> _voxels;        // Voxels of every partition, in order of appearance
+        std::vector<std::vector<int32_t>> _tables;      // Open addressing slots into _voxels, per partition
+    };
+
+    class voxel_filter : public stream_filter_processing_block
+    {
+    public:
+        voxel_filter();
+
+    protected:
+        rs2::frame process_frame(const rs2::frame_source& source, const rs2::frame& f) override;
+        bool should_process(const rs2::frame& frame) override;
+
+    private:
+        float                   _leaf_size_param;
+        uint8_t                 _policy_param;
+        float                   _leaf_size;     // Settings of the next frame, guarded by _mutex
+        voxel_policy            _policy;
+        rs2::stream_profile     _source_stream_profile;
+        rs2::stream_profile     _target_stream_profile;
+        voxel_grid              _grid;
+    };
+    MAP_EXTENSION(RS2_EXTENSION_VOXEL_FILTER, librealsense::voxel_filter);
+}
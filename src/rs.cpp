@@ -15,6 +15,7 @@
 #include <media/ros/ros_reader.h>
 #include "core/advanced_mode.h"
 #include "source.h"
+#include "points-export.h"
 #include "core/processing.h"
 #include "proc/synthetic-stream.h"
 #include "proc/processing-blocks-factory.h"
@@ -27,6 +28,11 @@
 #include "proc/decimation-filter.h"
 #include "proc/spatial-filter.h"
 #include "proc/zero-order.h"
+#include "proc/voxel-filter.h"
+#include "proc/depth-post-processing-chain.h"
+#include "proc/processing-graph.h"
+#include "proc/pipelined-processing-block.h"
+#include "proc/depth-lut-transform.h"
 #include "proc/hole-filling-filter.h"
 #include "proc/yuy2rgb.h"
 #include "proc/rates-printer.h"
@@ -108,6 +114,26 @@ struct rs2_frame_queue
     single_consumer_frame_queue<librealsense::frame_holder> queue;
 };
 
+struct rs2_processing_graph
+{
+    explicit rs2_processing_graph(unsigned int threads)
+        : graph(threads)
+    {
+    }
+
+    librealsense::processing_graph graph;
+};
+
+struct rs2_points_exporter
+{
+    rs2_points_exporter(const std::string& prefix, rs2_points_file_format format, int flags, int capacity)
+        : exporter(prefix, format, flags, capacity)
+    {
+    }
+
+    points_exporter exporter;
+};
+
 struct rs2_sensor_list
 {
     rs2_device dev;
@@ -1093,11 +1119,13 @@ const char* rs2_distortion_to_string(rs2_distortion distortion)
 const char* rs2_option_to_string(rs2_option option)                                       { return librealsense::get_string(option);       }
 const char* rs2_camera_info_to_string(rs2_camera_info info)                               { return librealsense::get_string(info);         }
 const char* rs2_timestamp_domain_to_string(rs2_timestamp_domain info)                     { return librealsense::get_string(info);         }
+const char* rs2_points_file_format_to_string(rs2_points_file_format format)                { return librealsense::get_string(format);       }
 const char* rs2_notification_category_to_string(rs2_notification_category category)       { return librealsense::get_string(category);     }
 const char* rs2_sr300_visual_preset_to_string(rs2_sr300_visual_preset preset)             { return librealsense::get_string(preset);       }
 const char* rs2_log_severity_to_string(rs2_log_severity severity)                         { return librealsense::get_string(severity);     }
 const char* rs2_exception_type_to_string(rs2_exception_type type)                         { return librealsense::get_string(type);         }
 const char* rs2_playback_status_to_string(rs2_playback_status status)                     { return librealsense::get_string(status);       }
+const char* rs2_recording_queue_policy_to_string(rs2_recording_queue_policy policy)        { return librealsense::get_string(policy);       }
 const char* rs2_extension_type_to_string(rs2_extension type)                              { return librealsense::get_string(type);         }
 const char* rs2_frame_metadata_to_string(rs2_frame_metadata_value metadata)               { return librealsense::get_string(metadata);     }
 const char* rs2_extension_to_string(rs2_extension type)                                   { return rs2_extension_type_to_string(type);     }
@@ -1200,6 +1228,10 @@ int rs2_is_processing_block_extendable_to(const rs2_processing_block* f, rs2_ext
     case RS2_EXTENSION_TEMPORAL_FILTER: return VALIDATE_INTERFACE_NO_THROW((processing_block_interface*)(f->block.get()), librealsense::temporal_filter) != nullptr;
     case RS2_EXTENSION_HOLE_FILLING_FILTER: return VALIDATE_INTERFACE_NO_THROW((processing_block_interface*)(f->block.get()), librealsense::hole_filling_filter) != nullptr;
     case RS2_EXTENSION_ZERO_ORDER_FILTER: return VALIDATE_INTERFACE_NO_THROW((processing_block_interface*)(f->block.get()), librealsense::zero_order) != nullptr;
+    case RS2_EXTENSION_VOXEL_FILTER: return VALIDATE_INTERFACE_NO_THROW((processing_block_interface*)(f->block.get()), librealsense::voxel_filter) != nullptr;
+    case RS2_EXTENSION_DEPTH_LUT_TRANSFORM: return VALIDATE_INTERFACE_NO_THROW((processing_block_interface*)(f->block.get()), librealsense::depth_lut_transform) != nullptr;
+    case RS2_EXTENSION_DEPTH_POST_PROCESSING_CHAIN: return VALIDATE_INTERFACE_NO_THROW((processing_block_interface*)(f->block.get()), librealsense::depth_post_processing_chain) != nullptr;
+    case RS2_EXTENSION_PIPELINED_PROCESSING_BLOCK: return VALIDATE_INTERFACE_NO_THROW((processing_block_interface*)(f->block.get()), librealsense::pipelined_processing_block) != nullptr;
   
     default:
         return false;
@@ -1284,6 +1316,16 @@ void rs2_playback_seek(const rs2_device* device, long long int time, rs2_error**
 }
 HANDLE_EXCEPTIONS_AND_RETURN(, device)
 
+void rs2_playback_seek_to_frame(const rs2_device* device, rs2_stream stream, int index, unsigned long long int frame_number, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(device);
+    VALIDATE_ENUM(stream);
+    VALIDATE_LE(0, index);
+    auto playback = VALIDATE_INTERFACE(device->device, librealsense::playback_device);
+    playback->seek_to_frame(stream, static_cast<uint32_t>(index), frame_number);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, device, stream, index, frame_number)
+
 unsigned long long int rs2_playback_get_position(const rs2_device* device, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(device);
@@ -1324,6 +1366,22 @@ int rs2_playback_device_is_real_time(const rs2_device* device, rs2_error** error
 }
 HANDLE_EXCEPTIONS_AND_RETURN(0, device)
 
+void rs2_playback_device_set_read_ahead(const rs2_device* device, unsigned int max_items, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(device);
+    auto playback = VALIDATE_INTERFACE(device->device, librealsense::playback_device);
+    playback->set_read_ahead(max_items);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, device, max_items)
+
+unsigned int rs2_playback_device_get_read_ahead_fill(const rs2_device* device, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(device);
+    auto playback = VALIDATE_INTERFACE(device->device, librealsense::playback_device);
+    return static_cast<unsigned int>(playback->get_read_ahead_fill());
+}
+HANDLE_EXCEPTIONS_AND_RETURN(0, device)
+
 void rs2_playback_device_set_status_changed_callback(const rs2_device* device, rs2_playback_status_changed_callback* callback, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(device);
@@ -1406,6 +1464,32 @@ const char* rs2_record_device_filename(const rs2_device* device, rs2_error** err
 }
 HANDLE_EXCEPTIONS_AND_RETURN(nullptr, device)
 
+void rs2_record_device_set_queue_budget(const rs2_device* device, unsigned long long max_bytes, rs2_recording_queue_policy policy, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(device);
+    VALIDATE_ENUM(policy);
+    auto record_device = VALIDATE_INTERFACE(device->device, librealsense::record_device);
+    record_device->set_queue_budget(max_bytes, policy);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, device, max_bytes, policy)
+
+void rs2_record_device_get_queue_stats(const rs2_device* device, rs2_recording_queue_stats* stats, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(device);
+    VALIDATE_NOT_NULL(stats);
+    auto record_device = VALIDATE_INTERFACE(device->device, librealsense::record_device);
+    *stats = record_device->get_queue_stats();
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, device, stats)
+
+void rs2_record_device_set_compression_options(const rs2_device* device, unsigned int chunk_size, unsigned int compression_threads, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(device);
+    auto record_device = VALIDATE_INTERFACE(device->device, librealsense::record_device);
+    record_device->set_compression_options(chunk_size, compression_threads);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, device, chunk_size, compression_threads)
+
 
 rs2_frame* rs2_allocate_synthetic_video_frame(rs2_source* source, const rs2_stream_profile* new_stream, rs2_frame* original,
     int new_bpp, int new_width, int new_height, int new_stride, rs2_extension frame_type, rs2_error** error) BEGIN_API_CALL
@@ -1860,6 +1944,50 @@ void rs2_export_to_ply(const rs2_frame* frame, const char* fname, rs2_frame* tex
 }
 HANDLE_EXCEPTIONS_AND_RETURN(, frame, fname)
 
+void rs2_export_points(const rs2_frame* frame, const char* fname, rs2_frame* texture, rs2_points_file_format format, int flags, rs2_error** error) BEGIN_API_CALL
+{
+    frame_holder texture_holder((frame_interface*)texture);
+    VALIDATE_NOT_NULL(frame);
+    VALIDATE_NOT_NULL(fname);
+    VALIDATE_ENUM(format);
+    auto points = VALIDATE_INTERFACE((frame_interface*)frame, librealsense::points);
+    export_points(*points, texture_holder, fname, format, flags);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, frame, fname, format, flags)
+
+rs2_points_exporter* rs2_create_points_exporter(const char* prefix, rs2_points_file_format format, int flags, int capacity, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(prefix);
+    VALIDATE_ENUM(format);
+    VALIDATE_RANGE(capacity, 1, 1024);
+    return new rs2_points_exporter(prefix, format, flags, capacity);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, prefix, format, flags, capacity)
+
+void rs2_points_exporter_enqueue(rs2_points_exporter* exporter, rs2_frame* frame, rs2_frame* texture, rs2_error** error) BEGIN_API_CALL
+{
+    frame_holder points((frame_interface*)frame), texture_holder((frame_interface*)texture);
+    VALIDATE_NOT_NULL(exporter);
+    VALIDATE_NOT_NULL(frame);
+    VALIDATE_INTERFACE(points.frame, librealsense::points);
+    exporter->exporter.enqueue(std::move(points), std::move(texture_holder));
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, exporter, frame, texture)
+
+void rs2_points_exporter_flush(rs2_points_exporter* exporter, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(exporter);
+    exporter->exporter.flush();
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, exporter)
+
+void rs2_delete_points_exporter(rs2_points_exporter* exporter) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(exporter);
+    delete exporter;
+}
+NOEXCEPT_RETURN(, exporter)
+
 rs2_pixel* rs2_get_frame_texture_coordinates(const rs2_frame* frame, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(frame);
@@ -1876,6 +2004,14 @@ int rs2_get_frame_points_count(const rs2_frame* frame, rs2_error** error) BEGIN_
 }
 HANDLE_EXCEPTIONS_AND_RETURN(0, frame)
 
+const int* rs2_get_frame_pixel_indices(const rs2_frame* frame, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(frame);
+    auto points = VALIDATE_INTERFACE((frame_interface*)frame, librealsense::points);
+    return points->get_pixel_indices();
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, frame)
+
 rs2_processing_block* rs2_create_pointcloud(rs2_error** error) BEGIN_API_CALL
 {
     return new rs2_processing_block { pointcloud::create() };
@@ -1979,6 +2115,133 @@ rs2_processing_block* rs2_create_zero_order_invalidation_block(rs2_error** error
 }
 NOARGS_HANDLE_EXCEPTIONS_AND_RETURN(nullptr)
 
+rs2_processing_block* rs2_create_voxel_filter_block(rs2_error** error) BEGIN_API_CALL
+{
+    auto block = std::make_shared<librealsense::voxel_filter>();
+
+    return new rs2_processing_block{ block };
+}
+NOARGS_HANDLE_EXCEPTIONS_AND_RETURN(nullptr)
+
+rs2_processing_block* rs2_create_depth_lut_transform_block(rs2_error** error) BEGIN_API_CALL
+{
+    auto block = std::make_shared<librealsense::depth_lut_transform>();
+
+    return new rs2_processing_block{ block };
+}
+NOARGS_HANDLE_EXCEPTIONS_AND_RETURN(nullptr)
+
+rs2_processing_block* rs2_create_depth_post_processing_chain_block(rs2_processing_block* decimation, rs2_processing_block* spatial,
+    rs2_processing_block* temporal, rs2_processing_block* hole_filling, rs2_error** error) BEGIN_API_CALL
+{
+    if (decimation) VALIDATE_INTERFACE(decimation->block, librealsense::decimation_filter);
+    if (spatial) VALIDATE_INTERFACE(spatial->block, librealsense::spatial_filter);
+    if (temporal) VALIDATE_INTERFACE(temporal->block, librealsense::temporal_filter);
+    if (hole_filling) VALIDATE_INTERFACE(hole_filling->block, librealsense::hole_filling_filter);
+
+    auto block = std::make_shared<librealsense::depth_post_processing_chain>(
+        decimation ? decimation->block : nullptr,
+        spatial ? spatial->block : nullptr,
+        temporal ? temporal->block : nullptr,
+        hole_filling ? hole_filling->block : nullptr);
+
+    return new rs2_processing_block{ block };
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, decimation, spatial, temporal, hole_filling)
+
+rs2_processing_block* rs2_create_pipelined_processing_block(rs2_processing_block** stages, int count, int queue_size, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(stages);
+    VALIDATE_RANGE(count, 1, 256);
+    VALIDATE_RANGE(queue_size, 1, 256);
+
+    std::vector<std::shared_ptr<processing_block_interface>> blocks;
+    for (int i = 0; i < count; i++)
+    {
+        VALIDATE_NOT_NULL(stages[i]);
+        blocks.push_back(stages[i]->block);
+    }
+
+    auto block = std::make_shared<librealsense::pipelined_processing_block>(blocks, queue_size);
+
+    return new rs2_processing_block{ block };
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, stages, count, queue_size)
+
+rs2_processing_graph* rs2_create_processing_graph(int threads, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_RANGE(threads, 0, 256);
+    return new rs2_processing_graph(threads);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, threads)
+
+void rs2_delete_processing_graph(rs2_processing_graph* graph) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(graph);
+    delete graph;
+}
+NOEXCEPT_RETURN(, graph)
+
+int rs2_processing_graph_add_node(rs2_processing_graph* graph, rs2_processing_block* block, int parent,
+    rs2_stream stream, rs2_format format, int index, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(graph);
+    VALIDATE_NOT_NULL(block);
+    VALIDATE_ENUM(stream);
+    VALIDATE_ENUM(format);
+
+    return graph->graph.add_node(block->block, parent, stream_filter(stream, format, index));
+}
+HANDLE_EXCEPTIONS_AND_RETURN(-1, graph, block, parent, stream, format, index)
+
+void rs2_processing_graph_start(rs2_processing_graph* graph, int node, rs2_frame_callback* on_frame, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(graph);
+    VALIDATE_NOT_NULL(on_frame);
+
+    graph->graph.set_output_callback(node, { on_frame, [](rs2_frame_callback* p) { p->release(); } });
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, graph, node, on_frame)
+
+void rs2_processing_graph_start_queue(rs2_processing_graph* graph, int node, rs2_frame_queue* queue, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(graph);
+    VALIDATE_NOT_NULL(queue);
+    librealsense::frame_callback_ptr callback(
+        new librealsense::frame_callback(rs2_enqueue_frame, queue));
+    graph->graph.set_output_callback(node, move(callback));
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, graph, node, queue)
+
+void rs2_processing_graph_invoke(rs2_processing_graph* graph, rs2_frame* frame, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(graph);
+    VALIDATE_NOT_NULL(frame);
+
+    graph->graph.invoke(frame_holder((frame_interface*)frame));
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, graph, frame)
+
+void rs2_processing_graph_wait(rs2_processing_graph* graph, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(graph);
+    graph->graph.wait();
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, graph)
+
+void rs2_processing_graph_get_stats(const rs2_processing_graph* graph, int node, rs2_processing_node_stats* stats, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(graph);
+    VALIDATE_NOT_NULL(stats);
+
+    auto s = graph->graph.get_stats(node);
+    stats->frames = s.frames;
+    stats->average_ms = s.average_ms;
+    stats->max_ms = s.max_ms;
+    stats->average_wait_ms = s.average_wait_ms;
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, graph, node, stats)
+
 float rs2_get_depth_scale(rs2_sensor* sensor, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(sensor);
@@ -34,6 +34,9 @@ namespace librealsense
           })
     {
         register_option(RS2_OPTION_FRAMES_QUEUE_SIZE, _source.get_published_size_option());
+        register_option(RS2_OPTION_FRAMES_POOL_HITS, _source.get_pool_stats_option(RS2_OPTION_FRAMES_POOL_HITS));
+        register_option(RS2_OPTION_FRAMES_POOL_MISSES, _source.get_pool_stats_option(RS2_OPTION_FRAMES_POOL_MISSES));
+        register_option(RS2_OPTION_FRAMES_POOL_EVICTIONS, _source.get_pool_stats_option(RS2_OPTION_FRAMES_POOL_EVICTIONS));
 
         register_metadata(RS2_FRAME_METADATA_TIME_OF_ARRIVAL, std::make_shared<librealsense::md_time_of_arrival_parser>());
 
@@ -419,6 +422,41 @@ namespace librealsense
             _pixel_formats.erase(it);
     }
 
+    std::vector<uvc_sensor::output_descriptor> uvc_sensor::describe_outputs(const request_mapping& mode) const
+    {
+        auto&& unpacker = *mode.unpacker;
+        if (unpacker.outputs.size() > MAX_UNPACKER_OUTPUTS)
+            throw invalid_value_exception(to_string() << "open(...) failed. Unpacker produces " << unpacker.outputs.size()
+                << " streams, at most " << MAX_UNPACKER_OUTPUTS << " are supported");
+
+        std::vector<output_descriptor> outputs;
+        for (auto&& output : unpacker.outputs)
+        {
+            output_descriptor desc;
+            for (auto&& original_prof : mode.original_requests)
+            {
+                if (original_prof->get_format() == output.format &&
+                    original_prof->get_stream_type() == output.stream_desc.type &&
+                    original_prof->get_stream_index() == output.stream_desc.index)
+                {
+                    desc.profile = original_prof;
+                }
+            }
+
+            auto res = output.stream_resolution({ mode.profile.width, mode.profile.height });
+            desc.frame_type = stream_to_frame_types(output.stream_desc.type);
+            desc.stream_type = output.stream_desc.type;
+            desc.stream_index = output.stream_desc.index;
+            desc.width = res.width;
+            desc.height = res.height;
+            desc.bpp = get_image_bpp(output.format);
+            desc.stride = desc.width * desc.bpp / 8;
+            desc.size = desc.width * desc.height * desc.bpp / 8;
+            outputs.push_back(desc);
+        }
+        return outputs;
+    }
+
     void uvc_sensor::open(const stream_profiles& requests)
     {
         std::lock_guard<std::mutex> lock(_configure_lock);
@@ -439,19 +477,20 @@ namespace librealsense
 
         for (auto&& mode : mapping)
         {
+            auto outputs = describe_outputs(mode);
             try
             {
                 unsigned long long last_frame_number = 0;
                 rs2_time_t last_timestamp = 0;
                 _device->probe_and_commit(mode.profile,
-                [this, mode, timestamp_reader, requests, last_frame_number, last_timestamp](platform::stream_profile p, platform::frame_object f, std::function<void()> continuation) mutable
+                [this, mode, outputs, timestamp_reader, last_frame_number, last_timestamp](platform::stream_profile p, platform::frame_object f, std::function<void()> continuation) mutable
                 {
                     auto system_time = environment::get_instance().get_time_service()->get_time();
                     if (!this->is_streaming())
                     {
                         LOG_WARNING("Frame received with streaming inactive,"
-                            << librealsense::get_string(mode.unpacker->outputs.front().stream_desc.type)
-                            << mode.unpacker->outputs.front().stream_desc.index
+                            << librealsense::get_string(outputs.front().stream_type)
+                            << outputs.front().stream_index
                                 << ", Arrived," << std::fixed << f.backend_time << " " << system_time);
                         return;
                     }
@@ -466,79 +505,78 @@ namespace librealsense
 
                     auto requires_processing = mode.requires_processing();
 
-                    std::vector<byte *> dest;
-                    std::vector<frame_holder> refs;
+                    // Zero-copy frames pin the backend buffer until released. When the backend runs low
+                    // on buffers, copy the frame into archive memory and return the buffer right away
+                    if (!requires_processing && f.copy_required)
+                    {
+                        requires_processing = true;
+                        ++_passthrough_copies;
+                    }
 
-                    auto&& unpacker = *mode.unpacker;
-                    for (auto&& output : unpacker.outputs)
+                    if (is_debug_log_enabled())
                     {
-                        LOG_DEBUG("FrameAccepted," << librealsense::get_string(output.stream_desc.type)
-                            << ",Counter," << std::dec << frame_counter
-                            << ",Index," << output.stream_desc.index
-                            << ",BackEndTS," << std::fixed << f.backend_time
-                            << ",SystemTime," << std::fixed << system_time
-                            <<" ,diff_ts[Sys-BE],"<< system_time- f.backend_time
-                            << ",TS," << std::fixed << timestamp << ",TS_Domain," << rs2_timestamp_domain_to_string(timestamp_domain)
-                            <<",last_frame_number,"<< last_frame_number<<",last_timestamp,"<< last_timestamp);
-
-                        std::shared_ptr<stream_profile_interface> request = nullptr;
-                        for (auto&& original_prof : mode.original_requests)
+                        for (auto&& output : outputs)
                         {
-                            if (original_prof->get_format() == output.format &&
-                                original_prof->get_stream_type() == output.stream_desc.type &&
-                                original_prof->get_stream_index() == output.stream_desc.index)
-                            {
-                                request = original_prof;
-                            }
+                            LOG_DEBUG("FrameAccepted," << librealsense::get_string(output.stream_type)
+                                << ",Counter," << std::dec << frame_counter
+                                << ",Index," << output.stream_index
+                                << ",BackEndTS," << std::fixed << f.backend_time
+                                << ",SystemTime," << std::fixed << system_time
+                                <<" ,diff_ts[Sys-BE],"<< system_time- f.backend_time
+                                << ",TS," << std::fixed << timestamp << ",TS_Domain," << rs2_timestamp_domain_to_string(timestamp_domain)
+                                <<",last_frame_number,"<< last_frame_number<<",last_timestamp,"<< last_timestamp);
                         }
+                    }
 
-                        auto bpp = get_image_bpp(output.format);
-                        frame_additional_data additional_data(timestamp,
-                            frame_counter,
-                            system_time,
-                            static_cast<uint8_t>(f.metadata_size),
-                            (const uint8_t*)f.metadata,
-                            f.backend_time,
-                            last_timestamp,
-                            last_frame_number,
-                            false);
-
-                        last_frame_number = frame_counter;
-                        last_timestamp = timestamp;
-
-                        auto res = output.stream_resolution({ mode.profile.width, mode.profile.height });
-                        auto width = res.width;
-                        auto height = res.height;
-
-                        frame_holder frame = _source.alloc_frame(stream_to_frame_types(output.stream_desc.type), width * height * bpp / 8, additional_data, requires_processing);
+                    // The header is shared by all the outputs of the native frame
+                    frame_additional_data additional_data(timestamp,
+                        frame_counter,
+                        system_time,
+                        static_cast<uint8_t>(f.metadata_size),
+                        (const uint8_t*)f.metadata,
+                        f.backend_time,
+                        last_timestamp,
+                        last_frame_number,
+                        false);
+
+                    last_frame_number = frame_counter;
+                    last_timestamp = timestamp;
+
+                    // Obtain buffers for unpacking the frame
+                    std::array<byte*, MAX_UNPACKER_OUTPUTS> dest;
+                    std::array<frame_holder, MAX_UNPACKER_OUTPUTS> refs;
+                    auto outputs_count = outputs.size();
+
+                    for (size_t i = 0; i < outputs_count; ++i)
+                    {
+                        auto&& output = outputs[i];
+                        frame_holder frame = _source.alloc_frame(output.frame_type, output.size, additional_data, requires_processing);
                         if (frame.frame)
                         {
                             auto video = (video_frame*)frame.frame;
-                            video->assign(width, height, width * bpp / 8, bpp);
+                            video->assign(output.width, output.height, output.stride, output.bpp);
                             video->set_timestamp_domain(timestamp_domain);
-                            dest.push_back(const_cast<byte*>(video->get_frame_data()));
-                            frame->set_stream(request);
-                            refs.push_back(std::move(frame));
+                            dest[i] = const_cast<byte*>(video->get_frame_data());
+                            frame->set_stream(output.profile);
+                            refs[i] = std::move(frame);
                         }
                         else
                         {
                             LOG_INFO("Dropped frame. alloc_frame(...) returned nullptr");
                             return;
                         }
-
-                        // Obtain buffers for unpacking the frame
-                        //dest.push_back(archive->alloc_frame(output.first, additional_data, requires_processing));
                     }
 
                     // Unpack the frame
-                    if (requires_processing && (dest.size() > 0))
+                    if (requires_processing && (outputs_count > 0))
                     {
-                        unpacker.unpack(dest.data(), reinterpret_cast<const byte *>(f.pixels), mode.profile.width, mode.profile.height, f.frame_size);
+                        mode.unpacker->unpack(dest.data(), reinterpret_cast<const byte *>(f.pixels), mode.profile.width, mode.profile.height, f.frame_size);
                     }
 
                     // If any frame callbacks were specified, dispatch them now
-                    for (auto&& pref : refs)
+                    for (size_t i = 0; i < outputs_count; ++i)
                     {
+                        auto&& pref = refs[i];
                         if (!requires_processing)
                         {
                             pref->attach_continuation(std::move(release_and_enqueue));
@@ -1107,9 +1145,12 @@ namespace librealsense
        :   sensor_base(name, dev, (recommended_proccesing_blocks_interface*)this),
           _device(move(uvc_device)),
           _user_count(0),
-          _timestamp_reader(std::move(timestamp_reader))
+          _timestamp_reader(std::move(timestamp_reader)),
+          _passthrough_copies(0)
     {
         register_metadata(RS2_FRAME_METADATA_BACKEND_TIMESTAMP,     make_additional_data_parser(&frame_additional_data::backend_timestamp));
+        register_option(RS2_OPTION_PASSTHROUGH_FRAMES_COPIED, std::make_shared<counter_option>(&_passthrough_copies,
+            "Number of zero-copy frames that were copied because the backend was running low on capture buffers"));
     }
 
     iio_hid_timestamp_reader::iio_hid_timestamp_reader()
@@ -233,6 +233,22 @@ namespace librealsense
         rs2_extension stream_to_frame_types(rs2_stream stream) const;
 
     private:
+        // Per-output parameters of a negotiated mode, resolved once on open instead of per frame
+        struct output_descriptor
+        {
+            std::shared_ptr<stream_profile_interface> profile;
+            rs2_extension frame_type;
+            rs2_stream stream_type;
+            int stream_index;
+            int width;
+            int height;
+            int bpp;
+            int stride;
+            size_t size;
+        };
+
+        std::vector<output_descriptor> describe_outputs(const request_mapping& mode) const;
+
         void acquire_power();
 
         void release_power();
@@ -273,6 +289,7 @@ namespace librealsense
         std::vector<platform::extension_unit> _xus;
         std::unique_ptr<power> _power;
         std::unique_ptr<frame_timestamp_reader> _timestamp_reader;
+        std::atomic<uint64_t> _passthrough_copies;
     };
 
     processing_blocks get_color_recommended_proccesing_blocks();
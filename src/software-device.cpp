@@ -150,7 +150,8 @@ namespace librealsense
         {
             if (supports_option(RS2_OPTION_DEPTH_UNITS))
             {
-                *ptr = &(*_stereo_extension);
+                // The caller reads the pointer as the extension's own type, the depth_sensor base is virtual
+                *ptr = static_cast<depth_sensor*>(&(*_stereo_extension));
                 return true;
             }
         }
@@ -159,7 +160,7 @@ namespace librealsense
             if (supports_option(RS2_OPTION_DEPTH_UNITS) && 
                 supports_option(RS2_OPTION_STEREO_BASELINE))
             {
-                *ptr = &(*_stereo_extension);
+                *ptr = static_cast<depth_stereo_sensor*>(&(*_stereo_extension));
                 return true;
             }
         }
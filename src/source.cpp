@@ -41,10 +41,30 @@ namespace librealsense
         return std::make_shared<frame_queue_size>(&_max_publish_list_size, option_range{ 0, 32, 1, 16 });
     }
 
+    std::shared_ptr<option> frame_source::get_pool_stats_option(rs2_option id)
+    {
+        switch (id)
+        {
+        // The aliasing pointers keep the statistics alive as long as the options
+        case RS2_OPTION_FRAMES_POOL_HITS:
+            return std::make_shared<counter_option>(std::shared_ptr<const std::atomic<uint64_t>>(_pool_stats, &_pool_stats->hits),
+                "Number of frame buffers served from the recycled frames pool");
+        case RS2_OPTION_FRAMES_POOL_MISSES:
+            return std::make_shared<counter_option>(std::shared_ptr<const std::atomic<uint64_t>>(_pool_stats, &_pool_stats->misses),
+                "Number of frame buffers that had to be newly allocated");
+        case RS2_OPTION_FRAMES_POOL_EVICTIONS:
+            return std::make_shared<counter_option>(std::shared_ptr<const std::atomic<uint64_t>>(_pool_stats, &_pool_stats->evictions),
+                "Number of recycled frame buffers released after staying unused in the pool for over a second");
+        default:
+            throw invalid_value_exception(to_string() << "get_pool_stats_option(...) failed! " << rs2_option_to_string(id) << " is not a frames pool counter.");
+        }
+    }
+
     frame_source::frame_source(uint32_t max_publish_list_size)
             : _callback(nullptr, [](rs2_frame_callback*) {}),
               _max_publish_list_size(max_publish_list_size),
-              _ts(environment::get_instance().get_time_service())
+              _ts(environment::get_instance().get_time_service()),
+              _pool_stats(std::make_shared<frame_pool_stats>())
     {}
 
     void frame_source::init(std::shared_ptr<metadata_parser_map> metadata_parsers)
@@ -61,7 +81,7 @@ namespace librealsense
 
         for (auto type : supported)
         {
-            _archive[type] = make_archive(type, &_max_publish_list_size, _ts, metadata_parsers);
+            _archive[type] = make_archive(type, &_max_publish_list_size, _ts, metadata_parsers, _pool_stats);
         }
 
         _metadata_parsers = metadata_parsers;
@@ -84,7 +104,7 @@ namespace librealsense
         _metadata_parsers.reset();
     }
 
-    frame_interface* frame_source::alloc_frame(rs2_extension type, size_t size, frame_additional_data additional_data, bool requires_memory) const
+    frame_interface* frame_source::alloc_frame(rs2_extension type, size_t size, const frame_additional_data& additional_data, bool requires_memory) const
     {
         auto it = _archive.find(type);
         if (it == _archive.end()) throw wrong_api_call_sequence_exception("Requested frame type is not supported!");
@@ -26,7 +26,9 @@ namespace librealsense
 
         std::shared_ptr<option> get_published_size_option();
 
-        frame_interface* alloc_frame(rs2_extension type, size_t size, frame_additional_data additional_data, bool requires_memory) const;
+        std::shared_ptr<option> get_pool_stats_option(rs2_option id);
+
+        frame_interface* alloc_frame(rs2_extension type, size_t size, const frame_additional_data& additional_data, bool requires_memory) const;
 
         void set_callback(frame_callback_ptr callback);
         frame_callback_ptr get_callback() const;
@@ -44,7 +46,7 @@ namespace librealsense
         template<class T>
         void add_extension(rs2_extension ex)
         {
-            _archive[ex] = std::make_shared<frame_archive<T>>(&_max_publish_list_size, _ts, _metadata_parsers);
+            _archive[ex] = std::make_shared<frame_archive<T>>(&_max_publish_list_size, _ts, _metadata_parsers, _pool_stats);
         }
 
         void set_max_publish_list_size(int qsize) {_max_publish_list_size = qsize; }
@@ -60,5 +62,6 @@ namespace librealsense
         frame_callback_ptr _callback;
         std::shared_ptr<platform::time_service> _ts;
         std::shared_ptr<metadata_parser_map> _metadata_parsers;
+        std::shared_ptr<frame_pool_stats> _pool_stats;
     };
 }
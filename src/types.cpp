@@ -185,6 +185,10 @@ namespace librealsense
             CASE(GLOBAL_TIMER)
             CASE(L500_DEPTH_SENSOR)
             CASE(TM2_SENSOR)
+            CASE(VOXEL_FILTER)
+            CASE(DEPTH_LUT_TRANSFORM)
+            CASE(DEPTH_POST_PROCESSING_CHAIN)
+            CASE(PIPELINED_PROCESSING_BLOCK)
         default: assert(!is_valid(value)); return UNKNOWN_VALUE;
         }
 #undef CASE
@@ -204,6 +208,19 @@ namespace librealsense
 #undef CASE
     }
 
+    const char* get_string(rs2_recording_queue_policy value)
+    {
+#define CASE(X) STRCASE(RECORDING_QUEUE_POLICY, X)
+        switch (value)
+        {
+            CASE(BLOCK)
+            CASE(DROP_OLDEST)
+            CASE(DROP_NON_DEPTH_FIRST)
+        default: assert(!is_valid(value)); return UNKNOWN_VALUE;
+        }
+#undef CASE
+    }
+
     const char* get_string(rs2_log_severity value)
     {
 #define CASE(X) STRCASE(LOG_SEVERITY, X)
@@ -285,6 +302,17 @@ namespace librealsense
             CASE(ENABLE_POSE_JUMPING)
             CASE(ENABLE_DYNAMIC_CALIBRATION)
             CASE(DEPTH_OFFSET)
+            CASE(FRAMES_POOL_HITS)
+            CASE(FRAMES_POOL_MISSES)
+            CASE(FRAMES_POOL_EVICTIONS)
+            CASE(PASSTHROUGH_FRAMES_COPIED)
+            CASE(POINTS_COMPACT)
+            CASE(POINTS_PIXEL_INDICES)
+            CASE(POINTS_ENCODING)
+            CASE(VOXEL_LEAF_SIZE)
+            CASE(VOXEL_POLICY)
+            CASE(COLORIZER_FORMAT)
+            CASE(DEPTH_LUT_OUTPUT)
         default: assert(!is_valid(value)); return UNKNOWN_VALUE;
         }
 #undef CASE
@@ -318,6 +346,8 @@ namespace librealsense
             CASE(Y10BPACK)
             CASE(DISTANCE)
             CASE(MJPEG)
+            CASE(XYZ16)
+            CASE(XYZ16F)
         default: assert(!is_valid(value)); return UNKNOWN_VALUE;
         }
 #undef CASE
@@ -401,6 +431,18 @@ namespace librealsense
 #undef CASE
     }
 
+    const char* get_string(rs2_points_file_format value)
+    {
+#define CASE(X) STRCASE(POINTS_FILE_FORMAT, X)
+        switch (value)
+        {
+            CASE(PLY)
+            CASE(PCD)
+        default: assert(!is_valid(value)); return UNKNOWN_VALUE;
+        }
+#undef CASE
+    }
+
     const char* get_string(rs2_timestamp_domain value)
     {
 #define CASE(X) STRCASE(TIMESTAMP_DOMAIN, X)
@@ -195,6 +195,7 @@ namespace librealsense
 
     void log_to_console(rs2_log_severity min_severity);
     void log_to_file(rs2_log_severity min_severity, const char * file_path);
+    bool is_debug_log_enabled(); // allows hot paths to skip formatting debug messages nobody will see
 
 #if BUILD_EASYLOGGINGPP
 
@@ -525,7 +526,9 @@ namespace librealsense
     RS2_ENUM_HELPERS(rs2_log_severity, LOG_SEVERITY)
     RS2_ENUM_HELPERS(rs2_notification_category, NOTIFICATION_CATEGORY)
     RS2_ENUM_HELPERS(rs2_playback_status, PLAYBACK_STATUS)
+    RS2_ENUM_HELPERS(rs2_recording_queue_policy, RECORDING_QUEUE_POLICY)
     RS2_ENUM_HELPERS(rs2_matchers, MATCHER)
+    RS2_ENUM_HELPERS(rs2_points_file_format, POINTS_FILE_FORMAT)
     ////////////////////////////////////////////
     // World's tiniest linear algebra library //
     ////////////////////////////////////////////
@@ -671,6 +674,8 @@ namespace librealsense
         resolution_func stream_resolution;
     };
 
+    const size_t MAX_UNPACKER_OUTPUTS = 4; // Upper bound on the number of streams a single native format is split into
+
     struct pixel_format_unpacker
     {
         bool requires_processing;
@@ -52,11 +52,17 @@
 
 //#include "ros/subscription_callback_helper.h"
 
+#include <condition_variable>
+#include <deque>
 #include <ios>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <queue>
 #include <set>
 #include <stdexcept>
+#include <thread>
+#include <vector>
 
 #include <boost/format.hpp>
 //#include <boost/iterator/iterator_facade.hpp>
@@ -123,6 +129,11 @@ public:
     std::tuple<std::string, uint64_t, uint64_t> getCompressionInfo() const;
     void            setChunkThreshold(uint32_t chunk_threshold);  //!< Set the threshold for creating new chunks
     uint32_t        getChunkThreshold() const;                    //!< Get the threshold for creating new chunks
+    void            setCompressionThreads(uint32_t threads);      //!< Set the number of threads compressing chunks in parallel, 0 compresses on the writing thread
+    uint32_t        getCompressionThreads() const;                //!< Get the number of threads compressing chunks in parallel
+    void            setReadAhead(uint32_t chunks, uint32_t threads); //!< Set how many chunks past the one being read are decompressed in advance, and by how many threads
+    uint32_t        getReadAheadChunks() const;                   //!< Get the number of chunks decompressed in advance while reading
+    uint32_t        getReadAheadReadyChunks() const;              //!< Get the number of chunks already decompressed and waiting to be read
 
     //! Write a message into the bag file
     /*!
@@ -202,12 +213,53 @@ private:
     template<class T>
     void writeMessageDataRecord(uint32_t conn_id, rs2rosinternal::Time const& time, T const& msg);
     void writeIndexRecords();
+    void writeIndexRecords(std::map<uint32_t, std::multiset<IndexEntry> > const& indexes);
     void writeConnectionRecords();
     void writeChunkInfoRecords();
     void startWritingChunk(rs2rosinternal::Time time);
     void writeChunkHeader(CompressionType compression, uint32_t compressed_size, uint32_t uncompressed_size);
     void stopWritingChunk();
 
+    // Parallel chunk compression
+
+    //! A closed chunk on its way from the writing thread, through a compression worker, to the file
+    struct PendingChunk
+    {
+        ChunkInfo                                      info;
+        std::map<uint32_t, std::multiset<IndexEntry> > indexes;       //!< entries of this chunk, chunk_pos is set once the chunk is written
+        CompressionType                                compression;
+        std::vector<uint8_t>                           data;          //!< uncompressed chunk records
+        std::vector<uint8_t>                           compressed;
+        bool                                           ready;
+    };
+
+    bool isCompressingInParallel() const;
+    void submitChunk();
+    void flushPendingChunks();
+    void stopCompressionWorkers();
+    void compressionWorker();
+    void compressChunk(PendingChunk& chunk) const;
+    void writePendingChunk(PendingChunk& chunk);
+    void throwPendingError();
+
+    // Read-ahead decompression
+
+    //! A chunk read from the file by the reading thread and decompressed by a worker
+    struct PrefetchedChunk
+    {
+        uint64_t             pos;
+        ChunkHeader          header;
+        std::vector<uint8_t> compressed;
+        Buffer               data;
+        bool                 ready;
+        std::string          error;
+    };
+
+    void decompressChunkAhead(uint64_t chunk_pos) const;
+    void prefetchChunk(uint64_t chunk_pos) const;
+    void stopDecompressionWorkers() const;
+    void decompressionWorker() const;
+
     // Reading
 
     void readVersion();
@@ -310,6 +362,27 @@ private:
     mutable Buffer*  current_buffer_;
 
     mutable uint64_t decompressed_chunk_;      //!< position of decompressed chunk
+
+    uint32_t                                   compression_threads_;
+    std::vector<std::thread>                   compression_workers_;
+    std::deque<std::shared_ptr<PendingChunk> > compression_queue_;   //!< chunks waiting for a worker
+    std::deque<std::shared_ptr<PendingChunk> > pending_chunks_;      //!< chunks not yet in the file, in file order
+    std::mutex                                 compression_mutex_;
+    std::condition_variable                    compression_cv_;
+    bool                                       stop_compression_;
+    bool                                       writing_chunk_;        //!< a worker is appending chunks to the file
+    uint64_t                                   written_size_;         //!< file size after the last chunk written by a worker
+    std::string                                compression_error_;
+
+    uint32_t                                                   read_ahead_chunks_;
+    uint32_t                                                   read_ahead_threads_;
+    mutable std::vector<std::thread>                           decompression_workers_;
+    mutable std::map<uint64_t, std::shared_ptr<PrefetchedChunk> > prefetched_chunks_;    //!< chunks around the one being read, by position
+    mutable std::deque<std::shared_ptr<PrefetchedChunk> >      decompression_queue_;     //!< chunks waiting for a worker
+    mutable std::shared_ptr<PrefetchedChunk>                   current_prefetched_;      //!< keeps current_buffer_ valid
+    mutable std::mutex                                         decompression_mutex_;
+    mutable std::condition_variable                            decompression_cv_;
+    mutable bool                                               stop_decompression_;
 };
 
 } // namespace rosbag
@@ -517,8 +590,10 @@ void Bag::doWrite(std::string const& topic, rs2rosinternal::Time const& time, T
 
     {
         // Seek to the end of the file (needed in case previous operation was a read)
-        seek(0, std::ios::end);
-        file_size_ = file_.getOffset();
+        if (!isCompressingInParallel()) {
+            seek(0, std::ios::end);
+            file_size_ = file_.getOffset();
+        }
 
         // Write the chunk header if we're starting a new chunk
         if (!chunk_open_)
@@ -543,7 +618,8 @@ void Bag::doWrite(std::string const& topic, rs2rosinternal::Time const& time, T
             }
             connections_[conn_id] = connection_info;
 
-            writeConnectionRecord(connection_info);
+            if (!isCompressingInParallel())
+                writeConnectionRecord(connection_info);
             appendConnectionRecordToBuffer(outgoing_chunk_buffer_, connection_info);
         }
 
@@ -555,8 +631,11 @@ void Bag::doWrite(std::string const& topic, rs2rosinternal::Time const& time, T
 
         std::multiset<IndexEntry>& chunk_connection_index = curr_chunk_connection_indexes_[connection_info->id];
         chunk_connection_index.insert(chunk_connection_index.end(), index_entry);
-        std::multiset<IndexEntry>& connection_index = connection_indexes_[connection_info->id];
-        connection_index.insert(connection_index.end(), index_entry);
+        // The chunk position is not known before a parallel chunk is written, its entries are indexed then
+        if (!isCompressingInParallel()) {
+            std::multiset<IndexEntry>& connection_index = connection_indexes_[connection_info->id];
+            connection_index.insert(connection_index.end(), index_entry);
+        }
 
         // Increment the connection count
         curr_chunk_info_.connection_counts[connection_info->id]++;
@@ -570,10 +649,6 @@ void Bag::doWrite(std::string const& topic, rs2rosinternal::Time const& time, T
         if (chunk_size > chunk_threshold_) {
             // Empty the outgoing chunk
             stopWritingChunk();
-            outgoing_chunk_buffer_.setSize(0);
-
-            // We no longer have a valid curr_chunk_info
-            curr_chunk_info_.pos = -1;
         }
     }
 }
@@ -595,18 +670,22 @@ void Bag::writeMessageDataRecord(uint32_t conn_id, rs2rosinternal::Time const& t
     // todo: serialize into the outgoing_chunk_buffer & remove record_buffer_
     rs2rosinternal::serialization::serialize(s, msg);
 
-    // We do an extra seek here since writing our data record may
-    // have indirectly moved our file-pointer if it was a
-    // MessageInstance for our own bag
-    seek(0, std::ios::end);
-    file_size_ = file_.getOffset();
+    // When compressing in parallel the chunk is assembled in outgoing_chunk_buffer_
+    // only, and the file belongs to the compression workers
+    if (!isCompressingInParallel()) {
+        // We do an extra seek here since writing our data record may
+        // have indirectly moved our file-pointer if it was a
+        // MessageInstance for our own bag
+        seek(0, std::ios::end);
+        file_size_ = file_.getOffset();
 
-    CONSOLE_BRIDGE_logDebug("Writing MSG_DATA [%llu:%d]: conn=%d sec=%d nsec=%d data_len=%d",
-              (unsigned long long) file_.getOffset(), getChunkOffset(), conn_id, time.sec, time.nsec, msg_ser_len);
+        CONSOLE_BRIDGE_logDebug("Writing MSG_DATA [%llu:%d]: conn=%d sec=%d nsec=%d data_len=%d",
+                  (unsigned long long) file_.getOffset(), getChunkOffset(), conn_id, time.sec, time.nsec, msg_ser_len);
 
-    writeHeader(header);
-    writeDataLength(msg_ser_len);
-    write((char*) record_buffer_.getData(), msg_ser_len);
+        writeHeader(header);
+        writeDataLength(msg_ser_len);
+        write((char*) record_buffer_.getData(), msg_ser_len);
+    }
 
     // todo: use better abstraction than appendHeaderToBuffer
     appendHeaderToBuffer(outgoing_chunk_buffer_, header);
@@ -37,6 +37,7 @@
 #endif
 #include <signal.h>
 #include <assert.h>
+#include <algorithm>
 #include <iomanip>
 #include <map>
 #include <tuple>
@@ -73,7 +74,14 @@ Bag::Bag() :
     chunk_open_(false),
     curr_chunk_data_pos_(0),
     current_buffer_(0),
-    decompressed_chunk_(0)
+    decompressed_chunk_(0),
+    compression_threads_(0),
+    stop_compression_(false),
+    writing_chunk_(false),
+    written_size_(0),
+    read_ahead_chunks_(0),
+    read_ahead_threads_(0),
+    stop_decompression_(false)
 {
 }
 
@@ -89,13 +97,28 @@ Bag::Bag(string const& filename, uint32_t mode) :
     chunk_open_(false),
     curr_chunk_data_pos_(0),
     current_buffer_(0),
-    decompressed_chunk_(0)
+    decompressed_chunk_(0),
+    compression_threads_(0),
+    stop_compression_(false),
+    writing_chunk_(false),
+    written_size_(0),
+    read_ahead_chunks_(0),
+    read_ahead_threads_(0),
+    stop_decompression_(false)
 {
     open(filename, mode);
 }
 
 Bag::~Bag() {
-    close();
+    // A chunk that failed to compress or write surfaces here at the latest, and must not escape a destructor
+    try {
+        close();
+    }
+    catch (std::exception const& e) {
+        CONSOLE_BRIDGE_logError("Failed to close bag %s: %s", file_.getFileName().c_str(), e.what());
+    }
+    stopCompressionWorkers();
+    stopDecompressionWorkers();
 }
 
 void Bag::open(string const& filename, uint32_t mode) {
@@ -165,6 +188,8 @@ void Bag::close() {
     if (mode_ & bagmode::Write || mode_ & bagmode::Append)
         closeWrite();
 
+    stopCompressionWorkers();
+    stopDecompressionWorkers();
     file_.close();
 
     topic_connection_ids_.clear();
@@ -196,6 +221,35 @@ void Bag::setChunkThreshold(uint32_t chunk_threshold) {
 
 CompressionType Bag::getCompression() const { return compression_; }
 
+uint32_t Bag::getCompressionThreads() const { return compression_threads_; }
+
+uint32_t Bag::getReadAheadChunks() const { return read_ahead_chunks_; }
+
+uint32_t Bag::getReadAheadReadyChunks() const {
+    std::lock_guard<std::mutex> lock(decompression_mutex_);
+    uint32_t ready = 0;
+    for (map<uint64_t, shared_ptr<PrefetchedChunk> >::const_iterator i = prefetched_chunks_.begin(); i != prefetched_chunks_.end(); i++)
+        if (i->second->ready && i->first > decompressed_chunk_)
+            ready++;
+    return ready;
+}
+
+void Bag::setReadAhead(uint32_t chunks, uint32_t threads) {
+    stopDecompressionWorkers();
+
+    read_ahead_chunks_  = chunks;
+    read_ahead_threads_ = threads;
+}
+
+void Bag::setCompressionThreads(uint32_t threads) {
+    if (file_.isOpen() && chunk_open_)
+        stopWritingChunk();
+    flushPendingChunks();
+    stopCompressionWorkers();
+
+    compression_threads_ = threads;
+}
+
 std::tuple<std::string, uint64_t, uint64_t> Bag::getCompressionInfo() const
 {
     std::map<std::string, uint64_t> compression_counts;
@@ -241,6 +295,7 @@ std::tuple<std::string, uint64_t, uint64_t> Bag::getCompressionInfo() const
 void Bag::setCompression(CompressionType compression) {
     if (file_.isOpen() && chunk_open_)
         stopWritingChunk();
+    flushPendingChunks();
 
     if (!(compression == compression::Uncompressed ||
           compression == compression::BZ2 ||
@@ -297,6 +352,7 @@ void Bag::startWriting() {
 void Bag::stopWriting() {
     if (chunk_open_)
         stopWritingChunk();
+    flushPendingChunks();
 
     seek(0, std::ios::end);
 
@@ -442,7 +498,9 @@ void Bag::readFileHeaderRecord() {
 }
 
 uint32_t Bag::getChunkOffset() const {
-    if (compression_ == compression::Uncompressed)
+    if (isCompressingInParallel())
+        return outgoing_chunk_buffer_.getSize();
+    else if (compression_ == compression::Uncompressed)
         return static_cast<uint32_t>(file_.getOffset() - curr_chunk_data_pos_);
     else
         return file_.getCompressedBytesIn();
@@ -450,10 +508,17 @@ uint32_t Bag::getChunkOffset() const {
 
 void Bag::startWritingChunk(Time time) {
     // Initialize chunk info
-    curr_chunk_info_.pos        = file_.getOffset();
     curr_chunk_info_.start_time = time;
     curr_chunk_info_.end_time   = time;
 
+    // The chunk is assembled in memory and placed in the file once compressed
+    if (isCompressingInParallel()) {
+        curr_chunk_info_.pos = 0;
+        chunk_open_ = true;
+        return;
+    }
+    curr_chunk_info_.pos = file_.getOffset();
+
     // Write the chunk header, with a place-holder for the data sizes (we'll fill in when the chunk is finished)
     writeChunkHeader(compression_, 0, 0);
 
@@ -467,6 +532,11 @@ void Bag::startWritingChunk(Time time) {
 }
 
 void Bag::stopWritingChunk() {
+    if (isCompressingInParallel()) {
+        submitChunk();
+        return;
+    }
+
     // Add this chunk to the index
     chunks_.push_back(curr_chunk_info_);
 
@@ -489,10 +559,176 @@ void Bag::stopWritingChunk() {
     // Clear the connection counts
     curr_chunk_info_.connection_counts.clear();
 
+    // Empty the outgoing chunk, we no longer have a valid curr_chunk_info
+    outgoing_chunk_buffer_.setSize(0);
+    curr_chunk_info_.pos = -1;
+
     // Flag that we're starting a new chunk
     chunk_open_ = false;
 }
 
+// Parallel chunk compression
+//
+// Closed chunks are queued for a pool of workers that compress them independently.
+// Whichever worker finds the oldest chunk compressed appends it to the file, so chunks
+// land in the order they were closed. The writing thread only touches the file again
+// after flushPendingChunks().
+
+bool Bag::isCompressingInParallel() const {
+    return compression_threads_ > 0 && compression_ == compression::LZ4;
+}
+
+void Bag::submitChunk() {
+    std::shared_ptr<PendingChunk> chunk = std::make_shared<PendingChunk>();
+    chunk->info        = curr_chunk_info_;
+    chunk->indexes.swap(curr_chunk_connection_indexes_);
+    chunk->compression = compression_;
+    chunk->data.assign(outgoing_chunk_buffer_.getData(), outgoing_chunk_buffer_.getData() + outgoing_chunk_buffer_.getSize());
+    chunk->ready       = false;
+
+    curr_chunk_info_.connection_counts.clear();
+    outgoing_chunk_buffer_.setSize(0);
+    curr_chunk_info_.pos = -1;
+    chunk_open_ = false;
+
+    std::unique_lock<std::mutex> lock(compression_mutex_);
+    if (compression_workers_.empty()) {
+        stop_compression_ = false;
+        written_size_     = file_.getOffset();
+        for (uint32_t i = 0; i < compression_threads_; i++)
+            compression_workers_.push_back(std::thread([this]() { compressionWorker(); }));
+    }
+
+    // Bound the memory held by chunks in flight
+    compression_cv_.wait(lock, [this]() { return pending_chunks_.size() < 2 * compression_threads_ || !compression_error_.empty(); });
+    throwPendingError();
+
+    pending_chunks_.push_back(chunk);
+    compression_queue_.push_back(chunk);
+    file_size_ = written_size_;
+    compression_cv_.notify_all();
+}
+
+void Bag::flushPendingChunks() {
+    std::unique_lock<std::mutex> lock(compression_mutex_);
+    compression_cv_.wait(lock, [this]() { return pending_chunks_.empty() || !compression_error_.empty(); });
+    throwPendingError();
+    if (!compression_workers_.empty())
+        file_size_ = written_size_;
+}
+
+void Bag::stopCompressionWorkers() {
+    {
+        std::lock_guard<std::mutex> lock(compression_mutex_);
+        stop_compression_ = true;
+    }
+    compression_cv_.notify_all();
+    foreach(std::thread& worker, compression_workers_)
+        worker.join();
+    compression_workers_.clear();
+
+    compression_queue_.clear();
+    pending_chunks_.clear();
+    compression_error_.clear();
+    writing_chunk_ = false;
+}
+
+void Bag::throwPendingError() {
+    if (!compression_error_.empty())
+        throw BagIOException(compression_error_);
+}
+
+void Bag::compressionWorker() {
+    std::unique_lock<std::mutex> lock(compression_mutex_);
+    while (true) {
+        compression_cv_.wait(lock, [this]() { return stop_compression_ || !compression_queue_.empty(); });
+        if (stop_compression_)
+            return;
+
+        std::shared_ptr<PendingChunk> chunk = compression_queue_.front();
+        compression_queue_.pop_front();
+
+        lock.unlock();
+        string error;
+        try {
+            compressChunk(*chunk);
+        }
+        catch (std::exception const& e) {
+            error = e.what();
+        }
+        lock.lock();
+
+        chunk->ready = true;
+        if (!error.empty() && compression_error_.empty())
+            compression_error_ = error;
+
+        // Append every compressed chunk at the head of the line, unless another worker already does
+        while (!writing_chunk_ && compression_error_.empty() && !pending_chunks_.empty() && pending_chunks_.front()->ready) {
+            std::shared_ptr<PendingChunk> next = pending_chunks_.front();
+            writing_chunk_ = true;
+            lock.unlock();
+            error.clear();
+            try {
+                writePendingChunk(*next);
+            }
+            catch (std::exception const& e) {
+                error = e.what();
+            }
+            lock.lock();
+            writing_chunk_ = false;
+            if (!error.empty() && compression_error_.empty())
+                compression_error_ = error;
+            pending_chunks_.pop_front();
+            written_size_ = file_.getOffset();
+        }
+        compression_cv_.notify_all();
+    }
+}
+
+void Bag::compressChunk(PendingChunk& chunk) const {
+    unsigned int input_size = static_cast<unsigned int>(chunk.data.size());
+    // LZ4 worst case expansion plus framing, grown if the data still doesn't fit
+    unsigned int capacity = input_size + input_size / 255 + 1024;
+    while (true) {
+        chunk.compressed.resize(capacity);
+        unsigned int output_size = capacity;
+        int ret = roslz4_buffToBuffCompress((char*) chunk.data.data(), input_size,
+                                            (char*) chunk.compressed.data(), &output_size, 6);
+        if (ret == ROSLZ4_OK) {
+            chunk.compressed.resize(output_size);
+            return;
+        }
+        if (ret != ROSLZ4_OUTPUT_SMALL && ret != ROSLZ4_ERROR)
+            throw BagIOException("ROSLZ4_ERROR: compression error");
+        if (capacity > 2 * input_size + 1024 * 1024)
+            throw BagIOException("ROSLZ4_OUTPUT_SMALL: output buffer is too small");
+        capacity *= 2;
+    }
+}
+
+void Bag::writePendingChunk(PendingChunk& chunk) {
+    seek(0, std::ios::end);
+    chunk.info.pos = file_.getOffset();
+
+    writeChunkHeader(chunk.compression, static_cast<uint32_t>(chunk.compressed.size()), static_cast<uint32_t>(chunk.data.size()));
+    write((char*) chunk.compressed.data(), chunk.compressed.size());
+    writeIndexRecords(chunk.indexes);
+
+    // Now that the chunk has a position, its messages can be indexed
+    chunks_.push_back(chunk.info);
+    for (map<uint32_t, multiset<IndexEntry> >::const_iterator i = chunk.indexes.begin(); i != chunk.indexes.end(); i++) {
+        multiset<IndexEntry>& connection_index = connection_indexes_[i->first];
+        foreach(IndexEntry entry, i->second) {
+            entry.chunk_pos = chunk.info.pos;
+            connection_index.insert(connection_index.end(), entry);
+        }
+    }
+
+    // Release the buffers early, the chunk stays queued until the lock is retaken
+    vector<uint8_t>().swap(chunk.data);
+    vector<uint8_t>().swap(chunk.compressed);
+}
+
 void Bag::writeChunkHeader(CompressionType compression, uint32_t compressed_size, uint32_t uncompressed_size) {
     ChunkHeader chunk_header;
     switch (compression) {
@@ -535,7 +771,11 @@ void Bag::readChunkHeader(ChunkHeader& chunk_header) const {
 // Index records
 
 void Bag::writeIndexRecords() {
-    for (map<uint32_t, multiset<IndexEntry> >::const_iterator i = curr_chunk_connection_indexes_.begin(); i != curr_chunk_connection_indexes_.end(); i++) {
+    writeIndexRecords(curr_chunk_connection_indexes_);
+}
+
+void Bag::writeIndexRecords(map<uint32_t, multiset<IndexEntry> > const& indexes) {
+    for (map<uint32_t, multiset<IndexEntry> >::const_iterator i = indexes.begin(); i != indexes.end(); i++) {
         uint32_t                    connection_id = i->first;
         multiset<IndexEntry> const& index         = i->second;
 
@@ -791,6 +1031,11 @@ void Bag::decompressChunk(uint64_t chunk_pos) const {
         return;
     }
 
+    if (read_ahead_chunks_ > 0 && read_ahead_threads_ > 0) {
+        decompressChunkAhead(chunk_pos);
+        return;
+    }
+
     current_buffer_ = &decompress_buffer_;
 
     if (decompressed_chunk_ == chunk_pos)
@@ -816,6 +1061,140 @@ void Bag::decompressChunk(uint64_t chunk_pos) const {
     decompressed_chunk_ = chunk_pos;
 }
 
+// Read-ahead decompression
+//
+// The reading thread keeps reading the raw chunks following the one being read, and
+// a pool of workers decompresses them, so a chunk is usually ready by the time the
+// reader gets to it. The file is only accessed from the reading thread.
+
+void Bag::decompressChunkAhead(uint64_t chunk_pos) const {
+    if (decompressed_chunk_ == chunk_pos && current_prefetched_) {
+        current_buffer_ = &current_prefetched_->data;
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(decompression_mutex_);
+    if (prefetched_chunks_.find(chunk_pos) == prefetched_chunks_.end()) {
+        lock.unlock();
+        prefetchChunk(chunk_pos);
+        lock.lock();
+    }
+    shared_ptr<PrefetchedChunk> chunk = prefetched_chunks_[chunk_pos];
+    decompression_cv_.wait(lock, [&chunk]() { return chunk->ready; });
+    if (!chunk->error.empty())
+        throw BagException(chunk->error);
+
+    current_prefetched_ = chunk;
+    current_buffer_     = &chunk->data;
+    decompressed_chunk_ = chunk_pos;
+
+    // Keep the previous chunk, messages at chunk boundaries alternate between the two,
+    // and drop anything else outside the read-ahead window
+    vector<ChunkInfo>::const_iterator curr = std::lower_bound(chunks_.begin(), chunks_.end(), chunk_pos,
+        [](ChunkInfo const& info, uint64_t pos) { return info.pos < pos; });
+    if (curr == chunks_.end() || curr->pos != chunk_pos)
+        return;
+    size_t index = curr - chunks_.begin();
+    uint64_t first = index > 0 ? chunks_[index - 1].pos : chunk_pos;
+    size_t last_index = std::min(chunks_.size() - 1, index + read_ahead_chunks_);
+    uint64_t last = chunks_[last_index].pos;
+    for (map<uint64_t, shared_ptr<PrefetchedChunk> >::iterator i = prefetched_chunks_.begin(); i != prefetched_chunks_.end();) {
+        if (i->first < first || i->first > last)
+            prefetched_chunks_.erase(i++);
+        else
+            ++i;
+    }
+
+    vector<uint64_t> missing;
+    for (size_t i = index + 1; i <= last_index; i++)
+        if (prefetched_chunks_.find(chunks_[i].pos) == prefetched_chunks_.end())
+            missing.push_back(chunks_[i].pos);
+    lock.unlock();
+
+    foreach(uint64_t pos, missing)
+        prefetchChunk(pos);
+}
+
+void Bag::prefetchChunk(uint64_t chunk_pos) const {
+    shared_ptr<PrefetchedChunk> chunk = std::make_shared<PrefetchedChunk>();
+    chunk->pos   = chunk_pos;
+    chunk->ready = false;
+
+    seek(chunk_pos);
+    readChunkHeader(chunk->header);
+    if (chunk->header.compression == COMPRESSION_NONE) {
+        chunk->data.setSize(chunk->header.compressed_size);
+        read((char*) chunk->data.getData(), chunk->header.compressed_size);
+        chunk->ready = true;
+    }
+    else if (chunk->header.compression == COMPRESSION_LZ4) {
+        chunk->compressed.resize(chunk->header.compressed_size);
+        read((char*) chunk->compressed.data(), chunk->header.compressed_size);
+    }
+    else {
+        throw BagFormatException("Unsupported compression for read-ahead: " + chunk->header.compression);
+    }
+
+    std::lock_guard<std::mutex> lock(decompression_mutex_);
+    prefetched_chunks_[chunk_pos] = chunk;
+    if (chunk->ready)
+        return;
+
+    if (decompression_workers_.empty()) {
+        stop_decompression_ = false;
+        for (uint32_t i = 0; i < read_ahead_threads_; i++)
+            decompression_workers_.push_back(std::thread([this]() { decompressionWorker(); }));
+    }
+    decompression_queue_.push_back(chunk);
+    decompression_cv_.notify_all();
+}
+
+void Bag::stopDecompressionWorkers() const {
+    {
+        std::lock_guard<std::mutex> lock(decompression_mutex_);
+        stop_decompression_ = true;
+    }
+    decompression_cv_.notify_all();
+    foreach(std::thread& worker, decompression_workers_)
+        worker.join();
+    decompression_workers_.clear();
+
+    std::lock_guard<std::mutex> lock(decompression_mutex_);
+    decompression_queue_.clear();
+    prefetched_chunks_.clear();
+    current_prefetched_.reset();
+    decompressed_chunk_ = 0;
+}
+
+void Bag::decompressionWorker() const {
+    std::unique_lock<std::mutex> lock(decompression_mutex_);
+    while (true) {
+        decompression_cv_.wait(lock, [this]() { return stop_decompression_ || !decompression_queue_.empty(); });
+        if (stop_decompression_)
+            return;
+
+        shared_ptr<PrefetchedChunk> chunk = decompression_queue_.front();
+        decompression_queue_.pop_front();
+        lock.unlock();
+
+        string error;
+        chunk->data.setSize(chunk->header.uncompressed_size);
+        unsigned int output_size = chunk->header.uncompressed_size;
+        int ret = roslz4_buffToBuffDecompress((char*) chunk->compressed.data(), static_cast<unsigned int>(chunk->compressed.size()),
+                                              (char*) chunk->data.getData(), &output_size);
+        if (ret != ROSLZ4_OK)
+            error = (format("ROSLZ4 decompression error %1% in chunk at %2%") % ret % chunk->pos).str();
+        else if (output_size != chunk->header.uncompressed_size)
+            error = "Decompression size mismatch in LZ4 chunk";
+        vector<uint8_t>().swap(chunk->compressed);
+
+        lock.lock();
+        chunk->error = error;
+        chunk->ready = true;
+        decompression_cv_.notify_all();
+    }
+}
+
 void Bag::readMessageDataRecord102(uint64_t offset, rs2rosinternal::Header& header) const {
     CONSOLE_BRIDGE_logDebug("readMessageDataRecord: offset=%llu", (unsigned long long) offset);
 
@@ -15,10 +15,12 @@ namespace rs2 {
             class converter_ply : public converter_base {
             protected:
                 std::string _filePath;
+                rs2::points_exporter _exporter;
 
             public:
                 converter_ply(const std::string& filePath)
                     : _filePath(filePath)
+                    , _exporter(filePath + "_")
                 {
                 }
 
@@ -44,15 +46,17 @@ namespace rs2 {
 
                                 auto points = pc.calculate(frameDepth);
 
-                                std::stringstream filename;
-                                filename << _filePath
-                                    << "_" << frameDepth.get_frame_number()
-                                    << ".ply";
-
-                                points.export_to_ply(filename.str(), frameColor);
+                                // Written on the exporter's thread, the next frameset is read meanwhile
+                                _exporter.enqueue(points, frameColor);
                             }
                         });
                 }
+
+                std::string get_statistics() override
+                {
+                    _exporter.flush();
+                    return converter_base::get_statistics();
+                }
             };
 
         }
@@ -0,0 +1,203 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#include "catch/catch.hpp"
+#include "proc/avx/avx-align.h"
+#include "stream.h"
+#include "cpu-dispatch.h"
+#include "internal-tests-benchmark.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <vector>
+
+using namespace librealsense;
+using namespace std::chrono;
+
+struct align_case
+{
+    const char* name;
+    rs2_intrinsics depth;
+    rs2_intrinsics other;
+};
+
+static const rs2_extrinsics depth_to_color = {
+    { 0.99998f, -0.00564f, 0.00312f, 0.00563f, 0.99998f, 0.00291f, -0.00314f, -0.00289f, 0.99999f },
+    { 0.0148f, 0.00021f, 0.00043f } };
+
+// Widths that are not a multiple of the vector widths exercise the scalar tail of each band
+static const std::vector<align_case> align_cases = {
+    { "1280x720 to 1920x1080",
+        { 1280, 720, 639.4f, 358.7f, 643.2f, 643.2f, RS2_DISTORTION_BROWN_CONRADY, { 0, 0, 0, 0, 0 } },
+        { 1920, 1080, 961.5f, 547.3f, 1384.6f, 1382.9f, RS2_DISTORTION_INVERSE_BROWN_CONRADY, { 0.05f, -0.07f, 0.001f, -0.002f, 0.01f } } },
+    { "640x480 to 640x360",
+        { 640, 480, 318.2f, 241.1f, 385.7f, 385.7f, RS2_DISTORTION_NONE, { 0, 0, 0, 0, 0 } },
+        { 640, 360, 321.4f, 181.9f, 462.3f, 461.8f, RS2_DISTORTION_MODIFIED_BROWN_CONRADY, { 0.12f, -0.25f, 0.0005f, 0.0007f, 0.1f } } },
+    { "851x101 to 300x301",
+        { 851, 101, 425.3f, 50.2f, 400.f, 400.f, RS2_DISTORTION_INVERSE_BROWN_CONRADY, { 0.01f, 0.02f, 0.001f, 0.001f, 0 } },
+        { 300, 301, 150.1f, 149.8f, 290.f, 291.f, RS2_DISTORTION_NONE, { 0, 0, 0, 0, 0 } } },
+    { "848x480 to kannala-brandt 800x848",
+        { 848, 480, 423.9f, 239.6f, 421.2f, 421.2f, RS2_DISTORTION_BROWN_CONRADY, { 0, 0, 0, 0, 0 } },
+        { 800, 848, 400.3f, 424.1f, 285.7f, 285.9f, RS2_DISTORTION_KANNALA_BRANDT4, { -0.006f, 0.04f, -0.037f, 0.006f, 0 } } },
+};
+
+static std::vector<uint16_t> make_depth_image(const rs2_intrinsics& depth)
+{
+    std::vector<uint16_t> z(depth.width * depth.height);
+    srand(1);
+    // Mostly valid depth between 0.2m and 6m, with holes
+    for (auto&& p : z) p = (rand() % 10) ? static_cast<uint16_t>(200 + rand() % 5800) : 0;
+    return z;
+}
+
+static std::vector<byte> make_other_image(const rs2_intrinsics& other, int bpp)
+{
+    std::vector<byte> image(other.width * other.height * bpp);
+    srand(2);
+    for (auto&& b : image) b = static_cast<byte>(rand());
+    return image;
+}
+
+struct simd_level_guard
+{
+    simd_level_guard() : _level(get_simd_level()) {}
+    ~simd_level_guard() { set_simd_level(_level); }
+    simd_level _level;
+};
+
+TEST_CASE("multithreaded align matches scalar align", "[code][align]")
+{
+    simd_level_guard guard;
+    const float depth_scale = 0.001f;
+    const std::vector<std::pair<rs2_format, int>> other_formats = {
+        { RS2_FORMAT_Y8, 1 }, { RS2_FORMAT_Z16, 2 }, { RS2_FORMAT_RGB8, 3 }, { RS2_FORMAT_BGRA8, 4 } };
+    thread_pool pool(4);
+
+    for (auto&& c : align_cases)
+    {
+        CAPTURE(c.name);
+        auto z = make_depth_image(c.depth);
+        image_transform_avx transform(c.depth, depth_scale, pool);
+
+        std::vector<byte> reference(c.other.width * c.other.height * 2);
+        align_z_to_other(reference.data(), z.data(), depth_scale, c.depth, depth_to_color, c.other);
+
+        for (int i = 0; i < static_cast<int>(simd_level::count); i++)
+        {
+            auto level = set_simd_level(static_cast<simd_level>(i));
+            if (level != static_cast<simd_level>(i)) break;
+            CAPTURE(get_string(level));
+
+            std::vector<byte> aligned(reference.size());
+            transform.align_depth_to_other(z.data(), reinterpret_cast<uint16_t*>(aligned.data()), c.other, depth_to_color);
+            auto same_as_scalar = aligned == reference;
+            REQUIRE(same_as_scalar);
+        }
+
+        for (auto&& f : other_formats)
+        {
+            CAPTURE(f.second);
+            auto other = make_other_image(c.other, f.second);
+
+            set_simd_level(simd_level::scalar);
+            std::vector<byte> other_reference(c.depth.width * c.depth.height * f.second);
+            align_other_to_z(other_reference.data(), z.data(), depth_scale, c.depth, depth_to_color, c.other, other.data(), f.first);
+
+            for (int i = 0; i < static_cast<int>(simd_level::count); i++)
+            {
+                auto level = set_simd_level(static_cast<simd_level>(i));
+                if (level != static_cast<simd_level>(i)) break;
+                CAPTURE(get_string(level));
+
+                std::vector<byte> aligned(other_reference.size());
+                transform.align_other_to_depth(z.data(), other.data(), aligned.data(), f.first, c.other, depth_to_color);
+                auto same_as_scalar = aligned == other_reference;
+                REQUIRE(same_as_scalar);
+            }
+        }
+    }
+}
+
+// Opens the transform cache of the AVX align to the test
+struct align_cache_under_test : public align_avx
+{
+    align_cache_under_test() : align_avx(RS2_STREAM_COLOR) {}
+
+    using align::find_transform;
+    using align::cache_transform;
+    using align::reset_cache;
+};
+
+TEST_CASE("align caches a transform per depth profile until reset", "[code][align]")
+{
+    const float depth_scale = 0.001f;
+    thread_pool pool(2);
+    align_cache_under_test align;
+    auto first = std::make_shared<video_stream_profile>(platform::stream_profile{});
+    auto second = std::make_shared<video_stream_profile>(platform::stream_profile{});
+    auto&& depth = align_cases[0].depth;
+    auto&& other_depth = align_cases[1].depth;
+
+    REQUIRE(align.get_cache_size() == 0);
+    REQUIRE(!align.find_transform(first.get(), depth, depth_scale));
+
+    auto& cached = align.cache_transform(first.get(), std::make_shared<image_transform_avx>(depth, depth_scale, pool));
+    REQUIRE(align.find_transform(first.get(), depth, depth_scale) == &cached);
+    REQUIRE(!align.find_transform(second.get(), depth, depth_scale));
+
+    // Corner maps and per-frame corners, four floats and four ints per depth pixel, and a row span per row
+    auto pixels = size_t(depth.width) * depth.height;
+    REQUIRE(cached.size_bytes() == pixels * 4 * (sizeof(float) + sizeof(int)) + depth.height * sizeof(int2));
+    REQUIRE(align.get_cache_size() == cached.size_bytes());
+
+    // A calibration or depth scale change of the profile is a miss
+    REQUIRE(!align.find_transform(first.get(), other_depth, depth_scale));
+    REQUIRE(!align.find_transform(first.get(), depth, depth_scale * 2));
+
+    auto& other_cached = align.cache_transform(second.get(), std::make_shared<image_transform_avx>(other_depth, depth_scale, pool));
+    REQUIRE(align.find_transform(first.get(), depth, depth_scale) == &cached);
+    REQUIRE(align.get_cache_size() == cached.size_bytes() + other_cached.size_bytes());
+
+    align.reset_cache(RS2_STREAM_DEPTH, RS2_STREAM_COLOR);
+    REQUIRE(align.get_cache_size() == 0);
+    REQUIRE(!align.find_transform(first.get(), depth, depth_scale));
+}
+
+BENCHMARK_TEST_CASE("align throughput per simd level", "[align]")
+{
+    simd_level_guard guard;
+    const float depth_scale = 0.001f;
+    const int iterations = 30;
+    auto&& c = align_cases.front();
+    auto z = make_depth_image(c.depth);
+    std::vector<byte> aligned(c.other.width * c.other.height * 2);
+
+    benchmark_table table({ "Align", "Level", "Threads", "ms/frame" });
+
+    auto start = high_resolution_clock::now();
+    for (int k = 0; k < iterations; k++)
+    {
+        std::fill(aligned.begin(), aligned.end(), byte(0));
+        align_z_to_other(aligned.data(), z.data(), depth_scale, c.depth, depth_to_color, c.other);
+    }
+    table.row("reference", "scalar", 1, elapsed_ms(start) / iterations);
+
+    for (unsigned int threads : { 1u, 4u })
+    {
+        thread_pool pool(threads);
+        image_transform_avx transform(c.depth, depth_scale, pool);
+        for (int i = 0; i < static_cast<int>(simd_level::count); i++)
+        {
+            auto level = set_simd_level(static_cast<simd_level>(i));
+            if (level != static_cast<simd_level>(i)) break;
+
+            start = high_resolution_clock::now();
+            for (int k = 0; k < iterations; k++)
+            {
+                std::fill(aligned.begin(), aligned.end(), byte(0));
+                transform.align_depth_to_other(z.data(), reinterpret_cast<uint16_t*>(aligned.data()), c.other, depth_to_color);
+            }
+            table.row("engine", get_string(level), threads, elapsed_ms(start) / iterations);
+        }
+    }
+}
@@ -0,0 +1,54 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "catch/catch.hpp"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Benchmarks are not part of the default run, invoke them explicitly with "[benchmark]"
+#define BENCHMARK_TEST_CASE(name, tags) TEST_CASE(name, "[.][benchmark]" tags)
+
+// Milliseconds between two points of time
+inline double elapsed_ms(std::chrono::high_resolution_clock::time_point start, std::chrono::high_resolution_clock::time_point end)
+{
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+// Milliseconds since start
+inline double elapsed_ms(std::chrono::high_resolution_clock::time_point start)
+{
+    return elapsed_ms(start, std::chrono::high_resolution_clock::now());
+}
+
+// Results of a benchmark, printed as a markdown table a row at a time, with two decimals
+class benchmark_table
+{
+public:
+    explicit benchmark_table(const std::vector<std::string>& columns)
+    {
+        std::string header = "|", separator = "|";
+        for (auto&& c : columns)
+        {
+            header += " " + c + " |";
+            separator += std::string(c.size() + 2, '-') + "|";
+        }
+        std::cout << std::endl << header << std::endl << separator << std::endl;
+    }
+
+    template<class... T>
+    void row(const T&... cells) const
+    {
+        std::ostringstream line;
+        line << std::fixed << std::setprecision(2) << "|";
+        int expand[] = { 0, ((line << " " << cells << " |"), 0)... };
+        (void)expand;
+        std::cout << line.str() << std::endl;
+    }
+};
@@ -0,0 +1,332 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#include "catch/catch.hpp"
+#include "concurrency.h"
+#include "internal-tests-benchmark.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono;
+
+static const std::vector<queue_mode> all_queue_modes = { queue_mode::locked, queue_mode::lock_free };
+
+static const char* to_string(queue_mode mode)
+{
+    return mode == queue_mode::locked ? "locked" : "lock_free";
+}
+
+TEST_CASE("single_consumer_queue preserves order", "[code][concurrency]")
+{
+    for (auto mode : all_queue_modes)
+    {
+        CAPTURE(to_string(mode));
+        single_consumer_queue<int> q(8, mode);
+
+        for (int i = 0; i < 5; i++)
+            q.enqueue(std::move(i));
+        REQUIRE(q.size() == 5);
+
+        int* front = nullptr;
+        REQUIRE(q.peek(&front));
+        REQUIRE(*front == 0);
+
+        for (int i = 0; i < 5; i++)
+        {
+            int item = -1;
+            REQUIRE(q.dequeue(&item, 10));
+            REQUIRE(item == i);
+        }
+
+        int item = -1;
+        REQUIRE_FALSE(q.try_dequeue(&item));
+        REQUIRE_FALSE(q.dequeue(&item, 10));
+    }
+}
+
+TEST_CASE("single_consumer_queue drops oldest when full", "[code][concurrency]")
+{
+    for (auto mode : all_queue_modes)
+    {
+        CAPTURE(to_string(mode));
+        single_consumer_queue<int> q(4, mode);
+
+        for (int i = 0; i < 10; i++)
+            q.enqueue(std::move(i));
+        REQUIRE(q.size() == 4);
+
+        for (int i = 6; i < 10; i++)
+        {
+            int item = -1;
+            REQUIRE(q.try_dequeue(&item));
+            REQUIRE(item == i);
+        }
+    }
+}
+
+TEST_CASE("single_consumer_queue releases owned items", "[code][concurrency]")
+{
+    for (auto mode : all_queue_modes)
+    {
+        CAPTURE(to_string(mode));
+        auto token = std::make_shared<int>(0);
+        {
+            single_consumer_queue<std::shared_ptr<int>> q(2, mode);
+            for (int i = 0; i < 5; i++)
+            {
+                auto copy = token;
+                q.enqueue(std::move(copy));
+            }
+            REQUIRE(token.use_count() == 3);
+
+            q.clear();
+            REQUIRE(token.use_count() == 1);
+
+            q.start();
+            auto copy = token;
+            q.enqueue(std::move(copy));
+        }
+        REQUIRE(token.use_count() == 1);
+    }
+}
+
+TEST_CASE("single_consumer_queue blocking enqueue is lossless", "[code][concurrency]")
+{
+    for (auto mode : all_queue_modes)
+    {
+        CAPTURE(to_string(mode));
+        const int producers = 4;
+        const int items_per_producer = 10000;
+        single_consumer_queue<int> q(16, mode);
+
+        std::vector<std::thread> threads;
+        for (int p = 0; p < producers; p++)
+        {
+            threads.emplace_back([&q, p, items_per_producer]()
+            {
+                for (int i = 0; i < items_per_producer; i++)
+                {
+                    auto item = p * items_per_producer + i;
+                    q.blocking_enqueue(std::move(item));
+                }
+            });
+        }
+
+        // Items of each producer must arrive complete and in order
+        std::vector<int> next(producers, 0);
+        int received = 0;
+        while (received < producers * items_per_producer)
+        {
+            int item;
+            REQUIRE(q.dequeue(&item, 5000));
+            auto p = item / items_per_producer;
+            REQUIRE(item % items_per_producer == next[p]);
+            next[p]++;
+            received++;
+        }
+
+        for (auto&& t : threads) t.join();
+    }
+}
+
+TEST_CASE("lock-free single_consumer_queue keeps no item a producer pushed during clear", "[code][concurrency]")
+{
+    single_consumer_queue<int> q(64, queue_mode::lock_free);
+    std::atomic<bool> done(false);
+    std::vector<std::thread> producers;
+    for (int p = 0; p < 2; p++)
+        producers.emplace_back([&]()
+        {
+            for (int i = 0; !done; i++)
+                q.enqueue(std::move(i));
+        });
+
+    for (int i = 0; i < 1000; i++)
+    {
+        q.start();
+        std::this_thread::yield();
+        q.clear();
+        if (q.size()) FAIL("round " << i << " left " << q.size() << " items after clear");
+    }
+    done = true;
+    for (auto&& t : producers) t.join();
+}
+
+TEST_CASE("lock-free single_consumer_queue keeps the peeked item while producers drop", "[code][concurrency]")
+{
+    single_consumer_queue<std::shared_ptr<int>> q(4, queue_mode::lock_free);
+    for (int i = 0; i < 4; i++)
+        q.enqueue(std::make_shared<int>(i));
+
+    std::shared_ptr<int>* front = nullptr;
+    REQUIRE(q.peek(&front));
+    REQUIRE(**front == 0);
+
+    // Overflowing producers drop the oldest items on the ring, not the peeked one
+    std::vector<std::thread> producers;
+    for (int p = 0; p < 2; p++)
+        producers.emplace_back([&q, p]()
+        {
+            for (int i = 0; i < 1000; i++)
+                q.enqueue(std::make_shared<int>(100 + p * 1000 + i));
+        });
+    for (auto&& t : producers) t.join();
+
+    REQUIRE(**front == 0);
+    REQUIRE(q.size() <= 5);
+    std::shared_ptr<int> item;
+    REQUIRE(q.dequeue(&item, 10));
+    REQUIRE(*item == 0);
+    while (q.try_dequeue(&item))
+        REQUIRE(*item >= 100);
+}
+
+TEST_CASE("dispatcher runs on lock-free queue", "[code][concurrency]")
+{
+    std::atomic<int> invoked(0);
+    {
+        dispatcher d(10, queue_mode::lock_free);
+        d.start();
+        for (int i = 0; i < 5; i++)
+            d.invoke([&](dispatcher::cancellable_timer) { invoked++; }, true);
+        REQUIRE(d.flush());
+        d.stop();
+    }
+    REQUIRE(invoked == 5);
+}
+
+TEST_CASE("thread_pool parallel_for covers every index once", "[code][concurrency]")
+{
+    thread_pool pool(4);
+    REQUIRE(pool.size() == 4);
+
+    for (auto count : { 0, 1, 7, 1000 })
+    {
+        CAPTURE(count);
+        std::vector<std::atomic<int>> visits(count);
+        for (auto&& v : visits) v = 0;
+        pool.parallel_for(count, [&](int begin, int end)
+        {
+            for (int i = begin; i < end; i++) visits[i]++;
+        }, 3);
+        for (auto&& v : visits) REQUIRE(v == 1);
+    }
+}
+
+TEST_CASE("thread_pool parallel_for rethrows on the caller", "[code][concurrency]")
+{
+    thread_pool pool(3);
+    REQUIRE_THROWS_AS(pool.parallel_for(100, [](int begin, int end)
+    {
+        if (begin == 0) throw std::runtime_error("band failed");
+    }), std::runtime_error);
+
+    // The pool stays usable after a failed loop
+    std::atomic<int> total(0);
+    pool.parallel_for(100, [&](int begin, int end) { total += end - begin; });
+    REQUIRE(total == 100);
+}
+
+TEST_CASE("thread_pool runs nested and concurrent loops on their callers", "[code][concurrency]")
+{
+    thread_pool pool(4);
+
+    // A loop in a band of another loop, on the caller and on the workers
+    const int rows = 16, cols = 100;
+    std::vector<std::atomic<int>> visits(rows * cols);
+    for (auto&& v : visits) v = 0;
+    pool.parallel_for(rows, [&](int begin, int end)
+    {
+        for (int r = begin; r < end; r++)
+            pool.parallel_for(cols, [&](int b, int e)
+            {
+                for (int c = b; c < e; c++) visits[r * cols + c]++;
+            });
+    });
+    for (auto&& v : visits) REQUIRE(v == 1);
+
+    // A second caller completes its loop while the first loop is still running
+    std::atomic<bool> second_done(false), seen_by_first(false);
+    std::thread first([&]()
+    {
+        pool.parallel_for(4, [&](int begin, int end)
+        {
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+            while (!second_done && std::chrono::steady_clock::now() < deadline)
+                std::this_thread::yield();
+            if (second_done) seen_by_first = true;
+        });
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    std::atomic<int> total(0);
+    pool.parallel_for(1000, [&](int begin, int end) { total += end - begin; });
+    second_done = true;
+    first.join();
+    REQUIRE(total == 1000);
+    REQUIRE(seen_by_first);
+}
+
+TEST_CASE("processing pool is shared and takes loops from several threads", "[code][concurrency]")
+{
+    auto& pool = get_processing_pool();
+    REQUIRE(&pool == &get_processing_pool());
+    REQUIRE(pool.size() >= 1);
+
+    std::atomic<int> total(0);
+    std::vector<std::thread> callers;
+    for (int i = 0; i < 4; i++)
+        callers.emplace_back([&]()
+        {
+            for (int j = 0; j < 50; j++)
+                pool.parallel_for(1000, [&](int begin, int end) { total += end - begin; });
+        });
+    for (auto&& t : callers) t.join();
+    REQUIRE(total == 4 * 50 * 1000);
+}
+
+BENCHMARK_TEST_CASE("single_consumer_queue throughput", "[concurrency]")
+{
+    const int total_items = 1000000;
+
+    benchmark_table table({ "Mode", "Producers", "M items/s", "Mean enqueue-to-dequeue ns" });
+
+    for (auto producers : { 1, 2, 4 })
+    {
+        for (auto mode : all_queue_modes)
+        {
+            single_consumer_queue<high_resolution_clock::time_point> q(1024, mode);
+            auto per_producer = total_items / producers;
+
+            auto start = high_resolution_clock::now();
+            std::vector<std::thread> threads;
+            for (int p = 0; p < producers; p++)
+            {
+                threads.emplace_back([&q, per_producer]()
+                {
+                    for (int i = 0; i < per_producer; i++)
+                        q.blocking_enqueue(high_resolution_clock::now());
+                });
+            }
+
+            double latency_sum = 0;
+            int lost = 0;
+            for (int i = 0; i < per_producer * producers; i++)
+            {
+                high_resolution_clock::time_point sent;
+                if (!q.dequeue(&sent, 5000)) { lost++; continue; }
+                latency_sum += duration_cast<nanoseconds>(high_resolution_clock::now() - sent).count();
+            }
+            auto elapsed = duration_cast<duration<double>>(high_resolution_clock::now() - start).count();
+            for (auto&& t : threads) t.join();
+            REQUIRE(lost == 0);
+
+            auto count = per_producer * producers;
+            table.row(to_string(mode), producers, count / elapsed / 1e6, latency_sum / count);
+        }
+    }
+}
@@ -0,0 +1,1199 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#include "catch/catch.hpp"
+#include "proc/synthetic-stream.h"
+#include "proc/spatial-filter.h"
+#include "proc/temporal-filter.h"
+#include "proc/decimation-filter.h"
+#include "proc/colorizer.h"
+#include "proc/depth-lut-transform.h"
+#include "proc/depth-post-processing-chain.h"
+#include "proc/hole-filling-filter.h"
+#include "proc/processing-graph.h"
+#include "proc/pipelined-processing-block.h"
+#include "stream.h"
+#include "cpu-dispatch.h"
+#include "internal-tests-benchmark.h"
+#include "../include/librealsense2/hpp/rs_internal.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace librealsense;
+using namespace std::chrono;
+
+struct filters_simd_guard
+{
+    filters_simd_guard() : _level(get_simd_level()) {}
+    ~filters_simd_guard() { set_simd_level(_level); }
+    simd_level _level;
+};
+
+// Disparity of a few slanted planes with holes, depth edges larger than the threshold and the odd
+// negative or NaN value, which the recursion treats as invalid
+static std::vector<float> make_disparity(int width, int height)
+{
+    std::vector<float> image(size_t(width) * height);
+    srand(18);
+    for (int y = 0; y < height; ++y)
+        for (int x = 0; x < width; ++x)
+        {
+            auto& d = image[size_t(y) * width + x];
+            auto r = rand() % 100;
+            if (r < 8) d = 0.f;
+            else if (r == 8) d = -d - 3.f;
+            else if (r == 9) d = std::numeric_limits<float>::quiet_NaN();
+            else d = ((x / 40 + y / 30) % 3 ? 20.f : 60.f) + 0.05f * x + 0.03f * y + (rand() % 100) * 0.04f;
+        }
+    return image;
+}
+
+TEST_CASE("vectorized spatial filter passes match the scalar passes", "[code][filters]")
+{
+    filters_simd_guard guard;
+    const float alpha = 0.5f;
+    const float delta_z = 4.f;
+
+    // Sizes off the 8 lane grid exercise the partial blocks and the scalar rows / columns
+    for (auto size : { std::make_pair(64, 48), std::make_pair(317, 123), std::make_pair(848, 480) })
+    {
+        auto width = size.first;
+        auto height = size.second;
+        CAPTURE(width);
+        CAPTURE(height);
+        auto input = make_disparity(width, height);
+
+        set_simd_level(simd_level::scalar);
+        auto rows = input;
+        spatial_filter_rows_fp(rows.data(), width, 0, height, alpha, delta_z);
+        auto columns = input;
+        spatial_filter_columns_fp(columns.data(), width, height, 0, width, alpha, delta_z);
+        REQUIRE(memcmp(rows.data(), input.data(), input.size() * sizeof(float)));
+        REQUIRE(memcmp(columns.data(), input.data(), input.size() * sizeof(float)));
+
+        for (int i = 0; i < static_cast<int>(simd_level::count); i++)
+        {
+            auto level = set_simd_level(static_cast<simd_level>(i));
+            if (level != static_cast<simd_level>(i)) break;
+            CAPTURE(get_string(level));
+
+            // Uneven bands, as the thread pool may hand them out, give the same frame
+            auto result = input;
+            spatial_filter_rows_fp(result.data(), width, 0, 13, alpha, delta_z);
+            spatial_filter_rows_fp(result.data(), width, 13, height / 2, alpha, delta_z);
+            spatial_filter_rows_fp(result.data(), width, height / 2, height, alpha, delta_z);
+            REQUIRE(!memcmp(result.data(), rows.data(), rows.size() * sizeof(float)));
+
+            result = input;
+            spatial_filter_columns_fp(result.data(), width, height, 0, 21, alpha, delta_z);
+            spatial_filter_columns_fp(result.data(), width, height, 21, width / 2 + 3, alpha, delta_z);
+            spatial_filter_columns_fp(result.data(), width, height, width / 2 + 3, width, alpha, delta_z);
+            REQUIRE(!memcmp(result.data(), columns.data(), columns.size() * sizeof(float)));
+        }
+    }
+}
+
+BENCHMARK_TEST_CASE("spatial filter throughput", "[filters]")
+{
+    filters_simd_guard guard;
+    const int width = 1280, height = 720, iterations = 20;
+    auto input = make_disparity(width, height);
+    auto image = input;
+
+    benchmark_table table({ "Spatial", "Level", "threads", "rows ms", "columns ms" });
+    for (int i = 0; i < static_cast<int>(simd_level::count); i++)
+    {
+        auto level = set_simd_level(static_cast<simd_level>(i));
+        if (level != static_cast<simd_level>(i)) break;
+
+        for (unsigned int threads : { 1u, 4u })
+        {
+            thread_pool pool(threads);
+            double rows = 0, columns = 0;
+            for (int k = 0; k < iterations; k++)
+            {
+                image = input;
+                auto start = high_resolution_clock::now();
+                pool.parallel_for((height + 7) / 8, [&](int begin, int end)
+                {
+                    spatial_filter_rows_fp(image.data(), width, begin * 8, std::min(end * 8, height), 0.5f, 4.f);
+                });
+                auto middle = high_resolution_clock::now();
+                pool.parallel_for((width + 7) / 8, [&](int begin, int end)
+                {
+                    spatial_filter_columns_fp(image.data(), width, height, begin * 8, std::min(end * 8, width), 0.5f, 4.f);
+                }, 8);
+                auto end = high_resolution_clock::now();
+                rows += elapsed_ms(start, middle);
+                columns += elapsed_ms(middle, end);
+            }
+            table.row("disparity", get_string(level), threads, rows / iterations, columns / iterations);
+        }
+    }
+}
+
+// A depth stream of flickering pixels: holes come and go, values jitter within or beyond the threshold
+template<typename T>
+static std::vector<std::vector<T>> make_depth_sequence(size_t pixels, int frames)
+{
+    std::vector<std::vector<T>> sequence(frames, std::vector<T>(pixels));
+    srand(19);
+    for (size_t i = 0; i < pixels; i++)
+    {
+        auto base = 300 + rand() % 3000;
+        for (int f = 0; f < frames; f++)
+        {
+            auto r = rand() % 100;
+            auto& v = sequence[f][i];
+            if (r < 25) v = 0;
+            else if (r < 30) v = static_cast<T>(base + 200 + rand() % 100);
+            else v = static_cast<T>(base + rand() % 40);
+        }
+    }
+    return sequence;
+}
+
+template<typename T>
+static void check_temporal_smooth(const std::vector<std::vector<T>>& sequence, T delta_z)
+{
+    auto pixels = sequence[0].size();
+
+    // Any map will do, the vector lookup must agree with the table for every history and bit
+    std::vector<uint8_t> persistence_map(PRESISTENCY_LUT_SIZE);
+    for (auto&& m : persistence_map)
+        m = static_cast<uint8_t>(rand());
+
+    set_simd_level(simd_level::scalar);
+    std::vector<std::vector<T>> reference;
+    std::vector<T> ref_last(pixels);
+    std::vector<uint8_t> ref_history(pixels);
+    for (size_t f = 0; f < sequence.size(); f++)
+    {
+        auto frame = sequence[f];
+        temporal_smooth(frame.data(), ref_last.data(), ref_history.data(), pixels, 0.4f, 1.f - 0.4f, delta_z,
+            uint8_t(1 << (f % 8)), persistence_map.data());
+        reference.push_back(frame);
+    }
+
+    for (int i = 1; i < static_cast<int>(simd_level::count); i++)
+    {
+        auto level = set_simd_level(static_cast<simd_level>(i));
+        if (level != static_cast<simd_level>(i)) break;
+        CAPTURE(get_string(level));
+
+        std::vector<T> last(pixels);
+        std::vector<uint8_t> history(pixels);
+        for (size_t f = 0; f < sequence.size(); f++)
+        {
+            CAPTURE(f);
+            auto frame = sequence[f];
+            temporal_smooth(frame.data(), last.data(), history.data(), pixels, 0.4f, 1.f - 0.4f, delta_z,
+                uint8_t(1 << (f % 8)), persistence_map.data());
+            REQUIRE(!memcmp(frame.data(), reference[f].data(), pixels * sizeof(T)));
+        }
+        REQUIRE(!memcmp(last.data(), ref_last.data(), pixels * sizeof(T)));
+        REQUIRE(history == ref_history);
+    }
+}
+
+TEST_CASE("vectorized temporal filter matches the scalar filter", "[code][filters]")
+{
+    filters_simd_guard guard;
+
+    // Not a multiple of the 16 pixel step, so the scalar tail runs as well
+    const size_t pixels = 4099;
+    const int frames = 20;
+
+    check_temporal_smooth<uint16_t>(make_depth_sequence<uint16_t>(pixels, frames), 20);
+
+    // Disparity adds the values the float tests treat specially: NaN is a value, -0 is a hole
+    auto disparity = make_depth_sequence<float>(pixels, frames);
+    for (size_t i = 0; i < pixels; i += 37)
+    {
+        disparity[i % frames][i] = std::numeric_limits<float>::quiet_NaN();
+        disparity[(i + 3) % frames][i] = -0.f;
+        disparity[(i + 5) % frames][i] *= 1.0001f;
+    }
+    check_temporal_smooth<float>(disparity, 20.f);
+}
+
+BENCHMARK_TEST_CASE("temporal filter throughput", "[filters]")
+{
+    filters_simd_guard guard;
+    const size_t pixels = 1280 * 720;
+    const int frames = 30;
+    auto depth = make_depth_sequence<uint16_t>(pixels, 8);
+    std::vector<std::vector<float>> disparity(8, std::vector<float>(pixels));
+    for (int f = 0; f < 8; f++)
+        for (size_t i = 0; i < pixels; i++)
+            disparity[f][i] = depth[f][i] ? 50000.f / depth[f][i] : 0.f;
+
+    std::vector<uint8_t> persistence_map(PRESISTENCY_LUT_SIZE, 0x55);
+
+    benchmark_table table({ "Temporal", "Level", "Z16 ms", "disparity ms" });
+    for (int i = 0; i < static_cast<int>(simd_level::count); i++)
+    {
+        auto level = set_simd_level(static_cast<simd_level>(i));
+        if (level != static_cast<simd_level>(i)) break;
+
+        std::vector<uint16_t> last16(pixels), frame16(pixels);
+        std::vector<float> last32(pixels), frame32(pixels);
+        std::vector<uint8_t> history(pixels);
+        double z16 = 0, fp = 0;
+        for (int f = 0; f < frames; f++)
+        {
+            auto mask = uint8_t(1 << (f % 8));
+            frame16 = depth[f % 8];
+            auto start = high_resolution_clock::now();
+            temporal_smooth(frame16.data(), last16.data(), history.data(), pixels, 0.4f, 0.6f, uint16_t(20), mask, persistence_map.data());
+            z16 += elapsed_ms(start);
+
+            frame32 = disparity[f % 8];
+            start = high_resolution_clock::now();
+            temporal_smooth(frame32.data(), last32.data(), history.data(), pixels, 0.4f, 0.6f, 0.5f, mask, persistence_map.data());
+            fp += elapsed_ms(start);
+        }
+        table.row("1280x720", get_string(level), z16 / frames, fp / frames);
+    }
+}
+
+// The decimation of one block the way the filter defines it, straight from the definition
+static uint16_t decimated_depth(const std::vector<uint16_t>& image, int width, int scale, int x, int y)
+{
+    std::vector<uint16_t> values;
+    for (int n = 0; n < scale; n++)
+        for (int m = 0; m < scale; m++)
+            if (auto z = image[(y * scale + n) * width + x * scale + m])
+                values.push_back(z);
+    if (values.empty())
+        return 0;
+    if (scale == 2 || scale == 3)
+    {
+        std::sort(values.begin(), values.end());
+        return values[(values.size() - 1) / 2];
+    }
+    int sum = 0;
+    for (auto z : values) sum += z;
+    return static_cast<uint16_t>(sum / static_cast<int>(values.size()));
+}
+
+TEST_CASE("decimation matches its definition at every simd level", "[code][filters]")
+{
+    filters_simd_guard guard;
+
+    // Odd sizes leave partial blocks at the edges and a scalar tail after the vectorized outputs
+    const int width = 533, height = 61;
+    std::vector<uint16_t> depth(width * height);
+    std::vector<uint8_t> color(width * height * 4);
+    srand(20);
+    for (auto&& z : depth)
+        z = (rand() % 4 == 0) ? 0 : static_cast<uint16_t>(rand() % 3 ? 1000 + rand() % 200 : rand() % 65536);
+    for (auto&& c : color)
+        c = static_cast<uint8_t>(rand());
+
+    for (int scale = 1; scale <= 8; scale++)
+    {
+        CAPTURE(scale);
+        int out_width = width / scale, out_height = height / scale, stride = out_width + 5;
+
+        for (int i = 0; i < static_cast<int>(simd_level::count); i++)
+        {
+            auto level = set_simd_level(static_cast<simd_level>(i));
+            if (level != static_cast<simd_level>(i)) break;
+            CAPTURE(get_string(level));
+
+            std::vector<uint16_t> out(stride * out_height, 0xffff);
+            decimate_depth_rows(depth.data(), width, scale, out_width, out.data(), stride, 0, out_height / 2);
+            decimate_depth_rows(depth.data(), width, scale, out_width, out.data(), stride, out_height / 2, out_height);
+            for (int y = 0; y < out_height; y++)
+                for (int x = 0; x < stride; x++)
+                {
+                    auto expected = x < out_width ? decimated_depth(depth, width, scale, x, y) : 0;
+                    if (out[y * stride + x] != expected)
+                        FAIL("depth output " << x << "," << y << " is " << out[y * stride + x] << " instead of " << expected);
+                }
+
+            for (size_t bpp : { 1, 3, 4 })
+            {
+                CAPTURE(bpp);
+                std::vector<uint8_t> result(stride * out_height * bpp, 0xff);
+                decimate_bytes_rows(color.data(), width, bpp, scale, out_width, result.data(), stride, 0, out_height);
+                for (int y = 0; y < out_height; y++)
+                    for (int x = 0; x < stride; x++)
+                        for (size_t k = 0; k < bpp; k++)
+                        {
+                            int expected = 0;
+                            if (x < out_width)
+                            {
+                                for (int n = 0; n < scale; n++)
+                                    for (int m = 0; m < scale; m++)
+                                        expected += color[((y * scale + n) * width + x * scale + m) * bpp + k];
+                                expected /= scale * scale;
+                            }
+                            if (result[(y * stride + x) * bpp + k] != expected)
+                                FAIL("channel " << k << " of output " << x << "," << y << " is " << int(result[(y * stride + x) * bpp + k]));
+                        }
+            }
+        }
+    }
+}
+
+BENCHMARK_TEST_CASE("decimation throughput", "[filters]")
+{
+    filters_simd_guard guard;
+    const int width = 1280, height = 720, iterations = 50;
+    std::vector<uint16_t> depth(width * height);
+    std::vector<uint8_t> color(width * height * 3);
+    srand(20);
+    for (auto&& z : depth)
+        z = (rand() % 10 == 0) ? 0 : static_cast<uint16_t>(1000 + rand() % 2000);
+    for (auto&& c : color)
+        c = static_cast<uint8_t>(rand());
+
+    benchmark_table table({ "Decimation", "Level", "depth ms", "rgb8 ms" });
+    for (int scale : { 2, 3, 4 })
+    {
+        int out_width = width / scale, out_height = height / scale;
+        std::vector<uint16_t> out(out_width * out_height);
+        std::vector<uint8_t> rgb(out_width * out_height * 3);
+        for (int i = 0; i < static_cast<int>(simd_level::count); i++)
+        {
+            auto level = set_simd_level(static_cast<simd_level>(i));
+            if (level != static_cast<simd_level>(i)) break;
+
+            auto start = high_resolution_clock::now();
+            for (int k = 0; k < iterations; k++)
+                decimate_depth_rows(depth.data(), width, scale, out_width, out.data(), out_width, 0, out_height);
+            auto middle = high_resolution_clock::now();
+            for (int k = 0; k < iterations; k++)
+                decimate_bytes_rows(color.data(), width, 3, scale, out_width, rgb.data(), out_width, 0, out_height);
+            auto end = high_resolution_clock::now();
+
+            table.row(std::to_string(scale) + "x" + std::to_string(scale), get_string(level),
+                elapsed_ms(start, middle) / iterations, elapsed_ms(middle, end) / iterations);
+        }
+    }
+}
+
+static std::vector<uint16_t> make_colorizer_depth(int width, int height)
+{
+    std::vector<uint16_t> depth(size_t(width) * height);
+    srand(21);
+    for (auto&& z : depth)
+        z = (rand() % 10 == 0) ? 0 : static_cast<uint16_t>(rand() % 4 ? 500 + rand() % 3000 : rand() % 65536);
+    return depth;
+}
+
+TEST_CASE("colorizer tables match the per-pixel colors", "[code][filters]")
+{
+    const int width = 97, height = 13;
+    auto depth = make_colorizer_depth(width, height);
+    color_map cm{ { { 0, 0, 255 }, { 0, 255, 255 }, { 255, 255, 0 }, { 255, 0, 0 }, { 50, 0, 0 } } };
+
+    std::vector<int> serial(colorizer::MAX_DEPTH), hist(colorizer::MAX_DEPTH), partials;
+    thread_pool pool(3);
+    colorizer::update_histogram(serial.data(), depth.data(), width, height);
+    colorizer::update_histogram(hist.data(), depth.data(), width, height, pool, partials);
+    REQUIRE(hist == serial);
+
+    const float depth_units = 0.001f, min = 0.3f, max = 4.f;
+    auto cropped = [&](float data) { return (data * depth_units - min) / (max - min); };
+    auto equalized = [&](float data) { return hist[(int)data] / (float)hist[colorizer::MAX_DEPTH - 1]; };
+
+    for (auto format : { RS2_FORMAT_RGB8, RS2_FORMAT_RGBA8, RS2_FORMAT_BGR8 })
+    {
+        CAPTURE(format);
+        const int bpp = format == RS2_FORMAT_RGBA8 ? 4 : 3;
+        for (int equalize = 0; equalize < 2; equalize++)
+        {
+            CAPTURE(equalize);
+            std::vector<uint32_t> lut(colorizer::MAX_DEPTH);
+            if (equalize) build_color_lut(lut.data(), cm, format, 0, colorizer::MAX_DEPTH, equalized);
+            else build_color_lut(lut.data(), cm, format, 0, colorizer::MAX_DEPTH, cropped);
+
+            std::vector<uint8_t> out(depth.size() * bpp + 1, 0xcd);
+            apply_color_lut(depth.data(), lut.data(), out.data(), bpp, width * height);
+            REQUIRE(out.back() == 0xcd);
+
+            for (size_t i = 0; i < depth.size(); i++)
+            {
+                float3 c{ 0.f, 0.f, 0.f };
+                if (depth[i]) c = cm.get(equalize ? equalized(depth[i]) : cropped(depth[i]));
+                uint8_t expected[4] = { (uint8_t)c.x, (uint8_t)c.y, (uint8_t)c.z, 255 };
+                if (format == RS2_FORMAT_BGR8) std::swap(expected[0], expected[2]);
+                if (memcmp(out.data() + i * bpp, expected, bpp))
+                    FAIL("pixel " << i << " of depth " << depth[i] << " has the wrong color");
+            }
+        }
+    }
+}
+
+// Depth frames of a software device with the depth units and stereo baseline of a stereo camera, as the filters
+// get them from a sensor
+struct software_depth_source
+{
+    // Without a stereo baseline the sensor is not a stereo sensor and has no disparity
+    software_depth_source(int width, int height, bool stereo = true)
+        : sensor(dev.add_sensor("Depth")), width(width), height(height)
+    {
+        rs2_intrinsics intrinsics{ width, height, width / 2.f, height / 2.f, 380.f, 380.f, RS2_DISTORTION_BROWN_CONRADY, { 0, 0, 0, 0, 0 } };
+        profile = sensor.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, width, height, 30, 2, RS2_FORMAT_Z16, intrinsics });
+        sensor.add_read_only_option(RS2_OPTION_DEPTH_UNITS, 0.001f);
+        if (stereo)
+            sensor.add_read_only_option(RS2_OPTION_STEREO_BASELINE, 50.f);
+        sensor.open(profile);
+        sensor.start(sync);
+    }
+
+    rs2::frame make(const std::vector<uint16_t>& depth)
+    {
+        auto pixels = new uint16_t[depth.size()];
+        std::copy(depth.begin(), depth.end(), pixels);
+        number++;
+        sensor.on_video_frame({ pixels, [](void* p) { delete[] static_cast<uint16_t*>(p); }, width * 2, 2,
+            rs2_time_t(number), RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, number, profile });
+        rs2::frameset fset = sync.wait_for_frames();
+        return fset.first_or_default(RS2_STREAM_DEPTH);
+    }
+
+    rs2::software_device dev;
+    rs2::software_sensor sensor;
+    rs2::stream_profile profile;
+    rs2::syncer sync;
+    int width, height, number = 0;
+};
+
+// Colors of depth as colorize_pixel gives them pixel by pixel
+template<class F>
+static std::vector<uint8_t> expected_colors(const std::vector<uint16_t>& depth, const color_map& cm, rs2_format format, F value_of)
+{
+    const int bpp = format == RS2_FORMAT_RGBA8 ? 4 : 3;
+    std::vector<uint8_t> colors(depth.size() * bpp);
+    for (size_t i = 0; i < depth.size(); i++)
+    {
+        auto color = pack_color(depth[i] ? cm.get(value_of(float(depth[i]))) : float3{ 0.f, 0.f, 0.f }, format);
+        memcpy(colors.data() + i * bpp, &color, bpp);
+    }
+    return colors;
+}
+
+class colorizer_under_test : public colorizer
+{
+public:
+    const color_map& map(int index) const { return *_maps[index]; }
+};
+
+TEST_CASE("colorizer rebuilds its table when the options change", "[code][filters]")
+{
+    const int width = 64, height = 48;
+    const float depth_units = 0.001f;
+    software_depth_source source(width, height);
+    auto block = std::make_shared<colorizer_under_test>();
+    rs2::filter colorize(std::make_shared<rs2_processing_block>(block));
+
+    // A near and a far scene, which cover different ranges of the table
+    std::vector<uint16_t> near_depth(width * height), far_depth(width * height);
+    for (int i = 0; i < width * height; i++)
+    {
+        near_depth[i] = (i % 7) ? static_cast<uint16_t>(400 + (i * 13) % 1100) : 0;
+        far_depth[i] = (i % 5) ? static_cast<uint16_t>(2600 + (i * 29) % 3400) : 0;
+    }
+
+    float min = 0.f, max = 6.f;
+    int map_index = 0;
+    rs2_format format = RS2_FORMAT_RGB8;
+    bool equalize = false;
+    auto check = [&](const std::vector<uint16_t>& depth)
+    {
+        CAPTURE(map_index);
+        CAPTURE(min);
+        CAPTURE(max);
+        CAPTURE(format);
+        CAPTURE(equalize);
+        colorize.set_option(RS2_OPTION_HISTOGRAM_EQUALIZATION_ENABLED, equalize);
+        colorize.set_option(RS2_OPTION_COLOR_SCHEME, float(map_index));
+        colorize.set_option(RS2_OPTION_MIN_DISTANCE, min);
+        colorize.set_option(RS2_OPTION_MAX_DISTANCE, max);
+        colorize.set_option(RS2_OPTION_COLORIZER_FORMAT, format == RS2_FORMAT_RGB8 ? 0.f : format == RS2_FORMAT_RGBA8 ? 1.f : 2.f);
+
+        auto out = colorize.process(source.make(depth));
+        REQUIRE(out.get_profile().format() == format);
+
+        std::vector<int> hist(colorizer::MAX_DEPTH);
+        colorizer::update_histogram(hist.data(), depth.data(), width, height);
+        auto cropped = [&](float data) { return (data * depth_units - min) / (max - min); };
+        auto equalized = [&](float data) { return hist[(int)data] / (float)hist[colorizer::MAX_DEPTH - 1]; };
+        auto expected = equalize ? expected_colors(depth, block->map(map_index), format, equalized)
+                                 : expected_colors(depth, block->map(map_index), format, cropped);
+        auto colors = static_cast<const uint8_t*>(out.get_data());
+        const int bpp = format == RS2_FORMAT_RGBA8 ? 4 : 3;
+        for (size_t i = 0; i < depth.size(); i++)
+            if (memcmp(colors + i * bpp, expected.data() + i * bpp, bpp))
+                FAIL("pixel " << i << " of depth " << depth[i] << " has the wrong color");
+    };
+
+    // The table built for the first frame serves the second, then follows every option it depends on
+    check(near_depth);
+    check(far_depth);
+    map_index = 2;
+    check(far_depth);
+    max = 4.f;
+    check(far_depth);
+    min = 0.5f;
+    check(near_depth);
+    format = RS2_FORMAT_BGR8;
+    check(near_depth);
+    format = RS2_FORMAT_RGBA8;
+    check(far_depth);
+
+    // Equalized frames rebuild only the range of values they hold
+    equalize = true;
+    check(near_depth);
+    check(far_depth);
+    map_index = 0;
+    format = RS2_FORMAT_RGB8;
+    check(near_depth);
+
+    // Leaving equalization rebuilds the whole table
+    equalize = false;
+    check(far_depth);
+}
+
+BENCHMARK_TEST_CASE("colorizer throughput", "[filters]")
+{
+    const int width = 1280, height = 720, iterations = 50;
+    auto depth = make_colorizer_depth(width, height);
+    color_map cm{ { { 0, 0, 255 }, { 0, 255, 255 }, { 255, 255, 0 }, { 255, 0, 0 }, { 50, 0, 0 } } };
+    std::vector<int> hist(colorizer::MAX_DEPTH), partials;
+    std::vector<uint32_t> lut(colorizer::MAX_DEPTH);
+    std::vector<uint8_t> rgb(depth.size() * 3);
+    thread_pool pool(std::max(1u, std::thread::hardware_concurrency()));
+    auto equalized = [&](float data) { return hist[(int)data] / (float)hist[colorizer::MAX_DEPTH - 1]; };
+
+    // Histogram and a color lookup through the color map for every pixel
+    auto start = high_resolution_clock::now();
+    for (int k = 0; k < iterations; k++)
+    {
+        colorizer::update_histogram(hist.data(), depth.data(), width, height);
+        for (size_t i = 0; i < depth.size(); i++)
+        {
+            auto c = depth[i] ? cm.get(equalized(depth[i])) : float3{ 0.f, 0.f, 0.f };
+            rgb[i * 3 + 0] = (uint8_t)c.x;
+            rgb[i * 3 + 1] = (uint8_t)c.y;
+            rgb[i * 3 + 2] = (uint8_t)c.z;
+        }
+    }
+    auto middle = high_resolution_clock::now();
+    for (int k = 0; k < iterations; k++)
+    {
+        colorizer::update_histogram(hist.data(), depth.data(), width, height, pool, partials);
+        build_color_lut(lut.data(), cm, RS2_FORMAT_RGB8, 0, colorizer::MAX_DEPTH, equalized);
+        apply_color_lut(depth.data(), lut.data(), rgb.data(), 3, width * height);
+    }
+    auto end = high_resolution_clock::now();
+
+    benchmark_table table({ "Colorizer", "per pixel ms", "table ms" });
+    table.row(std::to_string(width) + "x" + std::to_string(height), elapsed_ms(start, middle) / iterations, elapsed_ms(middle, end) / iterations);
+}
+
+TEST_CASE("depth lut matches the per-pixel transforms at every simd level", "[code][filters]")
+{
+    filters_simd_guard guard;
+
+    // Every 16 bit value, shuffled, and an odd count leaving a scalar tail
+    std::vector<uint16_t> depth(depth_lut::TABLE_SIZE + 13);
+    for (size_t i = 0; i < depth.size(); i++)
+        depth[i] = static_cast<uint16_t>(i * 40503);
+
+    const float du = 0.001f, min = 0.3f, max = 4.f, d2d = 12345.6f;
+    depth_lut lut;
+    for (int i = 0; i < static_cast<int>(simd_level::count); i++)
+    {
+        auto level = set_simd_level(static_cast<simd_level>(i));
+        if (level != static_cast<simd_level>(i)) break;
+        CAPTURE(get_string(level));
+
+        std::vector<uint16_t> z16(depth.size());
+        lut.set({ depth_mapping::make_threshold(min, max) }, du);
+        REQUIRE(lut.get_format() == RS2_FORMAT_Z16);
+        lut.apply(depth.data(), z16.data(), depth.size());
+        for (size_t k = 0; k < depth.size(); k++)
+        {
+            auto dist = du * depth[k];
+            if (z16[k] != ((dist >= min && dist <= max) ? depth[k] : 0))
+                FAIL("thresholded " << depth[k] << " is " << z16[k]);
+        }
+
+        std::vector<float> meters(depth.size());
+        lut.set({ depth_mapping::make_meters() }, du);
+        REQUIRE(lut.get_format() == RS2_FORMAT_DISTANCE);
+        lut.apply(depth.data(), meters.data(), depth.size());
+        for (size_t k = 0; k < depth.size(); k++)
+            if (meters[k] != du * depth[k])
+                FAIL(depth[k] << " is " << meters[k] << " meters");
+
+        // Threshold then disparity in one table
+        std::vector<float> disparity(depth.size());
+        lut.set({ depth_mapping::make_threshold(min, max), depth_mapping::make_disparity(d2d) }, du);
+        REQUIRE(lut.get_format() == RS2_FORMAT_DISPARITY32);
+        lut.apply(depth.data(), disparity.data(), depth.size());
+        for (size_t k = 0; k < depth.size(); k++)
+        {
+            auto dist = du * depth[k];
+            float input = (dist >= min && dist <= max) ? depth[k] : 0;
+            if (disparity[k] != (std::isnormal(input) ? static_cast<float>(d2d / input + 0.f) : 0.f))
+                FAIL("disparity of " << depth[k] << " is " << disparity[k]);
+        }
+    }
+
+    REQUIRE_THROWS(lut.set({ depth_mapping::make_meters(), depth_mapping::make_threshold(min, max) }, du));
+}
+
+TEST_CASE("depth lut transform matches threshold and disparity transform on any depth sensor", "[code][filters]")
+{
+    const int width = 64, height = 48;
+    std::vector<uint16_t> depth(width * height);
+    for (int i = 0; i < width * height; i++)
+        depth[i] = (i % 9) ? static_cast<uint16_t>(100 + (i * 37) % 6000) : 0;
+
+    // Without a stereo baseline disparity_transform passes the thresholded depth on, and so does the fused block
+    for (auto stereo : { true, false })
+    {
+        CAPTURE(stereo);
+        software_depth_source source(width, height, stereo);
+        auto f = source.make(depth);
+
+        rs2::threshold_filter threshold(0.5f, 3.f);
+        rs2::disparity_transform to_disparity(true);
+        auto expected = to_disparity.process(threshold.process(f));
+        rs2::depth_lut_transform fused(0.5f, 3.f, RS2_FORMAT_DISPARITY32);
+        auto result = fused.process(f);
+
+        REQUIRE(expected.get_profile().format() == (stereo ? RS2_FORMAT_DISPARITY32 : RS2_FORMAT_Z16));
+        REQUIRE(result.get_profile().format() == expected.get_profile().format());
+        REQUIRE(result.get_data_size() == expected.get_data_size());
+        REQUIRE(!memcmp(result.get_data(), expected.get_data(), expected.get_data_size()));
+    }
+}
+
+TEST_CASE("depth lut transform refuses a min range above its max range", "[code][filters]")
+{
+    rs2::depth_lut_transform fused;
+    REQUIRE_THROWS(fused.set_option(RS2_OPTION_MIN_DISTANCE, 5.f));
+    REQUIRE(fused.get_option(RS2_OPTION_MIN_DISTANCE) == Approx(0.1f));
+    REQUIRE_THROWS(fused.set_option(RS2_OPTION_MAX_DISTANCE, 0.05f));
+    REQUIRE(fused.get_option(RS2_OPTION_MAX_DISTANCE) == Approx(4.f));
+
+    // A range beyond the default one is set in the order that keeps it valid
+    rs2::depth_lut_transform far(5.f, 8.f);
+    REQUIRE(far.get_option(RS2_OPTION_MIN_DISTANCE) == Approx(5.f));
+    REQUIRE(far.get_option(RS2_OPTION_MAX_DISTANCE) == Approx(8.f));
+
+    const int width = 64, height = 48;
+    std::vector<uint16_t> depth(width * height);
+    for (int i = 0; i < width * height; i++)
+        depth[i] = static_cast<uint16_t>(1000 + i * 3);
+    software_depth_source source(width, height);
+    auto result = far.process(source.make(depth));
+    auto values = reinterpret_cast<const uint16_t*>(result.get_data());
+    for (int i = 0; i < width * height; i++)
+        REQUIRE(values[i] == (depth[i] >= 5000 && depth[i] <= 8000 ? depth[i] : 0));
+}
+
+BENCHMARK_TEST_CASE("depth lut throughput", "[filters]")
+{
+    filters_simd_guard guard;
+    const int width = 1280, height = 720, iterations = 50;
+    auto depth = make_colorizer_depth(width, height);
+    std::vector<uint16_t> thresholded(depth.size());
+    std::vector<float> disparity(depth.size());
+    const float du = 0.001f, min = 0.3f, max = 4.f, d2d = 12345.6f;
+
+    // Threshold, then depth to disparity on its output, as the blocks did per pixel
+    auto start = high_resolution_clock::now();
+    for (int k = 0; k < iterations; k++)
+    {
+        memset(thresholded.data(), 0, thresholded.size() * sizeof(uint16_t));
+        for (size_t i = 0; i < depth.size(); i++)
+        {
+            auto dist = du * depth[i];
+            if (dist >= min && dist <= max) thresholded[i] = depth[i];
+        }
+        for (size_t i = 0; i < depth.size(); i++)
+        {
+            float input = thresholded[i];
+            disparity[i] = std::isnormal(input) ? d2d / input : 0.f;
+        }
+    }
+    auto end = high_resolution_clock::now();
+
+    benchmark_table table({ "Threshold + disparity", "Level", "ms" });
+    table.row("per pixel", "scalar", elapsed_ms(start, end) / iterations);
+
+    depth_lut lut;
+    for (int i = 0; i < static_cast<int>(simd_level::count); i++)
+    {
+        auto level = set_simd_level(static_cast<simd_level>(i));
+        if (level != static_cast<simd_level>(i)) break;
+
+        start = high_resolution_clock::now();
+        for (int k = 0; k < iterations; k++)
+        {
+            lut.set({ depth_mapping::make_threshold(min, max), depth_mapping::make_disparity(d2d) }, du);
+            lut.apply(depth.data(), disparity.data(), depth.size());
+        }
+        end = high_resolution_clock::now();
+        table.row("table", get_string(level), elapsed_ms(start, end) / iterations);
+    }
+}
+
+// Depth of slanted planes at two distances, with holes that come and go from frame to frame
+static std::vector<std::vector<uint16_t>> make_chain_depth_sequence(int width, int height, int frames)
+{
+    std::vector<std::vector<uint16_t>> sequence(frames, std::vector<uint16_t>(size_t(width) * height));
+    srand(23);
+    for (auto&& depth : sequence)
+        for (int y = 0; y < height; ++y)
+            for (int x = 0; x < width; ++x)
+                depth[size_t(y) * width + x] = (rand() % 100 < 12) ? 0 :
+                    static_cast<uint16_t>(((x / 60 + y / 40) % 3 ? 1500 : 800) + x / 2 + y / 3 + rand() % 8);
+    return sequence;
+}
+
+// The chain as the separate blocks run it, every block allocating and writing a frame of its own over the whole image.
+// Counts the bytes of the frames allocated on the way
+struct separate_depth_filters
+{
+    separate_depth_filters(float scale, float spatial_holes_mode, int hole_filling_mode)
+        : decimation(scale), to_disparity(true), spatial(0.5f, 20.f, 2.f, spatial_holes_mode),
+        temporal(0.4f, 20.f, 3), to_depth(false), hole_filling(hole_filling_mode) {}
+
+    rs2::frame process(rs2::frame f)
+    {
+        frame_bytes = 0;
+        for (rs2::filter* block : std::initializer_list<rs2::filter*>{ &decimation, &to_disparity, &spatial, &temporal, &to_depth, &hole_filling })
+        {
+            f = block->process(f);
+            frame_bytes += f.as<rs2::video_frame>().get_data_size();
+        }
+        return f;
+    }
+
+    rs2::decimation_filter decimation;
+    rs2::disparity_transform to_disparity;
+    rs2::spatial_filter spatial;
+    rs2::temporal_filter temporal;
+    rs2::disparity_transform to_depth;
+    rs2::hole_filling_filter hole_filling;
+    size_t frame_bytes = 0;
+};
+
+TEST_CASE("voxel filter takes option changes from another thread while it processes", "[code][filters]")
+{
+    const int width = 160, height = 120;
+    std::vector<uint16_t> depth(width * height);
+    for (int i = 0; i < width * height; i++)
+        depth[i] = static_cast<uint16_t>(500 + (i * 53) % 3000);
+    software_depth_source source(width, height);
+    rs2::pointcloud pc;
+    rs2::points points = pc.calculate(source.make(depth));
+
+    // The points every pair of settings the second thread sets gives
+    const float leaves[] = { 0.01f, 0.05f };
+    const float policies[] = { 0.f, 1.f };
+    std::vector<size_t> counts;
+    for (auto leaf : leaves)
+        for (auto policy : policies)
+        {
+            rs2::voxel_filter voxel(leaf);
+            voxel.set_option(RS2_OPTION_VOXEL_POLICY, policy);
+            counts.push_back(voxel.process(points).as<rs2::points>().size());
+        }
+
+    rs2::voxel_filter voxel;
+    std::atomic<bool> done(false);
+    std::thread setter([&]()
+    {
+        for (int i = 0; !done; i++)
+        {
+            voxel.set_option(RS2_OPTION_VOXEL_LEAF_SIZE, leaves[i % 2]);
+            voxel.set_option(RS2_OPTION_VOXEL_POLICY, policies[(i / 2) % 2]);
+        }
+    });
+    for (int i = 0; i < 200; i++)
+    {
+        auto reduced = voxel.process(points).as<rs2::points>();
+        if (std::find(counts.begin(), counts.end(), reduced.size()) == counts.end())
+        {
+            done = true;
+            setter.join();
+            FAIL("frame " << i << " has " << reduced.size() << " points, which no pair of settings gives");
+        }
+    }
+    done = true;
+    setter.join();
+}
+
+TEST_CASE("fused depth chain matches the separate filters", "[code][filters]")
+{
+    filters_simd_guard guard;
+    const int width = 641, height = 363, frames = 6;
+    auto sequence = make_chain_depth_sequence(width, height, frames);
+
+    struct variant { float scale; float spatial_holes_mode; int hole_filling_mode; };
+    std::vector<variant> variants = {
+        { 2.f, 2.f, hf_farest_from_around },
+        { 3.f, 0.f, hf_fill_from_left },
+        { 1.f, 5.f, hf_nearest_from_around },
+    };
+
+    for (int i = 0; i < static_cast<int>(simd_level::count); i++)
+    {
+        auto level = set_simd_level(static_cast<simd_level>(i));
+        if (level != static_cast<simd_level>(i)) break;
+
+        for (size_t v = 0; v < variants.size(); v++)
+        {
+            // The chain follows the options of the same filters the separate chain runs
+            software_depth_source source(width, height);
+            separate_depth_filters separate(variants[v].scale, variants[v].spatial_holes_mode, variants[v].hole_filling_mode);
+            rs2::depth_post_processing_chain fused(separate.decimation, separate.spatial, separate.temporal, separate.hole_filling);
+            for (int f = 0; f < frames; f++)
+            {
+                auto depth = source.make(sequence[f]);
+                auto expected = separate.process(depth).as<rs2::video_frame>();
+                auto result = fused.process(depth).as<rs2::video_frame>();
+
+                REQUIRE(result.get_width() == expected.get_width());
+                REQUIRE(result.get_height() == expected.get_height());
+                REQUIRE(result.get_profile().as<rs2::video_stream_profile>().get_intrinsics().fx
+                    == expected.get_profile().as<rs2::video_stream_profile>().get_intrinsics().fx);
+                auto out = static_cast<const uint16_t*>(result.get_data());
+                auto ref = static_cast<const uint16_t*>(expected.get_data());
+                for (int p = 0; p < result.get_width() * result.get_height(); p++)
+                    if (out[p] != ref[p])
+                        FAIL("level " << get_string(level) << " variant " << v << " frame " << f << " pixel " << p
+                            << ": " << out[p] << " != " << ref[p]);
+            }
+        }
+    }
+}
+
+BENCHMARK_TEST_CASE("fused depth chain throughput", "[filters]")
+{
+    const int width = 1280, height = 720, frames = 8, iterations = 10;
+    auto sequence = make_chain_depth_sequence(width, height, frames);
+    software_depth_source source(width, height);
+    std::vector<rs2::frame> depth;
+    for (auto&& d : sequence)
+        depth.push_back(source.make(d));
+
+    separate_depth_filters separate(2.f, 0.f, hf_farest_from_around);
+    auto start = high_resolution_clock::now();
+    for (int k = 0; k < iterations; k++)
+        for (auto&& f : depth)
+            separate.process(f);
+    auto end = high_resolution_clock::now();
+
+    benchmark_table table({ "Depth chain", "ms", "frame MB allocated" });
+    table.row("separate", elapsed_ms(start, end) / (iterations * frames), separate.frame_bytes / 1e6);
+
+    rs2::depth_post_processing_chain fused(separate.decimation, separate.spatial, separate.temporal, separate.hole_filling);
+    rs2::frame out;
+    start = high_resolution_clock::now();
+    for (int k = 0; k < iterations; k++)
+        for (auto&& f : depth)
+            out = fused.process(f);
+    end = high_resolution_clock::now();
+    table.row("fused", elapsed_ms(start, end) / (iterations * frames), out.as<rs2::video_frame>().get_data_size() / 1e6);
+}
+
+// Forwards its frames after holding the worker for delay, recording the frame numbers it saw and the blocks running at once
+class recording_block : public librealsense::processing_block
+{
+public:
+    recording_block(milliseconds delay, std::atomic<int>& running, std::atomic<int>& max_running)
+        : processing_block("Recording Block")
+    {
+        auto on_frame = [this, delay, &running, &max_running](frame_holder f, synthetic_source_interface* source)
+        {
+            auto now = ++running;
+            auto max = max_running.load();
+            while (now > max && !max_running.compare_exchange_weak(max, now)) {}
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _seen.push_back(f->get_frame_number());
+            }
+            std::this_thread::sleep_for(delay);
+            running--;
+            source->frame_ready(std::move(f));
+        };
+        set_processing_callback({ new internal_frame_processor_callback<decltype(on_frame)>(on_frame),
+            [](rs2_frame_processor_callback* p) { p->release(); } });
+    }
+
+    std::vector<unsigned long long> seen()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _seen;
+    }
+
+private:
+    std::mutex _mutex;
+    std::vector<unsigned long long> _seen;
+};
+
+// Collects the frame numbers a node of a processing graph delivers
+struct graph_output
+{
+    std::mutex mutex;
+    std::vector<unsigned long long> frames;
+
+    frame_callback_ptr callback()
+    {
+        auto on_frame = [this](frame_holder f)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            frames.push_back(f->get_frame_number());
+        };
+        return { new internal_frame_callback<decltype(on_frame)>(on_frame), [](rs2_frame_callback* p) { p->release(); } };
+    }
+};
+
+static frame_holder make_graph_frame(frame_source& source, std::shared_ptr<stream_profile_interface> profile, unsigned long long number)
+{
+    frame_additional_data data{};
+    data.frame_number = number;
+    frame_holder f(source.alloc_frame(RS2_EXTENSION_VIDEO_FRAME, 0, data, false));
+    f->set_stream(profile);
+    return f;
+}
+
+static std::vector<unsigned long long> frame_numbers(unsigned long long first, unsigned long long last)
+{
+    std::vector<unsigned long long> numbers;
+    for (auto n = first; n <= last; n++)
+        numbers.push_back(n);
+    return numbers;
+}
+
+TEST_CASE("processing graph runs branches concurrently and every node in order", "[code][filters]")
+{
+    const int frames = 12;
+    frame_source source;
+    source.init(std::shared_ptr<metadata_parser_map>());
+    auto depth = std::make_shared<stream_profile_base>(platform::stream_profile{});
+    depth->set_stream_type(RS2_STREAM_DEPTH);
+    depth->set_format(RS2_FORMAT_Z16);
+    depth->set_stream_index(0);
+
+    std::atomic<int> running(0), max_running(0);
+    auto root = std::make_shared<recording_block>(milliseconds(1), running, max_running);
+    auto left = std::make_shared<recording_block>(milliseconds(4), running, max_running);
+    auto right = std::make_shared<recording_block>(milliseconds(4), running, max_running);
+    auto leaf = std::make_shared<recording_block>(milliseconds(2), running, max_running);
+    auto color = std::make_shared<recording_block>(milliseconds(1), running, max_running);
+    graph_output left_output, leaf_output;
+
+    {
+        processing_graph graph(4);
+        auto r = graph.add_node(root, -1, stream_filter());
+        auto l = graph.add_node(left, r, stream_filter(RS2_STREAM_DEPTH, RS2_FORMAT_ANY, -1));
+        graph.add_node(right, r, stream_filter(RS2_STREAM_DEPTH, RS2_FORMAT_Z16, 0));
+        auto f = graph.add_node(leaf, l, stream_filter());
+        auto c = graph.add_node(color, r, stream_filter(RS2_STREAM_COLOR, RS2_FORMAT_ANY, -1));
+        graph.set_output_callback(l, left_output.callback());
+        graph.set_output_callback(f, leaf_output.callback());
+
+        for (int i = 1; i <= frames; i++)
+            graph.invoke(make_graph_frame(source, depth, i));
+        graph.wait();
+
+        if (graph.get_stats(f).frames != frames) FAIL("leaf processed " << graph.get_stats(f).frames << " frames");
+        if (graph.get_stats(c).frames != 0) FAIL("color branch processed depth frames");
+        if (graph.get_stats(l).average_ms < 3.) FAIL("left branch average " << graph.get_stats(l).average_ms << " ms");
+        REQUIRE_THROWS(graph.add_node(std::make_shared<recording_block>(milliseconds(0), running, max_running), -1, stream_filter()));
+        REQUIRE_THROWS(graph.get_stats(5));
+    }
+
+    auto expected = frame_numbers(1, frames);
+    for (auto&& block : { root, left, right, leaf })
+        if (block->seen() != expected) FAIL("a node saw its frames out of order");
+    if (left_output.frames != expected) FAIL("left output out of order");
+    if (leaf_output.frames != expected) FAIL("leaf output out of order");
+    if (!color->seen().empty()) FAIL("color branch saw depth frames");
+    if (max_running < 2) FAIL("no two nodes ran at once");
+}
+
+TEST_CASE("processing graph takes frames from its output callbacks", "[code][filters]")
+{
+    const int frames = 6;
+    frame_source source;
+    source.init(std::shared_ptr<metadata_parser_map>());
+    auto depth = std::make_shared<stream_profile_base>(platform::stream_profile{});
+    depth->set_stream_type(RS2_STREAM_DEPTH);
+
+    std::atomic<int> running(0), max_running(0);
+    auto root = std::make_shared<recording_block>(milliseconds(1), running, max_running);
+    bool wait_threw = false;
+
+    // A single worker, held by the callback while it gives the graph an echo of every frame, with the graph full
+    processing_graph graph(1);
+    auto r = graph.add_node(root, -1, stream_filter());
+    auto on_frame = [&](frame_holder f)
+    {
+        if (f->get_frame_number() > frames) return;
+        graph.invoke(make_graph_frame(source, depth, f->get_frame_number() + frames));
+        try
+        {
+            graph.wait();
+        }
+        catch (const wrong_api_call_sequence_exception&)
+        {
+            wait_threw = true;
+        }
+    };
+    graph.set_output_callback(r, { new internal_frame_callback<decltype(on_frame)>(on_frame), [](rs2_frame_callback* p) { p->release(); } });
+
+    for (int i = 1; i <= frames; i++)
+        graph.invoke(make_graph_frame(source, depth, i));
+    graph.wait();
+
+    auto seen = root->seen();
+    std::sort(seen.begin(), seen.end());
+    if (seen != frame_numbers(1, 2 * frames)) FAIL("the graph processed " << seen.size() << " frames");
+    REQUIRE(wait_threw);
+}
+
+BENCHMARK_TEST_CASE("processing graph throughput", "[filters]")
+{
+    const int frames = 30, branches = 4;
+    const milliseconds delay(5);
+    frame_source source;
+    source.init(std::shared_ptr<metadata_parser_map>());
+    auto depth = std::make_shared<stream_profile_base>(platform::stream_profile{});
+    depth->set_stream_type(RS2_STREAM_DEPTH);
+
+    std::atomic<int> running(0), max_running(0);
+    std::vector<std::shared_ptr<recording_block>> blocks;
+    for (int i = 0; i < branches; i++)
+        blocks.push_back(std::make_shared<recording_block>(delay, running, max_running));
+
+    // The branches one after the other, as chained blocks run them on the thread of the caller
+    graph_output serial_output;
+    for (auto&& block : blocks)
+        block->set_output_callback(serial_output.callback());
+    auto start = high_resolution_clock::now();
+    for (int i = 1; i <= frames; i++)
+    {
+        auto f = make_graph_frame(source, depth, i);
+        for (auto&& block : blocks)
+            block->invoke(f.clone());
+    }
+    auto end = high_resolution_clock::now();
+
+    benchmark_table table({ std::to_string(branches) + " branches of " + std::to_string(delay.count()) + " ms", "threads", "ms per frame", "node wait ms" });
+    table.row("serial", 1, elapsed_ms(start, end) / frames, "-");
+
+    for (unsigned int threads : { 1u, 2u, 4u })
+    {
+        processing_graph graph(threads);
+        for (auto&& block : blocks)
+            graph.add_node(block, -1, stream_filter());
+        start = high_resolution_clock::now();
+        for (int i = 1; i <= frames; i++)
+            graph.invoke(make_graph_frame(source, depth, i));
+        graph.wait();
+        end = high_resolution_clock::now();
+        table.row("graph", threads, elapsed_ms(start, end) / frames, graph.get_stats(0).average_wait_ms);
+    }
+}
+
+TEST_CASE("pipelined processing block overlaps its stages and keeps every stage in order", "[code][filters]")
+{
+    const int frames = 12;
+    frame_source source;
+    source.init(std::shared_ptr<metadata_parser_map>());
+    auto depth = std::make_shared<stream_profile_base>(platform::stream_profile{});
+    depth->set_stream_type(RS2_STREAM_DEPTH);
+
+    std::atomic<int> running(0), max_running(0);
+    std::vector<std::shared_ptr<recording_block>> stages;
+    for (int delay : { 1, 3, 2 })
+        stages.push_back(std::make_shared<recording_block>(milliseconds(delay), running, max_running));
+    graph_output output;
+
+    {
+        pipelined_processing_block pipelined({ stages.begin(), stages.end() }, 1);
+        pipelined.set_output_callback(output.callback());
+        for (int i = 1; i <= frames; i++)
+            pipelined.invoke(make_graph_frame(source, depth, i));
+        pipelined.wait();
+
+        REQUIRE_THROWS(pipelined_processing_block({ stages[0], stages[0] }, 1));
+        REQUIRE_THROWS(pipelined_processing_block({}, 1));
+    }
+
+    // Its frames come from its own workers, after the graph took the node for done
+    processing_graph graph(1);
+    auto pipelined = std::make_shared<pipelined_processing_block>(std::vector<std::shared_ptr<processing_block_interface>>{ stages[0] }, 1);
+    REQUIRE_THROWS(graph.add_node(pipelined, -1, stream_filter()));
+
+    auto expected = frame_numbers(1, frames);
+    for (auto&& stage : stages)
+        if (stage->seen() != expected) FAIL("a stage saw its frames out of order");
+    if (output.frames != expected) FAIL("output out of order");
+    if (max_running < 2) FAIL("no two stages ran at once");
+}
+
+BENCHMARK_TEST_CASE("pipelined processing block throughput", "[filters]")
+{
+    const int frames = 30;
+    frame_source source;
+    source.init(std::shared_ptr<metadata_parser_map>());
+    auto depth = std::make_shared<stream_profile_base>(platform::stream_profile{});
+    depth->set_stream_type(RS2_STREAM_DEPTH);
+
+    // Stage times of the default depth chain at 1280x720, in ms: decimation, to disparity, spatial, temporal, to depth, holes
+    std::vector<int> delays = { 4, 3, 12, 6, 3, 5 };
+    std::atomic<int> running(0), max_running(0);
+    std::vector<std::shared_ptr<recording_block>> stages;
+    for (auto delay : delays)
+        stages.push_back(std::make_shared<recording_block>(milliseconds(delay), running, max_running));
+
+    // The stages chained on the thread of the caller
+    graph_output serial_output;
+    for (size_t i = 0; i + 1 < stages.size(); i++)
+    {
+        auto next = stages[i + 1];
+        auto to_next = [next](frame_holder f) { next->invoke(std::move(f)); };
+        stages[i]->set_output_callback({ new internal_frame_callback<decltype(to_next)>(to_next), [](rs2_frame_callback* p) { p->release(); } });
+    }
+    stages.back()->set_output_callback(serial_output.callback());
+    auto start = high_resolution_clock::now();
+    for (int i = 1; i <= frames; i++)
+        stages.front()->invoke(make_graph_frame(source, depth, i));
+    auto end = high_resolution_clock::now();
+
+    benchmark_table table({ std::to_string(stages.size()) + " stages", "fps" });
+    table.row("chained", frames * 1000. / elapsed_ms(start, end));
+
+    std::vector<std::shared_ptr<processing_block_interface>> blocks(stages.begin(), stages.end());
+    pipelined_processing_block pipelined(blocks, 1);
+    start = high_resolution_clock::now();
+    for (int i = 1; i <= frames; i++)
+        pipelined.invoke(make_graph_frame(source, depth, i));
+    pipelined.wait();
+    end = high_resolution_clock::now();
+    table.row("pipelined", frames * 1000. / elapsed_ms(start, end));
+}
@@ -0,0 +1,181 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#include "catch/catch.hpp"
+#include "image.h"
+#include "cpu-dispatch.h"
+#include "internal-tests-benchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <vector>
+
+using namespace librealsense;
+using namespace std::chrono;
+
+typedef void(*unpack_function)(byte * const d[], const byte * s, int w, int h, int actual_size);
+
+struct unpacker
+{
+    const char* name;
+    unpack_function unpack;
+    int in_bits;    // Bits per pixel of the packed input
+    int out_bpp;
+    int max_error;  // Allowed deviation of the SIMD paths from the scalar reference
+};
+
+static const std::vector<unpacker> yuy2_unpackers = {
+    { "yuy2_y8", unpack_yuy2_y8, 16, 1, 0 },
+    { "yuy2_y16", unpack_yuy2_y16, 16, 2, 0 },
+    { "yuy2_rgb8", unpack_yuy2_rgb8, 16, 3, 2 },
+    { "yuy2_rgba8", unpack_yuy2_rgba8, 16, 4, 2 },
+    { "yuy2_bgr8", unpack_yuy2_bgr8, 16, 3, 2 },
+    { "yuy2_bgra8", unpack_yuy2_bgra8, 16, 4, 2 },
+};
+
+static const std::vector<unpacker> ir_unpackers = {
+    { "y10bpack", unpack_y10bpack, 10, 2, 0 },
+    { "y8_from_rw10", unpack_y8_from_rw10, 10, 1, 0 },
+    { "rw10_from_rw8", unpack_rw10_from_rw8, 16, 1, 0 },
+    { "y8_from_y16_10", unpack_y8_from_y16_10, 16, 1, 0 },
+    { "y16_from_y16_10", unpack_y16_from_y16_10, 16, 2, 0 },
+    { "y16_from_y8", unpack_y16_from_y8, 8, 2, 0 },
+};
+
+static std::vector<byte> make_test_image(size_t size)
+{
+    std::vector<byte> image(size);
+    srand(1);
+    for (auto&& b : image) b = static_cast<byte>(rand());
+    return image;
+}
+
+// Restores the dispatch level selected at load time when the test ends
+struct simd_level_guard
+{
+    simd_level_guard() : _level(get_simd_level()) {}
+    ~simd_level_guard() { set_simd_level(_level); }
+    simd_level _level;
+};
+
+static std::vector<byte> unpack(const unpacker& u, const std::vector<byte>& src, int w, int h)
+{
+    std::vector<byte> out(w * h * u.out_bpp);
+    byte* dest[] = { out.data() };
+    u.unpack(dest, src.data(), w, h, static_cast<int>(src.size()));
+    return out;
+}
+
+static size_t input_size(const unpacker& u, int w, int h)
+{
+    return size_t(w) * h * u.in_bits / 8;
+}
+
+TEST_CASE("simd_level override is clamped to the CPU", "[code][image]")
+{
+    simd_level_guard guard;
+    auto detected = detect_simd_level();
+
+    REQUIRE(set_simd_level(simd_level::scalar) == simd_level::scalar);
+    REQUIRE(get_simd_level() == simd_level::scalar);
+    REQUIRE(set_simd_level(simd_level::avx512) == detected);
+    REQUIRE(get_simd_level() == detected);
+}
+
+TEST_CASE("yuy2 unpackers agree across simd levels", "[code][image]")
+{
+    simd_level_guard guard;
+    const int w = 640, h = 480;
+
+    for (auto&& u : yuy2_unpackers)
+    {
+        CAPTURE(u.name);
+        auto src = make_test_image(input_size(u, w, h));
+        set_simd_level(simd_level::scalar);
+        auto reference = unpack(u, src, w, h);
+
+        std::vector<byte> previous;
+        for (int i = 1; i < static_cast<int>(simd_level::count); i++)
+        {
+            auto level = set_simd_level(static_cast<simd_level>(i));
+            if (level != static_cast<simd_level>(i)) break;
+            CAPTURE(get_string(level));
+
+            auto result = unpack(u, src, w, h);
+            int max_error = 0;
+            for (size_t j = 0; j < result.size(); j++)
+                max_error = std::max(max_error, std::abs(result[j] - reference[j]));
+            REQUIRE(max_error <= u.max_error);
+
+            // The YUY2 kernels start at SSSE3 and share one arithmetic, so they must match each other exactly
+            if (level < simd_level::ssse3) continue;
+            if (!previous.empty())
+            {
+                auto same_as_previous_level = result == previous;
+                REQUIRE(same_as_previous_level);
+            }
+            previous = result;
+        }
+    }
+}
+
+TEST_CASE("10-bit and IR unpackers are bit-exact across simd levels", "[code][image]")
+{
+    simd_level_guard guard;
+
+    // Sizes that are not a multiple of the vector widths exercise the scalar tail
+    const std::vector<std::pair<int, int>> resolutions = { { 1280, 720 }, { 848, 100 }, { 1028, 3 }, { 4, 1 } };
+
+    for (auto&& u : ir_unpackers)
+    {
+        for (auto&& res : resolutions)
+        {
+            CAPTURE(u.name);
+            CAPTURE(res.first);
+            CAPTURE(res.second);
+            // Exact-size buffer, so a kernel reading past the image is caught by sanitizers
+            auto src = make_test_image(input_size(u, res.first, res.second));
+
+            set_simd_level(simd_level::scalar);
+            auto reference = unpack(u, src, res.first, res.second);
+
+            for (int i = 1; i < static_cast<int>(simd_level::count); i++)
+            {
+                auto level = set_simd_level(static_cast<simd_level>(i));
+                if (level != static_cast<simd_level>(i)) break;
+                CAPTURE(get_string(level));
+
+                auto same_as_scalar = unpack(u, src, res.first, res.second) == reference;
+                REQUIRE(same_as_scalar);
+            }
+        }
+    }
+}
+
+BENCHMARK_TEST_CASE("unpackers throughput per simd level", "[image]")
+{
+    simd_level_guard guard;
+    const int w = 1920, h = 1080, iterations = 50;
+
+    benchmark_table table({ "Unpacker", "Level", "Mpixel/s" });
+
+    auto all_unpackers = yuy2_unpackers;
+    all_unpackers.insert(all_unpackers.end(), ir_unpackers.begin(), ir_unpackers.end());
+    for (auto&& u : all_unpackers)
+    {
+        auto src = make_test_image(input_size(u, w, h));
+        std::vector<byte> out(w * h * u.out_bpp);
+        byte* dest[] = { out.data() };
+        for (int i = 0; i < static_cast<int>(simd_level::count); i++)
+        {
+            auto level = set_simd_level(static_cast<simd_level>(i));
+            if (level != static_cast<simd_level>(i)) break;
+
+            auto start = high_resolution_clock::now();
+            for (int k = 0; k < iterations; k++)
+                u.unpack(dest, src.data(), w, h, static_cast<int>(src.size()));
+            table.row(u.name, get_string(level), double(w) * h * iterations / elapsed_ms(start) / 1e3);
+        }
+    }
+}
@@ -0,0 +1,444 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#include "catch/catch.hpp"
+#include "proc/avx/avx-pointcloud.h"
+#include "proc/sse/sse-pointcloud.h"
+#include "proc/voxel-filter.h"
+#include "proc/occlusion-filter.h"
+#include "cpu-dispatch.h"
+#include "internal-tests-benchmark.h"
+#include "../include/librealsense2/rsutil.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <tuple>
+#include <vector>
+
+using namespace librealsense;
+using namespace std::chrono;
+
+static const rs2_extrinsics pointcloud_depth_to_color = {
+    { 0.99998f, -0.00564f, 0.00312f, 0.00563f, 0.99998f, 0.00291f, -0.00314f, -0.00289f, 0.99999f },
+    { 0.0148f, 0.00021f, 0.00043f } };
+
+// Every model rs2_deproject_pixel_to_point accepts, 851 columns leave a scalar tail in every band
+static const std::vector<rs2_intrinsics> pointcloud_depth_models = {
+    { 848, 480, 423.9f, 239.6f, 421.2f, 421.2f, RS2_DISTORTION_BROWN_CONRADY, { 0, 0, 0, 0, 0 } },
+    { 851, 101, 425.3f, 50.2f, 400.f, 400.f, RS2_DISTORTION_NONE, { 0, 0, 0, 0, 0 } },
+    { 640, 480, 318.2f, 241.1f, 385.7f, 385.7f, RS2_DISTORTION_INVERSE_BROWN_CONRADY, { 0.01f, 0.02f, 0.001f, 0.001f, 0.003f } },
+    { 851, 101, 425.3f, 50.2f, 285.7f, 285.9f, RS2_DISTORTION_FTHETA, { 0.95f, 0, 0, 0, 0 } },
+    { 851, 101, 425.3f, 50.2f, 285.7f, 285.9f, RS2_DISTORTION_KANNALA_BRANDT4, { -0.006f, 0.04f, -0.037f, 0.006f, 0 } },
+};
+
+static const std::vector<rs2_intrinsics> pointcloud_texture_models = {
+    { 1920, 1080, 961.5f, 547.3f, 1384.6f, 1382.9f, RS2_DISTORTION_NONE, { 0, 0, 0, 0, 0 } },
+    { 1920, 1080, 961.5f, 547.3f, 1384.6f, 1382.9f, RS2_DISTORTION_BROWN_CONRADY, { 0.05f, -0.07f, 0.001f, -0.002f, 0.01f } },
+    { 1920, 1080, 961.5f, 547.3f, 1384.6f, 1382.9f, RS2_DISTORTION_INVERSE_BROWN_CONRADY, { 0.05f, -0.07f, 0.001f, -0.002f, 0.01f } },
+    { 640, 360, 321.4f, 181.9f, 462.3f, 461.8f, RS2_DISTORTION_MODIFIED_BROWN_CONRADY, { 0.12f, -0.25f, 0.0005f, 0.0007f, 0.1f } },
+    { 848, 800, 424.1f, 400.3f, 285.7f, 285.9f, RS2_DISTORTION_FTHETA, { 0.95f, 0, 0, 0, 0 } },
+    { 800, 848, 400.3f, 424.1f, 285.7f, 285.9f, RS2_DISTORTION_KANNALA_BRANDT4, { -0.006f, 0.04f, -0.037f, 0.006f, 0 } },
+};
+
+static std::vector<uint16_t> make_pointcloud_depth(const rs2_intrinsics& depth)
+{
+    std::vector<uint16_t> z(depth.width * depth.height);
+    srand(3);
+    for (auto&& p : z) p = (rand() % 10) ? static_cast<uint16_t>(200 + rand() % 5800) : 0;
+    return z;
+}
+
+struct pointcloud_simd_guard
+{
+    pointcloud_simd_guard() : _level(get_simd_level()) {}
+    ~pointcloud_simd_guard() { set_simd_level(_level); }
+    simd_level _level;
+};
+
+TEST_CASE("multithreaded pointcloud matches rsutil", "[code][pointcloud]")
+{
+    pointcloud_simd_guard guard;
+    const float depth_scale = 0.001f;
+    thread_pool pool(4);
+
+    for (auto&& depth : pointcloud_depth_models)
+    {
+        CAPTURE(depth.model);
+        CAPTURE(depth.width);
+        auto z = make_pointcloud_depth(depth);
+        auto size = depth.width * depth.height;
+
+        std::vector<float3> reference(size);
+        for (int y = 0; y < depth.height; ++y)
+            for (int x = 0; x < depth.width; ++x)
+            {
+                const float pixel[] = { (float)x, (float)y };
+                rs2_deproject_pixel_to_point(&reference[y * depth.width + x].x, &depth, pixel, depth_scale * z[y * depth.width + x]);
+            }
+
+        pointcloud_transform_avx transform(depth, pool);
+        for (int i = 0; i < static_cast<int>(simd_level::count); i++)
+        {
+            auto level = set_simd_level(static_cast<simd_level>(i));
+            if (level != static_cast<simd_level>(i)) break;
+            CAPTURE(get_string(level));
+
+            std::vector<float3> points(size);
+            transform.depth_to_points(points.data(), z.data(), depth_scale);
+            auto same_as_scalar = !memcmp(points.data(), reference.data(), size * sizeof(float3));
+            REQUIRE(same_as_scalar);
+        }
+    }
+}
+
+TEST_CASE("multithreaded texture map matches rsutil", "[code][pointcloud]")
+{
+    pointcloud_simd_guard guard;
+    const float depth_scale = 0.001f;
+    thread_pool pool(4);
+    auto&& depth = pointcloud_depth_models[1];
+    auto z = make_pointcloud_depth(depth);
+    auto size = depth.width * depth.height;
+
+    pointcloud_transform_avx transform(depth, pool);
+    std::vector<float3> points(size);
+    transform.depth_to_points(points.data(), z.data(), depth_scale);
+
+    for (auto&& other : pointcloud_texture_models)
+    {
+        CAPTURE(other.model);
+        std::vector<float2> reference_pixels(size), reference_tex(size);
+        for (int i = 0; i < size; ++i)
+        {
+            if (!points[i].z) continue;
+            float3 trans;
+            rs2_transform_point_to_point(&trans.x, &pointcloud_depth_to_color, &points[i].x);
+            rs2_project_point_to_pixel(&reference_pixels[i].x, &other, &trans.x);
+            reference_tex[i] = { reference_pixels[i].x / other.width, reference_pixels[i].y / other.height };
+        }
+
+        // The arctangent of the fisheye models is approximated in the vector path
+        auto exact = other.model != RS2_DISTORTION_FTHETA && other.model != RS2_DISTORTION_KANNALA_BRANDT4;
+
+        for (int i = 0; i < static_cast<int>(simd_level::count); i++)
+        {
+            auto level = set_simd_level(static_cast<simd_level>(i));
+            if (level != static_cast<simd_level>(i)) break;
+            CAPTURE(get_string(level));
+
+            std::vector<float2> pixels(size, float2{ -1.f, -1.f }), tex(size, float2{ -1.f, -1.f });
+            transform.get_texture_map(tex.data(), pixels.data(), points.data(), other, pointcloud_depth_to_color);
+            if (exact)
+            {
+                auto same_pixels = !memcmp(pixels.data(), reference_pixels.data(), size * sizeof(float2));
+                auto same_tex = !memcmp(tex.data(), reference_tex.data(), size * sizeof(float2));
+                REQUIRE(same_pixels);
+                REQUIRE(same_tex);
+            }
+            else
+            {
+                float max_error = 0;
+                for (int k = 0; k < size; ++k)
+                {
+                    max_error = std::max(max_error, std::fabs(pixels[k].x - reference_pixels[k].x));
+                    max_error = std::max(max_error, std::fabs(pixels[k].y - reference_pixels[k].y));
+                }
+                REQUIRE(max_error < 0.01f);
+            }
+        }
+    }
+}
+
+BENCHMARK_TEST_CASE("pointcloud throughput per simd level", "[pointcloud]")
+{
+    pointcloud_simd_guard guard;
+    const float depth_scale = 0.001f;
+    const int iterations = 30;
+    auto&& depth = pointcloud_depth_models[0];
+    auto&& other = pointcloud_texture_models[2];
+    auto z = make_pointcloud_depth(depth);
+    auto size = depth.width * depth.height;
+    std::vector<float3> points(size);
+    std::vector<float2> pixels(size), tex(size);
+
+    benchmark_table table({ "Pointcloud", "Level", "Threads", "deproject ms", "texture ms" });
+
+    auto start = high_resolution_clock::now();
+    for (int k = 0; k < iterations; k++)
+        for (int y = 0; y < depth.height; ++y)
+            for (int x = 0; x < depth.width; ++x)
+            {
+                const float pixel[] = { (float)x, (float)y };
+                rs2_deproject_pixel_to_point(&points[y * depth.width + x].x, &depth, pixel, depth_scale * z[y * depth.width + x]);
+            }
+    auto deproject = elapsed_ms(start);
+    start = high_resolution_clock::now();
+    for (int k = 0; k < iterations; k++)
+        for (int i = 0; i < size; ++i)
+        {
+            if (!points[i].z) continue;
+            float3 trans;
+            rs2_transform_point_to_point(&trans.x, &pointcloud_depth_to_color, &points[i].x);
+            rs2_project_point_to_pixel(&pixels[i].x, &other, &trans.x);
+            tex[i] = { pixels[i].x / other.width, pixels[i].y / other.height };
+        }
+    auto texture = elapsed_ms(start);
+    table.row("rsutil", "scalar", 1, deproject / iterations, texture / iterations);
+
+#ifdef __SSSE3__
+    // Undistorted depth, so the unit-depth rays are what pointcloud_sse precomputes
+    std::vector<float> map_x(size), map_y(size);
+    for (int y = 0; y < depth.height; ++y)
+        for (int x = 0; x < depth.width; ++x)
+        {
+            map_x[y * depth.width + x] = (x - depth.ppx) / depth.fx;
+            map_y[y * depth.width + x] = (y - depth.ppy) / depth.fy;
+        }
+    start = high_resolution_clock::now();
+    for (int k = 0; k < iterations; k++)
+        deproject_depth_sse(&points[0].x, z.data(), map_x.data(), map_y.data(), size, depth_scale);
+    deproject = elapsed_ms(start);
+    start = high_resolution_clock::now();
+    for (int k = 0; k < iterations; k++)
+        get_texture_map_sse(&tex[0].x, &pixels[0].x, &points[0].x, size, other, pointcloud_depth_to_color);
+    texture = elapsed_ms(start);
+    table.row("pointcloud_sse", "ssse3", 1, deproject / iterations, texture / iterations);
+#endif
+
+    for (unsigned int threads : { 1u, 4u })
+    {
+        thread_pool pool(threads);
+        pointcloud_transform_avx transform(depth, pool);
+        for (int i = 0; i < static_cast<int>(simd_level::count); i++)
+        {
+            auto level = set_simd_level(static_cast<simd_level>(i));
+            if (level != static_cast<simd_level>(i)) break;
+
+            start = high_resolution_clock::now();
+            for (int k = 0; k < iterations; k++)
+                transform.depth_to_points(points.data(), z.data(), depth_scale);
+            deproject = elapsed_ms(start);
+            start = high_resolution_clock::now();
+            for (int k = 0; k < iterations; k++)
+                transform.get_texture_map(tex.data(), pixels.data(), points.data(), other, pointcloud_depth_to_color);
+            texture = elapsed_ms(start);
+            table.row("pointcloud_avx", get_string(level), threads, deproject / iterations, texture / iterations);
+        }
+    }
+}
+
+TEST_CASE("vectorized occlusion scan matches the scalar scan", "[code][pointcloud]")
+{
+    pointcloud_simd_guard guard;
+    thread_pool pool(4);
+    auto&& depth = pointcloud_depth_models[1];
+    auto&& other = pointcloud_texture_models[0];
+    auto z = make_pointcloud_depth(depth);
+    auto size = depth.width * depth.height;
+
+    pointcloud_transform_avx transform(depth, pool);
+    std::vector<float3> points(size);
+    std::vector<float2> pixels(size), tex(size);
+    transform.depth_to_points(points.data(), z.data(), 0.001f);
+    transform.get_texture_map(tex.data(), pixels.data(), points.data(), other, pointcloud_depth_to_color);
+
+    // Ties with the running maximum and NaN texels send their rows back to the scalar scan
+    for (int y = 0; y < depth.height; y += 3)
+    {
+        auto i = y * depth.width + 5 + y % 7;
+        pixels[i + 1].x = pixels[i].x;
+        points[i + 1].z = points[i].z + (y % 2 ? 0.2f : 0.f);
+        points[i].z = points[i].z ? points[i].z : 1.f;
+        if (y % 9 == 0) pixels[i + 20].x = std::numeric_limits<float>::quiet_NaN();
+    }
+
+    occlusion_filter filter;
+    filter.set_depth_intrinsics(depth);
+    filter.set_mode(occlusion_monotonic_scan);
+
+    set_simd_level(simd_level::scalar);
+    auto reference = tex;
+    filter.process(points.data(), reference.data(), pixels);
+    auto occluded = std::count_if(reference.begin(), reference.end(), [](const float2& t) { return !t.x && !t.y; });
+    REQUIRE(occluded > size / 20);
+
+    for (int i = 1; i < static_cast<int>(simd_level::count); i++)
+    {
+        auto level = set_simd_level(static_cast<simd_level>(i));
+        if (level != static_cast<simd_level>(i)) break;
+        CAPTURE(get_string(level));
+
+        auto result = tex;
+        filter.process(points.data(), result.data(), pixels);
+        REQUIRE(!memcmp(result.data(), reference.data(), size * sizeof(float2)));
+    }
+}
+
+BENCHMARK_TEST_CASE("occlusion filter cost", "[pointcloud]")
+{
+    pointcloud_simd_guard guard;
+    const int iterations = 30;
+    const rs2_intrinsics depth = { 1280, 720, 641.2f, 358.9f, 642.5f, 642.5f, RS2_DISTORTION_BROWN_CONRADY, { 0, 0, 0, 0, 0 } };
+    auto&& other = pointcloud_texture_models[0];
+    auto size = depth.width * depth.height;
+
+    // A wall at 3m behind a row of boxes at 0.8m, so every line crosses a few occlusion shadows
+    std::vector<uint16_t> z(size);
+    for (int y = 0; y < depth.height; ++y)
+        for (int x = 0; x < depth.width; ++x)
+            z[y * depth.width + x] = ((x / 160) % 2 && y > 200 && y < 600) ? 800 : ((x * 7 + y) % 23 ? 3000 : 0);
+
+    thread_pool pool(4);
+    pointcloud_transform_avx transform(depth, pool);
+    std::vector<float3> points(size);
+    std::vector<float2> pixels(size), tex(size);
+
+    benchmark_table table({ "Occlusion", "Level", "pointcloud ms", "filter ms" });
+
+    occlusion_filter filter;
+    filter.set_depth_intrinsics(depth);
+    filter.set_texel_intrinsics(other);
+    for (int i = 0; i < static_cast<int>(simd_level::count); i++)
+    {
+        auto level = set_simd_level(static_cast<simd_level>(i));
+        if (level != static_cast<simd_level>(i)) break;
+
+        auto start = high_resolution_clock::now();
+        for (int k = 0; k < iterations; k++)
+        {
+            transform.depth_to_points(points.data(), z.data(), 0.001f);
+            transform.get_texture_map(tex.data(), pixels.data(), points.data(), other, pointcloud_depth_to_color);
+        }
+        auto pointcloud = elapsed_ms(start);
+
+        // Invalidated texels only ever turn to zero, so repeated runs over the same map do the same work
+        for (auto mode : { occlusion_monotonic_scan, occlusion_exhaustic_search })
+        {
+            filter.set_mode(mode);
+            start = high_resolution_clock::now();
+            for (int k = 0; k < iterations; k++)
+                filter.process(points.data(), tex.data(), pixels);
+            auto occlusion = elapsed_ms(start);
+            table.row(mode == occlusion_monotonic_scan ? "heuristic" : "exhaustive", get_string(level), pointcloud / iterations, occlusion / iterations);
+        }
+    }
+}
+
+static std::vector<float3> make_cloud(size_t count)
+{
+    std::vector<float3> cloud(count);
+    srand(4);
+    for (auto&& p : cloud)
+    {
+        if (rand() % 4 == 0) { p = { 0, 0, 0 }; continue; }
+        p = { (rand() % 4000 - 2000) * 0.001f, (rand() % 3000 - 1500) * 0.001f, (rand() % 5000 + 200) * 0.001f };
+    }
+    return cloud;
+}
+
+TEST_CASE("voxel grid matches a sorted reduction", "[code][pointcloud]")
+{
+    auto cloud = make_cloud(300000);
+    std::vector<float2> texcoords(cloud.size());
+    for (size_t i = 0; i < cloud.size(); ++i)
+        texcoords[i] = { (i % 640) / 640.f, (i / 640) / 480.f };
+
+    for (auto leaf : { 0.005f, 0.05f })
+    {
+        CAPTURE(leaf);
+        auto inv_leaf = 1.f / leaf;
+        auto cell = [inv_leaf](float c) { return static_cast<int64_t>(std::floor(c * inv_leaf)); };
+
+        // Reference first points, keyed on the voxel
+        std::map<std::tuple<int64_t, int64_t, int64_t>, size_t> first;
+        std::map<std::tuple<int64_t, int64_t, int64_t>, int> members;
+        for (size_t i = 0; i < cloud.size(); ++i)
+        {
+            if (!cloud[i].z) continue;
+            auto key = std::make_tuple(cell(cloud[i].x), cell(cloud[i].y), cell(cloud[i].z));
+            first.insert({ key, i });
+            members[key]++;
+        }
+
+        std::vector<float3> reference_first;
+        for (auto&& v : first) reference_first.push_back(cloud[v.second]);
+        auto by_position = [](const float3& a, const float3& b) { return std::tie(a.x, a.y, a.z) < std::tie(b.x, b.y, b.z); };
+        std::sort(reference_first.begin(), reference_first.end(), by_position);
+
+        std::vector<float3> previous;
+        for (unsigned int threads : { 1u, 4u })
+        {
+            CAPTURE(threads);
+            thread_pool pool(threads);
+            voxel_grid grid(pool);
+
+            auto voxels = grid.reduce(cloud.data(), texcoords.data(), cloud.size(), leaf, voxel_policy::first_hit);
+            REQUIRE(voxels == first.size());
+            std::vector<float3> vertices(voxels);
+            std::vector<float2> tex(voxels);
+            grid.write(vertices.data(), tex.data());
+
+            // The order does not depend on the thread count
+            if (!previous.empty())
+                REQUIRE(!memcmp(previous.data(), vertices.data(), voxels * sizeof(float3)));
+            previous = vertices;
+
+            std::sort(vertices.begin(), vertices.end(), by_position);
+            REQUIRE(!memcmp(vertices.data(), reference_first.data(), voxels * sizeof(float3)));
+
+            voxels = grid.reduce(cloud.data(), texcoords.data(), cloud.size(), leaf, voxel_policy::centroid);
+            REQUIRE(voxels == members.size());
+            grid.write(vertices.data(), tex.data());
+            for (auto&& v : vertices)
+            {
+                // Every centroid lies in a voxel that has points
+                auto key = std::make_tuple(cell(v.x), cell(v.y), cell(v.z));
+                auto inside = members.count(key) > 0;
+                auto on_edge = !inside && (std::fabs(v.x * inv_leaf - std::round(v.x * inv_leaf)) < 1e-3f
+                    || std::fabs(v.y * inv_leaf - std::round(v.y * inv_leaf)) < 1e-3f
+                    || std::fabs(v.z * inv_leaf - std::round(v.z * inv_leaf)) < 1e-3f);
+                REQUIRE((inside || on_edge));
+            }
+        }
+    }
+}
+
+BENCHMARK_TEST_CASE("voxel grid throughput", "[pointcloud]")
+{
+    const int iterations = 10;
+    // A 1280x720 depth image of a wavy wall, surfaces are what real clouds are made of
+    std::vector<float3> cloud;
+    for (int y = 0; y < 720; ++y)
+        for (int x = 0; x < 1280; ++x)
+        {
+            auto z = 1.5f + 0.3f * std::sin(x * 0.01f) * std::cos(y * 0.013f);
+            cloud.push_back({ (x - 640) / 640.f * z, (y - 360) / 640.f * z, z });
+        }
+    std::vector<float2> texcoords(cloud.size());
+    std::vector<float3> vertices(cloud.size());
+    std::vector<float2> tex(cloud.size());
+
+    benchmark_table table({ "Voxel grid", "Leaf mm", "Threads", "Voxels", "ms/frame" });
+    for (unsigned int threads : { 1u, 4u })
+    {
+        thread_pool pool(threads);
+        voxel_grid grid(pool);
+        for (auto leaf : { 0.005f, 0.02f })
+        {
+            size_t voxels = 0;
+            auto start = high_resolution_clock::now();
+            for (int k = 0; k < iterations; k++)
+            {
+                voxels = grid.reduce(cloud.data(), texcoords.data(), cloud.size(), leaf, voxel_policy::centroid);
+                grid.write(vertices.data(), tex.data());
+            }
+            auto elapsed = elapsed_ms(start);
+            table.row("centroid", leaf * 1000, threads, voxels, elapsed / iterations);
+        }
+    }
+}
@@ -0,0 +1,394 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#include "catch/catch.hpp"
+#include "api.h"
+#include "context.h"
+#include "media/record/record_device.h"
+#include "media/ros/ros_reader.h"
+#include <librealsense2/rs.hpp>
+#include <librealsense2/hpp/rs_internal.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    const int width = 16, height = 12;
+
+    // A depth and a color stream of one software sensor, the frames carry the numbers they are given
+    struct software_camera
+    {
+        software_camera() : sensor(dev.add_sensor("Camera"))
+        {
+            rs2_intrinsics intrinsics{ width, height, width / 2.f, height / 2.f, 20.f, 20.f, RS2_DISTORTION_NONE, { 0, 0, 0, 0, 0 } };
+            depth = sensor.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, width, height, 30, 2, RS2_FORMAT_Z16, intrinsics });
+            color = sensor.add_video_stream({ RS2_STREAM_COLOR, 0, 1, width, height, 30, 3, RS2_FORMAT_RGB8, intrinsics });
+            sensor.add_read_only_option(RS2_OPTION_DEPTH_UNITS, 0.001f);
+        }
+
+        void start()
+        {
+            sensor.open({ depth, color });
+            sensor.start([](rs2::frame) {});
+        }
+
+        void stop()
+        {
+            sensor.stop();
+            sensor.close();
+        }
+
+        void push(const rs2::stream_profile& profile, int bpp, int frame_number)
+        {
+            auto pixels = new uint8_t[width * height * bpp];
+            for (int i = 0; i < width * height * bpp; i++)
+                pixels[i] = pixel(frame_number, i);
+            sensor.on_video_frame({ pixels, [](void* p) { delete[] static_cast<uint8_t*>(p); }, width * bpp, bpp,
+                rs2_time_t(frame_number), RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, frame_number, profile.get() });
+        }
+
+        // The pixels follow from the frame number, so a frame read back is checked on its own
+        static uint8_t pixel(unsigned long long frame_number, int i)
+        {
+            return static_cast<uint8_t>(frame_number * 7 + i);
+        }
+
+        rs2::software_device dev;
+        rs2::software_sensor sensor;
+        rs2::stream_profile depth, color;
+    };
+
+    // Records count frames of each stream, numbered first, first + step, ...
+    void record_bag(const std::string& file, int first, int step, int count)
+    {
+        software_camera camera;
+        rs2::recorder recorder(file, camera.dev);
+        camera.start();
+        for (int i = 0; i < count; i++)
+        {
+            camera.push(camera.depth, 2, first + i * step);
+            camera.push(camera.color, 3, first + i * step);
+        }
+        camera.stop();
+    }
+
+    struct played_frame
+    {
+        unsigned long long number;
+        std::vector<uint8_t> data;
+    };
+
+    // The frames of every stream in the order they were played, until the playback stops at the end of the file
+    std::map<rs2_stream, std::vector<played_frame>> play_bag(const std::string& file, unsigned int read_ahead)
+    {
+        rs2::context ctx;
+        auto playback = ctx.load_device(file);
+        playback.set_real_time(false);
+        playback.set_read_ahead(read_ahead);
+
+        std::mutex mutex;
+        std::condition_variable cv;
+        bool stopped = false;
+        std::map<rs2_stream, std::vector<played_frame>> frames;
+        playback.set_status_changed_callback([&](rs2_playback_status status)
+        {
+            if (status != RS2_PLAYBACK_STATUS_STOPPED)
+                return;
+            std::lock_guard<std::mutex> lock(mutex);
+            stopped = true;
+            cv.notify_all();
+        });
+
+        auto sensors = playback.query_sensors();
+        for (auto&& s : sensors)
+            s.open(s.get_stream_profiles());
+        for (auto&& s : sensors)
+        {
+            s.start([&](rs2::frame f)
+            {
+                auto data = static_cast<const uint8_t*>(f.get_data());
+                std::lock_guard<std::mutex> lock(mutex);
+                frames[f.get_profile().stream_type()].push_back({ f.get_frame_number(), { data, data + f.get_data_size() } });
+            });
+        }
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            REQUIRE(cv.wait_for(lock, std::chrono::seconds(30), [&]() { return stopped; }));
+        }
+        for (auto&& s : sensors)
+            s.close();
+        return frames;
+    }
+
+    // Holds every frame write until it is let through, as a writer slower than the sensors does
+    class slow_writer : public librealsense::device_serializer::writer
+    {
+    public:
+        typedef std::pair<rs2_stream, unsigned long long> written_frame;
+
+        slow_writer() : _held(0), _open(false) {}
+
+        void write_device_description(const librealsense::device_serializer::device_snapshot& device_description) override {}
+
+        void write_frame(const librealsense::device_serializer::stream_identifier& stream_id,
+            const librealsense::device_serializer::nanoseconds& timestamp, librealsense::frame_holder&& frame) override
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _held++;
+            _cv.notify_all();
+            _cv.wait(lock, [this]() { return _open; });
+            _written.push_back({ stream_id.stream_type, frame->get_frame_number() });
+            _cv.notify_all();
+        }
+
+        void write_snapshot(uint32_t device_index, const librealsense::device_serializer::nanoseconds& timestamp, rs2_extension type,
+            const std::shared_ptr<librealsense::extension_snapshot>& snapshot) override {}
+        void write_snapshot(const librealsense::device_serializer::sensor_identifier& sensor_id, const librealsense::device_serializer::nanoseconds& timestamp,
+            rs2_extension type, const std::shared_ptr<librealsense::extension_snapshot>& snapshot) override {}
+        void write_notification(const librealsense::device_serializer::sensor_identifier& sensor_id,
+            const librealsense::device_serializer::nanoseconds& timestamp, const librealsense::notification& n) override {}
+        const std::string& get_file_name() const override { return _file_name; }
+        void set_compression_options(uint32_t chunk_size, uint32_t compression_threads) override {}
+
+        // Waits until the write thread is held with the first frame
+        bool wait_for_first_frame()
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            return _cv.wait_for(lock, std::chrono::seconds(5), [this]() { return _held > 0; });
+        }
+
+        // Lets the held frame and all the next ones through
+        void open()
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _open = true;
+            _cv.notify_all();
+        }
+
+        bool wait_for_written(size_t count)
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            return _cv.wait_for(lock, std::chrono::seconds(5), [&]() { return _written.size() >= count; });
+        }
+
+        std::vector<written_frame> get_written()
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            return _written;
+        }
+
+    private:
+        std::mutex _mutex;
+        std::condition_variable _cv;
+        size_t _held;
+        bool _open;
+        std::vector<written_frame> _written;
+        std::string _file_name;
+    };
+
+    // The recorder updates its counters once the writer returns
+    template<class T>
+    bool wait_until(T condition)
+    {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (!condition())
+        {
+            if (std::chrono::steady_clock::now() > deadline)
+                return false;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+    // Number of the depth frame the reader gives first after seeking to frame_number
+    unsigned long long seek_to_frame(librealsense::ros_reader& reader, unsigned long long frame_number)
+    {
+        using namespace librealsense::device_serializer;
+        reader.seek_to_time(reader.find_frame(RS2_STREAM_DEPTH, 0, frame_number));
+        while (true)
+        {
+            auto data = reader.read_next_data();
+            REQUIRE_FALSE(data->is<serialized_end_of_file>());
+            auto frame = data->as<serialized_frame>();
+            if (frame && frame->stream_id.stream_type == RS2_STREAM_DEPTH)
+                return frame->frame->get_frame_number();
+        }
+    }
+}
+
+TEST_CASE("playback plays the same frames with and without read-ahead", "[code][record-playback]")
+{
+    const std::string file = "internal-tests-record-playback-read-ahead.bag";
+    const int count = 40;
+    record_bag(file, 1, 1, count);
+
+    auto without = play_bag(file, 0);
+    auto with = play_bag(file, 16);
+    std::remove(file.c_str());
+
+    for (auto stream : { RS2_STREAM_DEPTH, RS2_STREAM_COLOR })
+    {
+        CAPTURE(stream);
+        auto&& a = without[stream];
+        auto&& b = with[stream];
+        REQUIRE(a.size() == count);
+        REQUIRE(b.size() == count);
+        for (size_t i = 0; i < a.size(); i++)
+        {
+            CAPTURE(i);
+            REQUIRE(a[i].number == i + 1);
+            REQUIRE(b[i].number == a[i].number);
+            REQUIRE(b[i].data == a[i].data);
+
+            auto expected = a[i].data;
+            for (size_t j = 0; j < expected.size(); j++)
+                expected[j] = software_camera::pixel(a[i].number, int(j));
+            REQUIRE(a[i].data == expected);
+        }
+    }
+}
+
+TEST_CASE("ros_reader seeks to frame numbers, also after a reset", "[code][record-playback]")
+{
+    const std::string file = "internal-tests-record-playback-seek.bag";
+    // Even numbers only, so the odd ones are missing from the file
+    const int first = 10, step = 2, count = 25, last = first + step * (count - 1);
+    record_bag(file, first, step, count);
+
+    {
+        auto ctx = std::make_shared<librealsense::context>(librealsense::backend_type::standard);
+        librealsense::ros_reader reader(file, ctx);
+        reader.enable_stream({ { 0, 0, RS2_STREAM_DEPTH, 0 }, { 0, 0, RS2_STREAM_COLOR, 0 } });
+
+        for (int pass = 0; pass < 2; pass++)
+        {
+            CAPTURE(pass);
+            REQUIRE(seek_to_frame(reader, first) == first);
+            REQUIRE(seek_to_frame(reader, first + step * (count / 2)) == first + step * (count / 2));
+            REQUIRE(seek_to_frame(reader, last) == last);
+            // Back from the end, and the frame after a missing number
+            REQUIRE(seek_to_frame(reader, first + 1) == first + step);
+            REQUIRE(seek_to_frame(reader, 0) == first);
+            REQUIRE_THROWS(reader.find_frame(RS2_STREAM_DEPTH, 0, last + 1));
+            REQUIRE_THROWS(reader.find_frame(RS2_STREAM_INFRARED, 0, first));
+
+            // Reopens the file, the frames are found as before
+            reader.reset();
+        }
+    }
+    std::remove(file.c_str());
+}
+
+TEST_CASE("record_device applies its queue policy when the writer falls behind", "[code][record-playback]")
+{
+    typedef slow_writer::written_frame written_frame;
+    const uint64_t depth_size = width * height * 2, color_size = width * height * 3;
+
+    software_camera camera;
+    auto writer = std::make_shared<slow_writer>();
+    auto recorder = std::make_shared<librealsense::record_device>(camera.dev.get()->device, writer);
+    // The recorder waits for its queue when destroyed, so the writer is let through however the test ends
+    struct writer_opener
+    {
+        ~writer_opener() { writer->open(); }
+        std::shared_ptr<slow_writer> writer;
+    } opener{ writer };
+    camera.start();
+
+    // The first frame holds the write thread, the next ones stay queued until the writer is opened
+    camera.push(camera.depth, 2, 1);
+    REQUIRE(writer->wait_for_first_frame());
+
+    SECTION("BLOCK holds the sensor until the writer makes room")
+    {
+        recorder->set_queue_budget(2 * depth_size, RS2_RECORDING_QUEUE_POLICY_BLOCK);
+        camera.push(camera.depth, 2, 2);
+        camera.push(camera.depth, 2, 3);
+
+        std::atomic<bool> pushed(false);
+        std::thread sensor_thread([&]()
+        {
+            camera.push(camera.depth, 2, 4);
+            pushed = true;
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        auto stats = recorder->get_queue_stats();
+        CHECK_FALSE(pushed);
+        CHECK(stats.queued_frames == 2);
+        CHECK(stats.queued_bytes == 2 * depth_size);
+        CHECK(stats.dropped_frames == 0);
+        CHECK(stats.written_bytes == 0);
+
+        writer->open();
+        sensor_thread.join();
+        REQUIRE(pushed);
+        REQUIRE(writer->wait_for_written(4));
+        REQUIRE(writer->get_written() == std::vector<written_frame>({
+            { RS2_STREAM_DEPTH, 1 }, { RS2_STREAM_DEPTH, 2 }, { RS2_STREAM_DEPTH, 3 }, { RS2_STREAM_DEPTH, 4 } }));
+        REQUIRE(wait_until([&]() { return recorder->get_queue_stats().written_bytes == 4 * depth_size; }));
+        stats = recorder->get_queue_stats();
+        REQUIRE(stats.queued_frames == 0);
+        REQUIRE(stats.queued_bytes == 0);
+        REQUIRE(stats.dropped_frames == 0);
+    }
+
+    SECTION("DROP_OLDEST drops the oldest queued frame of the same stream")
+    {
+        recorder->set_queue_budget(color_size + 2 * depth_size, RS2_RECORDING_QUEUE_POLICY_DROP_OLDEST);
+        camera.push(camera.color, 3, 1);
+        camera.push(camera.depth, 2, 2);
+        camera.push(camera.depth, 2, 3);
+        auto stats = recorder->get_queue_stats();
+        REQUIRE(stats.queued_frames == 3);
+        REQUIRE(stats.dropped_frames == 0);
+
+        // The older color frame stays, depth 2 makes room for depth 4
+        camera.push(camera.depth, 2, 4);
+        stats = recorder->get_queue_stats();
+        REQUIRE(stats.queued_frames == 3);
+        REQUIRE(stats.queued_bytes == color_size + 2 * depth_size);
+        REQUIRE(stats.dropped_frames == 1);
+
+        writer->open();
+        REQUIRE(writer->wait_for_written(4));
+        REQUIRE(writer->get_written() == std::vector<written_frame>({
+            { RS2_STREAM_DEPTH, 1 }, { RS2_STREAM_COLOR, 1 }, { RS2_STREAM_DEPTH, 3 }, { RS2_STREAM_DEPTH, 4 } }));
+        REQUIRE(wait_until([&]() { return recorder->get_queue_stats().written_bytes == color_size + 3 * depth_size; }));
+        REQUIRE(recorder->get_queue_stats().queued_bytes == 0);
+    }
+
+    SECTION("DROP_NON_DEPTH_FIRST keeps the depth frames")
+    {
+        recorder->set_queue_budget(depth_size + 2 * color_size, RS2_RECORDING_QUEUE_POLICY_DROP_NON_DEPTH_FIRST);
+        camera.push(camera.depth, 2, 2);
+        camera.push(camera.color, 3, 1);
+        camera.push(camera.color, 3, 2);
+        camera.push(camera.depth, 2, 3);
+        camera.push(camera.color, 3, 3);
+        camera.push(camera.depth, 2, 4);
+        // Nothing but depth is queued, so the new color frame is the one dropped
+        camera.push(camera.color, 3, 4);
+
+        auto stats = recorder->get_queue_stats();
+        REQUIRE(stats.queued_frames == 3);
+        REQUIRE(stats.queued_bytes == 3 * depth_size);
+        REQUIRE(stats.dropped_frames == 4);
+
+        writer->open();
+        REQUIRE(writer->wait_for_written(4));
+        REQUIRE(writer->get_written() == std::vector<written_frame>({
+            { RS2_STREAM_DEPTH, 1 }, { RS2_STREAM_DEPTH, 2 }, { RS2_STREAM_DEPTH, 3 }, { RS2_STREAM_DEPTH, 4 } }));
+        REQUIRE(wait_until([&]() { return recorder->get_queue_stats().written_bytes == 4 * depth_size; }));
+    }
+
+    camera.stop();
+}
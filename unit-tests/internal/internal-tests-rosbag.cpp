@@ -0,0 +1,94 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2019 Intel Corporation. All Rights Reserved.
+
+#include "catch/catch.hpp"
+#include "rosbag/bag.h"
+#include "rosbag/view.h"
+#include "std_msgs/UInt32.h"
+
+#include <cstdio>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace
+{
+    struct bag_settings
+    {
+        rosbag::CompressionType compression;
+        uint32_t threads;
+        uint32_t chunk_threshold;
+    };
+
+    void write_values(const std::string& file, const std::vector<bag_settings>& phases, uint32_t messages_per_phase)
+    {
+        rosbag::Bag bag;
+        bag.open(file, rosbag::bagmode::Write);
+        uint32_t value = 0;
+        for (auto&& p : phases)
+        {
+            bag.setCompression(p.compression);
+            bag.setCompressionThreads(p.threads);
+            bag.setChunkThreshold(p.chunk_threshold);
+
+            for (uint32_t i = 0; i < messages_per_phase; i++, value++)
+            {
+                std_msgs::UInt32 msg;
+                msg.data = value;
+                bag.write("/values", rs2rosinternal::Time(1 + value, 0), msg);
+            }
+        }
+        bag.close();
+    }
+
+    // Values in the order they were read, and the size of all the chunks once uncompressed
+    std::vector<uint32_t> read_back(const std::string& file, uint64_t& uncompressed)
+    {
+        rosbag::Bag bag;
+        bag.open(file, rosbag::bagmode::Read);
+        uncompressed = std::get<2>(bag.getCompressionInfo());
+        rosbag::View view(bag);
+
+        std::vector<uint32_t> values;
+        for (auto&& m : view)
+        {
+            auto msg = m.instantiate<std_msgs::UInt32>();
+            REQUIRE(msg);
+            values.push_back(msg->data);
+        }
+        return values;
+    }
+}
+
+TEST_CASE("bag keeps every message when the compression options change between writes", "[code][rosbag]")
+{
+    const std::string file = "internal-tests-rosbag-options.bag";
+    // Every phase leaves a chunk open, which the next settings have to close
+    const std::vector<bag_settings> phases = {
+        { rosbag::compression::LZ4,          0, 512  },
+        { rosbag::compression::LZ4,          2, 512  },
+        { rosbag::compression::Uncompressed, 0, 1024 },
+        { rosbag::compression::LZ4,          4, 256  },
+        { rosbag::compression::Uncompressed, 2, 512  },
+        { rosbag::compression::LZ4,          0, 1024 },
+        { rosbag::compression::LZ4,          1, 512  },
+    };
+    const uint32_t messages_per_phase = 37;
+
+    write_values(file, phases, messages_per_phase);
+    uint64_t uncompressed = 0;
+    auto values = read_back(file, uncompressed);
+    std::remove(file.c_str());
+
+    REQUIRE(values.size() == phases.size() * messages_per_phase);
+    for (uint32_t i = 0; i < values.size(); i++)
+        REQUIRE(values[i] == i);
+
+    // A chunk carries nothing of the chunks closed before it, so the chunks hold as much as those of a bag written in one go
+    write_values(file, { { rosbag::compression::Uncompressed, 0, 512 } }, uint32_t(values.size()));
+    uint64_t expected = 0;
+    read_back(file, expected);
+    std::remove(file.c_str());
+
+    REQUIRE(uncompressed == expected);
+}
@@ -12,6 +12,7 @@
 #include <librealsense2/hpp/rs_sensor.hpp>
 #include "../../common/tiny-profiler.h"
 #include "./../src/environment.h"
+#include "./../src/frame-archive.h"
 
 using namespace librealsense;
 using namespace librealsense::platform;
@@ -102,3 +103,52 @@ TEST_CASE("copy_2darray", "[code]")
             REQUIRE(src_double[i][j] != tgt_float[i][j]);
         }
 }
+
+struct pooled_buffer
+{
+    std::vector<byte> data;
+    frame_additional_data additional_data;
+};
+
+static pooled_buffer make_pooled_buffer(size_t size)
+{
+    pooled_buffer b;
+    b.data.resize(size);
+    return b;
+}
+
+TEST_CASE("frame pool ages its buffers by return time, at most once per quarter of the age", "[code]")
+{
+    auto stats = std::make_shared<frame_pool_stats>();
+    frame_pool<pooled_buffer> pool(stats);
+
+    // A buffer is stamped with the latest allocation before its return
+    pool.evict(0, 1000);
+    pool.release(make_pooled_buffer(16));
+    pool.evict(300, 1000);
+    pool.release(make_pooled_buffer(32));
+    pool.release(make_pooled_buffer(16));
+
+    pool.evict(1100, 1000);
+    REQUIRE(stats->evictions == 1);
+
+    // The next aging is due at 1350, so the 32 bytes buffer outlives its second until then
+    pool.evict(1320, 1000);
+    REQUIRE(stats->evictions == 1);
+    pool.evict(1400, 1000);
+    REQUIRE(stats->evictions == 3);
+
+    pooled_buffer out;
+    REQUIRE(!pool.acquire(16, out));
+    REQUIRE(!pool.acquire(32, out));
+    REQUIRE(stats->misses == 2);
+
+    // The most recently returned buffer of a size is reused first
+    auto first = make_pooled_buffer(8), second = make_pooled_buffer(8);
+    auto second_data = second.data.data();
+    pool.release(std::move(first));
+    pool.release(std::move(second));
+    REQUIRE(pool.acquire(8, out));
+    REQUIRE(out.data.data() == second_data);
+    REQUIRE(stats->hits == 1);
+}
@@ -4889,6 +4889,7 @@ ADD_ENUM_TEST_CASE(rs2_sr300_visual_preset, RS2_SR300_VISUAL_PRESET_COUNT)
 ADD_ENUM_TEST_CASE(rs2_log_severity, RS2_LOG_SEVERITY_COUNT)
 ADD_ENUM_TEST_CASE(rs2_exception_type, RS2_EXCEPTION_TYPE_COUNT)
 ADD_ENUM_TEST_CASE(rs2_playback_status, RS2_PLAYBACK_STATUS_COUNT)
+ADD_ENUM_TEST_CASE(rs2_recording_queue_policy, RS2_RECORDING_QUEUE_POLICY_COUNT)
 ADD_ENUM_TEST_CASE(rs2_extension, RS2_EXTENSION_COUNT)
 ADD_ENUM_TEST_CASE(rs2_frame_metadata_value, RS2_FRAME_METADATA_COUNT)
 ADD_ENUM_TEST_CASE(rs2_rs400_visual_preset, RS2_RS400_VISUAL_PRESET_COUNT)
@@ -5137,6 +5138,238 @@ TEST_CASE("software-device motion stream", "[software-device]")
 
 }
 
+TEST_CASE("software-device compact pointcloud", "[software-device][pointcloud]")
+{
+    const int W = 640;
+    const int H = 480;
+    const int BPP = 2;
+    const float depth_units = 0.001f;
+
+    rs2::software_device dev;
+    auto sensor = dev.add_sensor("Depth");
+    rs2_intrinsics intrinsics{ W, H, W / 2.f, H / 2.f, 383.f, 383.f, RS2_DISTORTION_BROWN_CONRADY,{ 0,0,0,0,0 } };
+    auto stream_profile = sensor.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, W, H, 30, BPP, RS2_FORMAT_Z16, intrinsics });
+    sensor.add_read_only_option(RS2_OPTION_DEPTH_UNITS, depth_units);
+
+    rs2::syncer sync;
+    sensor.open(stream_profile);
+    sensor.start(sync);
+
+    // A third of the pixels have no depth
+    std::vector<uint16_t> pixels(W * H);
+    for (int i = 0; i < W * H; i++)
+        pixels[i] = (i % 3) ? static_cast<uint16_t>(300 + i % 4000) : 0;
+    sensor.on_video_frame({ pixels.data(), [](void*) {}, W * BPP, BPP, 0, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, 0, stream_profile });
+
+    rs2::frameset fset = sync.wait_for_frames();
+    rs2::depth_frame depth = fset.first_or_default(RS2_STREAM_DEPTH);
+    REQUIRE(depth);
+
+    rs2::pointcloud pc;
+    rs2::points full = pc.calculate(depth);
+    REQUIRE(full.size() == W * H);
+    REQUIRE(full.get_pixel_indices() == nullptr);
+    std::vector<rs2::vertex> full_vertices(full.get_vertices(), full.get_vertices() + full.size());
+
+    pc.set_option(RS2_OPTION_POINTS_COMPACT, 1);
+    pc.set_option(RS2_OPTION_POINTS_PIXEL_INDICES, 1);
+    rs2::points compact = pc.calculate(depth);
+    auto valid = W * H - (W * H + 2) / 3;
+    REQUIRE(compact.size() == valid);
+    REQUIRE(compact.get_data_size() == valid * (sizeof(rs2::vertex) + sizeof(rs2::texture_coordinate) + sizeof(int)));
+    auto indices = compact.get_pixel_indices();
+    REQUIRE(indices);
+    auto vertices = compact.get_vertices();
+    for (int i = 0; i < valid; i++)
+    {
+        REQUIRE(pixels[indices[i]]);
+        REQUIRE(!memcmp(&vertices[i], &full_vertices[indices[i]], sizeof(rs2::vertex)));
+    }
+
+    pc.set_option(RS2_OPTION_POINTS_ENCODING, 1);
+    rs2::points fixed = pc.calculate(depth);
+    REQUIRE(fixed.get_profile().format() == RS2_FORMAT_XYZ16);
+    REQUIRE(fixed.size() == valid);
+    REQUIRE_THROWS(fixed.get_vertices());
+    auto xyz = reinterpret_cast<const int16_t*>(fixed.get_data());
+    for (int i = 0; i < valid; i++)
+    {
+        REQUIRE(uint16_t(xyz[3 * i + 2]) == pixels[fixed.get_pixel_indices()[i]]);
+        REQUIRE(std::abs(xyz[3 * i] * depth_units - full_vertices[fixed.get_pixel_indices()[i]].x) <= depth_units / 2);
+    }
+
+    pc.set_option(RS2_OPTION_POINTS_ENCODING, 2);
+    pc.set_option(RS2_OPTION_POINTS_PIXEL_INDICES, 0);
+    rs2::points half = pc.calculate(depth);
+    REQUIRE(half.get_profile().format() == RS2_FORMAT_XYZ16F);
+    REQUIRE(half.get_pixel_indices() == nullptr);
+    REQUIRE(half.get_data_size() == valid * (3 * sizeof(uint16_t) + sizeof(rs2::texture_coordinate)));
+    auto halves = reinterpret_cast<const uint16_t*>(half.get_data());
+    for (int i = 0; i < valid; i++)
+    {
+        // Normal halves only, coordinates are within [2^-14, 2^16)
+        auto h = halves[3 * i + 2];
+        auto z = std::ldexp(1.f + (h & 0x3ff) / 1024.f, ((h >> 10) & 0x1f) - 15);
+        REQUIRE(std::abs(z - full_vertices[indices[i]].z) <= z / 2048);
+    }
+}
+
+TEST_CASE("software-device fixed point pointcloud keeps the whole depth range", "[software-device][pointcloud]")
+{
+    const int W = 640;
+    const int H = 480;
+    const int BPP = 2;
+    const float depth_units = 0.001f;
+
+    rs2::software_device dev;
+    auto sensor = dev.add_sensor("Depth");
+    rs2_intrinsics intrinsics{ W, H, W / 2.f, H / 2.f, 383.f, 383.f, RS2_DISTORTION_BROWN_CONRADY,{ 0,0,0,0,0 } };
+    auto stream_profile = sensor.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, W, H, 30, BPP, RS2_FORMAT_Z16, intrinsics });
+    sensor.add_read_only_option(RS2_OPTION_DEPTH_UNITS, depth_units);
+
+    rs2::syncer sync;
+    sensor.open(stream_profile);
+    sensor.start(sync);
+
+    // Depth up to the end of the Z16 range, far enough for x and y to leave the signed range near the edges
+    std::vector<uint16_t> pixels(W * H);
+    for (int i = 0; i < W * H; i++)
+        pixels[i] = static_cast<uint16_t>(20000 + (i * 7) % 45536);
+    sensor.on_video_frame({ pixels.data(), [](void*) {}, W * BPP, BPP, 0, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, 0, stream_profile });
+
+    rs2::frameset fset = sync.wait_for_frames();
+    rs2::depth_frame depth = fset.first_or_default(RS2_STREAM_DEPTH);
+    REQUIRE(depth);
+
+    rs2::pointcloud pc;
+    rs2::points full = pc.calculate(depth);
+    std::vector<rs2::vertex> full_vertices(full.get_vertices(), full.get_vertices() + full.size());
+    auto fits = [&](const rs2::vertex& v) { return std::abs(v.x) < 32767.5f * depth_units && std::abs(v.y) < 32767.5f * depth_units; };
+
+    pc.set_option(RS2_OPTION_POINTS_ENCODING, 1);
+    rs2::points fixed = pc.calculate(depth);
+    REQUIRE(fixed.get_profile().format() == RS2_FORMAT_XYZ16);
+    REQUIRE(fixed.size() == W * H);
+    auto xyz = reinterpret_cast<const int16_t*>(fixed.get_data());
+    int deep = 0, out_of_range = 0;
+    for (int i = 0; i < W * H; i++)
+    {
+        if (!fits(full_vertices[i]))
+        {
+            // Flagged as a point without depth rather than clamped
+            out_of_range++;
+            REQUIRE(xyz[3 * i] == 0);
+            REQUIRE(xyz[3 * i + 1] == 0);
+            REQUIRE(xyz[3 * i + 2] == 0);
+            continue;
+        }
+        if (pixels[i] > 32767) deep++;
+        REQUIRE(uint16_t(xyz[3 * i + 2]) == pixels[i]);
+        REQUIRE(std::abs(xyz[3 * i] * depth_units - full_vertices[i].x) <= depth_units / 2);
+        REQUIRE(std::abs(xyz[3 * i + 1] * depth_units - full_vertices[i].y) <= depth_units / 2);
+    }
+    REQUIRE(deep > 0);
+    REQUIRE(out_of_range > 0);
+
+    // Compaction leaves the out of range points out along with the points without depth
+    pc.set_option(RS2_OPTION_POINTS_COMPACT, 1);
+    rs2::points compact = pc.calculate(depth);
+    REQUIRE(compact.size() == W * H - out_of_range);
+}
+
+TEST_CASE("software-device points export", "[software-device][pointcloud]")
+{
+    const int W = 640;
+    const int H = 480;
+    const int BPP = 2;
+
+    rs2::software_device dev;
+    auto sensor = dev.add_sensor("Depth");
+    rs2_intrinsics intrinsics{ W, H, W / 2.f, H / 2.f, 383.f, 383.f, RS2_DISTORTION_BROWN_CONRADY,{ 0,0,0,0,0 } };
+    auto stream_profile = sensor.add_video_stream({ RS2_STREAM_DEPTH, 0, 0, W, H, 30, BPP, RS2_FORMAT_Z16, intrinsics });
+    sensor.add_read_only_option(RS2_OPTION_DEPTH_UNITS, 0.001f);
+
+    rs2::syncer sync;
+    sensor.open(stream_profile);
+    sensor.start(sync);
+
+    // A slanted plane with every third pixel missing
+    std::vector<uint16_t> pixels(W * H);
+    for (int i = 0; i < W * H; i++)
+        pixels[i] = (i % 3) ? static_cast<uint16_t>(1000 + (i % W)) : 0;
+    sensor.on_video_frame({ pixels.data(), [](void*) {}, W * BPP, BPP, 0, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, 7, stream_profile });
+
+    rs2::frameset fset = sync.wait_for_frames();
+    rs2::depth_frame depth = fset.first_or_default(RS2_STREAM_DEPTH);
+    REQUIRE(depth);
+
+    rs2::pointcloud pc;
+    rs2::points cloud = pc.calculate(depth);
+    auto vertices = cloud.get_vertices();
+    auto valid = W * H - (W * H + 2) / 3;
+
+    auto read_file = [](const std::string& name, std::string& header) -> std::vector<char>
+    {
+        std::ifstream in(name, std::ios::binary);
+        std::vector<char> content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        std::string text(content.begin(), content.end());
+        auto end = text.find(text.compare(0, 3, "ply") ? "DATA binary\n" : "end_header\n");
+        REQUIRE(end != std::string::npos);
+        end = text.find('\n', end) + 1;
+        header = text.substr(0, end);
+        return std::vector<char>(content.begin() + end, content.end());
+    };
+
+    std::string folder_name = get_folder_path(special_folder::temp_folder);
+    std::string header;
+
+    // Organized PCD keeps every pixel, the ones without depth as NaN
+    cloud.export_to(folder_name + "points.pcd", rs2::video_frame(rs2::frame()), RS2_POINTS_FILE_FORMAT_PCD, RS2_POINTS_EXPORT_NORMALS);
+    auto pcd = read_file(folder_name + "points.pcd", header);
+    REQUIRE(header.find("FIELDS x y z normal_x normal_y normal_z\n") != std::string::npos);
+    REQUIRE(header.find("WIDTH 640\nHEIGHT 480\n") != std::string::npos);
+    REQUIRE(pcd.size() == size_t(W * H * 6 * sizeof(float)));
+    auto pcd_points = reinterpret_cast<const float*>(pcd.data());
+    for (int i = 0; i < W * H; i++)
+    {
+        if (!pixels[i])
+        {
+            REQUIRE(std::isnan(pcd_points[6 * i + 2]));
+            continue;
+        }
+        REQUIRE(!memcmp(&pcd_points[6 * i], &vertices[i], sizeof(rs2::vertex)));
+        auto nz = pcd_points[6 * i + 5];
+        REQUIRE(nz <= 0.f); // Facing the camera
+    }
+
+    // PLY through the background writer, same content as export_to_ply
+    {
+        rs2::points_exporter exporter(folder_name + "points_");
+        exporter.enqueue(cloud);
+        exporter.flush();
+    }
+    auto ply = read_file(folder_name + "points_7.ply", header);
+    std::stringstream vertex_count;
+    vertex_count << "element vertex " << valid << "\n";
+    REQUIRE(header.find(vertex_count.str()) != std::string::npos);
+    REQUIRE(header.find("element face ") != std::string::npos);
+
+    cloud.export_to_ply(folder_name + "points_sync.ply", rs2::video_frame(rs2::frame()));
+    std::string sync_header;
+    auto sync_ply = read_file(folder_name + "points_sync.ply", sync_header);
+    REQUIRE(sync_header == header);
+    REQUIRE(sync_ply == ply);
+
+    auto ply_points = reinterpret_cast<const float*>(ply.data());
+    for (int i = 0, j = 0; i < W * H; i++)
+    {
+        if (!pixels[i]) continue;
+        REQUIRE(ply_points[3 * j] == vertices[i].x);
+        REQUIRE(ply_points[3 * j + 2] == -vertices[i].z);
+        j++;
+    }
+}
+
 TEST_CASE("Record software-device", "[software-device][record][!mayfail]")
 {
     const int W = 640;
@@ -176,6 +176,13 @@ PYBIND11_MODULE(NAME, m) {
     BIND_ENUM(m, rs2_timestamp_domain, RS2_TIMESTAMP_DOMAIN_COUNT, "Specifies the clock in relation to which the frame timestamp was measured.")
     BIND_ENUM(m, rs2_distortion, RS2_DISTORTION_COUNT, "Distortion model: defines how pixel coordinates should be mapped to sensor coordinates.")
     BIND_ENUM(m, rs2_playback_status, RS2_PLAYBACK_STATUS_COUNT, "") // No docstring in C++
+    BIND_ENUM(m, rs2_points_file_format, RS2_POINTS_FILE_FORMAT_COUNT, "File formats a points frame can be exported to.")
+
+    py::enum_<rs2_points_export_flags> points_export_flags(m, "points_export_flags", py::arithmetic(), "Content of an exported points file, combined bitwise.");
+    points_export_flags.value("drop_invalid", RS2_POINTS_EXPORT_DROP_INVALID)
+        .value("colors", RS2_POINTS_EXPORT_COLORS)
+        .value("normals", RS2_POINTS_EXPORT_NORMALS)
+        .value("faces", RS2_POINTS_EXPORT_FACES);
 
     py::class_<rs2_extrinsics> extrinsics(m, "extrinsics", "Cross-stream extrinsics: encodes the topology describing how the different devices are oriented.");
     extrinsics.def(py::init<>())
@@ -550,8 +557,17 @@ PYBIND11_MODULE(NAME, m) {
             }
         }, "Retrieve the texture coordinates (uv map) for the point cloud", py::keep_alive<0, 1>(), "dims"_a=1)
         .def("export_to_ply", &rs2::points::export_to_ply, "Export the point cloud to a PLY file")
+        .def("export_to", &rs2::points::export_to, "Export the point cloud to a binary PLY or PCD file, flags combine points_export_flags",
+            "fname"_a, "texture"_a, "format"_a, "flags"_a = RS2_POINTS_EXPORT_DROP_INVALID | RS2_POINTS_EXPORT_COLORS | RS2_POINTS_EXPORT_FACES)
         .def("size", &rs2::points::size); // No docstring in C++
 
+    py::class_<rs2::points_exporter> points_exporter(m, "points_exporter", "Writes point clouds to <prefix><frame number>.ply or .pcd on a background thread.");
+    points_exporter.def(py::init<const std::string&, rs2_points_file_format, int, int>(), "prefix"_a, "format"_a = RS2_POINTS_FILE_FORMAT_PLY,
+            "flags"_a = RS2_POINTS_EXPORT_DROP_INVALID | RS2_POINTS_EXPORT_COLORS | RS2_POINTS_EXPORT_FACES, "capacity"_a = 4)
+        .def("enqueue", &rs2::points_exporter::enqueue, "Queue a point cloud for export, blocks only while the queue is full",
+            "points"_a, "texture"_a = rs2::video_frame(rs2::frame()), py::call_guard<py::gil_scoped_release>())
+        .def("flush", &rs2::points_exporter::flush, "Wait until every queued point cloud is written", py::call_guard<py::gil_scoped_release>());
+
     // TODO: Deprecate composite_frame, replace with frameset
     py::class_<rs2::frameset, rs2::frame> frameset(m, "composite_frame", "Extends the frame class with additional frameset related attributes and functions");
     frameset.def(py::init<rs2::frame>())
@@ -672,6 +688,9 @@ PYBIND11_MODULE(NAME, m) {
         .def(BIND_DOWNCAST(filter, temporal_filter))
         .def(BIND_DOWNCAST(filter, threshold_filter))
         .def(BIND_DOWNCAST(filter, zero_order_invalidation))
+        .def(BIND_DOWNCAST(filter, voxel_filter))
+        .def(BIND_DOWNCAST(filter, depth_lut_transform))
+        .def(BIND_DOWNCAST(filter, depth_post_processing_chain))
         .def("__nonzero__", &rs2::filter::operator bool); // No docstring in C++
     // get_queue?
     // is/as?
@@ -774,6 +793,50 @@ PYBIND11_MODULE(NAME, m) {
     py::class_<rs2::zero_order_invalidation, rs2::filter> zero_order_invalidation(m, "zero_order_invalidation", "Fixes the zero order artifact");
     zero_order_invalidation.def(py::init<>());
 
+    py::class_<rs2::voxel_filter, rs2::filter> voxel_filter(m, "voxel_filter", "Downsamples a point cloud to a single point for every occupied voxel");
+    voxel_filter.def(py::init<>())
+        .def(py::init<float>(), "leaf_size"_a);
+
+    py::class_<rs2::depth_lut_transform, rs2::filter> depth_lut_transform(m, "depth_lut_transform", "Thresholds depth and converts it to disparity or meters in a single pass");
+    depth_lut_transform.def(py::init<>())
+        .def(py::init<float, float, rs2_format>(), "min_dist"_a, "max_dist"_a, "format"_a);
+
+    py::class_<rs2::depth_post_processing_chain, rs2::filter> depth_post_processing_chain(m, "depth_post_processing_chain", "Runs decimation, "
+                                                                                         "spatial, temporal and hole filling filters as a single block, following the options of the given filters");
+    depth_post_processing_chain.def(py::init<rs2::decimation_filter, rs2::spatial_filter, rs2::temporal_filter, rs2::hole_filling_filter>(),
+                                    "decimation"_a, "spatial"_a, "temporal"_a, "hole_filling"_a);
+
+    py::class_<rs2::pipelined_processing_block, rs2::processing_block> pipelined_processing_block(m, "pipelined_processing_block", "Runs a chain of "
+                                                                                               "processing blocks with every stage on a worker of its own.");
+    pipelined_processing_block.def(py::init([](const std::vector<rs2::processing_block>& stages, int queue_size) {
+            return new rs2::pipelined_processing_block({ stages.begin(), stages.end() }, queue_size);
+        }), "stages"_a, "queue_size"_a = 1)
+        .def(py::init<rs2::processing_block>(), "block"_a)
+        .def("invoke", &rs2::processing_block::invoke, "Queue a frame at the first stage.", "f"_a, py::call_guard<py::gil_scoped_release>());
+
+    py::class_<rs2_processing_node_stats> processing_node_stats(m, "processing_node_stats", "Latency of a node of a processing graph.");
+    processing_node_stats.def(py::init<>())
+        .def_readonly("frames", &rs2_processing_node_stats::frames, "Frames processed by the node")
+        .def_readonly("average_ms", &rs2_processing_node_stats::average_ms, "Average processing time of the block, in milliseconds")
+        .def_readonly("max_ms", &rs2_processing_node_stats::max_ms, "Longest processing time of the block, in milliseconds")
+        .def_readonly("average_wait_ms", &rs2_processing_node_stats::average_wait_ms, "Average time frames waited in the queue of the node, in milliseconds");
+
+    py::class_<rs2::processing_graph> processing_graph(m, "processing_graph", "Runs processing blocks as the nodes of a tree, "
+                                                       "independent nodes concurrently on a shared pool of workers.");
+    processing_graph.def(py::init<int>(), "threads"_a = 0)
+        .def("add", &rs2::processing_graph::add, "Add a processing block fed by the frames of parent, -1 for the frames given to invoke, "
+             "that pass the stream filter of the edge. Returns the node of the block.", "block"_a, "parent"_a = -1,
+             "stream"_a = RS2_STREAM_ANY, "format"_a = RS2_FORMAT_ANY, "index"_a = -1)
+        .def("start", [](rs2::processing_graph& self, int node, std::function<void(rs2::frame)> f) {
+            self.start(node, f);
+        }, "Receive the frames of a node with a callback, called on the worker that ran the node.", "node"_a, "callback"_a)
+        .def("start", [](rs2::processing_graph& self, int node, rs2::frame_queue queue) {
+            self.start(node, queue);
+        }, "Send the frames of a node to a frame queue.", "node"_a, "queue"_a)
+        .def("invoke", &rs2::processing_graph::invoke, "Queue a frame at the roots of the graph.", "f"_a, py::call_guard<py::gil_scoped_release>())
+        .def("wait", &rs2::processing_graph::wait, "Wait until all the frames given to invoke went through the graph.", py::call_guard<py::gil_scoped_release>())
+        .def("get_stats", &rs2::processing_graph::get_stats, "Retrieve the latency of a node.", "node"_a);
+
     /* rs_export.hpp */
     // py::class_<rs2::save_to_ply, rs2::filter> save_to_ply(m, "save_to_ply"); // No docstring in C++
     // save_to_ply.def(py::init<std::string, rs2::pointcloud>(), "filename"_a = "RealSense Pointcloud ", "pc"_a = rs2::pointcloud())